@@ -72,6 +72,10 @@ macro(perform_feature_checks)
     check_symbol_exists(_snprintf "stdio.h" HAVE_ISO_SNPRINTF)
     check_symbol_exists(_hypot "math.h" HAVE_ISO_HYPOT)
 
+    # Posix strtok_r(), or strtok_s() of Visual C++, for the parsers run by several threads.
+    check_symbol_exists(strtok_r "string.h" HAVE_STRTOK_R)
+    check_symbol_exists(strtok_s "string.h" HAVE_ISO_STRTOK_S)
+
     #check_symbol_exists(clock_gettime "time.h" HAVE_CLOCK_GETTIME) non-standard library, does not work
     check_library_exists(rt clock_gettime "" HAVE_CLOCK_GETTIME)
 
@@ -82,6 +86,10 @@ macro(perform_feature_checks)
     # getc() on platforms where getc_unlocked() doesn't exist.
     check_symbol_exists(getc_unlocked "stdio.h" HAVE_FGETC_NOLOCK)
 
+    # Check for mmap() so MMAP_LINE_READER can map the files it reads.  It reads them
+    # whole into memory on platforms where mmap() doesn't exist.
+    check_symbol_exists(mmap "sys/mman.h" HAVE_MMAP)
+
     # Generate config.h.
     configure_file(${PROJECT_SOURCE_DIR}/CMakeModules/config.h.cmake
                    ${CMAKE_BINARY_DIR}/config.h)
@@ -199,6 +199,193 @@ if( NOT ( tokensBefore EQUAL tokensAfter ) )
     message( FATAL_ERROR "Duplicate tokens found in file <${inputFile}>." )
 endif()
 
+# Build a perfect hash of the tokens, for DSNLEXER::findToken() to find a token
+# in a single pass over its characters, in any case and with no allocation.
+# The hash of a token is 2 polynomials of its characters, h1 and h2, computed
+# exactly as in DSNLEXER::findToken().  h1 chooses one of the hashBuckets
+# buckets, and each bucket has a displacement D chosen so that its tokens get
+# free slots of their own:
+#   ( h1 + ( D / hashSlots ) * ( 1 + h2 % ( hashSlots - 1 ) ) + D % hashSlots ) % hashSlots
+# hashSlots is a prime number a bit larger than the token count, and the next
+# prime is tried if a bucket cannot be placed.
+
+foreach( code RANGE 48 57 )         # 0-9
+    string( ASCII ${code} char )
+    set( asciiCode_${char} ${code} )
+endforeach()
+
+foreach( code RANGE 97 122 )        # a-z
+    string( ASCII ${code} char )
+    set( asciiCode_${char} ${code} )
+endforeach()
+
+set( asciiCode__ 95 )
+
+math( EXPR hashBuckets "( ${tokensAfter} + 2 ) / 3" )
+math( EXPR lastBucket "${hashBuckets} - 1" )
+set( maxBucketSize 0 )
+set( tokenIndex 0 )
+
+foreach( token ${tokens} )
+    set( h1 0 )
+    set( h2 0 )
+
+    string( LENGTH "${token}" tokenLength )
+    math( EXPR lastChar "${tokenLength} - 1" )
+
+    foreach( ii RANGE ${lastChar} )
+        string( SUBSTRING "${token}" ${ii} 1 char )
+        math( EXPR h1 "( ${h1} * 31 + ${asciiCode_${char}} ) % 65521" )
+        math( EXPR h2 "( ${h2} * 37 + ${asciiCode_${char}} ) % 65519" )
+    endforeach()
+
+    math( EXPR bucket "${h1} % ${hashBuckets}" )
+    set( hashH1_${tokenIndex} ${h1} )
+    set( hashH2_${tokenIndex} ${h2} )
+
+    list( APPEND hashBucket_${bucket} ${tokenIndex} )
+    list( LENGTH hashBucket_${bucket} bucketSize )
+
+    if( bucketSize GREATER maxBucketSize )
+        set( maxBucketSize ${bucketSize} )
+    endif()
+
+    math( EXPR tokenIndex "${tokenIndex} + 1" )
+endforeach()
+
+math( EXPR lastToken "${tokenIndex} - 1" )
+math( EXPR hashSlots "${tokensAfter} + ${tokensAfter} / 4 + 1" )
+math( EXPR maxHashSlots "${tokensAfter} * 4 + 10" )
+set( hashFound FALSE )
+
+while( NOT hashFound )
+    # the next prime number
+    set( isPrime FALSE )
+
+    while( NOT isPrime )
+        math( EXPR hashSlots "${hashSlots} + 1" )
+        set( isPrime TRUE )
+        set( divisor 2 )
+
+        while( isPrime AND divisor LESS hashSlots )
+            math( EXPR remainder "${hashSlots} % ${divisor}" )
+
+            if( remainder EQUAL 0 )
+                set( isPrime FALSE )
+            endif()
+
+            math( EXPR divisor "${divisor} + 1" )
+        endwhile()
+    endwhile()
+
+    if( hashSlots GREATER maxHashSlots )
+        message( FATAL_ERROR
+                 "${dsnErrorMsg} no perfect hash found for file <${inputFile}>." )
+    endif()
+
+    math( EXPR lastSlot "${hashSlots} - 1" )
+    math( EXPR slotModulo "${hashSlots} - 1" )
+    math( EXPR maxDisplacement "${hashSlots} * ${hashSlots}" )
+
+    foreach( slot RANGE ${lastSlot} )
+        unset( hashSlot_${slot} )
+    endforeach()
+
+    foreach( member RANGE ${lastToken} )
+        math( EXPR hashBase_${member} "${hashH1_${member}} % ${hashSlots}" )
+        math( EXPR hashStep_${member} "1 + ${hashH2_${member}} % ${slotModulo}" )
+    endforeach()
+
+    # Place the largest buckets first, while there are many free slots.
+    set( hashFound TRUE )
+    set( bucketSize ${maxBucketSize} )
+
+    while( hashFound AND bucketSize GREATER 0 )
+        foreach( bucket RANGE ${lastBucket} )
+            set( members ${hashBucket_${bucket}} )
+            list( LENGTH members memberCount )
+
+            if( hashFound AND memberCount EQUAL bucketSize )
+                set( displacement 0 )
+                set( placed FALSE )
+
+                while( NOT placed AND displacement LESS maxDisplacement )
+                    math( EXPR d0 "${displacement} / ${hashSlots}" )
+                    math( EXPR d1 "${displacement} % ${hashSlots}" )
+
+                    set( positions "" )
+                    set( placed TRUE )
+
+                    foreach( member ${members} )
+                        math( EXPR position
+                              "( ${hashBase_${member}} + ${d0} * ${hashStep_${member}} + ${d1} ) % ${hashSlots}" )
+                        list( FIND positions ${position} found )
+
+                        if( DEFINED hashSlot_${position} OR NOT found EQUAL -1 )
+                            set( placed FALSE )
+                            break()
+                        endif()
+
+                        list( APPEND positions ${position} )
+                    endforeach()
+
+                    if( NOT placed )
+                        math( EXPR displacement "${displacement} + 1" )
+                    endif()
+                endwhile()
+
+                if( placed )
+                    set( hashDisplacement_${bucket} ${displacement} )
+
+                    math( EXPR lastMember "${memberCount} - 1" )
+
+                    foreach( ii RANGE ${lastMember} )
+                        list( GET members ${ii} member )
+                        list( GET positions ${ii} position )
+                        set( hashSlot_${position} ${member} )
+                    endforeach()
+                else()
+                    set( hashFound FALSE )
+                endif()
+            endif()
+        endforeach()
+
+        math( EXPR bucketSize "${bucketSize} - 1" )
+    endwhile()
+endwhile()
+
+set( hashDisplacementsText "" )
+
+foreach( bucket RANGE ${lastBucket} )
+    if( NOT DEFINED hashDisplacement_${bucket} )
+        set( hashDisplacement_${bucket} 0 )
+    endif()
+
+    math( EXPR column "${bucket} % 10" )
+
+    if( column EQUAL 0 )
+        set( hashDisplacementsText "${hashDisplacementsText}\n   " )
+    endif()
+
+    set( hashDisplacementsText "${hashDisplacementsText} ${hashDisplacement_${bucket}}," )
+endforeach()
+
+set( hashSlotsText "" )
+
+foreach( slot RANGE ${lastSlot} )
+    if( NOT DEFINED hashSlot_${slot} )
+        set( hashSlot_${slot} -1 )
+    endif()
+
+    math( EXPR column "${slot} % 10" )
+
+    if( column EQUAL 0 )
+        set( hashSlotsText "${hashSlotsText}\n   " )
+    endif()
+
+    set( hashSlotsText "${hashSlotsText} ${hashSlot_${slot}}," )
+endforeach()
+
 file( WRITE "${outHeaderFile}" "${includeFileHeader}" )
 file( WRITE "${outCppFile}" "${sourceFileHeader}" )
 
@@ -240,6 +427,9 @@ class ${LEXERCLASS} : public DSNLEXER
     static const KEYWORD  keywords[];
     static const unsigned keyword_count;
 
+    /// Auto generated perfect hash of keywords:
+    static const KEYWORD_HASH keyword_hash;
+
 public:
     /**
      * Constructor ( const std::string&, const wxString& )
@@ -250,6 +440,7 @@ public:
     ${LEXERCLASS}( const std::string& aSExpression, const wxString& aSource = wxEmptyString ) :
         DSNLEXER( keywords, keyword_count, aSExpression, aSource )
     {
+        keywordHash = &keyword_hash;
     }
 
     /**
@@ -264,6 +455,7 @@ public:
     ${LEXERCLASS}( FILE* aFile, const wxString& aFilename ) :
         DSNLEXER( keywords, keyword_count, aFile, aFilename )
     {
+        keywordHash = &keyword_hash;
     }
 
     /**
@@ -280,6 +472,7 @@ public:
     ${LEXERCLASS}( LINE_READER* aLineReader ) :
         DSNLEXER( keywords, keyword_count, aLineReader )
     {
+        keywordHash = &keyword_hash;
     }
 
     /**
@@ -370,6 +563,17 @@ file( APPEND "${outCppFile}"
 const unsigned ${LEXERCLASS}::keyword_count = unsigned( sizeof( ${LEXERCLASS}::keywords )/sizeof( ${LEXERCLASS}::keywords[0] ) );
 
 
+static const int hashDisplacements[${hashBuckets}] = {${hashDisplacementsText}
+};
+
+static const int hashSlots[${hashSlots}] = {${hashSlotsText}
+};
+
+const KEYWORD_HASH ${LEXERCLASS}::keyword_hash = {
+    hashDisplacements, ${hashBuckets}, hashSlots, ${hashSlots}
+};
+
+
 const char* ${LEXERCLASS}::TokenName( T aTok )
 {
     const char* ret;
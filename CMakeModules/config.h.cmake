@@ -50,9 +50,20 @@
 #define strnicmp _strnicmp
 #endif
 
+#cmakedefine HAVE_STRTOK_R
+
+#cmakedefine HAVE_ISO_STRTOK_S
+
+#if !defined( HAVE_STRTOK_R ) && defined( HAVE_ISO_STRTOK_S )
+#define strtok_r strtok_s
+#endif
+
 // Use Posix getc_unlocked() instead of getc() when it's available.
 #cmakedefine HAVE_FGETC_NOLOCK
 
+// Use mmap() in MMAP_LINE_READER when it's available.
+#cmakedefine HAVE_MMAP
+
 // Warning!!!  Using wxGraphicContext for rendering is experimental.
 #cmakedefine USE_WX_GRAPHICS_CONTEXT 1
 
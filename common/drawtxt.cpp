@@ -30,6 +30,7 @@
  */
 
 #include <fctsys.h>
+#include <wx/thread.h>
 #include <gr_basic.h>
 #include <common.h>
 #include <plot_common.h>
@@ -133,29 +134,139 @@ int NegableTextLength( const wxString& aText )
 }
 
 
-/* Function GetHersheyShapeDescription
- * return a pointer to the shape corresponding to unicode value AsciiCode
- * Note we use the same font for Bold and Normal texts
- * because KiCad handles a variable pen size to do that
- * that gives better results in XOR draw mode.
+/**
+ * Class STROKE_GLYPHS
+ * is the newstroke font decoded once: the strokes of each glyph as integer points,
+ * and the advance width of each glyph.  Decoding the strings of newstroke_font[] for
+ * each char of each text was most of the time spent to draw and to measure texts.
+ * <p>
+ * The coordinates are in font units: x from the left side of the glyph, y from its
+ * middle, to be scaled by the text size and s_HerscheyScaleFactor.
+ * </p>
  */
-static const char* GetHersheyShapeDescription( int AsciiCode )
+class STROKE_GLYPHS
 {
-    /* calculate font length */
-    int font_length_max = newstroke_font_bufsize;
+public:
+    struct GLYPH_POINT
+    {
+        signed char x;
+        signed char y;
+    };
+
+    struct GLYPH
+    {
+        unsigned    m_FirstStroke;      ///< index of its first stroke in m_strokeStarts
+        unsigned    m_StrokeCount;
+        int         m_Advance;          ///< advance width in font units
+    };
+
+    STROKE_GLYPHS();
+
+    /**
+     * Function Get
+     * @return the glyph of unicode value \a aCode, the glyph of '?' for codes out of
+     *         the font and the glyph of the space for control chars.
+     *         Note we use the same font for Bold and Normal texts because KiCad handles
+     *         a variable pen size to do that, that gives better results in XOR draw mode.
+     */
+    const GLYPH& Get( int aCode ) const
+    {
+        if( aCode >= 32 + (int) m_glyphs.size() )
+            aCode = '?';
+
+        if( aCode < 32 )
+            aCode = 32;
+
+        return m_glyphs[aCode - 32];
+    }
 
-    if( AsciiCode >= (32 + font_length_max) )
-        AsciiCode = '?';
-    if( AsciiCode < 32 )
-        AsciiCode = 32;                 /* Clamp control chars */
-    AsciiCode -= 32;
+    /// @return the first point of stroke \a aStroke
+    const GLYPH_POINT* StrokePoints( unsigned aStroke ) const
+    {
+        return &m_points[ m_strokeStarts[aStroke] ];
+    }
 
-    return newstroke_font[AsciiCode];
+    /// @return the point count of stroke \a aStroke
+    int StrokePointCount( unsigned aStroke ) const
+    {
+        return m_strokeStarts[aStroke + 1] - m_strokeStarts[aStroke];
+    }
+
+private:
+    std::vector<GLYPH_POINT>    m_points;       ///< the points of all the strokes
+    std::vector<unsigned>       m_strokeStarts; ///< first point of each stroke, then the end
+    std::vector<GLYPH>          m_glyphs;       ///< the glyphs, from the space char
+};
+
+
+STROKE_GLYPHS::STROKE_GLYPHS()
+{
+    m_glyphs.resize( newstroke_font_bufsize );
+
+    for( int ii = 0;  ii < newstroke_font_bufsize;  ii++ )
+    {
+        const char* ptcar = newstroke_font[ii];
+        GLYPH&      glyph = m_glyphs[ii];
+
+        // Get metrics: coordinates values are coded as <value> + 'R'
+        int xsta = *ptcar++ - 'R';
+        int xsto = *ptcar++ - 'R';
+
+        glyph.m_FirstStroke = m_strokeStarts.size();
+        glyph.m_StrokeCount = 0;
+        glyph.m_Advance     = xsto - xsta;
+
+        unsigned strokeStart = m_points.size();
+
+        for( ;; )
+        {
+            int hc1 = *ptcar++;
+            int hc2 = hc1 ? *ptcar++ : 0;
+
+            // A pen up request, the end of the glyph is a synthetic pen up
+            if( !hc1 || ( hc1 == ' ' && hc2 == 'R' ) )
+            {
+                if( m_points.size() > strokeStart )
+                {
+                    m_strokeStarts.push_back( strokeStart );
+                    glyph.m_StrokeCount++;
+                    strokeStart = m_points.size();
+                }
+
+                if( !hc1 )
+                    break;
+
+                continue;
+            }
+
+            GLYPH_POINT point;
+
+            point.x = hc1 - 'R' - xsta;
+            point.y = hc2 - 'R' - 11;       // Align the midpoint
+            m_points.push_back( point );
+        }
+    }
+
+    m_strokeStarts.push_back( m_points.size() );
+}
+
+
+/**
+ * Function strokeGlyphs
+ * @return the newstroke font, decoded at the first call.
+ */
+static const STROKE_GLYPHS& strokeGlyphs()
+{
+    static const STROKE_GLYPHS glyphs;
+
+    return glyphs;
 }
 
 
 int ReturnGraphicTextWidth( const wxString& aText, int aXSize, bool aItalic, bool aWidth )
 {
+    const STROKE_GLYPHS& glyphs = strokeGlyphs();
+
     int tally = 0;
     int char_count = aText.length();
 
@@ -168,11 +279,7 @@ int ReturnGraphicTextWidth( const wxString& aText, int aXSize, bool aItalic, boo
             continue;
         }
 
-        const char* ptcar = GetHersheyShapeDescription( AsciiCode );
-        /* Get metrics */
-        int         xsta = *ptcar++ - 'R';
-        int         xsto = *ptcar++ - 'R';
-        tally += KiROUND( aXSize * (xsto - xsta) * s_HerscheyScaleFactor );
+        tally += KiROUND( aXSize * glyphs.Get( AsciiCode ).m_Advance * s_HerscheyScaleFactor );
     }
 
     /* Italic correction, 1/8em */
@@ -227,111 +334,68 @@ static void DrawGraphicTextPline(
 
 
 /**
- * Function DrawGraphicText
- * Draw a graphic text (like module texts)
- *  @param aPanel = the current m_canvas. NULL if draw within a 3D GL Canvas
- *  @param aDC = the current Device Context. NULL if draw within a 3D GL Canvas
- *  @param aPos = text position (according to h_justify, v_justify)
- *  @param aColor (enum EDA_COLOR_T) = text color
- *  @param aText = text to draw
- *  @param aOrient = angle in 0.1 degree
- *  @param aSize = text size (size.x or size.y can be < 0 for mirrored texts)
- *  @param aH_justify = horizontal justification (Left, center, right)
- *  @param aV_justify = vertical justification (bottom, center, top)
- *  @param aWidth = line width (pen width) (use default width if aWidth = 0)
- *      if width < 0 : draw segments in sketch mode, width = abs(width)
- *      Use a value min(aSize.x, aSize.y) / 5 for a bold text
- *  @param aItalic = true to simulate an italic font
- *  @param aBold = true to use a bold font. Useful only with default width value (aWidth = 0)
- *  @param aCallback() = function called (if non null) to draw each segment.
- *                  used to draw 3D texts or for plotting, NULL for normal drawings
- *  @param aPlotter = a pointer to a PLOTTER instance, when this function is used to plot
- *                  the text. NULL to draw this text.
+ * Function addPolyline
+ * ends the polyline of \a aStrokes started at \a aStart, the points added since.
  */
-void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
-                      wxDC* aDC,
-                      const wxPoint& aPos,
-                      EDA_COLOR_T aColor,
-                      const wxString& aText,
-                      int aOrient,
-                      const wxSize& aSize,
-                      enum EDA_TEXT_HJUSTIFY_T aH_justify,
-                      enum EDA_TEXT_VJUSTIFY_T aV_justify,
-                      int aWidth,
-                      bool aItalic,
-                      bool aBold,
-                      void (* aCallback)( int x0, int y0, int xf, int yf ),
-                      PLOTTER* aPlotter )
+static void addPolyline( TEXT_STROKES& aStrokes, unsigned aStart )
 {
-    int       AsciiCode;
-    int       x0, y0;
+    if( aStrokes.m_Points.size() > aStart )
+        aStrokes.m_PolylineEnds.push_back( aStrokes.m_Points.size() );
+}
+
+
+/**
+ * Function buildTextStrokes
+ * computes the strokes of a text drawn by DrawGraphicText(), which parameters are
+ * the same, but for the pen width which is the pen size actually used.
+ */
+static void buildTextStrokes( TEXT_STROKES& aStrokes,
+                              const wxPoint& aPos,
+                              const wxString& aText,
+                              int aOrient,
+                              const wxSize& aSize,
+                              enum EDA_TEXT_HJUSTIFY_T aH_justify,
+                              enum EDA_TEXT_VJUSTIFY_T aV_justify,
+                              int aWidth,
+                              bool aItalic,
+                              int aTextWidth )
+{
+    const STROKE_GLYPHS& glyphs = strokeGlyphs();
+
     int       size_h, size_v;
     unsigned  ptr;
     int       dx, dy;                       // Draw coordinate for segments to draw. also used in some other calculation
     wxPoint   current_char_pos;             // Draw coordinates for the current char
     wxPoint   overbar_pos;                  // Start point for the current overbar
     int       overbar_italic_comp;          // Italic compensation for overbar
-    EDA_RECT* clipBox;                      // Clip box used in basic draw functions
-
-    clipBox = aPanel ? aPanel->GetClipBox() : NULL;
-    #define        BUF_SIZE 100
-    wxPoint coord[BUF_SIZE + 1];                // Buffer coordinate used to draw polylines (one char shape)
-    bool    sketch_mode    = false;
-    bool    italic_reverse = false;             // true for mirrored texts with m_Size.x < 0
+    bool      italic_reverse = false;       // true for mirrored texts with m_Size.x < 0
+
+    aStrokes.m_Valid     = true;
+    aStrokes.m_Pos       = aPos;
+    aStrokes.m_Text      = aText;
+    aStrokes.m_Orient    = aOrient;
+    aStrokes.m_Size      = aSize;
+    aStrokes.m_HJustify  = aH_justify;
+    aStrokes.m_VJustify  = aV_justify;
+    aStrokes.m_Width     = aWidth;
+    aStrokes.m_Italic    = aItalic;
+    aStrokes.m_TextWidth = aTextWidth;
+    aStrokes.m_Points.clear();
+    aStrokes.m_PolylineEnds.clear();
 
     size_h = aSize.x;                           /* PLEASE NOTE: H is for HORIZONTAL not for HEIGHT */
     size_v = aSize.y;
 
-    if( aWidth == 0 && aBold )       // Use default values if aWidth == 0
-        aWidth = GetPenSizeForBold( std::min( aSize.x, aSize.y ) );
-
-    if( aWidth < 0 )
-    {
-        aWidth = -aWidth;
-        sketch_mode = true;
-    }
-
-#ifdef CLIP_PEN      // made by draw and plot functions
-    aWidth = Clamp_Text_PenSize( aWidth, aSize, aBold );
-#endif
-
     if( size_h < 0 )       // text is mirrored using size.x < 0 (mirror / Y axis)
         italic_reverse = true;
 
     unsigned char_count = NegableTextLength( aText );
-    if( char_count == 0 )
-        return;
 
     current_char_pos = aPos;
 
-    dx = ReturnGraphicTextWidth( aText, size_h, aItalic, aWidth );
+    dx = aTextWidth;
     dy = size_v;
 
-    /* Do not draw the text if out of draw area! */
-    if( aPanel )
-    {
-        int xm, ym, ll, xc, yc;
-        ll = std::abs( dx );
-
-        xc = current_char_pos.x;
-        yc = current_char_pos.y;
-
-        x0 = aPanel->GetClipBox()->GetX() - ll;
-        y0 = aPanel->GetClipBox()->GetY() - ll;
-        xm = aPanel->GetClipBox()->GetRight() + ll;
-        ym = aPanel->GetClipBox()->GetBottom() + ll;
-
-        if( xc < x0 )
-            return;
-        if( yc < y0 )
-            return;
-        if( xc > xm )
-            return;
-        if( yc > ym )
-            return;
-    }
-
-
     /* Compute the position of the first letter of the text
      * this position is the position of the left bottom point of the letter
      * this is the same as the text position only for a left and bottom justified text
@@ -380,19 +444,9 @@ void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
         RotatePoint( &current_char_pos, aPos, aOrient );
         RotatePoint( &end, aPos, aOrient );
 
-        if( aPlotter )
-        {
-            aPlotter->MoveTo( current_char_pos );
-            aPlotter->FinishTo( end );
-        }
-        else if( aCallback )
-        {
-            aCallback( current_char_pos.x, current_char_pos.y, end.x, end.y );
-        }
-        else
-            GRLine( clipBox, aDC,
-                    current_char_pos.x, current_char_pos.y, end.x, end.y, aWidth, aColor );
-
+        aStrokes.m_Points.push_back( current_char_pos );
+        aStrokes.m_Points.push_back( end );
+        addPolyline( aStrokes, 0 );
         return;
     }
 
@@ -429,64 +483,33 @@ void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
             else
             {
                 /* Ending the overbar */
-                coord[0]       = overbar_pos;
+                unsigned start = aStrokes.m_Points.size();
+
+                aStrokes.m_Points.push_back( overbar_pos );
                 overbar_pos    = current_char_pos;
                 overbar_pos.x += overbar_italic_comp;
                 overbar_pos.y -= OverbarPositionY( size_v, aWidth );
                 RotatePoint( &overbar_pos, aPos, aOrient );
-                coord[1] = overbar_pos;
-                /* Plot the overbar segment */
-                DrawGraphicTextPline( clipBox, aDC, aColor, aWidth,
-                                      sketch_mode, 2, coord, aCallback, aPlotter );
+                aStrokes.m_Points.push_back( overbar_pos );
+                addPolyline( aStrokes, start );
             }
             continue; /* Skip ~ processing */
         }
 
-        AsciiCode = aText.GetChar( ptr + overbars );
+        const STROKE_GLYPHS::GLYPH& glyph = glyphs.Get( aText.GetChar( ptr + overbars ) );
 
-        const char* ptcar = GetHersheyShapeDescription( AsciiCode );
-        /* Get metrics */
-        int         xsta = *ptcar++ - 'R';
-        int         xsto = *ptcar++ - 'R';
-        int         point_count = 0;
-        bool        endcar = false;
-        while( !endcar )
+        for( unsigned stroke = glyph.m_FirstStroke;
+             stroke < glyph.m_FirstStroke + glyph.m_StrokeCount;  stroke++ )
         {
-            int hc1, hc2;
-            hc1 = *ptcar++;
-            if( hc1 )
-            {
-                hc2 = *ptcar++;
-            }
-            else
-            {
-                // End of character, insert a synthetic pen up:
-                hc1    = ' ';
-                hc2    = 'R';
-                endcar = true;
-            }
-            // Do the Hershey decode thing: coordinates values are coded as <value> + 'R'
-            hc1 -= 'R'; hc2 -= 'R';
+            const STROKE_GLYPHS::GLYPH_POINT* points = glyphs.StrokePoints( stroke );
+            int                               point_count = glyphs.StrokePointCount( stroke );
+            unsigned                          start = aStrokes.m_Points.size();
 
-            /* Pen up request */
-            if( hc1 == -50 && hc2 == 0 )
-            {
-                if( point_count )
-                {
-                    if( aWidth <= 1 )
-                        aWidth = 0;
-                    DrawGraphicTextPline( clipBox, aDC, aColor, aWidth,
-                                          sketch_mode, point_count, coord,
-                                          aCallback, aPlotter );
-                }
-                point_count = 0;
-            }
-            else
+            for( int ii = 0;  ii < point_count;  ii++ )
             {
                 wxPoint currpoint;
-                hc1 -= xsta; hc2 -= 11; /* Align the midpoint */
-                hc1  = KiROUND( hc1 * size_h * s_HerscheyScaleFactor );
-                hc2  = KiROUND( hc2 * size_v * s_HerscheyScaleFactor );
+                int     hc1 = KiROUND( points[ii].x * size_h * s_HerscheyScaleFactor );
+                int     hc2 = KiROUND( points[ii].y * size_v * s_HerscheyScaleFactor );
 
                 // To simulate an italic font, add a x offset depending on the y offset
                 if( aItalic )
@@ -495,10 +518,10 @@ void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
                 currpoint.y = hc2 + current_char_pos.y;
 
                 RotatePoint( &currpoint, aPos, aOrient );
-                coord[point_count] = currpoint;
-                if( point_count < BUF_SIZE - 1 )
-                    point_count++;
+                aStrokes.m_Points.push_back( currpoint );
             }
+
+            addPolyline( aStrokes, start );
         }
 
         /* end draw 1 char */
@@ -506,20 +529,155 @@ void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
         ptr++;
 
         // Apply the advance width
-        current_char_pos.x += KiROUND( size_h * (xsto - xsta) * s_HerscheyScaleFactor );
+        current_char_pos.x += KiROUND( size_h * glyph.m_Advance * s_HerscheyScaleFactor );
     }
 
     if( overbars % 2 )
     {
         /* Close the last overbar */
-        coord[0]       = overbar_pos;
+        unsigned start = aStrokes.m_Points.size();
+
+        aStrokes.m_Points.push_back( overbar_pos );
         overbar_pos    = current_char_pos;
         overbar_pos.y -= OverbarPositionY( size_v, aWidth );
         RotatePoint( &overbar_pos, aPos, aOrient );
-        coord[1] = overbar_pos;
-        /* Plot the overbar segment */
-        DrawGraphicTextPline( clipBox, aDC, aColor, aWidth,
-                              sketch_mode, 2, coord, aCallback, aPlotter );
+        aStrokes.m_Points.push_back( overbar_pos );
+        addPolyline( aStrokes, start );
+    }
+}
+
+
+bool TEXT_STROKES::IsFor( const wxPoint& aPos, const wxString& aText, int aOrient,
+                          const wxSize& aSize, EDA_TEXT_HJUSTIFY_T aH_justify,
+                          EDA_TEXT_VJUSTIFY_T aV_justify, int aWidth, bool aItalic ) const
+{
+    return m_Valid && m_Pos == aPos && m_Orient == aOrient && m_Size == aSize
+        && m_HJustify == aH_justify && m_VJustify == aV_justify && m_Width == aWidth
+        && m_Italic == aItalic && m_Text == aText;
+}
+
+
+/**
+ * Function DrawGraphicText
+ * Draw a graphic text (like module texts)
+ *  @param aPanel = the current m_canvas. NULL if draw within a 3D GL Canvas
+ *  @param aDC = the current Device Context. NULL if draw within a 3D GL Canvas
+ *  @param aPos = text position (according to h_justify, v_justify)
+ *  @param aColor (enum EDA_COLOR_T) = text color
+ *  @param aText = text to draw
+ *  @param aOrient = angle in 0.1 degree
+ *  @param aSize = text size (size.x or size.y can be < 0 for mirrored texts)
+ *  @param aH_justify = horizontal justification (Left, center, right)
+ *  @param aV_justify = vertical justification (bottom, center, top)
+ *  @param aWidth = line width (pen width) (use default width if aWidth = 0)
+ *      if width < 0 : draw segments in sketch mode, width = abs(width)
+ *      Use a value min(aSize.x, aSize.y) / 5 for a bold text
+ *  @param aItalic = true to simulate an italic font
+ *  @param aBold = true to use a bold font. Useful only with default width value (aWidth = 0)
+ *  @param aCallback() = function called (if non null) to draw each segment.
+ *                  used to draw 3D texts or for plotting, NULL for normal drawings
+ *  @param aPlotter = a pointer to a PLOTTER instance, when this function is used to plot
+ *                  the text. NULL to draw this text.
+ *  @param aStrokes = the strokes of this text the last time it was drawn, reused if
+ *                  nothing changed since, else rebuilt.  NULL if the text has no cache.
+ */
+void DrawGraphicText( EDA_DRAW_PANEL* aPanel,
+                      wxDC* aDC,
+                      const wxPoint& aPos,
+                      EDA_COLOR_T aColor,
+                      const wxString& aText,
+                      int aOrient,
+                      const wxSize& aSize,
+                      enum EDA_TEXT_HJUSTIFY_T aH_justify,
+                      enum EDA_TEXT_VJUSTIFY_T aV_justify,
+                      int aWidth,
+                      bool aItalic,
+                      bool aBold,
+                      void (* aCallback)( int x0, int y0, int xf, int yf ),
+                      PLOTTER* aPlotter,
+                      TEXT_STROKES* aStrokes )
+{
+    // The strokes of the texts without a cache, which keeps its buffers from one text
+    // to the next.  Texts are only drawn by the GUI thread.
+    static TEXT_STROKES s_strokes;
+
+    wxASSERT( wxIsMainThread() );
+
+    EDA_RECT* clipBox;                      // Clip box used in basic draw functions
+    bool      sketch_mode = false;
+
+    clipBox = aPanel ? aPanel->GetClipBox() : NULL;
+
+    if( aWidth == 0 && aBold )       // Use default values if aWidth == 0
+        aWidth = GetPenSizeForBold( std::min( aSize.x, aSize.y ) );
+
+    if( aWidth < 0 )
+    {
+        aWidth = -aWidth;
+        sketch_mode = true;
+    }
+
+#ifdef CLIP_PEN      // made by draw and plot functions
+    aWidth = Clamp_Text_PenSize( aWidth, aSize, aBold );
+#endif
+
+    unsigned char_count = NegableTextLength( aText );
+    if( char_count == 0 )
+        return;
+
+    // a text too small to be read on screen is not drawn, nor even measured
+    if( !aPlotter && !aCallback && !GRIsTextDrawable( aPanel, aDC, std::abs( aSize.y ) ) )
+        return;
+
+    if( !aStrokes )
+        aStrokes = &s_strokes;
+
+    bool cached = aStrokes->IsFor( aPos, aText, aOrient, aSize, aH_justify, aV_justify,
+                                   aWidth, aItalic );
+
+    int dx = cached ? aStrokes->m_TextWidth
+                    : ReturnGraphicTextWidth( aText, aSize.x, aItalic, aWidth );
+
+    /* Do not draw the text if out of draw area! */
+    if( aPanel )
+    {
+        int x0, y0, xm, ym, ll, xc, yc;
+        ll = std::abs( dx );
+
+        xc = aPos.x;
+        yc = aPos.y;
+
+        x0 = aPanel->GetClipBox()->GetX() - ll;
+        y0 = aPanel->GetClipBox()->GetY() - ll;
+        xm = aPanel->GetClipBox()->GetRight() + ll;
+        ym = aPanel->GetClipBox()->GetBottom() + ll;
+
+        if( xc < x0 )
+            return;
+        if( yc < y0 )
+            return;
+        if( xc > xm )
+            return;
+        if( yc > ym )
+            return;
+    }
+
+    if( !cached )
+        buildTextStrokes( *aStrokes, aPos, aText, aOrient, aSize, aH_justify, aV_justify,
+                          aWidth, aItalic, dx );
+
+    if( aWidth <= 1 )
+        aWidth = 0;
+
+    unsigned start = 0;
+
+    for( unsigned ii = 0;  ii < aStrokes->m_PolylineEnds.size();  ii++ )
+    {
+        unsigned end = aStrokes->m_PolylineEnds[ii];
+
+        DrawGraphicTextPline( clipBox, aDC, aColor, aWidth, sketch_mode, end - start,
+                              &aStrokes->m_Points[start], aCallback, aPlotter );
+        start = end;
     }
 }
 
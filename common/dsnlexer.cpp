@@ -54,6 +54,8 @@ void DSNLEXER::init()
     curTok  = DSN_NONE;
     prevTok = DSN_NONE;
 
+    keywordHash = NULL;
+
     stringDelimiter = '"';
 
     specctraMode = false;
@@ -169,6 +171,51 @@ LINE_READER* DSNLEXER::PopReader()
 
 int DSNLEXER::findToken( const std::string& tok )
 {
+    if( keywordHash )
+    {
+        // The hash of the token in lower case.  This must be the same hash as
+        // TokenList2DsnLexer.cmake's, which generated keywordHash.
+        unsigned h1 = 0;
+        unsigned h2 = 0;
+
+        for( std::string::const_iterator iter = tok.begin();  iter!=tok.end();  ++iter )
+        {
+            unsigned cc = (unsigned char) *iter;
+
+            if( cc >= 'A' && cc <= 'Z' )
+                cc += 'a' - 'A';
+
+            h1 = ( h1 * 31 + cc ) % 65521;
+            h2 = ( h2 * 37 + cc ) % 65519;
+        }
+
+        unsigned slotCount    = keywordHash->slotCount;
+        unsigned displacement = keywordHash->displacements[ h1 % keywordHash->bucketCount ];
+        unsigned slot = ( h1 + ( displacement / slotCount ) * ( 1 + h2 % ( slotCount - 1 ) )
+                          + displacement % slotCount ) % slotCount;
+
+        int token = keywordHash->slots[slot];
+
+        if( token < 0 )
+            return -1;
+
+        // the only keyword the token can be: compare them, ignoring the case.
+        const char* name = keywords[token].name;
+
+        for( std::string::const_iterator iter = tok.begin();  iter!=tok.end();  ++iter, ++name )
+        {
+            char cc = *iter;
+
+            if( cc >= 'A' && cc <= 'Z' )
+                cc += 'a' - 'A';
+
+            if( *name != cc )
+                return -1;
+        }
+
+        return *name ? -1 : token;
+    }
+
     // convert to lower case once, this should be faster than using strcasecmp()
     // for each test in compare().
     lowercase.clear();
@@ -227,6 +227,8 @@ void EDA_TEXT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aOffset,
 
         RotatePoint( &offset, m_Orient );
 
+        m_strokes.resize( list->Count() );
+
         for( unsigned i = 0; i<list->Count(); i++ )
         {
             wxString txt = list->Item( i );
@@ -238,13 +240,17 @@ void EDA_TEXT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aOffset,
                                aFillMode,
                                i ?  UNSPECIFIED_COLOR : aAnchor_color,
                                txt,
-                               pos );
+                               pos,
+                               &m_strokes[i] );
             pos += offset;
         }
 
         delete (list);
     }
     else
+    {
+        m_strokes.resize( 1 );
+
         DrawOneLineOfText( aPanel,
                            aDC,
                            aOffset,
@@ -253,7 +259,9 @@ void EDA_TEXT::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aOffset,
                            aFillMode,
                            aAnchor_color,
                            m_Text,
-                           m_Pos );
+                           m_Pos,
+                           &m_strokes[0] );
+    }
 }
 
 
@@ -261,7 +269,7 @@ void EDA_TEXT::DrawOneLineOfText( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
                                   const wxPoint& aOffset, EDA_COLOR_T aColor,
                                   GR_DRAWMODE aDrawMode, EDA_DRAW_MODE_T aFillMode,
                                   EDA_COLOR_T aAnchor_color,
-                                  wxString& aText, wxPoint aPos )
+                                  wxString& aText, wxPoint aPos, TEXT_STROKES* aStrokes )
 {
     int width = m_Thickness;
 
@@ -298,7 +306,7 @@ void EDA_TEXT::DrawOneLineOfText( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
         size.x = -size.x;
 
     DrawGraphicText( aPanel, aDC, aOffset + aPos, aColor, aText, m_Orient, size,
-                     m_HJustify, m_VJustify, width, m_Italic, m_Bold );
+                     m_HJustify, m_VJustify, width, m_Italic, m_Bold, NULL, NULL, aStrokes );
 }
 
 
@@ -7,11 +7,17 @@
  * Functions to read footprint libraries and fill m_footprints by available footprints names
  * and their documentation (comments and keywords)
  */
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include <fctsys.h>
+#include <wx/stdpaths.h>
 #include <wxstruct.h>
 #include <common.h>
 #include <kicad_string.h>
 #include <macros.h>
+#include <openmp_threads.h>
 #include <appl_wxstruct.h>
 
 #include <pcbcommon.h>
@@ -24,6 +30,220 @@
 #include <wildcards_and_files_ext.h>
 
 
+/// The first line of the footprint info cache file, with the version of its format.
+#define FOOTPRINT_INFO_CACHE_HEADER     "FOOTPRINT_INFO_CACHE 1"
+
+
+/**
+ * Struct FOOTPRINT_LIB_INFO
+ * holds the footprint infos of a library, as read from the library or from the
+ * cache file.
+ */
+struct FOOTPRINT_LIB_INFO
+{
+    wxString                            m_LibPath;
+    long                                m_ModTime;  ///< of the library, when read
+    boost::ptr_vector< FOOTPRINT_INFO > m_List;
+    wxString                            m_Error;    ///< if the library cannot be read
+    bool                                m_Cached;   ///< m_List is from the cache file
+
+    FOOTPRINT_LIB_INFO() :
+        m_ModTime( 0 ),
+        m_Cached( false )
+    {
+    }
+};
+
+typedef std::map< wxString, FOOTPRINT_LIB_INFO > FOOTPRINT_LIB_INFO_MAP;
+
+
+/**
+ * Function footprintInfoCacheFileName
+ * @return wxString - the file caching the footprint infos of the libraries, shared
+ *  by all the applications.
+ */
+static wxString footprintInfoCacheFileName()
+{
+    wxFileName fn( wxStandardPaths::Get().GetUserConfigDir(), wxT( ".kicad_footprint_info" ) );
+
+    return fn.GetFullPath();
+}
+
+
+/// @return the modification time of a library, in seconds, 0 if it does not exist
+static long libModificationTime( const wxString& aLibPath )
+{
+    wxFileName fn( aLibPath );
+
+    if( !fn.FileExists() )
+        return 0;
+
+    return fn.GetModificationTime().GetTicks();
+}
+
+
+/**
+ * Function readFootprintInfoCache
+ * reads the footprint infos of the libraries which are in the cache file.  The file
+ * holds, for each library:
+ *   $LIBRARY "library path" modification_time
+ *   "footprint name" pad_count "keywords" "description"
+ *   ...... other footprints
+ *   $EndLIBRARY
+ * A cache file which cannot be read is ignored.
+ */
+static void readFootprintInfoCache( FOOTPRINT_LIB_INFO_MAP& aLibs )
+{
+    wxString fileName = footprintInfoCacheFileName();
+
+    if( !wxFileName::FileExists( fileName ) )
+        return;
+
+    try
+    {
+        FILE_LINE_READER    reader( fileName );
+        FOOTPRINT_LIB_INFO* lib = NULL;
+        char*               line;
+
+        if( !reader.ReadLine() || strncmp( reader.Line(), FOOTPRINT_INFO_CACHE_HEADER,
+                                           sizeof( FOOTPRINT_INFO_CACHE_HEADER ) - 1 ) )
+            return;
+
+        while( ( line = reader.ReadLine() ) != NULL )
+        {
+            if( !strncmp( line, "$LIBRARY", 8 ) )
+            {
+                wxString libPath;
+
+                line += 8;
+                line += ReadDelimitedText( &libPath, line );
+
+                lib = &aLibs[libPath];
+                lib->m_LibPath = libPath;
+                lib->m_ModTime = strtol( line, NULL, 10 );
+                lib->m_List.clear();
+                lib->m_Cached  = true;
+            }
+            else if( !strncmp( line, "$EndLIBRARY", 11 ) )
+            {
+                lib = NULL;
+            }
+            else if( lib && *line == '"' )
+            {
+                FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO();
+
+                lib->m_List.push_back( fpinfo );
+
+                fpinfo->m_LibName = lib->m_LibPath;
+                line += ReadDelimitedText( &fpinfo->m_Module, line );
+                fpinfo->m_padCount = strtol( line, &line, 10 );
+                line += ReadDelimitedText( &fpinfo->m_KeyWord, line );
+                ReadDelimitedText( &fpinfo->m_Doc, line );
+            }
+        }
+    }
+    catch( IO_ERROR ioe )
+    {
+        aLibs.clear();
+    }
+}
+
+
+/**
+ * Function writeFootprintInfoCache
+ * writes the footprint infos of the libraries which still exist in the cache file,
+ * through a temporary file, so that an other application reading the cache at the
+ * same time never sees a partial file.  Errors are ignored: the cache is only
+ * used to read the libraries faster.
+ */
+static void writeFootprintInfoCache( const FOOTPRINT_LIB_INFO_MAP& aLibs )
+{
+    wxString fileName = footprintInfoCacheFileName();
+    wxString tempFileName = fileName + wxT( ".tmp" );
+
+    try
+    {
+        {
+            FILE_OUTPUTFORMATTER out( tempFileName );
+
+            out.Print( 0, "%s\n", FOOTPRINT_INFO_CACHE_HEADER );
+
+            for( FOOTPRINT_LIB_INFO_MAP::const_iterator it = aLibs.begin();  it != aLibs.end();  ++it )
+            {
+                const FOOTPRINT_LIB_INFO& lib = it->second;
+
+                if( !lib.m_Error.IsEmpty() || !wxFileName::FileExists( lib.m_LibPath ) )
+                    continue;
+
+                out.Print( 0, "$LIBRARY %s %ld\n", EscapedUTF8( lib.m_LibPath ).c_str(),
+                           lib.m_ModTime );
+
+                for( unsigned ii = 0; ii < lib.m_List.size(); ++ii )
+                {
+                    const FOOTPRINT_INFO& fpinfo = lib.m_List[ii];
+
+                    out.Print( 0, "%s %d %s %s\n",
+                               EscapedUTF8( fpinfo.m_Module ).c_str(),
+                               fpinfo.m_padCount,
+                               EscapedUTF8( fpinfo.m_KeyWord ).c_str(),
+                               EscapedUTF8( fpinfo.m_Doc ).c_str() );
+                }
+
+                out.Print( 0, "$EndLIBRARY\n" );
+            }
+        }
+
+        wxRenameFile( tempFileName, fileName, true );
+    }
+    catch( IO_ERROR ioe )
+    {
+        wxRemoveFile( tempFileName );
+    }
+}
+
+
+/**
+ * Function readLibrary
+ * reads the footprint infos of a library with its own plugin, so that several
+ * libraries can be read at the same time.
+ */
+static void readLibrary( FOOTPRINT_LIB_INFO& aLib )
+{
+    aLib.m_List.clear();
+    aLib.m_Error.Empty();
+
+    try
+    {
+        PLUGIN::RELEASER pi( IO_MGR::PluginFind( IO_MGR::LEGACY ) );
+
+        wxArrayString fpnames = pi->FootprintEnumerate( aLib.m_LibPath );
+
+        for( unsigned i=0; i<fpnames.GetCount();  ++i )
+        {
+            std::auto_ptr<MODULE> m( pi->FootprintLoad( aLib.m_LibPath, fpnames[i] ) );
+
+            // we're loading what we enumerated, all must be there.
+            wxASSERT( m.get() );
+
+            FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO();
+
+            fpinfo->m_Module   = fpnames[i];
+            fpinfo->m_LibName  = aLib.m_LibPath;
+            fpinfo->m_padCount = m->GetPadCount();
+            fpinfo->m_KeyWord  = m->GetKeywords();
+            fpinfo->m_Doc      = m->GetDescription();
+
+            aLib.m_List.push_back( fpinfo );
+        }
+    }
+    catch( IO_ERROR ioe )
+    {
+        aLib.m_List.clear();
+        aLib.m_Error = ioe.errorText;
+    }
+}
+
+
 /* Read the list of libraries (*.mod files)
  * for each module are stored
  *      the module name
@@ -37,6 +257,9 @@
  *   Kw PAD_CONN DIN                    associated keywords
  *   ...... other data (pads, outlines ..)
  *   $Endmodule
+ *
+ * The infos are cached in a file, and only the libraries modified since they were
+ * cached are read again, in parallel.
  */
 bool FOOTPRINT_LIST::ReadFootprintFiles( wxArrayString& aFootprintsLibNames )
 {
@@ -45,61 +268,71 @@ bool FOOTPRINT_LIST::ReadFootprintFiles( wxArrayString& aFootprintsLibNames )
     m_filesInvalid.Empty();
     m_List.clear();
 
-    // try
-    {
-        PLUGIN::RELEASER pi( IO_MGR::PluginFind( IO_MGR::LEGACY ) );
+    FOOTPRINT_LIB_INFO_MAP              cache;
+    std::vector< FOOTPRINT_LIB_INFO* >  libs;       // the libraries, in the given order
+    std::vector< FOOTPRINT_LIB_INFO* >  toRead;     // the ones the cache does not hold
 
-        // Parse Libraries Listed
-        for( unsigned ii = 0; ii < aFootprintsLibNames.GetCount(); ii++ )
-        {
-            wxFileName filename = aFootprintsLibNames[ii];
+    readFootprintInfoCache( cache );
 
-            filename.SetExt( LegacyFootprintLibPathExtension );
+    for( unsigned ii = 0; ii < aFootprintsLibNames.GetCount(); ii++ )
+    {
+        wxFileName filename = aFootprintsLibNames[ii];
 
-            wxString libPath = wxGetApp().FindLibraryPath( filename );
+        filename.SetExt( LegacyFootprintLibPathExtension );
 
-            if( !libPath )
-            {
-                m_filesNotFound << filename.GetFullName() << wxT("\n");
-                continue;
-            }
+        wxString libPath = wxGetApp().FindLibraryPath( filename );
 
-            try
-            {
-                wxArrayString fpnames = pi->FootprintEnumerate( libPath );
+        if( !libPath )
+        {
+            m_filesNotFound << filename.GetFullName() << wxT("\n");
+            continue;
+        }
 
-                for( unsigned i=0; i<fpnames.GetCount();  ++i )
-                {
-                    std::auto_ptr<MODULE> m( pi->FootprintLoad( libPath, fpnames[i] ) );
+        FOOTPRINT_LIB_INFO& lib = cache[libPath];
+        long modTime = libModificationTime( libPath );
 
-                    // we're loading what we enumerated, all must be there.
-                    wxASSERT( m.get() );
+        if( !lib.m_Cached || lib.m_ModTime != modTime )
+        {
+            lib.m_LibPath = libPath;
+            lib.m_ModTime = modTime;
+            lib.m_Cached  = false;
 
-                    FOOTPRINT_INFO* fpinfo = new FOOTPRINT_INFO();
+            // a library given twice is read once
+            if( std::find( toRead.begin(), toRead.end(), &lib ) == toRead.end() )
+                toRead.push_back( &lib );
+        }
 
-                    fpinfo->m_Module   = fpnames[i];
-                    fpinfo->m_LibName  = libPath;
-                    fpinfo->m_padCount = m->GetPadCount();
-                    fpinfo->m_KeyWord  = m->GetKeywords();
-                    fpinfo->m_Doc      = m->GetDescription();
+        libs.push_back( &lib );
+    }
 
-                    AddItem( fpinfo );
-                }
-            }
-            catch( IO_ERROR ioe )
-            {
-                m_filesInvalid << ioe.errorText << wxT("\n");
-            }
-        }
+    // Parse the libraries the cache does not hold, each by its own plugin.  The
+    // legacy plugin tokenizes the lines with strtok_r(), its loaders only share
+    // constant data.  The plugins toggle the C locale, this one keeps it on while
+    // the threads run.
+    {
+        LOCALE_IO toggle;
+
+#pragma omp parallel for schedule( dynamic, 1 )
+        for( int ii = 0; ii < (int) toRead.size(); ++ii )
+            readLibrary( *toRead[ii] );
     }
 
-    /*  caller should catch this, UI seems not wanted here.
-    catch( IO_ERROR ioe )
+    for( unsigned ii = 0; ii < libs.size(); ++ii )
     {
-        DisplayError( NULL, ioe.errorText );
-        return false;
+        const FOOTPRINT_LIB_INFO& lib = *libs[ii];
+
+        if( !lib.m_Error.IsEmpty() )
+        {
+            m_filesInvalid << lib.m_Error << wxT("\n");
+            continue;
+        }
+
+        for( unsigned jj = 0; jj < lib.m_List.size(); ++jj )
+            AddItem( new FOOTPRINT_INFO( lib.m_List[jj] ) );
     }
-    */
+
+    if( toRead.size() )
+        writeFootprintInfoCache( cache );
 
     m_List.sort();
 
@@ -10,6 +10,7 @@
 #include <macros.h>
 #include <base_struct.h>
 #include <class_base_screen.h>
+#include <class_drawpanel.h>
 #include <bezier_curves.h>
 #include <math_for_graphics.h>
 #include <wx/graphics.h>
@@ -434,6 +435,50 @@ bool GetGRForceBlackPenState( void )
 }
 
 
+/**
+ * Function lodSizeInPixels
+ * @return the size in pixels of \a aSize logical units on the screen, or -1 if the level
+ *         of detail does not apply: there is no screen, or it is being printed.
+ */
+static int lodSizeInPixels( EDA_DRAW_PANEL* aPanel, wxDC* aDC, int aSize )
+{
+    if( aPanel == NULL || aDC == NULL )
+        return -1;
+
+    BASE_SCREEN* screen = aPanel->GetScreen();
+
+    if( screen == NULL || screen->m_IsPrinting )
+        return -1;
+
+    return std::abs( aDC->LogicalToDeviceXRel( aSize ) );
+}
+
+
+GR_LOD_T GRGetLOD( EDA_DRAW_PANEL* aPanel, wxDC* aDC, int aSize )
+{
+    int size = lodSizeInPixels( aPanel, aDC, aSize );
+
+    if( size < 0 )
+        return GR_LOD_FULL;
+
+    if( size < GR_LOD_POINT_SIZE )
+        return GR_LOD_POINT;
+
+    if( size < GR_LOD_BOX_SIZE )
+        return GR_LOD_BOX;
+
+    return GR_LOD_FULL;
+}
+
+
+bool GRIsTextDrawable( EDA_DRAW_PANEL* aPanel, wxDC* aDC, int aHeight )
+{
+    int height = lodSizeInPixels( aPanel, aDC, aHeight );
+
+    return height < 0 || height >= GR_LOD_MIN_TEXT_HEIGHT;
+}
+
+
 /*************************************/
 /* Set the device context draw mode. */
 /*************************************/
@@ -0,0 +1,226 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file parse_double.cpp
+ * @brief A locale independent decimal number parser for the file readers.
+ */
+
+#include <errno.h>
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <parse_double.h>
+
+
+/// The exact powers of ten of a double.
+static const double exactPowersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// The largest power of ten in exactPowersOf10.
+#define MAX_EXACT_POWER_OF_10   22
+
+/// The digits kept in the mantissa, which fits in 64 bits.
+#define MAX_MANTISSA_DIGITS     19
+
+/// The largest mantissa which is exactly a double.
+#define MAX_EXACT_MANTISSA      ( (unsigned long long) 1 << 53 )
+
+/// The longest number read by strtodCLocale(), in bytes.
+#define MAX_NUMBER_LENGTH       127
+
+
+static inline bool isDigit( char c )
+{
+    return c >= '0' && c <= '9';
+}
+
+
+/**
+ * Function strtodCLocale
+ * reads the number at @a aText by strtod(), with the '.' replaced by the decimal point
+ * of the current locale, so that it is read as in the "C" locale.
+ */
+static double strtodCLocale( const char* aText, const char** aEnd, bool* aOutOfRange )
+{
+    const char* point = localeconv()->decimal_point;
+    char        buf[MAX_NUMBER_LENGTH + 1];
+    int         len = 0;
+
+    // The number is copied up to any decimal point of the locale which is not a '.',
+    // it ends the number in the "C" locale.
+    for( ; aText[len] && len < MAX_NUMBER_LENGTH; ++len )
+    {
+        if( aText[len] == '.' )
+        {
+            buf[len] = point[0];
+        }
+        else if( aText[len] == point[0] )
+        {
+            break;
+        }
+        else
+        {
+            buf[len] = aText[len];
+        }
+    }
+
+    buf[len] = 0;
+
+    // A decimal point of several bytes is very unusual, strtod() reads the text as is.
+    bool        asIs = point[0] && point[1];
+    char*       end;
+    int         savedErrno = errno;
+
+    errno = 0;
+
+    double value = asIs ? strtod( aText, &end ) : strtod( buf, &end );
+
+    if( aOutOfRange )
+        *aOutOfRange = errno == ERANGE;
+
+    errno = savedErrno;
+
+    if( aEnd )
+        *aEnd = asIs ? end : aText + ( end - buf );
+
+    return value;
+}
+
+
+double ParseDouble( const char* aText, const char** aEnd, bool* aOutOfRange )
+{
+    const char* cur = aText;
+
+    // strtod() skips the white space of isspace() in the "C" locale
+    while( *cur == ' ' || ( *cur >= '\t' && *cur <= '\r' ) )
+        ++cur;
+
+    const char*         start = cur;
+    bool                negative = false;
+    unsigned long long  mantissa = 0;
+    int                 digitCount = 0;     // digits in mantissa, but the leading zeros
+    int                 exponent = 0;
+    bool                sawDigit = false;
+    bool                exact = true;       // no digit was dropped from mantissa
+
+    if( *cur == '-' || *cur == '+' )
+        negative = *cur++ == '-';
+
+    for( ; isDigit( *cur ); ++cur )
+    {
+        sawDigit = true;
+
+        if( digitCount < MAX_MANTISSA_DIGITS )
+        {
+            mantissa = mantissa * 10 + ( *cur - '0' );
+
+            if( mantissa )
+                ++digitCount;
+        }
+        else
+        {
+            exact = exact && *cur == '0';
+            ++exponent;
+        }
+    }
+
+    // a hexadecimal number, read by strtod()
+    if( ( *cur == 'x' || *cur == 'X' ) && sawDigit && cur - start <= 2 && !mantissa )
+        exact = false;
+
+    if( *cur == '.' )
+    {
+        for( ++cur; isDigit( *cur ); ++cur )
+        {
+            sawDigit = true;
+
+            if( digitCount < MAX_MANTISSA_DIGITS )
+            {
+                mantissa = mantissa * 10 + ( *cur - '0' );
+                --exponent;
+
+                if( mantissa )
+                    ++digitCount;
+            }
+            else
+            {
+                exact = exact && *cur == '0';
+            }
+        }
+    }
+
+    // no digit: no number, or an infinity or a NaN, read by strtod()
+    if( !sawDigit )
+        exact = false;
+
+    if( exact && ( *cur == 'e' || *cur == 'E' ) )
+    {
+        // the exponent is a part of the number only if it has a digit
+        const char* next = cur + 1;
+        bool        negativeExponent = false;
+        int         value = 0;
+
+        if( *next == '-' || *next == '+' )
+            negativeExponent = *next++ == '-';
+
+        if( isDigit( *next ) )
+        {
+            for( ; isDigit( *next ); ++next )
+            {
+                if( value < 10000 )
+                    value = value * 10 + ( *next - '0' );
+            }
+
+            exponent += negativeExponent ? -value : value;
+            cur = next;
+        }
+    }
+
+    if( exact && mantissa <= MAX_EXACT_MANTISSA
+     && exponent >= -MAX_EXACT_POWER_OF_10 && exponent <= MAX_EXACT_POWER_OF_10 )
+    {
+        // The mantissa and the power of ten are exact doubles, so that their product
+        // or their quotient is the correctly rounded number, as strtod() reads it.
+        double value = (double) mantissa;
+
+        if( exponent < 0 )
+            value /= exactPowersOf10[ -exponent ];
+        else
+            value *= exactPowersOf10[ exponent ];
+
+        if( aEnd )
+            *aEnd = cur;
+
+        if( aOutOfRange )
+            *aOutOfRange = false;
+
+        return negative ? -value : value;
+    }
+
+    return strtodCLocale( aText, aEnd, aOutOfRange );
+}
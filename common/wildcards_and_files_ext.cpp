@@ -46,6 +46,7 @@ const wxString GerberFileExtension( wxT( "pho" ) );
 
 const wxString LegacyPcbFileExtension( wxT( "brd" ) );
 const wxString KiCadPcbFileExtension( wxT( "kicad_pcb" ) );
+const wxString SnapshotPcbFileExtension( wxT( "kicad_snapshot" ) );
 
 const wxString PdfFileExtension( wxT( "pdf" ) );
 const wxString MacrosFileExtension( wxT( "mcr" ) );
@@ -374,7 +374,7 @@ bool BOM_LISTER::PrintComponentsListByReferenceHumanReadable( FILE* aFile )
 
         bool            isMulti = false;
 
-        LIB_COMPONENT*  entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+        LIB_COMPONENT*  entry = comp->GetLibComponent();
 
         if( entry )
             isMulti = entry->IsMulti();
@@ -514,7 +514,7 @@ bool BOM_LISTER::PrintComponentsListByReferenceCsvForm( FILE* aFile )
 
         SCH_COMPONENT*  comp = (SCH_COMPONENT*) item;
 
-        LIB_COMPONENT*  entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+        LIB_COMPONENT*  entry = comp->GetLibComponent();
 
         bool            isMulti = false;
 
@@ -686,7 +686,7 @@ int BOM_LISTER::PrintComponentsListByValue( FILE* aFile )
         SCH_COMPONENT*  drawLibItem = (SCH_COMPONENT*) schItem;
 
         bool            isMulti = false;
-        LIB_COMPONENT*  entry   = CMP_LIBRARY::FindLibraryComponent( drawLibItem->GetLibName() );
+        LIB_COMPONENT*  entry   = drawLibItem->GetLibComponent();
 
         if( entry )
             isMulti = entry->IsMulti();
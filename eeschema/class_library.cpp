@@ -108,6 +108,8 @@ CMP_LIBRARY::CMP_LIBRARY( int aType, const wxFileName& aFileName )
 
 CMP_LIBRARY::~CMP_LIBRARY()
 {
+    ++libraryGeneration;
+
     for( LIB_ALIAS_MAP::iterator it=aliases.begin();  it!=aliases.end();  it++ )
     {
         LIB_ALIAS* alias = (*it).second;
@@ -251,6 +253,7 @@ bool CMP_LIBRARY::AddAlias( LIB_ALIAS* aAlias )
 
     aliases[ aAlias->GetName() ] = aAlias;
     isModified = true;
+    ++libraryGeneration;
     return true;
 }
 
@@ -287,6 +290,7 @@ LIB_COMPONENT* CMP_LIBRARY::AddComponent( LIB_COMPONENT* aComponent )
     }
 
     isModified = true;
+    ++libraryGeneration;
 
     return newCmp;
 }
@@ -329,6 +333,7 @@ LIB_ALIAS* CMP_LIBRARY::RemoveEntry( LIB_ALIAS* aEntry )
 
     aliases.erase( it );
     isModified = true;
+    ++libraryGeneration;
 
     return alias;
 }
@@ -363,6 +368,7 @@ LIB_COMPONENT* CMP_LIBRARY::ReplaceComponent( LIB_COMPONENT* aOldComponent,
     }
 
     isModified = true;
+    ++libraryGeneration;
 
     return newCmp;
 }
@@ -557,6 +563,7 @@ void CMP_LIBRARY::LoadAliases( LIB_COMPONENT* component )
         }
 
         aliases[ component->m_aliases[i]->GetName() ] = component->m_aliases[i];
+        ++libraryGeneration;
     }
 }
 
@@ -748,6 +755,9 @@ bool CMP_LIBRARY::SaveHeader( OUTPUTFORMATTER& aFormatter )
  */
 CMP_LIBRARY_LIST CMP_LIBRARY::libraryList;
 wxArrayString CMP_LIBRARY::libraryListSortOrder;
+unsigned CMP_LIBRARY::libraryGeneration = 1;
+LIB_ALIAS_MAP CMP_LIBRARY::libraryEntryIndex;
+unsigned CMP_LIBRARY::libraryEntryIndexGeneration = 0;
 
 
 CMP_LIBRARY* CMP_LIBRARY::LoadLibrary( const wxFileName& aFileName, wxString& aErrorMsg )
@@ -787,6 +797,7 @@ bool CMP_LIBRARY::AddLibrary( const wxFileName& aFileName, wxString& aErrorMsg )
         return false;
 
     libraryList.push_back( lib );
+    ++libraryGeneration;
 
     return true;
 }
@@ -813,6 +824,8 @@ bool CMP_LIBRARY::AddLibrary( const wxFileName& aFileName, wxString& aErrorMsg,
     else
         libraryList.push_back( lib );
 
+    ++libraryGeneration;
+
     return true;
 }
 
@@ -882,23 +895,34 @@ wxArrayString CMP_LIBRARY::GetLibraryNames( bool aSorted )
 }
 
 
-LIB_COMPONENT* CMP_LIBRARY::FindLibraryComponent( const wxString& aName,
-                                                  const wxString& aLibraryName )
+const LIB_ALIAS_MAP& CMP_LIBRARY::getLibraryEntryIndex()
 {
-    LIB_COMPONENT* component = NULL;
-
-    BOOST_FOREACH( CMP_LIBRARY& lib, libraryList )
+    if( libraryEntryIndexGeneration != libraryGeneration )
     {
-        if( !aLibraryName.IsEmpty() && lib.GetName() != aLibraryName )
-            continue;
+        libraryEntryIndex.clear();
+
+        // insert() keeps the entry of the first library which has the name
+        BOOST_FOREACH( CMP_LIBRARY& lib, libraryList )
+        {
+            LIB_ALIAS_MAP::iterator it;
 
-        component = lib.FindComponent( aName );
+            for( it = lib.aliases.begin();  it != lib.aliases.end();  ++it )
+                libraryEntryIndex.insert( *it );
+        }
 
-        if( component != NULL )
-            break;
+        libraryEntryIndexGeneration = libraryGeneration;
     }
 
-    return component;
+    return libraryEntryIndex;
+}
+
+
+LIB_COMPONENT* CMP_LIBRARY::FindLibraryComponent( const wxString& aName,
+                                                  const wxString& aLibraryName )
+{
+    LIB_ALIAS* entry = FindLibraryEntry( aName, aLibraryName );
+
+    return entry ? entry->GetComponent() : NULL;
 }
 
 
@@ -906,6 +930,15 @@ LIB_ALIAS* CMP_LIBRARY::FindLibraryEntry( const wxString& aName, const wxString&
 {
     LIB_ALIAS* entry = NULL;
 
+    // The search in all the libraries is a search in their index
+    if( aLibraryName.IsEmpty() )
+    {
+        const LIB_ALIAS_MAP&            index = getLibraryEntryIndex();
+        LIB_ALIAS_MAP::const_iterator   it = index.find( aName );
+
+        return it != index.end() ? it->second : NULL;
+    }
+
     BOOST_FOREACH( CMP_LIBRARY& lib, libraryList )
     {
         if( !aLibraryName.IsEmpty() && lib.GetName() != aLibraryName )
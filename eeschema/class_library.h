@@ -102,6 +102,17 @@ class CMP_LIBRARY
 
     static CMP_LIBRARY_LIST libraryList;
     static wxArrayString    libraryListSortOrder;
+    static unsigned         libraryGeneration;      ///< Changed by any change of the libraries.
+    static LIB_ALIAS_MAP    libraryEntryIndex;      ///< The entries of all the libraries.
+    static unsigned         libraryEntryIndexGeneration;    ///< Generation of the index.
+
+    /**
+     * Function getLibraryEntryIndex
+     * returns the entries of all the libraries by name, rebuilt if the libraries changed
+     * since the last call.  A name of several libraries is the entry of the first one
+     * in the library list, as searched by FindLibraryEntry().
+     */
+    static const LIB_ALIAS_MAP& getLibraryEntryIndex();
 
     friend class LIB_COMPONENT;
 
@@ -505,6 +516,24 @@ public:
 
     static int GetLibraryCount() { return libraryList.size(); }
 
+    /**
+     * Function GetGeneration
+     * returns a number which changes whenever a library is added to, removed from or
+     * reordered in the library list, or an entry is added to or removed from a library.
+     * A LIB_COMPONENT or a LIB_ALIAS found in the libraries remains valid as long as the
+     * generation is unchanged.
+     *
+     * @return The generation of the libraries.
+     */
+    static unsigned GetGeneration() { return libraryGeneration; }
+
+    /**
+     * Function LibraryListChanged
+     * must be called after a library is added to the library list returned by
+     * GetLibraryList() or after this list is sorted.
+     */
+    static void LibraryListChanged() { ++libraryGeneration; }
+
     static CMP_LIBRARY_LIST& GetLibraryList()
     {
         return libraryList;
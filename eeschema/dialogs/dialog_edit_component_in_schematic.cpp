@@ -271,7 +271,7 @@ Do you wish to remove this and all remaining undefined fields?" ),
         ++i;
     }
 
-    LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( m_Cmp->m_ChipName );
+    LIB_COMPONENT* entry = m_Cmp->GetLibComponent();
 
     if( entry &&  entry->IsPower() )
         m_FieldsBuf[VALUE].m_Text = m_Cmp->m_ChipName;
@@ -435,7 +435,7 @@ void DIALOG_EDIT_COMPONENT_IN_SCHEMATIC::InitBuffers( SCH_COMPONENT* aComponent
         which came from the component.
     */
 
-    m_LibEntry = CMP_LIBRARY::FindLibraryComponent( m_Cmp->m_ChipName );
+    m_LibEntry = m_Cmp->GetLibComponent();
 
 #if 0 && defined(DEBUG)
     for( int i = 0;  i<aComponent->GetFieldCount();  ++i )
@@ -834,7 +834,7 @@ void DIALOG_EDIT_COMPONENT_IN_SCHEMATIC::SetInitCmp( wxCommandEvent& event )
     if( m_Cmp == NULL )
         return;
 
-    entry = CMP_LIBRARY::FindLibraryComponent( m_Cmp->m_ChipName );
+    entry = m_Cmp->GetLibComponent();
 
     if( entry == NULL )
         return;
@@ -53,7 +53,7 @@ void SCH_EDIT_FRAME::EditComponentFieldText( SCH_FIELD* aField )
     wxCHECK_RET( component != NULL && component->Type() == SCH_COMPONENT_T,
                  wxT( "Invalid schematic field parent item." ) );
 
-    LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+    LIB_COMPONENT* entry = component->GetLibComponent();
 
     wxCHECK_RET( entry != NULL, wxT( "Library entry for component <" ) +
                  component->GetLibName() + wxT( "> could not be found." ) );
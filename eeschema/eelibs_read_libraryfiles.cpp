@@ -103,6 +103,7 @@ void SCH_EDIT_FRAME::LoadLibraries( void )
     /* Put the libraries in the correct order. */
     CMP_LIBRARY::SetSortOrder( sortOrder );
     CMP_LIBRARY::GetLibraryList().sort();
+    CMP_LIBRARY::LibraryListChanged();
 
 #if 0   // #ifdef __WXDEBUG__
     wxLogDebug( wxT( "LoadLibraries() requested component library sort order:" ) );
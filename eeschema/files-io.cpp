@@ -225,6 +225,7 @@ bool SCH_EDIT_FRAME::LoadCacheLibrary( const wxString& aFilename )
 
             LibCacheExist = true;
             CMP_LIBRARY::GetLibraryList().push_back( LibCache );
+            CMP_LIBRARY::LibraryListChanged();
         }
         else
         {
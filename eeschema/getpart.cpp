@@ -340,7 +340,7 @@ void SCH_EDIT_FRAME::OnSelectUnit( wxCommandEvent& aEvent )
 
     int unit = aEvent.GetId() + 1 - ID_POPUP_SCH_SELECT_UNIT1;
 
-    LIB_COMPONENT* libEntry = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+    LIB_COMPONENT* libEntry = component->GetLibComponent();
 
     if( libEntry == NULL )
         return;
@@ -394,7 +394,7 @@ void SCH_EDIT_FRAME::ConvertPart( SCH_COMPONENT* DrawComponent, wxDC* DC )
     if( DrawComponent == NULL )
         return;
 
-    LibEntry = CMP_LIBRARY::FindLibraryComponent( DrawComponent->GetLibName() );
+    LibEntry = DrawComponent->GetLibComponent();
 
     if( LibEntry == NULL )
         return;
@@ -298,9 +298,20 @@ void LIB_FIELD::drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& a
     else
         text = m_Text;
 
+    // Keep the strokes only in the library editor: in a schematic, the components are
+    // drawn with their own fields, see SCH_FIELD::Draw().
+    TEXT_STROKES* strokes = NULL;
+
+    if( aOffset == wxPoint( 0, 0 ) && aTransform == DefaultTransform )
+    {
+        m_strokes.resize( 1 );
+        strokes = &m_strokes[0];
+    }
+
     GRSetDrawMode( aDC, aDrawMode );
     DrawGraphicText( aPanel, aDC, text_pos, (EDA_COLOR_T) color, text, m_Orient, m_Size,
-                     m_HJustify, m_VJustify, linewidth, m_Italic, m_Bold );
+                     m_HJustify, m_VJustify, linewidth, m_Italic, m_Bold,
+                     NULL, NULL, strokes );
 
     /* Set to one (1) to draw bounding box around field text to validate
      * bounding box calculation. */
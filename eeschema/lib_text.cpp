@@ -391,9 +391,20 @@ void LIB_TEXT::drawGraphic( EDA_DRAW_PANEL* aPanel, wxDC* aDC, const wxPoint& aO
     // Calculate pos accordint to mirror/rotation.
     txtpos = aTransform.TransformCoordinate( txtpos ) + aOffset;
 
+    // A library text is shared by all the components of its library part, each drawing
+    // it at its own position and orientation: its strokes are only kept when it is drawn
+    // as it is, by the library editor, else each component would replace them.
+    TEXT_STROKES* strokes = NULL;
+
+    if( aOffset == wxPoint( 0, 0 ) && aTransform == DefaultTransform )
+    {
+        m_strokes.resize( 1 );
+        strokes = &m_strokes[0];
+    }
+
     DrawGraphicText( aPanel, aDC, txtpos, (EDA_COLOR_T) color, m_Text, orient, m_Size,
                      GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER, GetPenSize(),
-                     m_Italic, m_Bold );
+                     m_Italic, m_Bold, NULL, NULL, strokes );
 
 
     /* Enable this to draw the bounding box around the text field to validate
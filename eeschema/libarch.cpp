@@ -83,7 +83,7 @@ bool SCH_EDIT_FRAME::CreateArchiveLibrary( const wxString& aFileName )
 
             if( libCache->FindEntry( component->GetLibName()) == NULL )
             {
-                libComponent = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+                libComponent = component->GetLibComponent();
 
                 if( libComponent )    // if NULL : component not found, cannot be stored
                     libCache->AddComponent( libComponent );
@@ -532,7 +532,7 @@ SCH_COMPONENT* NETLIST_EXPORT_TOOL::findNextComponent( EDA_ITEM* aItem, SCH_SHEE
         // (several sheets pointing to 1 screen), this will be erroneously be
         // toggled.
 
-        LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+        LIB_COMPONENT* entry = comp->GetLibComponent();
         if( !entry )
             continue;
 
@@ -583,7 +583,7 @@ SCH_COMPONENT* NETLIST_EXPORT_TOOL::findNextComponentAndCreatePinList( EDA_ITEM*
         // (several sheets pointing to 1 screen), this will be erroneously be
         // toggled.
 
-        LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+        LIB_COMPONENT* entry = comp->GetLibComponent();
 
         if( !entry )
             continue;
@@ -1036,7 +1036,7 @@ XNODE* NETLIST_EXPORT_TOOL::makeGenericComponents()
             // "logical" library name, which is in anticipation of a better search
             // algorithm for parts based on "logical_lib.part" and where logical_lib
             // is merely the library name minus path and extension.
-            LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+            LIB_COMPONENT* entry = comp->GetLibComponent();
             if( entry )
                 xlibsource->AddAttribute( sLib, entry->GetLibrary()->GetLogicalName() );
             xlibsource->AddAttribute( sPart, comp->GetLibName() );
@@ -1515,7 +1515,7 @@ bool NETLIST_EXPORT_TOOL::WriteNetListPCBNEW( FILE* f, bool with_pcbnew )
 
             // Get the Component FootprintFilter and put the component in
             // cmpList if filter is present
-            LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( comp->GetLibName() );
+            LIB_COMPONENT* entry = comp->GetLibComponent();
 
             if( entry )
             {
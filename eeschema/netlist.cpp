@@ -41,9 +41,12 @@
 #include <sch_no_connect.h>
 #include <sch_text.h>
 #include <sch_sheet.h>
+#include <disjoint_set.h>
 #include <algorithm>
+#include <map>
 
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
 
 
 const SCH_SHEET_PATH BOM_LABEL::emptySheetPath;
@@ -54,11 +57,161 @@ NETLIST_OBJECT_LIST g_NetObjectslist;
 
 //#define NETLIST_DEBUG
 
-static void PropageNetCode( int OldNetCode, int NewNetCode, int IsBus );
-static void SheetLabelConnect( NETLIST_OBJECT* SheetLabel );
-static void PointToPointConnect( NETLIST_OBJECT* Ref, int IsBus, int start );
-static void SegmentToPointConnect( NETLIST_OBJECT* Jonction, int IsBus, int start );
-static void LabelConnect( NETLIST_OBJECT* Label );
+
+/**
+ * Class NET_CODES
+ * holds the net codes, or the bus net codes, given to the items of g_NetObjectslist
+ * while they are connected.  An item holds the handle of the code it was given, and a
+ * connection merges the sets of handles of two items in a disjoint-set forest, instead
+ * of rewriting the code of all the items of a net.  The merged set takes the code of
+ * the item it is connected to, so that the codes are the ones the rewriting gave.
+ */
+class NET_CODES
+{
+public:
+    NET_CODES() { Reset(); }
+
+    /**
+     * Function Reset
+     * forgets all the codes.  The handle 0 is no code.
+     */
+    void Reset()
+    {
+        m_sets.Reset( 1 );
+        m_codes.assign( 1, 0 );
+    }
+
+    /**
+     * Function New
+     * @return int - the handle of a new code, which is also this code.
+     */
+    int New()
+    {
+        int handle = m_sets.Add();
+
+        m_codes.push_back( handle );
+        return handle;
+    }
+
+    /**
+     * Function Code
+     * @return int - the code of the handle \a aHandle, 0 for no code.
+     */
+    int Code( int aHandle )
+    {
+        return m_codes[ m_sets.Find( aHandle ) ];
+    }
+
+    /**
+     * Function Connect
+     * gives the code of the handle \a aTo to the item of handle \a aHandle and to all
+     * the items which have its code.  An item without a code takes the handle \a aTo.
+     *
+     * @param aHandle - the handle of the item, changed if the item has no code.
+     * @param aTo - the handle of the item it is connected to.
+     */
+    void Connect( int& aHandle, int aTo )
+    {
+        int code    = Code( aTo );
+        int oldCode = Code( aHandle );
+
+        if( oldCode == 0 )
+        {
+            aHandle = code ? aTo : 0;
+        }
+        else if( oldCode != code )
+        {
+            if( code )
+                m_sets.Union( aHandle, aTo );
+
+            // All the items which had oldCode now have code, even if it is 0
+            m_codes[ m_sets.Find( aHandle ) ] = code;
+        }
+    }
+
+private:
+    DISJOINT_SET        m_sets;     ///< the handles merged by the connections
+    std::vector<int>    m_codes;    ///< the code of each set, at the handle of its root
+};
+
+
+/**
+ * Class SHEET_CONNECTIONS
+ * indexes the items of a sheet of g_NetObjectslist by their position, to find the items
+ * which may be connected to an item without a scan of the list.
+ */
+class SHEET_CONNECTIONS
+{
+public:
+    /**
+     * Function Build
+     * indexes the items \a aStart to \a aEnd - 1 of g_NetObjectslist: all the items by
+     * their start and end points, and the wires and buses by the line they are on.
+     */
+    void Build( unsigned aStart, unsigned aEnd );
+
+    /**
+     * Function ItemsAt
+     * appends to \a aItems the index of the items which start or end at \a aPoint.
+     */
+    void ItemsAt( const wxPoint& aPoint, std::vector<unsigned>& aItems ) const;
+
+    /**
+     * Function SegmentsThrough
+     * appends to \a aItems the index of the wires and buses which may pass through
+     * \a aPoint, to be tested by SegmentIntersect().
+     */
+    void SegmentsThrough( const wxPoint& aPoint, std::vector<unsigned>& aItems ) const;
+
+private:
+    typedef boost::unordered_map< unsigned long long, std::vector<unsigned> > POINT_ITEMS;
+    typedef boost::unordered_map< int, std::vector<unsigned> > LINE_ITEMS;
+
+    static unsigned long long pointKey( const wxPoint& aPoint )
+    {
+        return ( (unsigned long long) (unsigned) aPoint.x << 32 ) | (unsigned) aPoint.y;
+    }
+
+    POINT_ITEMS             m_ends;     ///< the items by their start and end points
+    LINE_ITEMS              m_rows;     ///< the horizontal segments by their y
+    LINE_ITEMS              m_columns;  ///< the vertical segments by their x
+    std::vector<unsigned>   m_slanted;  ///< the other segments
+};
+
+
+/// Case insensitive order of the label names, as they are compared to connect labels.
+struct LABEL_NAME_LESS
+{
+    bool operator()( const wxString& aFirst, const wxString& aSecond ) const
+    {
+        return aFirst.CmpNoCase( aSecond ) < 0;
+    }
+};
+
+/**
+ * Struct LABEL_GROUP
+ * is the labels of a sheet which have the same name and the same type.  LabelConnect()
+ * and SheetLabelConnect() connect either all of them to a label, or none of them, so
+ * that once connected they are in the same net for good.
+ */
+struct LABEL_GROUP
+{
+    const SCH_SHEET_PATH*           m_Sheet;    ///< the sheet of the labels
+    NETLIST_ITEM_T                  m_Type;     ///< the type of the labels
+    bool                            m_SameNet;  ///< true once the labels are in the same net
+    std::vector<NETLIST_OBJECT*>    m_Labels;   ///< the labels, in list order
+};
+
+/// The labels of g_NetObjectslist which may be connected by their name, by name.
+typedef std::map< wxString, std::vector<LABEL_GROUP>, LABEL_NAME_LESS > LABEL_INDEX;
+
+
+static void SheetLabelConnect( NETLIST_OBJECT* SheetLabel, LABEL_INDEX& aLabels );
+static void PointToPointConnect( NETLIST_OBJECT* Ref, int IsBus, int start,
+                                 const SHEET_CONNECTIONS& aConnections );
+static void SegmentToPointConnect( NETLIST_OBJECT* Jonction, int IsBus, int start,
+                                   const SHEET_CONNECTIONS& aConnections );
+static void LabelConnect( NETLIST_OBJECT* Label, LABEL_INDEX& aLabels );
 static void ConnectBusLabels( NETLIST_OBJECT_LIST& aNetItemBuffer );
 static void SetUnconnectedFlag( NETLIST_OBJECT_LIST& aNetItemBuffer );
 
@@ -69,8 +222,95 @@ static NETLIST_OBJECT* FindBestNetName( NETLIST_OBJECT_LIST& aLabelItemBuffer );
 static bool SortItemsbyNetcode( const NETLIST_OBJECT* Objet1, const NETLIST_OBJECT* Objet2 );
 static bool SortItemsBySheet( const NETLIST_OBJECT* Objet1, const NETLIST_OBJECT* Objet2 );
 
-// Local variables
-static int LastNetCode, LastBusNetCode;
+// Local variables: the codes given while the net list is built
+static NET_CODES netCodes, busNetCodes;
+
+
+/// @return the net code of \a aItem while the net list is built.
+static int netCode( NETLIST_OBJECT* aItem )
+{
+    return netCodes.Code( aItem->GetNet() );
+}
+
+
+/// @return the bus net code of \a aItem while the net list is built.
+static int busNetCode( NETLIST_OBJECT* aItem )
+{
+    return busNetCodes.Code( aItem->m_BusNetCode );
+}
+
+
+/**
+ * Function connectNet
+ * gives the net code of \a aTo to \a aItem and to all the items of the net of
+ * \a aItem, or only to \a aItem if it has no net code yet.
+ */
+static void connectNet( NETLIST_OBJECT* aItem, NETLIST_OBJECT* aTo )
+{
+    int handle = aItem->GetNet();
+
+    netCodes.Connect( handle, aTo->GetNet() );
+    aItem->SetNet( handle );
+}
+
+
+/**
+ * Function addLabel
+ * adds \a aLabel to the group of its sheet and type in \a aLabels.
+ */
+static void addLabel( LABEL_INDEX& aLabels, NETLIST_OBJECT* aLabel )
+{
+    std::vector<LABEL_GROUP>& groups = aLabels[ aLabel->m_Label ];
+
+    // The labels are sorted by sheet: their group is most likely one of the last ones
+    for( unsigned ii = groups.size(); ii-- > 0; )
+    {
+        if( groups[ii].m_Type == aLabel->m_Type && *groups[ii].m_Sheet == aLabel->m_SheetList )
+        {
+            groups[ii].m_Labels.push_back( aLabel );
+            return;
+        }
+    }
+
+    LABEL_GROUP group;
+
+    group.m_Sheet   = &aLabel->m_SheetList;
+    group.m_Type    = aLabel->m_Type;
+    group.m_SameNet = false;
+    group.m_Labels.push_back( aLabel );
+    groups.push_back( group );
+}
+
+
+/**
+ * Function connectLabels
+ * connects all the labels of \a aGroup to \a aLabel, which has a net code.  Once they
+ * are in the same net, the first one stands for all of them.
+ */
+static void connectLabels( LABEL_GROUP& aGroup, NETLIST_OBJECT* aLabel )
+{
+    if( aGroup.m_SameNet )
+    {
+        connectNet( aGroup.m_Labels[0], aLabel );
+        return;
+    }
+
+    for( unsigned ii = 0; ii < aGroup.m_Labels.size(); ii++ )
+        connectNet( aGroup.m_Labels[ii], aLabel );
+
+    aGroup.m_SameNet = true;
+}
+
+
+/**
+ * Function connectBus
+ * gives the bus net code of \a aTo to \a aItem and to all the items of the bus of
+ * \a aItem, or only to \a aItem if it has no bus net code yet.
+ */
+static void connectBus( NETLIST_OBJECT* aItem, NETLIST_OBJECT* aTo )
+{
+    busNetCodes.Connect( aItem->m_BusNetCode, aTo->m_BusNetCode );
+}
 
 
 #if defined(DEBUG)
@@ -107,6 +347,61 @@ static void FreeNetObjectsList( NETLIST_OBJECT_LIST& aNetObjectsBuffer )
 }
 
 
+void SHEET_CONNECTIONS::Build( unsigned aStart, unsigned aEnd )
+{
+    m_ends.clear();
+    m_rows.clear();
+    m_columns.clear();
+    m_slanted.clear();
+
+    for( unsigned ii = aStart; ii < aEnd; ii++ )
+    {
+        NETLIST_OBJECT* item = g_NetObjectslist[ii];
+
+        m_ends[ pointKey( item->m_Start ) ].push_back( ii );
+
+        if( item->m_End != item->m_Start )
+            m_ends[ pointKey( item->m_End ) ].push_back( ii );
+
+        if( item->m_Type != NET_SEGMENT && item->m_Type != NET_BUS )
+            continue;
+
+        if( item->m_Start.y == item->m_End.y )
+            m_rows[ item->m_Start.y ].push_back( ii );
+        else if( item->m_Start.x == item->m_End.x )
+            m_columns[ item->m_Start.x ].push_back( ii );
+        else
+            m_slanted.push_back( ii );
+    }
+}
+
+
+void SHEET_CONNECTIONS::ItemsAt( const wxPoint& aPoint, std::vector<unsigned>& aItems ) const
+{
+    POINT_ITEMS::const_iterator it = m_ends.find( pointKey( aPoint ) );
+
+    if( it != m_ends.end() )
+        aItems.insert( aItems.end(), it->second.begin(), it->second.end() );
+}
+
+
+void SHEET_CONNECTIONS::SegmentsThrough( const wxPoint& aPoint,
+                                         std::vector<unsigned>& aItems ) const
+{
+    LINE_ITEMS::const_iterator it = m_rows.find( aPoint.y );
+
+    if( it != m_rows.end() )
+        aItems.insert( aItems.end(), it->second.begin(), it->second.end() );
+
+    it = m_columns.find( aPoint.x );
+
+    if( it != m_columns.end() )
+        aItems.insert( aItems.end(), it->second.begin(), it->second.end() );
+
+    aItems.insert( aItems.end(), m_slanted.begin(), m_slanted.end() );
+}
+
+
 /*
  * Build net list connection table.
  *
@@ -115,7 +410,7 @@ static void FreeNetObjectsList( NETLIST_OBJECT_LIST& aNetObjectsBuffer )
  */
 void SCH_EDIT_FRAME::BuildNetListBase()
 {
-    int             NetCode;
+    int             NetCode, LastNetCode;
     SCH_SHEET_PATH* sheet;
     wxString        msg, activity;
     wxBusyCursor    Busy;
@@ -151,9 +446,12 @@ void SCH_EDIT_FRAME::BuildNetListBase()
     SetStatusText( activity );
 
     sheet = &(g_NetObjectslist[0]->m_SheetList);
-    LastNetCode = LastBusNetCode = 1;
+    netCodes.Reset();
+    busNetCodes.Reset();
 
-    for( unsigned ii = 0, istart = 0; ii < g_NetObjectslist.size(); ii++ )
+    SHEET_CONNECTIONS connections;
+
+    for( unsigned ii = 0, istart = 0, iend = 0; ii < g_NetObjectslist.size(); ii++ )
     {
         NETLIST_OBJECT* net_item = g_NetObjectslist[ii];
 
@@ -163,6 +461,16 @@ void SCH_EDIT_FRAME::BuildNetListBase()
             istart = ii;
         }
 
+        /* Index the items of the sheet, the next ones in the list sorted by sheet. */
+        if( ii == iend )
+        {
+            while( iend < g_NetObjectslist.size()
+                && g_NetObjectslist[iend]->m_SheetList.Cmp( *sheet ) == 0 )
+                iend++;
+
+            connections.Build( ii, iend );
+        }
+
         switch( net_item->m_Type )
         {
         case NET_ITEM_UNSPECIFIED:
@@ -173,79 +481,61 @@ void SCH_EDIT_FRAME::BuildNetListBase()
         case NET_PINLABEL:
         case NET_SHEETLABEL:
         case NET_NOCONNECT:
-            if( net_item->GetNet() != 0 )
+            if( netCode( net_item ) != 0 )
                 break;
 
         case NET_SEGMENT:
             /* Control connections point to point type without bus.  */
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( LastNetCode );
-                LastNetCode++;
-            }
+            if( netCode( net_item ) == 0 )
+                net_item->SetNet( netCodes.New() );
 
-            PointToPointConnect( net_item, 0, istart );
+            PointToPointConnect( net_item, 0, istart, connections );
             break;
 
         case NET_JUNCTION:
             /* Control of the junction outside BUS. */
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( LastNetCode );
-                LastNetCode++;
-            }
+            if( netCode( net_item ) == 0 )
+                net_item->SetNet( netCodes.New() );
 
-            SegmentToPointConnect( net_item, 0, istart );
+            SegmentToPointConnect( net_item, 0, istart, connections );
 
             /* Control of the junction, on BUS. */
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = LastBusNetCode;
-                LastBusNetCode++;
-            }
+            if( busNetCode( net_item ) == 0 )
+                net_item->m_BusNetCode = busNetCodes.New();
 
-            SegmentToPointConnect( net_item, ISBUS, istart );
+            SegmentToPointConnect( net_item, ISBUS, istart, connections );
             break;
 
         case NET_LABEL:
         case NET_HIERLABEL:
         case NET_GLOBLABEL:
             /* Control connections type junction without bus. */
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->SetNet( LastNetCode );
-                LastNetCode++;
-            }
+            if( netCode( net_item ) == 0 )
+                net_item->SetNet( netCodes.New() );
 
-            SegmentToPointConnect( net_item, 0, istart );
+            SegmentToPointConnect( net_item, 0, istart, connections );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
-            if( net_item->m_BusNetCode != 0 )
+            if( busNetCode( net_item ) != 0 )
                 break;
 
         case NET_BUS:
             /* Control type connections point to point mode bus */
-            if( net_item->m_BusNetCode == 0 )
-            {
-                net_item->m_BusNetCode = LastBusNetCode;
-                LastBusNetCode++;
-            }
+            if( busNetCode( net_item ) == 0 )
+                net_item->m_BusNetCode = busNetCodes.New();
 
-            PointToPointConnect( net_item, ISBUS, istart );
+            PointToPointConnect( net_item, ISBUS, istart, connections );
             break;
 
         case NET_BUSLABELMEMBER:
         case NET_HIERBUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
             /* Control connections similar has on BUS */
-            if( net_item->GetNet() == 0 )
-            {
-                net_item->m_BusNetCode = LastBusNetCode;
-                LastBusNetCode++;
-            }
+            if( netCode( net_item ) == 0 )
+                net_item->m_BusNetCode = busNetCodes.New();
 
-            SegmentToPointConnect( net_item, ISBUS, istart );
+            SegmentToPointConnect( net_item, ISBUS, istart, connections );
             break;
         }
     }
@@ -264,6 +554,28 @@ void SCH_EDIT_FRAME::BuildNetListBase()
     activity << wxT( ",  " ) << _( "bus labels" ) << wxT( "..." );
     SetStatusText( activity );
 
+    /* Index the labels by name, sheet and type. */
+    LABEL_INDEX labels;
+
+    for( unsigned ii = 0; ii < g_NetObjectslist.size(); ii++ )
+    {
+        switch( g_NetObjectslist[ii]->m_Type )
+        {
+        case NET_LABEL:
+        case NET_GLOBLABEL:
+        case NET_HIERLABEL:
+        case NET_BUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_PINLABEL:
+            addLabel( labels, g_NetObjectslist[ii] );
+            break;
+
+        default:
+            break;
+        }
+    }
+
     /* Group objects by label. */
     for( unsigned ii = 0; ii < g_NetObjectslist.size(); ii++ )
     {
@@ -282,7 +594,7 @@ void SCH_EDIT_FRAME::BuildNetListBase()
         case NET_PINLABEL:
         case NET_BUSLABELMEMBER:
         case NET_GLOBBUSLABELMEMBER:
-            LabelConnect( g_NetObjectslist[ii] );
+            LabelConnect( g_NetObjectslist[ii], labels );
             break;
 
         case NET_SHEETBUSLABELMEMBER:
@@ -311,7 +623,16 @@ void SCH_EDIT_FRAME::BuildNetListBase()
     {
         if( g_NetObjectslist[ii]->m_Type == NET_SHEETLABEL
             || g_NetObjectslist[ii]->m_Type == NET_SHEETBUSLABELMEMBER )
-            SheetLabelConnect( g_NetObjectslist[ii] );
+            SheetLabelConnect( g_NetObjectslist[ii], labels );
+    }
+
+    /* Give to each item the code of its net, instead of the handle of its code. */
+    for( unsigned ii = 0; ii < g_NetObjectslist.size(); ii++ )
+    {
+        NETLIST_OBJECT* item = g_NetObjectslist[ii];
+
+        item->SetNet( netCode( item ) );
+        item->m_BusNetCode = busNetCode( item );
     }
 
     /* Sort objects by NetCode */
@@ -520,36 +841,29 @@ static NETLIST_OBJECT* FindBestNetName( NETLIST_OBJECT_LIST& aLabelItemBuffer )
 /*
  * Connect sheets by sheetLabels
  */
-static void SheetLabelConnect( NETLIST_OBJECT* SheetLabel )
+static void SheetLabelConnect( NETLIST_OBJECT* SheetLabel, LABEL_INDEX& aLabels )
 {
-    if( SheetLabel->GetNet() == 0 )
+    if( netCode( SheetLabel ) == 0 )
         return;
 
-    /* Calculate the number of nodes in the corresponding sheetlabel */
-
     /* Comparison with SheetLabel GLABELS sub sheet to group Netcode */
+    LABEL_INDEX::iterator sameName = aLabels.find( SheetLabel->m_Label );
 
-    for( unsigned ii = 0; ii < g_NetObjectslist.size(); ii++ )
-    {
-        NETLIST_OBJECT* ObjetNet = g_NetObjectslist[ii];
+    if( sameName == aLabels.end() )
+        return;
 
-        if( ObjetNet->m_SheetList != SheetLabel->m_SheetListInclude )
+    std::vector<LABEL_GROUP>& groups = sameName->second;
+
+    for( unsigned ii = 0; ii < groups.size(); ii++ )
+    {
+        if( *groups[ii].m_Sheet != SheetLabel->m_SheetListInclude )
             continue;  //use SheetInclude, not the sheet!!
 
-        if( (ObjetNet->m_Type != NET_HIERLABEL ) && (ObjetNet->m_Type != NET_HIERBUSLABELMEMBER ) )
+        if( (groups[ii].m_Type != NET_HIERLABEL ) && (groups[ii].m_Type != NET_HIERBUSLABELMEMBER ) )
             continue;
 
-        if( ObjetNet->GetNet() == SheetLabel->GetNet() )
-            continue;  //already connected.
-
-        if( ObjetNet->m_Label.CmpNoCase( SheetLabel->m_Label ) != 0 )
-            continue;  //different names.
-
         /* Propagate Netcode having all the objects of the same Netcode. */
-        if( ObjetNet->GetNet() )
-            PropageNetCode( ObjetNet->GetNet(), SheetLabel->GetNet(), 0 );
-        else
-            ObjetNet->SetNet( SheetLabel->GetNet() );
+        connectLabels( groups[ii], SheetLabel );
     }
 }
 
@@ -559,10 +873,15 @@ static void SheetLabelConnect( NETLIST_OBJECT* SheetLabel )
  * Propagate Netcode between the corresponding labels (ie when
  * Their member number is the same) when they are connected
  * Generally by their BusNetCode
- * Uses and updates the variable LastNetCode
+ * Uses and updates the net codes
  */
 static void ConnectBusLabels( NETLIST_OBJECT_LIST& aNetItemBuffer )
 {
+    // The labels of each bus member, by bus net code and member number, in list order
+    typedef std::map< std::pair<int, int>, std::vector<NETLIST_OBJECT*> > BUS_MEMBERS;
+
+    BUS_MEMBERS members;
+
     for( unsigned ii = 0; ii < aNetItemBuffer.size(); ii++ )
     {
         NETLIST_OBJECT* Label = aNetItemBuffer[ii];
@@ -571,69 +890,33 @@ static void ConnectBusLabels( NETLIST_OBJECT_LIST& aNetItemBuffer )
           || (Label->m_Type == NET_BUSLABELMEMBER)
           || (Label->m_Type == NET_HIERBUSLABELMEMBER) )
         {
-            if( Label->GetNet() == 0 )
-            {
-                Label->SetNet( LastNetCode );
-                LastNetCode++;
-            }
-
-            for( unsigned jj = ii + 1; jj < aNetItemBuffer.size(); jj++ )
-            {
-                NETLIST_OBJECT* LabelInTst = aNetItemBuffer[jj];
-                if( (LabelInTst->m_Type == NET_SHEETBUSLABELMEMBER)
-                   || (LabelInTst->m_Type == NET_BUSLABELMEMBER)
-                   || (LabelInTst->m_Type == NET_HIERBUSLABELMEMBER) )
-                {
-                    if( LabelInTst->m_BusNetCode != Label->m_BusNetCode )
-                        continue;
-
-                    if( LabelInTst->m_Member != Label->m_Member )
-                        continue;
+            std::pair<int, int> member( busNetCode( Label ), Label->m_Member );
 
-                    if( LabelInTst->GetNet() == 0 )
-                        LabelInTst->SetNet( Label->GetNet() );
-                    else
-                        PropageNetCode( LabelInTst->GetNet(), Label->GetNet(), 0 );
-                }
-            }
+            members[member].push_back( Label );
         }
     }
-}
-
 
-/*
- * PropageNetCode propagates Netcode NewNetCode on all elements
- * belonging to the former Netcode OldNetCode
- * If IsBus == 0; Netcode is the member who is spreading
- * If IsBus != 0; is the member who is spreading BusNetCode
- */
-static void PropageNetCode( int OldNetCode, int NewNetCode, int IsBus )
-{
-    if( OldNetCode == NewNetCode )
-        return;
-
-    if( IsBus == 0 )    /* Propagate NetCode */
+    // The labels of a member are connected to the first one, the next ones have
+    // its net code when their turn comes.
+    for( unsigned ii = 0; ii < aNetItemBuffer.size(); ii++ )
     {
-        for( unsigned jj = 0; jj < g_NetObjectslist.size(); jj++ )
-        {
-            NETLIST_OBJECT* Objet = g_NetObjectslist[jj];
+        NETLIST_OBJECT* Label = aNetItemBuffer[ii];
 
-            if( Objet->GetNet() == OldNetCode )
-            {
-                Objet->SetNet( NewNetCode );
-            }
-        }
-    }
-    else               /* Propagate BusNetCode */
-    {
-        for( unsigned jj = 0; jj < g_NetObjectslist.size(); jj++ )
+        if(  (Label->m_Type == NET_SHEETBUSLABELMEMBER)
+          || (Label->m_Type == NET_BUSLABELMEMBER)
+          || (Label->m_Type == NET_HIERBUSLABELMEMBER) )
         {
-            NETLIST_OBJECT* Objet = g_NetObjectslist[jj];
+            if( netCode( Label ) == 0 )
+                Label->SetNet( netCodes.New() );
 
-            if( Objet->m_BusNetCode == OldNetCode )
-            {
-                Objet->m_BusNetCode = NewNetCode;
-            }
+            std::pair<int, int>             member( busNetCode( Label ), Label->m_Member );
+            std::vector<NETLIST_OBJECT*>&   sameMember = members[member];
+
+            if( sameMember[0] != Label )
+                continue;
+
+            for( unsigned jj = 1; jj < sameMember.size(); jj++ )
+                connectNet( sameMember[jj], Label );
         }
     }
 }
@@ -657,97 +940,62 @@ static void PropageNetCode( int OldNetCode, int NewNetCode, int IsBus )
  * And research is done from the start element, 1st element
  * Leaf schema
  * (There can be no physical connection between elements of different sheets)
+ * The elements are found by aConnections, the index of the sheet of Ref
  */
-static void PointToPointConnect( NETLIST_OBJECT* Ref, int IsBus, int start )
+static void PointToPointConnect( NETLIST_OBJECT* Ref, int IsBus, int start,
+                                 const SHEET_CONNECTIONS& aConnections )
 {
-    int netCode;
+    std::vector<unsigned> candidates;
 
-    if( IsBus == 0 )    /* Objects other than BUS and BUSLABELS. */
-    {
-        netCode = Ref->GetNet();
+    aConnections.ItemsAt( Ref->m_Start, candidates );
 
-        for( unsigned i = start; i < g_NetObjectslist.size(); i++ )
-        {
-            NETLIST_OBJECT* item = g_NetObjectslist[i];
+    if( Ref->m_End != Ref->m_Start )
+        aConnections.ItemsAt( Ref->m_End, candidates );
 
-            if( item->m_SheetList != Ref->m_SheetList )  //used to be > (why?)
-                continue;
+    for( unsigned ii = 0; ii < candidates.size(); ii++ )
+    {
+        if( candidates[ii] < (unsigned) start )
+            continue;
 
-            switch( item->m_Type )
-            {
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_JUNCTION:
-            case NET_NOCONNECT:
-                if( Ref->m_Start == item->m_Start
-                    || Ref->m_Start == item->m_End
-                    || Ref->m_End   == item->m_Start
-                    || Ref->m_End   == item->m_End )
-                {
-                    if( item->GetNet() == 0 )
-                        item->SetNet( netCode );
-                    else
-                        PropageNetCode( item->GetNet(), netCode, 0 );
-                }
-                break;
+        NETLIST_OBJECT* item = g_NetObjectslist[ candidates[ii] ];
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_ITEM_UNSPECIFIED:
-                break;
-            }
-        }
-    }
-    else    /* Object type BUS, BUSLABELS, and junctions. */
-    {
-        netCode = Ref->m_BusNetCode;
+        if( item->m_SheetList != Ref->m_SheetList )  //used to be > (why?)
+            continue;
 
-        for( unsigned i = start; i<g_NetObjectslist.size(); i++ )
+        switch( item->m_Type )
         {
-            NETLIST_OBJECT* item = g_NetObjectslist[i];
+        case NET_SEGMENT:
+        case NET_PIN:
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+        case NET_SHEETLABEL:
+        case NET_PINLABEL:
+        case NET_NOCONNECT:
+            /* Objects other than BUS and BUSLABELS. */
+            if( IsBus == 0 )
+                connectNet( item, Ref );
+            break;
 
-            if( item->m_SheetList != Ref->m_SheetList )
-                continue;
+        case NET_JUNCTION:
+            if( IsBus == 0 )
+                connectNet( item, Ref );
+            else
+                connectBus( item, Ref );
+            break;
 
-            switch( item->m_Type )
-            {
-            case NET_ITEM_UNSPECIFIED:
-            case NET_SEGMENT:
-            case NET_PIN:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_NOCONNECT:
-                break;
+        case NET_BUS:
+        case NET_BUSLABELMEMBER:
+        case NET_SHEETBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+            /* Object type BUS, BUSLABELS, and junctions. */
+            if( IsBus != 0 )
+                connectBus( item, Ref );
+            break;
 
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                if(  Ref->m_Start == item->m_Start
-                  || Ref->m_Start == item->m_End
-                  || Ref->m_End   == item->m_Start
-                  || Ref->m_End   == item->m_End )
-                {
-                    if( item->m_BusNetCode == 0 )
-                        item->m_BusNetCode = netCode;
-                    else
-                        PropageNetCode( item->m_BusNetCode, netCode, 1 );
-                }
-                break;
-            }
+        case NET_ITEM_UNSPECIFIED:
+            break;
         }
     }
 }
@@ -758,13 +1006,22 @@ static void PointToPointConnect( NETLIST_OBJECT* Ref, int IsBus, int start )
  * to objects connected by the junction.
  * The junction must have a valid Netcode
  * The list of objects is expected sorted by sheets.
- * Search is done from index aIdxStart to the last element of g_NetObjectslist
+ * Search is done from index aIdxStart to the last element of the sheet, in the
+ * index aConnections of the sheet
  */
-static void SegmentToPointConnect( NETLIST_OBJECT* aJonction, int aIsBus, int aIdxStart )
+static void SegmentToPointConnect( NETLIST_OBJECT* aJonction, int aIsBus, int aIdxStart,
+                                   const SHEET_CONNECTIONS& aConnections )
 {
-    for( unsigned i = aIdxStart; i < g_NetObjectslist.size(); i++ )
+    std::vector<unsigned> candidates;
+
+    aConnections.SegmentsThrough( aJonction->m_Start, candidates );
+
+    for( unsigned ii = 0; ii < candidates.size(); ii++ )
     {
-        NETLIST_OBJECT* Segment = g_NetObjectslist[i];
+        if( candidates[ii] < (unsigned) aIdxStart )
+            continue;
+
+        NETLIST_OBJECT* Segment = g_NetObjectslist[ candidates[ii] ];
 
         // if different sheets, no physical connection between elements is possible.
         if( Segment->m_SheetList != aJonction->m_SheetList )
@@ -785,19 +1042,9 @@ static void SegmentToPointConnect( NETLIST_OBJECT* aJonction, int aIsBus, int aI
         {
             /* Propagation Netcode has all the objects of the same Netcode. */
             if( aIsBus == 0 )
-            {
-                if( Segment->GetNet() )
-                    PropageNetCode( Segment->GetNet(), aJonction->GetNet(), aIsBus );
-                else
-                    Segment->SetNet( aJonction->GetNet() );
-            }
+                connectNet( Segment, aJonction );
             else
-            {
-                if( Segment->m_BusNetCode )
-                    PropageNetCode( Segment->m_BusNetCode, aJonction->m_BusNetCode, aIsBus );
-                else
-                    Segment->m_BusNetCode = aJonction->m_BusNetCode;
-            }
+                connectBus( Segment, aJonction );
         }
     }
 }
@@ -806,26 +1053,33 @@ static void SegmentToPointConnect( NETLIST_OBJECT* aJonction, int aIsBus, int aI
 /*****************************************************************
  * Function which connects the groups of object which have the same label
  *******************************************************************/
-void LabelConnect( NETLIST_OBJECT* LabelRef )
+void LabelConnect( NETLIST_OBJECT* LabelRef, LABEL_INDEX& aLabels )
 {
-    if( LabelRef->GetNet() == 0 )
+    if( netCode( LabelRef ) == 0 )
         return;
 
-    for( unsigned i = 0; i < g_NetObjectslist.size(); i++ )
+    // the labels of any type which may be connected, with the same name
+    LABEL_INDEX::iterator sameName = aLabels.find( LabelRef->m_Label );
+
+    if( sameName == aLabels.end() )
+        return;
+
+    std::vector<LABEL_GROUP>& groups = sameName->second;
+
+    for( unsigned i = 0; i < groups.size(); i++ )
     {
-        if( g_NetObjectslist[i]->GetNet() == LabelRef->GetNet() )
-            continue;
+        NETLIST_ITEM_T ntype = groups[i].m_Type;
 
-        if( g_NetObjectslist[i]->m_SheetList != LabelRef->m_SheetList )
+        if( *groups[i].m_Sheet != LabelRef->m_SheetList )
         {
-            if( (g_NetObjectslist[i]->m_Type != NET_PINLABEL
-                 && g_NetObjectslist[i]->m_Type != NET_GLOBLABEL
-                 && g_NetObjectslist[i]->m_Type != NET_GLOBBUSLABELMEMBER) )
+            if( (ntype != NET_PINLABEL
+                 && ntype != NET_GLOBLABEL
+                 && ntype != NET_GLOBBUSLABELMEMBER) )
                 continue;
 
-            if( (g_NetObjectslist[i]->m_Type == NET_GLOBLABEL
-                 || g_NetObjectslist[i]->m_Type == NET_GLOBBUSLABELMEMBER)
-               && g_NetObjectslist[i]->m_Type != LabelRef->m_Type )
+            if( (ntype == NET_GLOBLABEL
+                 || ntype == NET_GLOBBUSLABELMEMBER)
+               && ntype != LabelRef->m_Type )
                 //global labels only connect other global labels.
                 continue;
         }
@@ -835,24 +1089,7 @@ void LabelConnect( NETLIST_OBJECT* LabelRef )
         // NET_LABEL is sheet-local (***)
         // NET_GLOBLABEL is global.
         // NET_PINLABEL is a kind of global label (generated by a power pin invisible)
-        NETLIST_ITEM_T ntype = g_NetObjectslist[i]->m_Type;
-
-        if(  ntype == NET_LABEL
-          || ntype == NET_GLOBLABEL
-          || ntype == NET_HIERLABEL
-          || ntype == NET_BUSLABELMEMBER
-          || ntype == NET_GLOBBUSLABELMEMBER
-          || ntype == NET_HIERBUSLABELMEMBER
-          || ntype == NET_PINLABEL )
-        {
-            if( g_NetObjectslist[i]->m_Label.CmpNoCase( LabelRef->m_Label ) != 0 )
-                continue;
-
-            if( g_NetObjectslist[i]->GetNet() )
-                PropageNetCode( g_NetObjectslist[i]->GetNet(), LabelRef->GetNet(), 0 );
-            else
-                g_NetObjectslist[i]->SetNet( LabelRef->GetNet() );
-        }
+        connectLabels( groups[i], LabelRef );
     }
 }
 
@@ -881,86 +1118,75 @@ bool SortItemsBySheet( const NETLIST_OBJECT* Objet1, const NETLIST_OBJECT* Objet
 static void SetUnconnectedFlag( NETLIST_OBJECT_LIST& aNetItemBuffer )
 {
     NETLIST_OBJECT* NetItemRef;
-    unsigned NetStart, NetEnd;
+    unsigned NetStart;
     NET_CONNECTION_T StateFlag;
+    bool PinPresent;
+
+    NetStart   = 0;
+    StateFlag  = UNCONNECTED;
+    PinPresent = false;
 
-    NetStart  = NetEnd = 0;
-    StateFlag = UNCONNECTED;
     for( unsigned ii = 0; ii < aNetItemBuffer.size(); ii++ )
     {
         NetItemRef = aNetItemBuffer[ii];
-        if( NetItemRef->m_Type == NET_NOCONNECT && StateFlag != PAD_CONNECT )
-            StateFlag = NOCONNECT_SYMBOL_PRESENT;
-
-        /* Analysis of current net. */
-        unsigned idxtoTest = ii + 1;
 
-        if( ( idxtoTest >= aNetItemBuffer.size() )
-           || ( NetItemRef->GetNet() != aNetItemBuffer[idxtoTest]->GetNet() ) )
-        {
-            /* Net analysis to update m_FlagOfConnection */
-            NetEnd = idxtoTest;
-
-            /* set m_FlagOfConnection member to StateFlag for all items of
-             * this net: */
-            for( unsigned kk = NetStart; kk < NetEnd; kk++ )
-                aNetItemBuffer[kk]->m_FlagOfConnection = StateFlag;
-
-            if( idxtoTest >= aNetItemBuffer.size() )
-                return;
-
-            /* Start Analysis next Net */
-            StateFlag = UNCONNECTED;
-            NetStart  = idxtoTest;
-            continue;
-        }
-
-        /* test the current item: if this is a pin and if the reference item
-         * is also a pin, then 2 pins are connected, so set StateFlag to
-         * PAD_CONNECT (can be already done)  Of course, if the current
+        /* test the current item: if this is a pin and if an other item of
+         * the net is also a pin, then 2 pins are connected, so set StateFlag
+         * to PAD_CONNECT (can be already done)  Of course, if the current
          * item is a no connect symbol, set StateFlag to
          * NOCONNECT_SYMBOL_PRESENT to inhibit error diags. However if
          * StateFlag is already set to PAD_CONNECT this state is kept (the
          * no connect symbol was surely an error and an ERC will report this)
          */
-        for( ; ; idxtoTest++ )
+        switch( NetItemRef->m_Type )
         {
-            if( ( idxtoTest >= aNetItemBuffer.size() )
-               || ( NetItemRef->GetNet() != aNetItemBuffer[idxtoTest]->GetNet() ) )
-                break;
+        case NET_ITEM_UNSPECIFIED:
+            wxMessageBox( wxT( "BuildNetListBase() error" ) );
+            break;
 
-            switch( aNetItemBuffer[idxtoTest]->m_Type )
-            {
-            case NET_ITEM_UNSPECIFIED:
-                wxMessageBox( wxT( "BuildNetListBase() error" ) );
-                break;
+        case NET_SEGMENT:
+        case NET_LABEL:
+        case NET_HIERLABEL:
+        case NET_GLOBLABEL:
+        case NET_SHEETLABEL:
+        case NET_PINLABEL:
+        case NET_BUS:
+        case NET_BUSLABELMEMBER:
+        case NET_SHEETBUSLABELMEMBER:
+        case NET_HIERBUSLABELMEMBER:
+        case NET_GLOBBUSLABELMEMBER:
+        case NET_JUNCTION:
+            break;
 
-            case NET_SEGMENT:
-            case NET_LABEL:
-            case NET_HIERLABEL:
-            case NET_GLOBLABEL:
-            case NET_SHEETLABEL:
-            case NET_PINLABEL:
-            case NET_BUS:
-            case NET_BUSLABELMEMBER:
-            case NET_SHEETBUSLABELMEMBER:
-            case NET_HIERBUSLABELMEMBER:
-            case NET_GLOBBUSLABELMEMBER:
-            case NET_JUNCTION:
-                break;
+        case NET_PIN:
+            if( PinPresent )
+                StateFlag = PAD_CONNECT;
 
-            case NET_PIN:
-                if( NetItemRef->m_Type == NET_PIN )
-                    StateFlag = PAD_CONNECT;
+            PinPresent = true;
+            break;
 
-                break;
+        case NET_NOCONNECT:
+            if( StateFlag != PAD_CONNECT )
+                StateFlag = NOCONNECT_SYMBOL_PRESENT;
 
-            case NET_NOCONNECT:
-                if( StateFlag != PAD_CONNECT )
-                    StateFlag = NOCONNECT_SYMBOL_PRESENT;
+            break;
+        }
 
-                break;
-            }
+        /* Analysis of current net. */
+        unsigned idxtoTest = ii + 1;
+
+        if( ( idxtoTest >= aNetItemBuffer.size() )
+           || ( NetItemRef->GetNet() != aNetItemBuffer[idxtoTest]->GetNet() ) )
+        {
+            /* set m_FlagOfConnection member to StateFlag for all items of
+             * this net: */
+            for( unsigned kk = NetStart; kk < idxtoTest; kk++ )
+                aNetItemBuffer[kk]->m_FlagOfConnection = StateFlag;
+
+            /* Start Analysis next Net */
+            StateFlag  = UNCONNECTED;
+            PinPresent = false;
+            NetStart   = idxtoTest;
         }
     }
 }
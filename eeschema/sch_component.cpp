@@ -195,6 +195,8 @@ SCH_COMPONENT::SCH_COMPONENT( const SCH_COMPONENT& aComponent ) :
     m_prefix = aComponent.m_prefix;
     m_PathsAndReferences = aComponent.m_PathsAndReferences;
     m_Fields = aComponent.m_Fields;
+    m_libComponent = NULL;
+    m_libGeneration = 0;
 
     // Re-parent the fields, which before this had aComponent as parent
     for( int i = 0; i<GetFieldCount(); ++i )
@@ -213,6 +215,9 @@ void SCH_COMPONENT::Init( const wxPoint& pos )
     // The rotation/mirror transformation matrix. pos normal
     m_transform = TRANSFORM();
 
+    m_libComponent  = NULL;
+    m_libGeneration = 0;    // no library generation
+
     // construct only the mandatory fields, which are the first 4 only.
     for( int i = 0; i < MANDATORY_FIELDS; ++i )
     {
@@ -249,6 +254,19 @@ void SCH_COMPONENT::SetLibName( const wxString& aName )
 }
 
 
+LIB_COMPONENT* SCH_COMPONENT::GetLibComponent() const
+{
+    if( m_libGeneration != CMP_LIBRARY::GetGeneration() || m_libComponentName != m_ChipName )
+    {
+        m_libComponent     = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+        m_libComponentName = m_ChipName;
+        m_libGeneration    = CMP_LIBRARY::GetGeneration();
+    }
+
+    return m_libComponent;
+}
+
+
 void SCH_COMPONENT::SetUnit( int aUnit )
 {
     if( m_unit != aUnit )
@@ -281,7 +299,7 @@ void SCH_COMPONENT::SetTransform( const TRANSFORM& aTransform )
 
 int SCH_COMPONENT::GetPartCount() const
 {
-    LIB_COMPONENT* Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* Entry = GetLibComponent();
 
     if( Entry == NULL )
         return 0;
@@ -296,7 +314,7 @@ void SCH_COMPONENT::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, const wxPoint& offset
 {
     bool           dummy = false;
 
-    LIB_COMPONENT* Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* Entry = GetLibComponent();
 
     if( Entry == NULL )
     {
@@ -637,7 +655,7 @@ SCH_FIELD* SCH_COMPONENT::FindField( const wxString& aFieldName )
 
 LIB_PIN* SCH_COMPONENT::GetPin( const wxString& number )
 {
-    LIB_COMPONENT* Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* Entry = GetLibComponent();
 
     if( Entry == NULL )
         return NULL;
@@ -687,7 +705,7 @@ void SCH_COMPONENT::ClearAnnotation( SCH_SHEET_PATH* aSheetPath )
     static const wxString separators( wxT( " " ) );
     wxArrayString  reference_fields;
 
-    Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    Entry = GetLibComponent();
 
     if( Entry && Entry->UnitsLocked() )
         keepMulti = true;
@@ -1408,7 +1426,7 @@ bool SCH_COMPONENT::Load( LINE_READER& aLine, wxString& aErrorMsg )
 
 EDA_RECT SCH_COMPONENT::GetBodyBoundingBox() const
 {
-    LIB_COMPONENT* Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* Entry = GetLibComponent();
     EDA_RECT       bBox;
     int            x0, xm, y0, ym;
 
@@ -1470,7 +1488,7 @@ void SCH_COMPONENT::GetMsgPanelInfo( MSG_PANEL_ITEMS& aList )
     // search for the component in lib
     // Entry and root_component can differ if Entry is an alias
     LIB_ALIAS* alias = CMP_LIBRARY::FindLibraryEntry( m_ChipName );
-    LIB_COMPONENT* root_component = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* root_component = GetLibComponent();
 
     if( (alias == NULL) || (root_component == NULL) )
         return;
@@ -1572,7 +1590,7 @@ bool SCH_COMPONENT::Matches( wxFindReplaceData& aSearchData, void* aAuxData,
 
 void SCH_COMPONENT::GetEndPoints( std::vector <DANGLING_END_ITEM>& aItemList )
 {
-    LIB_COMPONENT* Entry = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* Entry = GetLibComponent();
 
     if( Entry == NULL )
         return;
@@ -1620,7 +1638,7 @@ bool SCH_COMPONENT::IsSelectStateChanged( const wxRect& aRect )
 void SCH_COMPONENT::GetConnectionPoints( vector< wxPoint >& aPoints ) const
 {
     LIB_PIN* pin;
-    LIB_COMPONENT* component = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* component = GetLibComponent();
 
     wxCHECK_RET( component != NULL,
                  wxT( "Cannot add connection points to list.  Cannot find component <" ) +
@@ -1646,7 +1664,7 @@ void SCH_COMPONENT::GetConnectionPoints( vector< wxPoint >& aPoints ) const
 
 LIB_ITEM* SCH_COMPONENT::GetDrawItem( const wxPoint& aPosition, KICAD_T aType )
 {
-    LIB_COMPONENT* component = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+    LIB_COMPONENT* component = GetLibComponent();
 
     if( component == NULL )
         return NULL;
@@ -1710,7 +1728,7 @@ SEARCH_RESULT SCH_COMPONENT::Visit( INSPECTOR* aInspector, const void* aTestData
 
 
             case LIB_PIN_T:
-                component = CMP_LIBRARY::FindLibraryComponent( m_ChipName );
+                component = GetLibComponent();
 
                 if( component != NULL )
                 {
@@ -1736,7 +1754,7 @@ SEARCH_RESULT SCH_COMPONENT::Visit( INSPECTOR* aInspector, const void* aTestData
 void SCH_COMPONENT::GetNetListItem( vector<NETLIST_OBJECT*>& aNetListItems,
                                     SCH_SHEET_PATH*          aSheetPath )
 {
-    LIB_COMPONENT* component = CMP_LIBRARY::FindLibraryComponent( GetLibName() );
+    LIB_COMPONENT* component = GetLibComponent();
 
     if( component == NULL )
         return;
@@ -1907,7 +1925,7 @@ void SCH_COMPONENT::Plot( PLOTTER* aPlotter )
     LIB_COMPONENT* Entry;
     TRANSFORM temp = TRANSFORM();
 
-    Entry = CMP_LIBRARY::FindLibraryComponent( GetLibName() );
+    Entry = GetLibComponent();
 
     if( Entry == NULL )
         return;
@@ -83,6 +83,10 @@ class SCH_COMPONENT : public SCH_ITEM
      */
     wxArrayString m_PathsAndReferences;
 
+    mutable LIB_COMPONENT* m_libComponent;      ///< The library component last found.
+    mutable wxString       m_libComponentName;  ///< The name m_libComponent was found for.
+    mutable unsigned       m_libGeneration;     ///< The library generation it was found in.
+
     void Init( const wxPoint& pos = wxPoint( 0, 0 ) );
 
     EDA_RECT GetBodyBoundingBox() const;
@@ -128,6 +132,15 @@ public:
 
     void SetLibName( const wxString& aName );
 
+    /**
+     * Function GetLibComponent
+     * returns the library component of this component.  It is searched in the libraries
+     * again only if its name or the libraries changed since the last call.
+     *
+     * @return LIB_COMPONENT* - the library component, or NULL if it is not found.
+     */
+    LIB_COMPONENT* GetLibComponent() const;
+
     int GetUnit() const { return m_unit; }
 
     void SetUnit( int aUnit );
@@ -194,9 +194,11 @@ void SCH_FIELD::Draw( EDA_DRAW_PANEL* panel, wxDC* DC,
             color = ReturnLayerColor( LAYER_FIELDS );
     }
 
+    m_strokes.resize( 1 );
+
     DrawGraphicText( panel, DC, textpos, color, GetText(), orient, m_Size,
                      GR_TEXT_HJUSTIFY_CENTER, GR_TEXT_VJUSTIFY_CENTER,
-                     LineWidth, m_Italic, m_Bold );
+                     LineWidth, m_Italic, m_Bold, NULL, NULL, &m_strokes[0] );
 
     /* Enable this to draw the bounding box around the text field to validate
      * the bounding box calculations.
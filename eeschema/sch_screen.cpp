@@ -624,7 +624,7 @@ LIB_PIN* SCH_SCREEN::GetPin( const wxPoint& aPosition, SCH_COMPONENT** aComponen
         if( aEndPointOnly )
         {
             pin = NULL;
-            LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+            LIB_COMPONENT* entry = component->GetLibComponent();
 
             if( entry == NULL )
                 continue;
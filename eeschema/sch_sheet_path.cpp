@@ -255,7 +255,7 @@ void SCH_SHEET_PATH::AnnotatePowerSymbols( int* aReference )
                 continue;
 
         SCH_COMPONENT* component = (SCH_COMPONENT*) item;
-        LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+        LIB_COMPONENT* entry = component->GetLibComponent();
 
         if( ( entry == NULL ) || !entry->IsPower() )
             continue;
@@ -303,7 +303,7 @@ void SCH_SHEET_PATH::GetComponents( SCH_REFERENCE_LIST& aReferences, bool aInclu
             if( !aIncludePowerSymbols && component->GetRef( this )[0] == wxT( '#' ) )
                 continue;
 
-            LIB_COMPONENT* entry = CMP_LIBRARY::FindLibraryComponent( component->GetLibName() );
+            LIB_COMPONENT* entry = component->GetLibComponent();
 
             if( entry == NULL )
                 continue;
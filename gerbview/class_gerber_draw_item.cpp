@@ -413,6 +413,35 @@ void GERBER_DRAW_ITEM::Draw( EDA_DRAW_PANEL* aPanel, wxDC* aDC, GR_DRAWMODE aDra
     case GBR_SPOT_POLY:
     case GBR_SPOT_MACRO:
         isFilled = gerbFrame->DisplayFlashedItemsSolidMode();
+
+        // When zoomed out, a flash is drawn as a point or as its box.  The size of a
+        // macro is not known, nor can a negative flash be simplified without erasing
+        // what is around it.
+        if( isDark && d_codeDescr->m_Shape != APT_MACRO )
+        {
+            GR_LOD_T lod = GRGetLOD( aPanel, aDC, std::max( m_Size.x, m_Size.y ) );
+
+            if( lod == GR_LOD_POINT )
+            {
+                wxPoint pos = GetABPosition( m_Start );
+                GRPutPixel( aPanel->GetClipBox(), aDC, pos.x, pos.y, color );
+                break;
+            }
+
+            if( lod == GR_LOD_BOX )
+            {
+                EDA_RECT bbox = GetBoundingBox();
+
+                if( isFilled )
+                    GRFilledRect( aPanel->GetClipBox(), aDC, bbox.GetX(), bbox.GetY(),
+                                  bbox.GetRight(), bbox.GetBottom(), color, color );
+                else
+                    GRRect( aPanel->GetClipBox(), aDC, bbox.GetX(), bbox.GetY(),
+                            bbox.GetRight(), bbox.GetBottom(), color );
+                break;
+            }
+        }
+
         d_codeDescr->DrawFlashedShape( this, aPanel->GetClipBox(), aDC, color, alt_color,
                                        m_Start, isFilled );
         break;
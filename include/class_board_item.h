@@ -36,9 +36,14 @@
 #include <boost/ptr_container/ptr_vector.hpp>
 
 
-/// Abbrevation for fomatting internal units to a string.
-#define FMT_IU     BOARD_ITEM::FormatInternalUnits
-#define FMT_ANGLE  BOARD_ITEM::FormatAngle
+/// Abbrevation for fomatting internal units to a string, for the "%s" of a
+/// OUTPUTFORMATTER::Print(): FMT_IU( value ).c_str()
+#define FMT_IU     FORMATTED_IU
+#define FMT_ANGLE  FORMATTED_ANGLE
+
+/// The size of a buffer for BOARD_ITEM::FormatInternalUnits( char*, int ) or
+/// BOARD_ITEM::FormatAngle( char*, double ), with the terminating null.
+#define FMT_IU_BUFSIZE  32
 
 class BOARD;
 class EDA_DRAW_PANEL;
@@ -234,6 +239,17 @@ public:
      */
     static std::string FormatInternalUnits( int aValue );
 
+    /**
+     * Function FormatInternalUnits
+     * converts \a aValue as FormatInternalUnits( int ) does, into \a aBuffer, without
+     * any memory allocation.
+     *
+     * @param aBuffer is where to put the null terminated string, FMT_IU_BUFSIZE chars.
+     * @param aValue A coordinate value to convert.
+     * @return int - the length of the string.
+     */
+    static int FormatInternalUnits( char* aBuffer, int aValue );
+
     /**
      * Function FormatAngle
      * converts \a aAngle from board units to a string appropriate for writing to file.
@@ -245,9 +261,78 @@ public:
      */
     static std::string FormatAngle( double aAngle );
 
+    /**
+     * Function FormatAngle
+     * converts \a aAngle as FormatAngle( double ) does, into \a aBuffer, without any
+     * memory allocation.
+     *
+     * @param aBuffer is where to put the null terminated string, FMT_IU_BUFSIZE chars.
+     * @param aAngle A angle value to convert.
+     * @return int - the length of the string.
+     */
+    static int FormatAngle( char* aBuffer, double aAngle );
+
     static std::string FormatInternalUnits( const wxPoint& aPoint );
 
     static std::string FormatInternalUnits( const wxSize& aSize );
 };
 
+
+/**
+ * Class FORMATTED_IU
+ * is a value in internal units formatted by BOARD_ITEM::FormatInternalUnits() into
+ * a buffer of its own, so that the numbers of a board are written to a file without
+ * a std::string each.  It is meant to be a temporary, used through FMT_IU.
+ */
+class FORMATTED_IU
+{
+    char    m_text[2 * FMT_IU_BUFSIZE];
+
+public:
+    explicit FORMATTED_IU( int aValue )
+    {
+        BOARD_ITEM::FormatInternalUnits( m_text, aValue );
+    }
+
+    explicit FORMATTED_IU( const wxPoint& aPoint )
+    {
+        formatPair( aPoint.x, aPoint.y );
+    }
+
+    explicit FORMATTED_IU( const wxSize& aSize )
+    {
+        formatPair( aSize.GetWidth(), aSize.GetHeight() );
+    }
+
+    const char* c_str() const   { return m_text; }
+
+private:
+    void formatPair( int aFirst, int aSecond )
+    {
+        int len = BOARD_ITEM::FormatInternalUnits( m_text, aFirst );
+
+        m_text[len++] = ' ';
+        BOARD_ITEM::FormatInternalUnits( m_text + len, aSecond );
+    }
+};
+
+
+/**
+ * Class FORMATTED_ANGLE
+ * is an angle formatted by BOARD_ITEM::FormatAngle() into a buffer of its own, used
+ * through FMT_ANGLE.
+ */
+class FORMATTED_ANGLE
+{
+    char    m_text[FMT_IU_BUFSIZE];
+
+public:
+    explicit FORMATTED_ANGLE( double aAngle )
+    {
+        BOARD_ITEM::FormatAngle( m_text, aAngle );
+    }
+
+    const char* c_str() const   { return m_text; }
+};
+
 #endif /* BOARD_ITEM_STRUCT_H */
@@ -504,19 +504,22 @@ void SetLocaleTo_Default();
  * is a class that can be instantiated within a scope in which you are expecting
  * exceptions to be thrown.  Its constructor calls SetLocaleTo_C_Standard().
  * Its destructor insures that the default locale is restored if an exception
- * is thrown, or not.
+ * is thrown, or not.  The threads reading files at the same time share the nesting
+ * count, which is updated in a critical section.
  */
 class LOCALE_IO
 {
 public:
     LOCALE_IO()
     {
+#pragma omp critical (LOCALE_IO)
         if( C_count++ == 0 )
             SetLocaleTo_C_standard();
     }
 
     ~LOCALE_IO()
     {
+#pragma omp critical (LOCALE_IO)
         if( --C_count == 0 )
             SetLocaleTo_Default();
     }
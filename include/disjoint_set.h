@@ -0,0 +1,145 @@
+/**
+ * @file disjoint_set.h
+ * @brief a disjoint-set forest, to find the clusters of items connected together.
+ */
+
+#ifndef DISJOINT_SET_H_
+#define DISJOINT_SET_H_
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <vector>
+
+
+/**
+ * Class DISJOINT_SET
+ * partitions the integers 0 to GetCount() - 1 into sets, a union-find
+ * structure with path compression and union by rank.
+ * <p>
+ * Items are given an index by the user, each one starts in a set of its own,
+ * and Union() is called for each pair of items known to be connected.  Find()
+ * then returns the same representative for all the items of a cluster, in
+ * almost constant time, whatever the order the connections were given in.
+ * </p>
+ */
+class DISJOINT_SET
+{
+public:
+    DISJOINT_SET( int aCount = 0 )
+    {
+        Reset( aCount );
+    }
+
+    /**
+     * Function Reset
+     * puts each of \a aCount items in a set of its own.
+     */
+    void Reset( int aCount )
+    {
+        m_parent.resize( aCount );
+        m_rank.assign( aCount, 0 );
+
+        for( int ii = 0; ii < aCount; ++ii )
+            m_parent[ii] = ii;
+    }
+
+    /**
+     * Function Add
+     * adds an item in a set of its own.
+     * @return int - the index of the new item, the former GetCount().
+     */
+    int Add()
+    {
+        int item = (int) m_parent.size();
+
+        m_parent.push_back( item );
+        m_rank.push_back( 0 );
+
+        return item;
+    }
+
+    /**
+     * Function GetCount
+     * @return int - the number of items.
+     */
+    int GetCount() const { return (int) m_parent.size(); }
+
+    /**
+     * Function Find
+     * @return int - the representative of the set of \a aItem.  It changes
+     *  when sets are merged, do not keep it across calls to Union().
+     */
+    int Find( int aItem )
+    {
+        int root = aItem;
+
+        while( m_parent[root] != root )
+            root = m_parent[root];
+
+        // path compression: make the whole path point to the root
+        while( m_parent[aItem] != root )
+        {
+            int next = m_parent[aItem];
+            m_parent[aItem] = root;
+            aItem = next;
+        }
+
+        return root;
+    }
+
+    /**
+     * Function Union
+     * merges the sets of \a aFirst and \a aSecond.
+     * @return bool - true if they were in different sets.
+     */
+    bool Union( int aFirst, int aSecond )
+    {
+        int first  = Find( aFirst );
+        int second = Find( aSecond );
+
+        if( first == second )
+            return false;
+
+        // attach the shallower tree under the deeper one
+        if( m_rank[first] < m_rank[second] )
+        {
+            m_parent[first] = second;
+        }
+        else
+        {
+            m_parent[second] = first;
+
+            if( m_rank[first] == m_rank[second] )
+                m_rank[first]++;
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<int>            m_parent;   ///< parent item, the root is its own parent
+    std::vector<unsigned char>  m_rank;     ///< upper bound of the tree depth, for roots
+};
+
+#endif  // DISJOINT_SET_H_
@@ -68,6 +68,8 @@ int NegableTextLength( const wxString& aText );
  *                  used to draw 3D texts or for plotting, NULL for normal drawings
  *  @param aPlotter = a pointer to a PLOTTER instance, when this function is used to plot
  *                  the text. NULL to draw this text.
+ *  @param aStrokes = the strokes of this text the last time it was drawn, reused if
+ *                  nothing changed since, else rebuilt.  NULL if the text has no cache.
  */
 void DrawGraphicText( EDA_DRAW_PANEL * aPanel,
                       wxDC * aDC,
@@ -82,7 +84,8 @@ void DrawGraphicText( EDA_DRAW_PANEL * aPanel,
                       bool aItalic,
                       bool aBold,
                       void (*aCallback)( int x0, int y0, int xf, int yf ) = NULL,
-                      PLOTTER * aPlotter = NULL );
+                      PLOTTER * aPlotter = NULL,
+                      TEXT_STROKES* aStrokes = NULL );
 
 
 #endif /* __INCLUDE__DRAWTXT_H__ */
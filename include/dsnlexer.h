@@ -41,6 +41,22 @@ struct KEYWORD
     const char* name;       ///< unique keyword.
     int         token;      ///< a zero based index into an array of KEYWORDs
 };
+
+
+/**
+ * Struct KEYWORD_HASH
+ * is a perfect hash of a KEYWORD table, generated with the table by
+ * TokenList2DsnLexer.cmake.  Each keyword has a slot of its own, found from
+ * the characters of a token in any case, with no allocation.
+ * See DSNLEXER::findToken() and TokenList2DsnLexer.cmake for the hash.
+ */
+struct KEYWORD_HASH
+{
+    const int*  displacements;  ///< the displacement of the slots of each bucket
+    unsigned    bucketCount;
+    const int*  slots;          ///< the token of each slot, or -1 if none
+    unsigned    slotCount;      ///< a prime number
+};
 #endif
 
 // something like this macro can be used to help initialize a KEYWORD table.
@@ -110,6 +126,7 @@ protected:
 
     const KEYWORD*      keywords;
     unsigned            keywordCount;
+    const KEYWORD_HASH* keywordHash;    ///< perfect hash of keywords, or NULL
 
     void init();
 
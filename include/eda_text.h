@@ -35,6 +35,8 @@
 #include <gr_basic.h>               // EDA_DRAW_MODE_T
 #include <base_struct.h>            // EDA_RECT
 
+#include <vector>
+
 
 // Graphic Text justify:
 // Values -1,0,1 are used in computations, do not change them
@@ -64,6 +66,44 @@ enum EDA_DRAW_MODE_T {
 #define TEXT_NO_VISIBLE   1     //< EDA_TEXT::m_Attribut(e?) visibility flag.
 
 
+/**
+ * Class TEXT_STROKES
+ * holds the strokes of one line of text as DrawGraphicText() draws them: polylines in
+ * drawing coordinates, once justified, slanted, overbarred and rotated, with the
+ * parameters they were computed for.  Given to DrawGraphicText(), they are reused as
+ * long as these parameters do not change, so that redrawing an unchanged text does not
+ * decode and transform its glyphs again.
+ */
+class TEXT_STROKES
+{
+public:
+    bool                    m_Valid;        ///< false until computed once
+    wxPoint                 m_Pos;
+    wxString                m_Text;
+    int                     m_Orient;
+    wxSize                  m_Size;
+    EDA_TEXT_HJUSTIFY_T     m_HJustify;
+    EDA_TEXT_VJUSTIFY_T     m_VJustify;
+    int                     m_Width;        ///< pen size actually used
+    bool                    m_Italic;
+
+    int                     m_TextWidth;    ///< ReturnGraphicTextWidth() of m_Text
+    std::vector<wxPoint>    m_Points;       ///< the points of all the polylines
+    std::vector<unsigned>   m_PolylineEnds; ///< end of each polyline in m_Points
+
+    TEXT_STROKES() : m_Valid( false ) {}
+
+    /**
+     * Function IsFor
+     * @return bool - true if the strokes were computed for these parameters of
+     *                DrawGraphicText().
+     */
+    bool IsFor( const wxPoint& aPos, const wxString& aText, int aOrient, const wxSize& aSize,
+                EDA_TEXT_HJUSTIFY_T aH_justify, EDA_TEXT_VJUSTIFY_T aV_justify,
+                int aWidth, bool aItalic ) const;
+};
+
+
 /**
  * Class EDA_TEXT
  * is a basic class to handle texts (labels, texts on components or footprints
@@ -90,6 +130,10 @@ public:
                                          * Single line is faster in
                                          * calculations than multiline */
 
+protected:
+    /// The strokes of each line the last time it was drawn, see TEXT_STROKES.
+    mutable std::vector<TEXT_STROKES> m_strokes;
+
 public:
     EDA_TEXT( const wxString& text = wxEmptyString );
     EDA_TEXT( const EDA_TEXT& aText );
@@ -183,12 +227,13 @@ private:
      * @param aAnchor_color = anchor color ( UNSPECIFIED_COLOR = do not draw anchor ).
      * @param aText = the single line of text to draw.
      * @param aPos = the position of this line ).
+     * @param aStrokes = the strokes of this line, kept from a draw to the next.
      */
     void DrawOneLineOfText( EDA_DRAW_PANEL* aPanel, wxDC* aDC,
                             const wxPoint& aOffset, EDA_COLOR_T aColor,
                             GR_DRAWMODE aDrawMode, EDA_DRAW_MODE_T aFillMode,
                             EDA_COLOR_T aAnchor_color, wxString& aText,
-                            wxPoint aPos );
+                            wxPoint aPos, TEXT_STROKES* aStrokes );
 
 public:
 
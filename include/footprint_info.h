@@ -100,6 +100,9 @@ public:
      *   ...... other data (pads, outlines ..)
      *   $Endmodule
      *
+     * The footprint infos are cached in a file, by library path and modification time:
+     * only the libraries modified since they were cached are read again, in parallel.
+     *
      * @param aFootprintsLibNames = an array string giving the list of libraries to load
      */
     bool ReadFootprintFiles( wxArrayString & aFootprintsLibNames );
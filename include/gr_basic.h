@@ -119,6 +119,49 @@ void GRForceBlackPen( bool flagforce );
  */
 bool GetGRForceBlackPenState( void );
 
+
+/**
+ * Level of detail of an item drawn on screen, from its size in pixels, see GRGetLOD().
+ * Printing and exporting draw everything with full details.
+ */
+enum GR_LOD_T {
+    GR_LOD_POINT,       ///< about a pixel: drawn as a point, without any detail
+    GR_LOD_BOX,         ///< a few pixels: a complex shape is drawn as its box, without details
+    GR_LOD_FULL         ///< drawn with all its details
+};
+
+/// Items smaller than this on screen, in pixels, are drawn as a point.
+#define GR_LOD_POINT_SIZE       2
+
+/// Complex shapes smaller than this on screen, in pixels, are drawn as a box.
+#define GR_LOD_BOX_SIZE         8
+
+/// Texts less high than this on screen, in pixels, are not drawn.
+#define GR_LOD_MIN_TEXT_HEIGHT  3
+
+/**
+ * Function GRGetLOD
+ * returns how much detail an item needs when drawn in \a aDC.  This is the level of
+ * detail policy of every editor drawing with gr_basic: board, footprint and gerber items
+ * use it to skip what cannot be seen when the view is zoomed out.
+ * @param aPanel is the panel where the item is drawn, or NULL.
+ * @param aDC is the device context where the item is drawn, or NULL.
+ * @param aSize is the size of the item, its largest dimension, in logical units.
+ * @return GR_LOD_T - GR_LOD_FULL when printing, or without any panel or device context.
+ */
+GR_LOD_T GRGetLOD( EDA_DRAW_PANEL* aPanel, wxDC* aDC, int aSize );
+
+/**
+ * Function GRIsTextDrawable
+ * tells if a text of height \a aHeight is high enough to be drawn in \a aDC, as
+ * GRGetLOD() tells it for shapes.
+ * @param aPanel is the panel where the text is drawn, or NULL.
+ * @param aDC is the device context where the text is drawn, or NULL.
+ * @param aHeight is the height of the text in logical units.
+ * @return bool - false if the text is too small to be read on screen.
+ */
+bool GRIsTextDrawable( EDA_DRAW_PANEL* aPanel, wxDC* aDC, int aHeight );
+
 void GRLine( EDA_RECT* aClipBox, wxDC* aDC, wxPoint aStart, wxPoint aEnd, int aWidth, EDA_COLOR_T aColor );
 void GRLine( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int x2, int y2, int width, EDA_COLOR_T Color );
 void GRMixedLine( EDA_RECT* ClipBox, wxDC* DC, int x1, int y1, int x2, int y2,
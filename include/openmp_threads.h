@@ -0,0 +1,64 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file openmp_threads.h
+ * @brief the OpenMP threads, or the calling thread only if built without OpenMP.
+ */
+
+#ifndef OPENMP_THREADS_H_
+#define OPENMP_THREADS_H_
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+
+/**
+ * Function OpenMPThreadCount
+ * @return int - the number of threads of a parallel region, 1 without OpenMP.
+ */
+inline int OpenMPThreadCount()
+{
+#ifdef USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+/**
+ * Function OpenMPThreadNum
+ * @return int - the number of the calling thread, from 0 to OpenMPThreadCount() - 1.
+ */
+inline int OpenMPThreadNum()
+{
+#ifdef USE_OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+#endif  // OPENMP_THREADS_H_
@@ -0,0 +1,125 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file parallel_loader.h
+ * @brief loading the parts of a file in the OpenMP threads.
+ */
+
+#ifndef PARALLEL_LOADER_H_
+#define PARALLEL_LOADER_H_
+
+#include <algorithm>
+#include <vector>
+
+#include <openmp_threads.h>
+
+
+/**
+ * Class PARALLEL_LOADER
+ * loads the parts of a file, read but not yet parsed, with one loader per thread,
+ * then adds them in the order of the file.  No exception leaves a thread: a part
+ * which cannot be loaded by a thread is loaded again by the first loader, on the
+ * calling thread, to throw its error as if the file was loaded by one thread.
+ *
+ * A derived class makes the loaders and loads, adds and deletes a PART.
+ */
+template <class PART>
+class PARALLEL_LOADER
+{
+public:
+    virtual ~PARALLEL_LOADER() {}
+
+    /**
+     * Function Load
+     * loads all of @a aParts, and adds them with addPart() in their order.
+     *
+     * @param aParts are the parts to load, cleared after loading.
+     * @param aChunk is the number of parts a thread takes at a time.
+     * @throw the error of the first part which cannot be loaded.  The parts before
+     *  it are added, the ones after it are deleted.
+     */
+    void Load( std::vector<PART>& aParts, int aChunk )
+    {
+        int                 threadCount = std::min( OpenMPThreadCount(), (int) aParts.size() );
+        std::vector<char>   loaded( aParts.size(), false );
+
+        makeLoaders( threadCount );
+
+#pragma omp parallel for num_threads( threadCount ) schedule( dynamic, aChunk )
+        for( int ii = 0; ii < (int) aParts.size(); ++ii )
+        {
+            try
+            {
+                loadPart( aParts[ii], OpenMPThreadNum() );
+                loaded[ii] = true;
+            }
+            catch( ... )
+            {
+                // the part is loaded again below
+            }
+        }
+
+        for( unsigned ii = 0; ii < aParts.size(); ++ii )
+        {
+            if( !loaded[ii] )
+            {
+                try
+                {
+                    loadPart( aParts[ii], 0 );
+                }
+                catch( ... )
+                {
+                    for( unsigned jj = ii + 1; jj < aParts.size(); ++jj )
+                        deletePart( aParts[jj] );
+
+                    aParts.clear();
+                    throw;
+                }
+            }
+
+            addPart( aParts[ii] );
+        }
+
+        aParts.clear();
+    }
+
+protected:
+    /// makes the loaders of @a aCount threads
+    virtual void makeLoaders( int aCount ) = 0;
+
+    /**
+     * Function loadPart
+     * loads @a aPart with the loader @a aLoader.
+     * @throw anything if the part cannot be loaded, which then has nothing to delete.
+     */
+    virtual void loadPart( PART& aPart, int aLoader ) = 0;
+
+    /// adds what is loaded of @a aPart to the board
+    virtual void addPart( PART& aPart ) = 0;
+
+    /// deletes what is loaded of @a aPart, if it is loaded, instead of adding it
+    virtual void deletePart( PART& aPart ) = 0;
+};
+
+#endif  // PARALLEL_LOADER_H_
@@ -0,0 +1,55 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file parse_double.h
+ * @brief A locale independent decimal number parser for the file readers.
+ */
+
+#ifndef PARSE_DOUBLE_H_
+#define PARSE_DOUBLE_H_
+
+
+/**
+ * Function ParseDouble
+ * reads a decimal floating point number as strtod() does in the "C" locale, whatever
+ * the current locale is, and without setting errno.
+ * <p>
+ * The numbers written by KiCad, with up to 15 significant digits and no exponent,
+ * or a small one, are read without calling strtod() and without any allocation,
+ * to the same double as strtod().  Any other number, e.g. with many digits, a large
+ * exponent, in hexadecimal or an infinity, is read by strtod(), with the decimal
+ * point of the current locale.
+ * </p>
+ *
+ * @param aText is the text of the number, with possible leading whitespace.
+ * @param aEnd may be NULL, but if not, then it tells where to put a pointer to the
+ *  next unconsumed input text, @a aText if there is no number.
+ * @param aOutOfRange may be NULL, but if not, it is set to true if the number is too
+ *  large or too small for a double, as strtod() would set errno to ERANGE, else false.
+ * @return double - the number, 0.0 if there is none.
+ */
+double ParseDouble( const char* aText, const char** aEnd = 0, bool* aOutOfRange = 0 );
+
+
+#endif  // PARSE_DOUBLE_H_
@@ -350,6 +350,72 @@ public:
 };
 
 
+/**
+ * Class MMAP_LINE_READER
+ * is a LINE_READER that maps a whole file into memory, and returns its
+ * lines in place instead of copying them into a line buffer one byte at a
+ * time.
+ * <p>
+ * The file is mapped private and writable: the byte after the returned line
+ * is replaced by a nul, and put back by the next ReadLine().  The caller may
+ * modify the line, as it may modify the line buffer of the other
+ * LINE_READERs, the file is not changed.  Only a last line which is not
+ * followed by a byte is copied, to the line buffer.  Where the file cannot be
+ * mapped, it is read whole into memory, in binary mode.
+ * </p><p>
+ * A line ending with "\r\n" is returned ending with a '\n', as a FILE_LINE_READER
+ * returns it on Windows, on all the platforms.
+ * </p>
+ */
+class MMAP_LINE_READER : public LINE_READER
+{
+protected:
+    char*       m_data;         ///< the contents of the file
+    size_t      m_size;         ///< no. bytes in m_data
+    size_t      m_ndx;          ///< offset of the next line in m_data
+    size_t      m_lineNdx;      ///< offset of the last line read in m_data
+    char*       m_saved;        ///< the byte replaced by the nul ending the line, or NULL
+    char        m_savedChar;    ///< its value
+    bool        m_mapped;       ///< m_data is mapped, else it is m_contents
+    std::string m_contents;     ///< the file contents, when it cannot be mapped
+    char*       m_buffer;       ///< the line buffer of LINE_READER, line may point into m_data
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * maps @a aFileName into memory, or reads it.
+     *
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum allowed length of a line.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened.
+     */
+    MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX ) throw( IO_ERROR );
+
+    ~MMAP_LINE_READER();
+
+    char* ReadLine() throw( IO_ERROR );   // see LINE_READER::ReadLine() description
+
+    /**
+     * Function Offset
+     * returns the offset in the file of the byte after the last line read, so that
+     * the caller can note where the lines of a section begin and end.  It counts
+     * the '\r' of the "\r\n" line endings, which ReadLine() does not return.
+     */
+    size_t Offset() const           { return m_ndx; }
+
+    /**
+     * Function LineOffset
+     * returns the offset in the file of the last line read.
+     */
+    size_t LineOffset() const       { return m_lineNdx; }
+};
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -371,8 +437,12 @@ public:
      *
      * @param aSource describes the source of aString for error reporting purposes
      *  can be anything meaninful, such as wxT( "clipboard" ).
+     *
+     * @param aStartingLineNumber is the initial line number to report on error, for
+     *  when aString is a part of a larger text.
      */
-    STRING_LINE_READER( const std::string& aString, const wxString& aSource );
+    STRING_LINE_READER( const std::string& aString, const wxString& aSource,
+                        unsigned aStartingLineNumber = 0 );
 
     /**
      * Constructor STRING_LINE_READER( const STRING_LINE_READER& )
@@ -409,6 +479,7 @@ public:
 
 
 #define OUTPUTFMTBUFZ    500        ///< default buffer size for any OUTPUT_FORMATTER
+#define FILE_OUTPUTFMTBUFZ  (256*1024)  ///< stdio buffer size of a FILE_OUTPUTFORMATTER
 
 /**
  * Class OUTPUTFORMATTER
@@ -434,6 +505,9 @@ class OUTPUTFORMATTER
     int sprint( const char* fmt, ... )  throw( IO_ERROR );
     int vprint( const char* fmt,  va_list ap )  throw( IO_ERROR );
 
+    /// writes the spaces of \a nestLevel, @return the count of spaces
+    int indent( int nestLevel )  throw( IO_ERROR );
+
 
 protected:
     OUTPUTFORMATTER( int aReserve = OUTPUTFMTBUFZ, char aQuoteChar = '"' ) :
@@ -557,6 +631,17 @@ public:
     STRING_FORMATTER( int aReserve = OUTPUTFMTBUFZ, char aQuoteChar = '"' ) :
         OUTPUTFORMATTER( aReserve, aQuoteChar )
     {
+        mystring.reserve( aReserve );
+    }
+
+    /**
+     * Function Reserve
+     * makes room for \a aSize bytes of output, when the output size is known in
+     * advance, so the string is not reallocated while it grows.
+     */
+    void Reserve( size_t aSize )
+    {
+        mystring.reserve( aSize );
     }
 
     /**
@@ -574,7 +659,7 @@ public:
      */
     void StripUseless();
 
-    std::string GetString()
+    const std::string& GetString()
     {
         return mystring;
     }
@@ -616,8 +701,9 @@ protected:
     void write( const char* aOutBuf, int aCount ) throw( IO_ERROR );
     //-----</OUTPUTFORMATTER>-----------------------------------------------
 
-    FILE*       m_fp;               ///< takes ownership
-    wxString    m_filename;
+    FILE*               m_fp;       ///< takes ownership
+    wxString            m_filename;
+    std::vector<char>   m_buffer;   ///< the stdio buffer of m_fp, FILE_OUTPUTFMTBUFZ bytes
 };
 
 
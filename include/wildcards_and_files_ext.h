@@ -55,6 +55,7 @@ extern const wxString GerberFileExtension;
 extern const wxString LegacyPcbFileExtension;
 extern const wxString KiCadPcbFileExtension;
 #define PcbFileExtension    KiCadPcbFileExtension       // symlink choice
+extern const wxString SnapshotPcbFileExtension;
 
 extern const wxString LegacyFootprintLibPathExtension;
 extern const wxString PdfFileExtension;
@@ -54,6 +54,7 @@ class GENERAL_COLLECTORS_GUIDE;
 class BOARD_DESIGN_SETTINGS;
 class ZONE_SETTINGS;
 class PCB_PLOT_PARAMS;
+class PLUGIN;
 
 
 /**
@@ -87,6 +88,9 @@ protected:
     /// main window.
     wxAuiToolBar* m_auxiliaryToolBar;
 
+    /// the plugin the footprints are loaded with, see footprintLibPlugin(), or NULL
+    PLUGIN*       m_footprintLibPlugin;
+
     void updateGridSelectBox();
     void updateZoomSelectBox();
     virtual void unitsChangeRefresh();
@@ -374,6 +378,14 @@ public:
 
     // loading footprints
 
+    /**
+     * Function footprintLibPlugin
+     * returns the LEGACY_PLUGIN the footprints are loaded with, made at the first load.
+     * It lives as long as the frame, so that its library caches are kept from one
+     * footprint load to the next.
+     */
+    PLUGIN* footprintLibPlugin();
+
     /**
      * Function loadFootprintFromLibrary
      * loads @a aFootprintName from @a aLibraryPath.
@@ -489,6 +501,8 @@ public:
     /**
      * Function Build_Board_Ratsnest.
      * Calculates the full ratsnest depending only on pads.
+     * The minimum spanning tree of a net is only recalculated when its pads
+     * changed since the last call, see BOARD::m_RatsnestCache.
      */
     void Build_Board_Ratsnest();
 
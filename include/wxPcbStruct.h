@@ -1279,9 +1279,12 @@ public:
      * The old fillings are removed
      * @param aActiveWindow = the current active window, if a progress bar is shown
      *                      = NULL to do not display a progress bar
-     * @param aVerbose = true to show error messages
+     * @param aVerbose = true to show error messages, false to stop at the first error
+     * @param aZones = the time stamps of the zones to fill, NULL to fill all the zones
+     * @return error level (0 = no error, 1 = a zone outline is malformed)
      */
-    int Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose = true );
+    int Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose = true,
+                        const std::vector<time_t>* aZones = NULL );
 
 
     /**
@@ -193,7 +193,6 @@ void PCB_EDIT_FRAME::Autoroute( wxDC* DC, int mode )
     Solve( DC, RoutingMatrix.m_RoutingLayersCount );
 
     /* Free memory. */
-    FreeQueue();
     InitWork();             /* Free memory for the list of router connections. */
     RoutingMatrix.UnInitRoutingMatrix();
     stop = time( NULL ) - start;
@@ -33,7 +33,10 @@
 #define AUTOROUT_H
 
 
+#include <vector>
+
 #include <base_struct.h>
+#include <route_queue.h>
 
 
 class BOARD;
@@ -63,13 +66,6 @@ enum AUTOPLACEROUTE_OPTIONS
 
 #define FORCE_PADS 1  /* Force placement of pads for any Netcode */
 
-/* search statistics */
-extern int OpenNodes;   /* total number of nodes opened */
-extern int ClosNodes;   /* total number of nodes closed */
-extern int MoveNodes;   /* total number of nodes moved */
-extern int MaxNodes;    /* maximum number of nodes opened at one time */
-
-
 /* Structures useful to the generation of board as bitmap. */
 typedef char MATRIX_CELL;
 typedef int  DIST_CELL;
@@ -211,11 +207,93 @@ void TraceFilledRectangle( int ux0, int uy0, int ux1, int uy1,
                            int angle, int masque_layer, int color, int op_logic );
 
 /* QUEUE.CPP */
-void FreeQueue();
-void InitQueue();
-void GetQueue( int *, int *, int *, int *, int * );
-int  SetQueue( int, int, int, int, int, int, int );
-void ReSetQueue( int, int, int, int, int, int, int );
+
+/**
+ * Class ROUTE_SEARCH
+ * is the state of the search of one route: the queue of the cells to
+ * expand, the maps of the distance and direction to the source of the
+ * cells, and the search statistics.
+ * <p>
+ * The maps cover a window of the routing matrix, and the search does not
+ * leave it.  The serial router searches the whole matrix, in the maps of
+ * RoutingMatrix.  Each thread of the parallel router has a search of its
+ * own, with maps of its own for a window around the connection it routes:
+ * the threads only share the board cells, which they only read.
+ * </p>
+ */
+class ROUTE_SEARCH
+{
+public:
+    /* search statistics */
+    int OpenNodes;      /* total number of nodes opened */
+    int ClosNodes;      /* total number of nodes closed */
+    int MoveNodes;      /* total number of nodes moved */
+    int MaxNodes;       /* maximum number of nodes opened at one time */
+
+    /* stop the search: the abort request of the canvas, read by the main
+     * thread before the search, since the threads do not read the frame */
+    bool AbortRequest;
+
+    ROUTE_SEARCH();
+
+    /**
+     * Function InitMatrix
+     * initializes a search of the whole routing matrix, in the distance and
+     * direction maps of RoutingMatrix.
+     */
+    void InitMatrix();
+
+    /**
+     * Function InitWindow
+     * initializes a search of the \a aNrows x \a aNcols cells from
+     * \a aRow0, \a aCol0, in maps of its own.
+     */
+    void InitWindow( int aRow0, int aCol0, int aNrows, int aNcols );
+
+    bool IsInWindow( int aRow, int aCol ) const
+    {
+        return aRow >= m_row0 && aRow < m_row0 + m_nrows
+            && aCol >= m_col0 && aCol < m_col0 + m_ncols;
+    }
+
+    int GetDir( int aRow, int aCol, int aSide ) const
+    {
+        return m_dir[aSide][ cellOffset( aRow, aCol ) ];
+    }
+
+    void SetDir( int aRow, int aCol, int aSide, int aDir )
+    {
+        m_dir[aSide][ cellOffset( aRow, aCol ) ] = (DIR_CELL) aDir;
+    }
+
+    DIST_CELL GetDist( int aRow, int aCol, int aSide ) const
+    {
+        return m_dist[aSide][ cellOffset( aRow, aCol ) ];
+    }
+
+    void SetDist( int aRow, int aCol, int aSide, DIST_CELL aDist )
+    {
+        m_dist[aSide][ cellOffset( aRow, aCol ) ] = aDist;
+    }
+
+    void GetQueue( int *, int *, int *, int *, int * );
+    int  SetQueue( int, int, int, int, int, int, int );
+    void ReSetQueue( int, int, int, int, int, int, int );
+
+private:
+    ROUTE_QUEUE             m_queue;        // cells relative to the window origin
+    std::vector<DIR_CELL>   m_dirMap;       // maps of a window
+    std::vector<DIST_CELL>  m_distMap;
+    DIR_CELL*               m_dir[MAX_ROUTING_LAYERS_COUNT];
+    DIST_CELL*              m_dist[MAX_ROUTING_LAYERS_COUNT];
+    int                     m_row0, m_col0;
+    int                     m_nrows, m_ncols;
+
+    int cellOffset( int aRow, int aCol ) const
+    {
+        return ( aRow - m_row0 ) * m_ncols + aCol - m_col0;
+    }
+};
 
 /* WORK.CPP */
 void InitWork();
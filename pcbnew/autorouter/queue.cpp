@@ -32,6 +32,8 @@
  * @file queue.cpp
  */
 
+#include <new>
+
 #include <fctsys.h>
 #include <common.h>
 
@@ -40,76 +42,79 @@
 #include <cell.h>
 
 
-struct PcbQueue /* search queue structure */
+ROUTE_SEARCH::ROUTE_SEARCH()
 {
-    struct PcbQueue* Next;
-    int              Row;       /* current row                  */
-    int              Col;       /* current column               */
-    int              Side;      /* 0=top, 1=bottom              */
-    int              Dist;      /* path distance to this cell so far        */
-    int              ApxDist;   /* approximate distance to target from here */
-};
-
-static long             qlen = 0;   /* current queue length */
-static struct PcbQueue* Head = NULL;
-static struct PcbQueue* Tail = NULL;
-static struct PcbQueue* Save = NULL;    /* hold empty queue structs */
-
+    OpenNodes = ClosNodes = MoveNodes = MaxNodes = 0;
+    AbortRequest = false;
+    m_row0  = m_col0  = 0;
+    m_nrows = m_ncols = 0;
 
-void InitQueue();
-void GetQueue( int*, int*, int*, int*, int* );
-int  SetQueue( int, int, int, int, int, int, int );
-void ReSetQueue( int, int, int, int, int, int, int );
+    for( int ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
+    {
+        m_dir[ii]  = NULL;
+        m_dist[ii] = NULL;
+    }
+}
 
 
-/* Free the memory used for storing all the queue */
-void FreeQueue()
+void ROUTE_SEARCH::InitMatrix()
 {
-    struct PcbQueue* p;
+    m_row0  = 0;
+    m_col0  = 0;
+    m_nrows = RoutingMatrix.m_Nrows;
+    m_ncols = RoutingMatrix.m_Ncols;
 
-    InitQueue();
+    /* clear direction flags */
+    int i = m_nrows * m_ncols * sizeof(DIR_CELL);
+    memset( RoutingMatrix.m_DirSide[TOP], FROM_NOWHERE, i );
+    memset( RoutingMatrix.m_DirSide[BOTTOM], FROM_NOWHERE, i );
 
-    while( (p = Save) != NULL )
+    for( int ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
     {
-        Save = p->Next;
-        delete p;
+        m_dir[ii]  = RoutingMatrix.m_DirSide[ii];
+        m_dist[ii] = RoutingMatrix.m_DistSide[ii];
     }
+
+    m_queue.Init( m_nrows, m_ncols );
+    OpenNodes = ClosNodes = MoveNodes = MaxNodes = 0;
 }
 
 
-/* initialize the search queue */
-void InitQueue()
+void ROUTE_SEARCH::InitWindow( int aRow0, int aCol0, int aNrows, int aNcols )
 {
-    struct PcbQueue* p;
+    m_row0  = aRow0;
+    m_col0  = aCol0;
+    m_nrows = aNrows;
+    m_ncols = aNcols;
+
+    int cellCount = m_nrows * m_ncols;
+
+    /* clear direction flags */
+    m_dirMap.assign( cellCount * MAX_ROUTING_LAYERS_COUNT, FROM_NOWHERE );
+    m_distMap.resize( cellCount * MAX_ROUTING_LAYERS_COUNT );
 
-    while( (p = Head) != NULL )
+    for( int ii = 0; ii < MAX_ROUTING_LAYERS_COUNT; ii++ )
     {
-        Head    = p->Next;
-        p->Next = Save; Save = p;
+        m_dir[ii]  = &m_dirMap[ ii * cellCount ];
+        m_dist[ii] = &m_distMap[ ii * cellCount ];
     }
 
-    Tail = NULL;
-    OpenNodes = ClosNodes = MoveNodes = MaxNodes = qlen = 0;
+    m_queue.Init( m_nrows, m_ncols );
+    OpenNodes = ClosNodes = MoveNodes = MaxNodes = 0;
 }
 
 
 /* get search queue item from list */
-void GetQueue( int* r, int* c, int* s, int* d, int* a )
+void ROUTE_SEARCH::GetQueue( int* r, int* c, int* s, int* d, int* a )
 {
-    struct PcbQueue* p;
+    ROUTE_QUEUE::NODE node;
 
-    if( (p = Head) != NULL )  /* return first item in list */
+    if( m_queue.Pop( node ) )  /* return first item in list */
     {
-        *r = p->Row; *c = p->Col;
-        *s = p->Side;
-        *d = p->Dist; *a = p->ApxDist;
-
-        if( (Head = p->Next) == NULL )
-            Tail = NULL;
-
-        /* put node on free list */
-        p->Next = Save; Save = p;
-        ClosNodes++; qlen--;
+        *r = node.m_Row + m_row0; *c = node.m_Col + m_col0;
+        *s = node.m_Side;
+        *d = node.m_Dist; *a = node.m_ApxDist;
+        ClosNodes++;
     }
     else /* empty list */
     {
@@ -123,103 +128,39 @@ void GetQueue( int* r, int* c, int* s, int* d, int* a )
  *      1 - OK
  *      0 - Failed to allocate memory.
  */
-int SetQueue( int r, int c, int side, int d, int a, int r2, int c2 )
+int ROUTE_SEARCH::SetQueue( int r, int c, int side, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q, * t;
-    int i, j;
-
-    j = 0;                      // gcc warning fix
-
-    if( (p = Save) != NULL )    /* try free list first */
+    try
     {
-        Save = p->Next;
+        m_queue.Push( r - m_row0, c - m_col0, side, d, a, r2 - m_row0, c2 - m_col0 );
     }
-    else if( ( p = (PcbQueue*) operator new( sizeof( PcbQueue ), std::nothrow ) ) == NULL )
+    catch( const std::bad_alloc& )
     {
         return 0;
     }
 
-    p->Row  = r;
-    p->Col  = c;
-    p->Side = side;
-    i = (p->Dist = d) + (p->ApxDist = a);
-    p->Next = NULL;
-
-    if( (q = Head) != NULL ) /* insert in proper position in list */
-    {
-        if( q->Dist + q->ApxDist > i ) /* insert at head */
-        {
-            p->Next = q; Head = p;
-        }
-        else   /* search for proper position */
-        {
-            for( t = q, q = q->Next; q && i > ( j = q->Dist + q->ApxDist ); t = q, q = q->Next )
-                ;
-
-            if( q && i == j && q->Row == r2 && q->Col == c2 )
-            {
-                /* insert after q, which is a goal node */
-                if( ( p->Next = q->Next ) == NULL )
-                    Tail = p;
-
-                q->Next = p;
-            }
-            else  /* insert in front of q */
-            {
-                if( ( p->Next = q ) == NULL )
-                    Tail = p;
-
-                t->Next = p;
-            }
-        }
-    }
-    else /* empty search list */
-    {
-        Head = Tail = p;
-    }
-
     OpenNodes++;
 
-    if( ++qlen > MaxNodes )
-        MaxNodes = qlen;
+    if( m_queue.GetCount() > MaxNodes )
+        MaxNodes = m_queue.GetCount();
 
     return 1;
 }
 
 
 /* reposition node in list */
-void ReSetQueue( int r, int c, int s, int d, int a, int r2, int c2 )
+void ROUTE_SEARCH::ReSetQueue( int r, int c, int s, int d, int a, int r2, int c2 )
 {
-    struct PcbQueue* p, * q;
-
-    /* first, see if it is already in the list */
-    for( q = NULL, p = Head; p; q = p, p = p->Next )
+    if( m_queue.Contains( r - m_row0, c - m_col0, s ) )
     {
-        if( p->Row == r && p->Col == c && p->Side == s )
-        {
-            /* old one to remove */
-            if( q )
-            {
-                if( ( q->Next = p->Next ) == NULL )
-                    Tail = q;
-            }
-            else if( ( Head = p->Next ) == NULL )
-            {
-                Tail = NULL;
-            }
-
-            p->Next = Save;
-            Save = p;
-            OpenNodes--;
-            MoveNodes++;
-            qlen--;
-            break;
-        }
+        /* move it to its new position */
+        m_queue.Push( r - m_row0, c - m_col0, s, d, a, r2 - m_row0, c2 - m_col0 );
+        MoveNodes++;
     }
-
-    if( !p )            /* not found, it has already been closed once */
+    else
+    {
+        /* not found, it has already been closed once */
         ClosNodes--;    /* we will close it again, but just count once */
-
-    /* if it was there, it's gone now; insert it at the proper position */
-    SetQueue( r, c, s, d, a, r2, c2 );
+        SetQueue( r, c, s, d, a, r2, c2 );
+    }
 }
@@ -0,0 +1,266 @@
+/**
+ * @file route_queue.h
+ * @brief the search queue of the autorouter, an indexed binary heap.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef ROUTE_QUEUE_H_
+#define ROUTE_QUEUE_H_
+
+#include <vector>
+
+
+/**
+ * Class ROUTE_QUEUE
+ * holds the cells of the routing matrix waiting to be expanded by the
+ * autorouter, the nearest to the target first.
+ * <p>
+ * A cell (row, column, side) is at most once in the queue, an index from
+ * the cells to their heap position allows to move a cell when a shorter
+ * path to it is found.  Push() and Pop() are O(log n), Contains() is O(1).
+ * </p><p>
+ * The cells are sorted by path distance + approximate distance to the
+ * target.  On a tie a target cell comes first, then the last pushed cell,
+ * as in the former sorted list, except that the list also kept its first
+ * cell in place: the cells of a tie may be expanded in an other order, and
+ * an other path of the same cost found.
+ * </p>
+ */
+class ROUTE_QUEUE
+{
+public:
+    struct NODE
+    {
+        int         m_Row;
+        int         m_Col;
+        int         m_Side;         ///< 0=top, 1=bottom
+        int         m_Dist;         ///< path distance to this cell so far
+        int         m_ApxDist;      ///< approximate distance to target from here
+        bool        m_Target;       ///< the cell is at the target row and column
+        unsigned    m_Seq;          ///< push order, to break ties
+    };
+
+    ROUTE_QUEUE() : m_ncols( 0 ), m_seq( 0 ) {}
+
+    /**
+     * Function Init
+     * empties the queue, for a routing matrix of \a aRows x \a aCols cells
+     * on 2 sides.
+     */
+    void Init( int aRows, int aCols )
+    {
+        size_t cellCount = (size_t) aRows * aCols * 2;
+
+        if( cellCount != m_position.size() )
+        {
+            m_position.assign( cellCount, -1 );
+        }
+        else
+        {
+            for( unsigned ii = 0; ii < m_heap.size(); ++ii )
+                m_position[ cellIndex( m_heap[ii] ) ] = -1;
+        }
+
+        m_heap.clear();
+        m_ncols = aCols;
+        m_seq   = 0;
+    }
+
+    /**
+     * Function Clear
+     * empties the queue and frees its memory.
+     */
+    void Clear()
+    {
+        std::vector<NODE>().swap( m_heap );
+        std::vector<int>().swap( m_position );
+        m_ncols = 0;
+    }
+
+    bool IsEmpty() const { return m_heap.empty(); }
+
+    int GetCount() const { return (int) m_heap.size(); }
+
+    bool Contains( int aRow, int aCol, int aSide ) const
+    {
+        return m_position[ cellIndex( aRow, aCol, aSide ) ] >= 0;
+    }
+
+    /**
+     * Function Push
+     * adds a cell to the queue, or moves it to its new position if it is
+     * already there.
+     * @param aRow, aCol, aSide = the cell
+     * @param aDist = the path distance to the cell
+     * @param aApxDist = the approximate distance from the cell to the target
+     * @param aTargetRow, aTargetCol = the target cell
+     * @return bool - true if the cell was already in the queue
+     */
+    bool Push( int aRow, int aCol, int aSide, int aDist, int aApxDist,
+               int aTargetRow, int aTargetCol )
+    {
+        NODE node;
+
+        node.m_Row     = aRow;
+        node.m_Col     = aCol;
+        node.m_Side    = aSide;
+        node.m_Dist    = aDist;
+        node.m_ApxDist = aApxDist;
+        node.m_Target  = aRow == aTargetRow && aCol == aTargetCol;
+        node.m_Seq     = m_seq++;
+
+        int& position = m_position[ cellIndex( node ) ];
+
+        if( position >= 0 )
+        {
+            // a new distance, and the last pushed cell on a tie: it can go up
+            // or down
+            int ii = position;
+
+            m_heap[ii] = node;
+            siftDown( siftUp( ii ) );
+            return true;
+        }
+
+        position = m_heap.size();
+        m_heap.push_back( node );
+        siftUp( position );
+        return false;
+    }
+
+    /**
+     * Function Pop
+     * removes the first cell of the queue.
+     * @param aNode = where to put the cell
+     * @return bool - false if the queue is empty
+     */
+    bool Pop( NODE& aNode )
+    {
+        if( m_heap.empty() )
+            return false;
+
+        aNode = m_heap[0];
+        m_position[ cellIndex( aNode ) ] = -1;
+
+        if( m_heap.size() > 1 )
+        {
+            m_heap[0] = m_heap.back();
+            m_position[ cellIndex( m_heap[0] ) ] = 0;
+            m_heap.pop_back();
+            siftDown( 0 );
+        }
+        else
+        {
+            m_heap.pop_back();
+        }
+
+        return true;
+    }
+
+private:
+    std::vector<NODE>   m_heap;         ///< the binary heap, first cell at 0
+    std::vector<int>    m_position;     ///< heap position of each cell, or -1
+    int                 m_ncols;
+    unsigned            m_seq;
+
+    int cellIndex( int aRow, int aCol, int aSide ) const
+    {
+        return ( aRow * m_ncols + aCol ) * 2 + aSide;
+    }
+
+    int cellIndex( const NODE& aNode ) const
+    {
+        return cellIndex( aNode.m_Row, aNode.m_Col, aNode.m_Side );
+    }
+
+    /// @return true if \a a must be expanded before \a b
+    static bool before( const NODE& a, const NODE& b )
+    {
+        int da = a.m_Dist + a.m_ApxDist;
+        int db = b.m_Dist + b.m_ApxDist;
+
+        if( da != db )
+            return da < db;
+
+        if( a.m_Target != b.m_Target )
+            return a.m_Target;
+
+        // target cells in push order, the others last pushed first
+        return a.m_Target ? a.m_Seq < b.m_Seq : a.m_Seq > b.m_Seq;
+    }
+
+    void place( int aPosition, const NODE& aNode )
+    {
+        m_heap[aPosition] = aNode;
+        m_position[ cellIndex( aNode ) ] = aPosition;
+    }
+
+    int siftUp( int aPosition )
+    {
+        NODE node = m_heap[aPosition];
+
+        while( aPosition > 0 )
+        {
+            int parent = ( aPosition - 1 ) / 2;
+
+            if( !before( node, m_heap[parent] ) )
+                break;
+
+            place( aPosition, m_heap[parent] );
+            aPosition = parent;
+        }
+
+        place( aPosition, node );
+        return aPosition;
+    }
+
+    int siftDown( int aPosition )
+    {
+        NODE node  = m_heap[aPosition];
+        int  count = m_heap.size();
+
+        for( ;; )
+        {
+            int child = 2 * aPosition + 1;
+
+            if( child >= count )
+                break;
+
+            if( child + 1 < count && before( m_heap[child + 1], m_heap[child] ) )
+                child++;
+
+            if( !before( m_heap[child], node ) )
+                break;
+
+            place( aPosition, m_heap[child] );
+            aPosition = child;
+        }
+
+        place( aPosition, node );
+        return aPosition;
+    }
+};
+
+#endif  // ROUTE_QUEUE_H_
@@ -33,6 +33,11 @@
  * @file solve.cpp
  */
 
+#include <algorithm>
+#include <vector>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <fctsys.h>
 #include <class_drawpanel.h>
 #include <confirm.h>
@@ -40,18 +45,22 @@
 #include <gr_basic.h>
 #include <macros.h>
 #include <pcbcommon.h>
+#include <openmp_threads.h>
 
 #include <class_board.h>
 #include <class_track.h>
+#include <class_pad.h>
 
 #include <pcbnew.h>
 #include <protos.h>
 #include <autorout.h>
 #include <cell.h>
+#include <board_spatial_index.h>
 
 
 static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
                                 wxDC*           DC,
+                                ROUTE_SEARCH&   search,
                                 int             two_sides,
                                 int             row_source,
                                 int             col_source,
@@ -59,14 +68,15 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
                                 int             col_target,
                                 RATSNEST_ITEM*  pt_rat );
 
-static int Retrace( PCB_EDIT_FRAME* pcbframe,
-                    wxDC*           DC,
+static int Retrace( PCB_EDIT_FRAME*     pcbframe,
+                    wxDC*               DC,
+                    const ROUTE_SEARCH& search,
                     int,
                     int,
                     int,
                     int,
                     int,
-                    int              net_code );
+                    int                 net_code );
 
 static void OrCell_Trace( BOARD* pcb,
                           int    col,
@@ -86,10 +96,11 @@ static int            s_Clearance;  // Clearance value used in autorouter
 
 static PICKED_ITEMS_LIST s_ItemsListPicker;
 
-int OpenNodes;       /* total number of nodes opened */
-int ClosNodes;       /* total number of nodes closed */
-int MoveNodes;       /* total number of nodes moved */
-int MaxNodes;        /* maximum number of nodes opened at one time */
+/**
+ * Trace mask used to log the search statistics of each connection the autorouter
+ * routes.  Set the WXTRACE environment variable to "KicadAutorouter" to show them.
+ */
+static const wxChar* traceAutorouter = wxT( "KicadAutorouter" );
 
 #define NOSUCCESS       0
 #define STOP_FROM_ESC   -1
@@ -231,22 +242,19 @@ static struct block blocking[8] =
   } };
 
 /* mask for hole-related blocking effects */
-static struct
+static const long selfok2[8] =
 {
-    long trace;
-    int  present;
-} selfok2[8] =
-{
-    { HOLE_NORTHWEST, 0 },
-    { HOLE_NORTH,     0 },
-    { HOLE_NORTHEAST, 0 },
-    { HOLE_WEST,      0 },
-    { HOLE_EAST,      0 },
-    { HOLE_SOUTHWEST, 0 },
-    { HOLE_SOUTH,     0 },
-    { HOLE_SOUTHEAST, 0 }
+    HOLE_NORTHWEST,
+    HOLE_NORTH,
+    HOLE_NORTHEAST,
+    HOLE_WEST,
+    HOLE_EAST,
+    HOLE_SOUTHWEST,
+    HOLE_SOUTH,
+    HOLE_SOUTHEAST
 };
 
+
 static long newmask[8] =
 {
     /* patterns to mask out in neighbor cells */
@@ -261,272 +269,162 @@ static long newmask[8] =
 };
 
 
-/* Route all traces
- * Return:
- *  1 if OK
- * -1 if escape (stop being routed) request
- * -2 if default memory allocation
- */
-int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount )
-{
-    int           current_net_code;
-    int           row_source, col_source, row_target, col_target;
-    int           success, nbsucces = 0, nbunsucces = 0;
-    NETINFO_ITEM* net;
-    bool          stop = false;
-    wxString      msg;
-    int           routedCount = 0;      // routed ratsnest count
-    bool          two_sides = aLayersCount == 2;
 
-    m_canvas->SetAbortRequest( false );
 
-    s_Clearance = GetBoard()->m_NetClasses.GetDefault()->GetClearance();
+/* A connection of the work list. */
+struct ROUTE_WORK
+{
+    int            m_FromRow, m_FromCol;
+    int            m_ToRow, m_ToCol;
+    int            m_NetCode;
+    RATSNEST_ITEM* m_Ratsnest;
+};
 
-    // Prepare the undo command info
-    s_ItemsListPicker.ClearListAndDeleteItems();  // Should not be necessary, but...
 
-    /* go until no more work to do */
-    GetWork( &row_source, &col_source, &current_net_code,
-             &row_target, &col_target, &pt_cur_ch ); // First net to route.
+/* The cells of the routing matrix the parallel router searches a
+ * connection in: rows m_Row0 to m_Row1, columns m_Col0 to m_Col1.
+ */
+struct ROUTE_WINDOW
+{
+    int m_Row0, m_Col0;
+    int m_Row1, m_Col1;
 
-    for( ; row_source != ILLEGAL; GetWork( &row_source, &col_source,
-                                           &current_net_code, &row_target,
-                                           &col_target,
-                                           &pt_cur_ch ) )
+    /* Test if the windows are less than aGap cells apart. */
+    bool Intersects( const ROUTE_WINDOW& aOther, int aGap ) const
     {
-        /* Test to stop routing ( escape key pressed ) */
-        wxYield();
-
-        if( m_canvas->GetAbortRequest() )
-        {
-            if( IsOK( this, _( "Abort routing?" ) ) )
-            {
-                success = STOP_FROM_ESC;
-                stop    = true;
-                break;
-            }
-            else
-            {
-                m_canvas->SetAbortRequest( false );
-            }
-        }
+        return m_Row0 - aGap <= aOther.m_Row1 && aOther.m_Row0 <= m_Row1 + aGap
+            && m_Col0 - aGap <= aOther.m_Col1 && aOther.m_Col0 <= m_Col1 + aGap;
+    }
+};
 
-        EraseMsgBox();
 
-        routedCount++;
-        net = GetBoard()->FindNet( current_net_code );
+/* Show the count of routed and failed connections. */
+static void showRouteCounts( PCB_EDIT_FRAME* pcbframe, int nbsucces, int nbunsucces )
+{
+    wxString msg;
+
+    msg.Printf( wxT( "%d" ), nbsucces );
+    pcbframe->AppendMsgPanel( wxT( "Ok" ), msg, GREEN );
+    msg.Printf( wxT( "%d" ), nbunsucces );
+    pcbframe->AppendMsgPanel( wxT( "Fail" ), msg, RED );
+    msg.Printf( wxT( "  %d" ), pcbframe->GetBoard()->GetUnconnectedNetCount() );
+    pcbframe->AppendMsgPanel( wxT( "Not Connected" ), msg, CYAN );
+}
 
-        if( net )
-        {
-            msg.Printf( wxT( "[%8.8s]" ), GetChars( net->GetNetname() ) );
-            AppendMsgPanel( wxT( "Net route" ), msg, BROWN );
-            msg.Printf( wxT( "%d / %d" ), routedCount, RoutingMatrix.m_RouteCount );
-            AppendMsgPanel( wxT( "Activity" ), msg, BROWN );
-        }
 
-        pt_cur_ch = pt_cur_ch;
-        segm_oX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_source);
-        segm_oY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_source);
-        segm_fX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_target);
-        segm_fY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_target);
+/* Test if a connection can be routed: the pads must be on the routing
+ * layers, and a point of the routing grid must be inside each pad.
+ * Returns:
+ * SUCCESS if the connection can be routed
+ * TRIVIAL_SUCCESS if pads are connected by overlay (no track needed)
+ * NOSUCCESS if it cannot be routed
+ */
+static int checkConnection( BOARD* pcb, int row_source, int col_source,
+                            int row_target, int col_target, RATSNEST_ITEM* pt_rat )
+{
+    int padLayerMaskStart = pt_rat->m_PadStart->GetLayerMask();
+    int padLayerMaskEnd   = pt_rat->m_PadEnd->GetLayerMask();
+    int routeLayerMask    = GetLayerMask( Route_Layer_TOP ) | GetLayerMask( Route_Layer_BOTTOM );
 
-        /* Draw segment. */
-        GRLine( m_canvas->GetClipBox(), DC,
-                segm_oX, segm_oY, segm_fX, segm_fY,
-                0, WHITE );
-        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
-        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+    /* First Test if routing possible ie if the pads are accessible
+     * on the routing layers.
+     */
+    if( ( routeLayerMask & padLayerMaskStart ) == 0 )
+        return NOSUCCESS;
 
-        success = Autoroute_One_Track( this, DC,
-                                       two_sides, row_source, col_source,
-                                       row_target, col_target, pt_cur_ch );
+    if( ( routeLayerMask & padLayerMaskEnd ) == 0 )
+        return NOSUCCESS;
 
-        switch( success )
-        {
-        case NOSUCCESS:
-            pt_cur_ch->m_Status |= CH_UNROUTABLE;
-            nbunsucces++;
-            break;
+    /* Then test if routing possible ie if the pads are accessible
+     * On the routing grid (1 grid point must be in the pad)
+     */
+    int cX = ( RoutingMatrix.m_GridRouting * col_source ) + pcb->GetBoundingBox().GetX();
+    int cY = ( RoutingMatrix.m_GridRouting * row_source ) + pcb->GetBoundingBox().GetY();
+    int dx = pt_rat->m_PadStart->GetSize().x / 2;
+    int dy = pt_rat->m_PadStart->GetSize().y / 2;
+    int px = pt_rat->m_PadStart->GetPosition().x;
+    int py = pt_rat->m_PadStart->GetPosition().y;
 
-        case STOP_FROM_ESC:
-            stop = true;
-            break;
+    if( ( ( int( pt_rat->m_PadStart->GetOrientation() ) / 900 ) & 1 ) != 0 )
+        EXCHG( dx, dy );
 
-        case ERR_MEMORY:
-            stop = true;
-            break;
+    if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
+        return NOSUCCESS;
 
-        default:
-            nbsucces++;
-            break;
-        }
+    cX = ( RoutingMatrix.m_GridRouting * col_target ) + pcb->GetBoundingBox().GetX();
+    cY = ( RoutingMatrix.m_GridRouting * row_target ) + pcb->GetBoundingBox().GetY();
+    dx = pt_rat->m_PadEnd->GetSize().x / 2;
+    dy = pt_rat->m_PadEnd->GetSize().y / 2;
+    px = pt_rat->m_PadEnd->GetPosition().x;
+    py = pt_rat->m_PadEnd->GetPosition().y;
 
-        msg.Printf( wxT( "%d" ), nbsucces );
-        AppendMsgPanel( wxT( "Ok" ), msg, GREEN );
-        msg.Printf( wxT( "%d" ), nbunsucces );
-        AppendMsgPanel( wxT( "Fail" ), msg, RED );
-        msg.Printf( wxT( "  %d" ), GetBoard()->GetUnconnectedNetCount() );
-        AppendMsgPanel( wxT( "Not Connected" ), msg, CYAN );
+    if( ( ( int( pt_rat->m_PadEnd->GetOrientation() ) / 900) & 1 ) != 0 )
+        EXCHG( dx, dy );
 
-        /* Delete routing from display. */
-        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_AND );
-        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_AND );
+    if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
+        return NOSUCCESS;
 
-        if( stop )
-            break;
+    /* Test the trivial case: direct connection overlay pads. */
+    if( ( row_source == row_target ) && ( col_source == col_target )
+       && ( padLayerMaskEnd & padLayerMaskStart &
+            g_TabAllCopperLayerMask[pcb->GetCopperLayerCount() - 1] ) )
+    {
+        return TRIVIAL_SUCCESS;
     }
 
-    SaveCopyInUndoList( s_ItemsListPicker, UR_UNSPECIFIED );
-    s_ItemsListPicker.ClearItemsList(); // s_ItemsListPicker is no more owner of picked items
-
     return SUCCESS;
 }
 
 
-/* Route a trace on the BOARD.
+/* Search the route of a connection, in the window of search.
+ * The board cells are only read: the pads of the connection must be placed
+ * with CURRENT_PAD before, and several searches can run at the same time.
+ * The escape key is the AbortRequest flag of search, read from the canvas by
+ * the main thread before the search: the threads do not read the frame.
  * Parameters:
+ * The frame, to show the search activity if aShowActivity (main thread only)
  * 1 side / 2 sides (0 / 1)
  * Coord source (row, col)
  * Coord destination (row, col)
- * Net_code
- * Pointer to the ratsnest reference
+ * Mask layers of the starting and ending pads
+ * Where to put the side the route arrives on the target
  *
  * Returns:
- * SUCCESS if routed
- * TRIVIAL_SUCCESS if pads are connected by overlay (no track needed)
+ * SUCCESS if a route is found: search holds its directions
  * If failure NOSUCCESS
  * Escape STOP_FROM_ESC if demand
  * ERR_MEMORY if memory allocation failed.
  */
-static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
-                                wxDC*           DC,
-                                int             two_sides,
-                                int             row_source,
-                                int             col_source,
-                                int             row_target,
-                                int             col_target,
-                                RATSNEST_ITEM*  pt_rat )
+static int searchRoute( PCB_EDIT_FRAME* pcbframe,
+                        bool            aShowActivity,
+                        ROUTE_SEARCH&   search,
+                        int             two_sides,
+                        int             row_source,
+                        int             col_source,
+                        int             row_target,
+                        int             col_target,
+                        int             padLayerMaskStart,
+                        int             padLayerMaskEnd,
+                        int*            aTargetSide )
 {
     int          r, c, side, d, apx_dist, nr, nc;
-    int          result, skip;
+    int          skip;
     int          i;
     long         curcell, newcell, buddy, lastopen, lastclos, lastmove;
     int          newdist, olddir, _self;
-    int          current_net_code;
-    int          marge;
-    int          padLayerMaskStart;    /* Mask layers belonging to the starting pad. */
-    int          padLayerMaskEnd;      /* Mask layers belonging to the ending pad. */
     int          topLayerMask = GetLayerMask( Route_Layer_TOP );
     int          bottomLayerMask = GetLayerMask( Route_Layer_BOTTOM );
-    int          routeLayerMask;       /* Mask two layers for routing. */
     int          tab_mask[2];       /* Enables the calculation of the mask layer being
                                      * tested. (side = TOP or BOTTOM) */
-    int          start_mask_layer = 0;
+    bool         present[8];        /* the hole-related blocking effects of the current cell */
     wxString     msg;
 
-    wxBusyCursor dummy_cursor;      // Set an hourglass cursor while routing a
-                                    // track
-
-    result = NOSUCCESS;
-
-    marge = s_Clearance + ( pcbframe->GetBoard()->GetCurrentTrackWidth() / 2 );
-
-    /* clear direction flags */
-    i = RoutingMatrix.m_Nrows * RoutingMatrix.m_Ncols * sizeof(DIR_CELL);
-    memset( RoutingMatrix.m_DirSide[TOP], FROM_NOWHERE, i );
-    memset( RoutingMatrix.m_DirSide[BOTTOM], FROM_NOWHERE, i );
-
     lastopen = lastclos = lastmove = 0;
 
     /* Set tab_masque[side] for final test of routing. */
     tab_mask[TOP]    = topLayerMask;
     tab_mask[BOTTOM] = bottomLayerMask;
 
-    /* Set active layers mask. */
-    routeLayerMask = topLayerMask | bottomLayerMask;
-
-    pt_cur_ch = pt_rat;
-
-    current_net_code  = pt_rat->GetNet();
-    padLayerMaskStart = pt_cur_ch->m_PadStart->GetLayerMask();
-
-    padLayerMaskEnd = pt_cur_ch->m_PadEnd->GetLayerMask();
-
-
-    /* First Test if routing possible ie if the pads are accessible
-     * on the routing layers.
-     */
-    if( ( routeLayerMask & padLayerMaskStart ) == 0 )
-        goto end_of_route;
-
-    if( ( routeLayerMask & padLayerMaskEnd ) == 0 )
-        goto end_of_route;
-
-    /* Then test if routing possible ie if the pads are accessible
-     * On the routing grid (1 grid point must be in the pad)
-     */
-    {
-        int cX = ( RoutingMatrix.m_GridRouting * col_source )
-                 + pcbframe->GetBoard()->GetBoundingBox().GetX();
-        int cY = ( RoutingMatrix.m_GridRouting * row_source )
-                 + pcbframe->GetBoard()->GetBoundingBox().GetY();
-        int dx = pt_cur_ch->m_PadStart->GetSize().x / 2;
-        int dy = pt_cur_ch->m_PadStart->GetSize().y / 2;
-        int px = pt_cur_ch->m_PadStart->GetPosition().x;
-        int py = pt_cur_ch->m_PadStart->GetPosition().y;
-
-        if( ( ( int( pt_cur_ch->m_PadStart->GetOrientation() ) / 900 ) & 1 ) != 0 )
-            EXCHG( dx, dy );
-
-        if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
-            goto end_of_route;
-
-        cX = ( RoutingMatrix.m_GridRouting * col_target )
-             + pcbframe->GetBoard()->GetBoundingBox().GetX();
-        cY = ( RoutingMatrix.m_GridRouting * row_target )
-             + pcbframe->GetBoard()->GetBoundingBox().GetY();
-        dx = pt_cur_ch->m_PadEnd->GetSize().x / 2;
-        dy = pt_cur_ch->m_PadEnd->GetSize().y / 2;
-        px = pt_cur_ch->m_PadEnd->GetPosition().x;
-        py = pt_cur_ch->m_PadEnd->GetPosition().y;
-
-        if( ( ( int( pt_cur_ch->m_PadEnd->GetOrientation() ) / 900) & 1 ) != 0 )
-            EXCHG( dx, dy );
-
-        if( ( abs( cX - px ) > dx ) || ( abs( cY - py ) > dy ) )
-            goto end_of_route;
-    }
-
-    /* Test the trivial case: direct connection overlay pads. */
-    if( ( row_source == row_target ) && ( col_source == col_target )
-       && ( padLayerMaskEnd & padLayerMaskStart &
-            g_TabAllCopperLayerMask[pcbframe->GetBoard()->GetCopperLayerCount() - 1] ) )
-    {
-        result = TRIVIAL_SUCCESS;
-        goto end_of_route;
-    }
-
-    /* Placing the bit to remove obstacles on 2 pads to a link. */
-    pcbframe->SetStatusText( wxT( "Gen Cells" ) );
-
-    PlacePad( pt_cur_ch->m_PadStart, CURRENT_PAD, marge, WRITE_OR_CELL );
-    PlacePad( pt_cur_ch->m_PadEnd, CURRENT_PAD, marge, WRITE_OR_CELL );
-
-    /* Regenerates the remaining barriers (which may encroach on the placement bits precedent)
-     */
-    i = pcbframe->GetBoard()->GetPadCount();
-
-    for( unsigned ii = 0; ii < pcbframe->GetBoard()->GetPadCount(); ii++ )
-    {
-        D_PAD* ptr = pcbframe->GetBoard()->GetPad( ii );
-
-        if( ( pt_cur_ch->m_PadStart != ptr ) && ( pt_cur_ch->m_PadEnd != ptr ) )
-        {
-            PlacePad( ptr, ~CURRENT_PAD, marge, WRITE_AND_CELL );
-        }
-    }
-
-    InitQueue(); /* initialize the search queue */
     apx_dist = RoutingMatrix.GetApxDist( row_source, col_source, row_target, col_target );
 
     /* Initialize first search. */
@@ -536,10 +434,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         {
             if( padLayerMaskStart & topLayerMask )
             {
-                start_mask_layer = 2;
-
-                if( SetQueue( row_source, col_source, TOP, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( search.SetQueue( row_source, col_source, TOP, 0, apx_dist,
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -547,10 +443,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 
             if( padLayerMaskStart & bottomLayerMask )
             {
-                start_mask_layer |= 1;
-
-                if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( search.SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -560,10 +454,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         {
             if( padLayerMaskStart & bottomLayerMask )
             {
-                start_mask_layer = 1;
-
-                if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( search.SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -571,10 +463,8 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 
             if( padLayerMaskStart & topLayerMask )
             {
-                start_mask_layer |= 2;
-
-                if( SetQueue( row_source, col_source, TOP, 0, apx_dist,
-                              row_target, col_target ) == 0 )
+                if( search.SetQueue( row_source, col_source, TOP, 0, apx_dist,
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
@@ -583,18 +473,17 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
     }
     else if( padLayerMaskStart & bottomLayerMask )
     {
-        start_mask_layer = 1;
-
-        if( SetQueue( row_source, col_source, BOTTOM, 0, apx_dist, row_target, col_target ) == 0 )
+        if( search.SetQueue( row_source, col_source, BOTTOM, 0, apx_dist,
+                             row_target, col_target ) == 0 )
         {
             return ERR_MEMORY;
         }
     }
 
     /* search until success or we exhaust all possibilities */
-    GetQueue( &r, &c, &side, &d, &apx_dist );
+    search.GetQueue( &r, &c, &side, &d, &apx_dist );
 
-    for( ; r != ILLEGAL; GetQueue( &r, &c, &side, &d, &apx_dist ) )
+    for( ; r != ILLEGAL; search.GetQueue( &r, &c, &side, &d, &apx_dist ) )
     {
         curcell = RoutingMatrix.GetCell( r, c, side );
 
@@ -604,45 +493,26 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
         if( (r == row_target) && (c == col_target)  /* success if layer OK */
            && ( tab_mask[side] & padLayerMaskEnd) )
         {
-            /* Remove link. */
-            GRSetDrawMode( DC, GR_XOR );
-            GRLine( pcbframe->GetCanvas()->GetClipBox(),
-                    DC,
-                    segm_oX,
-                    segm_oY,
-                    segm_fX,
-                    segm_fY,
-                    0,
-                    WHITE );
-
-            /* Generate trace. */
-            if( Retrace( pcbframe, DC, row_source, col_source,
-                         row_target, col_target, side, current_net_code ) )
-            {
-                result = SUCCESS;   /* Success : Route OK */
-            }
-
-            break;                  /* Routing complete. */
+            *aTargetSide = side;
+            return SUCCESS;         /* Routing complete. */
         }
 
-        if( pcbframe->GetCanvas()->GetAbortRequest() )
-        {
-            result = STOP_FROM_ESC;
-            break;
-        }
+        if( search.AbortRequest )
+            return STOP_FROM_ESC;
 
         /* report every COUNT new nodes or so */
         #define COUNT 20000
 
-        if( ( OpenNodes - lastopen > COUNT )
-           || ( ClosNodes - lastclos > COUNT )
-           || ( MoveNodes - lastmove > COUNT ) )
+        if( aShowActivity
+           && ( ( search.OpenNodes - lastopen > COUNT )
+                || ( search.ClosNodes - lastclos > COUNT )
+                || ( search.MoveNodes - lastmove > COUNT ) ) )
         {
-            lastopen = OpenNodes;
-            lastclos = ClosNodes;
-            lastmove = MoveNodes;
+            lastopen = search.OpenNodes;
+            lastclos = search.ClosNodes;
+            lastmove = search.MoveNodes;
             msg.Printf( wxT( "Activity: Open %d   Closed %d   Moved %d" ),
-                        OpenNodes, ClosNodes, MoveNodes );
+                        search.OpenNodes, search.ClosNodes, search.MoveNodes );
             pcbframe->SetStatusText( msg );
         }
 
@@ -654,12 +524,7 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 
             /* set 'present' bits */
             for( i = 0; i < 8; i++ )
-            {
-                selfok2[i].present = 0;
-
-                if( curcell & selfok2[i].trace )
-                    selfok2[i].present = 1;
-            }
+                present[i] = ( curcell & selfok2[i] ) != 0;
         }
 
         for( i = 0; i < 8; i++ ) /* consider neighbors */
@@ -668,11 +533,10 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
             nc = c + delta[i][1];
 
             /* off the edge? */
-            if( nr < 0 || nr >= RoutingMatrix.m_Nrows ||
-                nc < 0 || nc >= RoutingMatrix.m_Ncols )
+            if( !search.IsInWindow( nr, nc ) )
                 continue;  /* off the edge */
 
-            if( _self == 5 && selfok2[i].present )
+            if( _self == 5 && present[i] )
                 continue;
 
             newcell = RoutingMatrix.GetCell( nr, nc, side );
@@ -717,39 +581,39 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
 //              if (buddy & (blocking[i].b2)) continue;
             }
 
-            olddir  = RoutingMatrix.GetDir( r, c, side );
+            olddir  = search.GetDir( r, c, side );
             newdist = d + RoutingMatrix.CalcDist( ndir[i], olddir,
                                     ( olddir == FROM_OTHERSIDE ) ?
-                                    RoutingMatrix.GetDir( r, c, 1 - side ) : 0, side );
+                                    search.GetDir( r, c, 1 - side ) : 0, side );
 
             /* if (a) not visited yet, or (b) we have */
             /* found a better path, add it to queue */
-            if( !RoutingMatrix.GetDir( nr, nc, side ) )
+            if( !search.GetDir( nr, nc, side ) )
             {
-                RoutingMatrix.SetDir( nr, nc, side, ndir[i] );
-                RoutingMatrix.SetDist( nr, nc, side, newdist );
+                search.SetDir( nr, nc, side, ndir[i] );
+                search.SetDist( nr, nc, side, newdist );
 
-                if( SetQueue( nr, nc, side, newdist,
-                              RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
-                              row_target, col_target ) == 0 )
+                if( search.SetQueue( nr, nc, side, newdist,
+                                     RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
             }
-            else if( newdist < RoutingMatrix.GetDist( nr, nc, side ) )
+            else if( newdist < search.GetDist( nr, nc, side ) )
             {
-                RoutingMatrix.SetDir( nr, nc, side, ndir[i] );
-                RoutingMatrix.SetDist( nr, nc, side, newdist );
-                ReSetQueue( nr, nc, side, newdist,
-                            RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
-                            row_target, col_target );
+                search.SetDir( nr, nc, side, ndir[i] );
+                search.SetDist( nr, nc, side, newdist );
+                search.ReSetQueue( nr, nc, side, newdist,
+                                   RoutingMatrix.GetApxDist( nr, nc, row_target, col_target ),
+                                   row_target, col_target );
             }
         }
 
         /** Test the other layer. **/
         if( two_sides )
         {
-            olddir = RoutingMatrix.GetDir( r, c, side );
+            olddir = search.GetDir( r, c, side );
 
             if( olddir == FROM_OTHERSIDE )
                 continue;   /* useless move, so don't bother */
@@ -791,38 +655,603 @@ static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
             /*  if (a) not visited yet,
              *  or (b) we have found a better path,
              *  add it to queue */
-            if( !RoutingMatrix.GetDir( r, c, 1 - side ) )
+            if( !search.GetDir( r, c, 1 - side ) )
             {
-                RoutingMatrix.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
-                RoutingMatrix.SetDist( r, c, 1 - side, newdist );
+                search.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
+                search.SetDist( r, c, 1 - side, newdist );
 
-                if( SetQueue( r, c, 1 - side, newdist, apx_dist, row_target, col_target ) == 0 )
+                if( search.SetQueue( r, c, 1 - side, newdist, apx_dist,
+                                     row_target, col_target ) == 0 )
                 {
                     return ERR_MEMORY;
                 }
             }
-            else if( newdist < RoutingMatrix.GetDist( r, c, 1 - side ) )
+            else if( newdist < search.GetDist( r, c, 1 - side ) )
             {
-                RoutingMatrix.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
-                RoutingMatrix.SetDist( r, c, 1 - side, newdist );
-                ReSetQueue( r, c,
-                            1 - side,
-                            newdist,
-                            apx_dist,
-                            row_target,
-                            col_target );
+                search.SetDir( r, c, 1 - side, FROM_OTHERSIDE );
+                search.SetDist( r, c, 1 - side, newdist );
+                search.ReSetQueue( r, c,
+                                   1 - side,
+                                   newdist,
+                                   apx_dist,
+                                   row_target,
+                                   col_target );
             }
         }     /* Finished attempt to route on other layer. */
     }
 
-end_of_route:
+    return NOSUCCESS;
+}
+
+
+/* Compute the window the parallel router searches a connection in: the
+ * cells of its pads and their clearance, and room around them to go round
+ * the obstacles between the pads.
+ */
+static ROUTE_WINDOW routeWindow( const ROUTE_WORK& aWork, int marge )
+{
+    EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( aWork.m_Ratsnest->m_PadStart );
+
+    area.Merge( BOARD_SPATIAL_INDEX::ItemBoundingBox( aWork.m_Ratsnest->m_PadEnd ) );
+    area.Inflate( marge );
+
+    int          grid = RoutingMatrix.m_GridRouting;
+    wxPoint      origin = RoutingMatrix.m_BrdBox.GetOrigin();
+    ROUTE_WINDOW window;
+
+    window.m_Row0 = std::min( ( area.GetY() - origin.y ) / grid,
+                              std::min( aWork.m_FromRow, aWork.m_ToRow ) );
+    window.m_Row1 = std::max( ( area.GetBottom() - origin.y ) / grid + 1,
+                              std::max( aWork.m_FromRow, aWork.m_ToRow ) );
+    window.m_Col0 = std::min( ( area.GetX() - origin.x ) / grid,
+                              std::min( aWork.m_FromCol, aWork.m_ToCol ) );
+    window.m_Col1 = std::max( ( area.GetRight() - origin.x ) / grid + 1,
+                              std::max( aWork.m_FromCol, aWork.m_ToCol ) );
+
+    int room = std::max( 10, std::max( window.m_Row1 - window.m_Row0,
+                                       window.m_Col1 - window.m_Col0 ) / 2 );
+
+    window.m_Row0 = std::max( window.m_Row0 - room, 0 );
+    window.m_Col0 = std::max( window.m_Col0 - room, 0 );
+    window.m_Row1 = std::min( window.m_Row1 + room, RoutingMatrix.m_Nrows - 1 );
+    window.m_Col1 = std::min( window.m_Col1 + room, RoutingMatrix.m_Ncols - 1 );
+
+    return window;
+}
+
+
+/* Test if the route found by search, from the target back to the source,
+ * only crosses free cells of the board: the routes committed after the
+ * search may have taken some of them.
+ */
+static bool isRouteFree( const ROUTE_SEARCH& search,
+                         int row_source, int col_source,
+                         int row_target, int col_target, int target_side )
+{
+    int r = row_target;
+    int c = col_target;
+    int s = target_side;
+
+    while( r != row_source || c != col_source )
+    {
+        int cell = RoutingMatrix.GetCell( r, c, s );
+
+        if( ( cell & HOLE ) && !( cell & CURRENT_PAD ) )
+            return false;
+
+        switch( search.GetDir( r, c, s ) )
+        {
+        case FROM_NORTH:        r++;            break;
+        case FROM_EAST:         c++;            break;
+        case FROM_SOUTH:        r--;            break;
+        case FROM_WEST:         c--;            break;
+        case FROM_NORTHEAST:    r++; c++;       break;
+        case FROM_SOUTHEAST:    r--; c++;       break;
+        case FROM_SOUTHWEST:    r--; c--;       break;
+        case FROM_NORTHWEST:    r++; c--;       break;
+        case FROM_OTHERSIDE:    s = 1 - s;      break;
+        default:                return false;
+        }
+    }
+
+    return true;
+}
+
+
+/* Route the connections far enough from each other at the same time.
+ * The connections are taken by batches, in the work list order: a
+ * connection is in a batch if its window is far from the windows of the
+ * other connections of the batch, and of the connections before it which
+ * are left for a later batch.  Each connection of a batch is searched by a
+ * thread, in its window and with a search of its own: the threads only
+ * read the board cells.  Then the routes are committed to the board one by
+ * one, in the work list order.
+ * The connections which cannot be routed in their window, or whose route
+ * crosses a route committed before it, are put in aRetries, to be routed
+ * on the whole matrix afterwards.
+ * Returns:
+ * SUCCESS if all the connections are routed or in aRetries
+ * Escape STOP_FROM_ESC if demand
+ * ERR_MEMORY if memory allocation failed.
+ */
+static int solveInParallel( PCB_EDIT_FRAME*                pcbframe,
+                            wxDC*                          DC,
+                            int                            two_sides,
+                            const std::vector<ROUTE_WORK>& aWorks,
+                            std::vector<ROUTE_WORK>&       aRetries,
+                            int&                           aRoutedCount,
+                            int&                           aSuccessCount,
+                            int&                           aFailCount )
+{
+    BOARD*   pcb = pcbframe->GetBoard();
+    int      marge = s_Clearance + ( pcb->GetCurrentTrackWidth() / 2 );
+    int      via_marge = s_Clearance + ( pcb->GetCurrentViaSize() / 2 );
+    int      threadCount = OpenMPThreadCount();
+    wxString msg;
+
+    /* The windows of a batch are so far apart that the cells a route takes,
+     * with its clearance, are outside the windows of the other routes.
+     */
+    int gap = std::max( marge, via_marge ) / RoutingMatrix.m_GridRouting + 2;
+
+    boost::ptr_vector<ROUTE_SEARCH> searches;
+
+    for( int ii = 0; ii < threadCount; ++ii )
+        searches.push_back( new ROUTE_SEARCH );
+
+    std::vector<ROUTE_WINDOW> windows( aWorks.size() );
+    std::vector<int>          pending;  // the connections to route, in the work list order
+
+    for( unsigned ii = 0; ii < aWorks.size(); ++ii )
+    {
+        const ROUTE_WORK& work = aWorks[ii];
+
+        switch( checkConnection( pcb, work.m_FromRow, work.m_FromCol,
+                                 work.m_ToRow, work.m_ToCol, work.m_Ratsnest ) )
+        {
+        case NOSUCCESS:
+            work.m_Ratsnest->m_Status |= CH_UNROUTABLE;
+            aFailCount++;
+            aRoutedCount++;
+            break;
+
+        case TRIVIAL_SUCCESS:
+            aSuccessCount++;
+            aRoutedCount++;
+            break;
+
+        default:
+            windows[ii] = routeWindow( work, marge );
+            pending.push_back( ii );
+            break;
+        }
+    }
+
+    std::vector<int>    batch;
+    std::vector<int>    left;
+    std::vector<int>    results;
+    std::vector<int>    targetSides;
+    std::vector<D_PAD*> batchPads;
+    wxBusyCursor        dummy_cursor;   // Set an hourglass cursor while routing
+
+    while( !pending.empty() )
+    {
+        /* Test to stop routing ( escape key pressed ) */
+        wxYield();
+
+        if( pcbframe->GetCanvas()->GetAbortRequest() )
+        {
+            if( IsOK( pcbframe, _( "Abort routing?" ) ) )
+                return STOP_FROM_ESC;
+
+            pcbframe->GetCanvas()->SetAbortRequest( false );
+        }
+
+        batch.clear();
+        left.clear();
+
+        for( unsigned ii = 0; ii < pending.size(); ++ii )
+        {
+            int  work = pending[ii];
+            bool isFree = (int) batch.size() < threadCount
+                        && (int) left.size() < 16 * threadCount;
+
+            for( unsigned jj = 0; isFree && jj < batch.size(); ++jj )
+                isFree = !windows[work].Intersects( windows[ batch[jj] ], gap );
+
+            for( unsigned jj = 0; isFree && jj < left.size(); ++jj )
+                isFree = !windows[work].Intersects( windows[ left[jj] ], gap );
+
+            if( isFree )
+                batch.push_back( work );
+            else
+                left.push_back( work );
+        }
+
+        pending.swap( left );
+
+        /* Placing the bit to remove obstacles on the pads of the batch. */
+        batchPads.clear();
+
+        for( unsigned ii = 0; ii < batch.size(); ++ii )
+        {
+            RATSNEST_ITEM* pt_rat = aWorks[ batch[ii] ].m_Ratsnest;
+
+            PlacePad( pt_rat->m_PadStart, CURRENT_PAD, marge, WRITE_OR_CELL );
+            PlacePad( pt_rat->m_PadEnd, CURRENT_PAD, marge, WRITE_OR_CELL );
+            batchPads.push_back( pt_rat->m_PadStart );
+            batchPads.push_back( pt_rat->m_PadEnd );
+        }
+
+        std::sort( batchPads.begin(), batchPads.end() );
+
+        /* Regenerates the remaining barriers (which may encroach on the placement bits precedent)
+         */
+        for( unsigned ii = 0; ii < pcb->GetPadCount(); ii++ )
+        {
+            D_PAD* ptr = pcb->GetPad( ii );
+
+            if( !std::binary_search( batchPads.begin(), batchPads.end(), ptr ) )
+                PlacePad( ptr, ~CURRENT_PAD, marge, WRITE_AND_CELL );
+        }
+
+        int batchCount = batch.size();
+
+        results.assign( batchCount, NOSUCCESS );
+        targetSides.assign( batchCount, TOP );
+
+        /* The threads do not read the canvas: its abort request is read once per batch. */
+        bool abortRequest = pcbframe->GetCanvas()->GetAbortRequest();
+
+        for( int ii = 0; ii < batchCount; ++ii )
+            searches[ii].AbortRequest = abortRequest;
+
+#pragma omp parallel for schedule( dynamic, 1 )
+        for( int ii = 0; ii < batchCount; ++ii )
+        {
+            const ROUTE_WORK&   work   = aWorks[ batch[ii] ];
+            const ROUTE_WINDOW& window = windows[ batch[ii] ];
+            ROUTE_SEARCH&       search = searches[ii];
+
+            try
+            {
+                search.InitWindow( window.m_Row0, window.m_Col0,
+                                   window.m_Row1 - window.m_Row0 + 1,
+                                   window.m_Col1 - window.m_Col0 + 1 );
+
+                results[ii] = searchRoute( pcbframe, false, search, two_sides,
+                                           work.m_FromRow, work.m_FromCol,
+                                           work.m_ToRow, work.m_ToCol,
+                                           work.m_Ratsnest->m_PadStart->GetLayerMask(),
+                                           work.m_Ratsnest->m_PadEnd->GetLayerMask(),
+                                           &targetSides[ii] );
+            }
+            catch( const std::bad_alloc& )
+            {
+                results[ii] = ERR_MEMORY;
+            }
+        }
+
+        int status = SUCCESS;
+
+        for( int ii = 0; ii < batchCount; ++ii )
+        {
+            const ROUTE_WORK& work = aWorks[ batch[ii] ];
+            int               result = results[ii];
+
+            if( result == SUCCESS
+               && !isRouteFree( searches[ii], work.m_FromRow, work.m_FromCol,
+                                work.m_ToRow, work.m_ToCol, targetSides[ii] ) )
+            {
+                result = NOSUCCESS;
+            }
+
+            if( result == NOSUCCESS )
+            {
+                /* route it again later, on the whole matrix */
+                aRetries.push_back( work );
+                continue;
+            }
+
+            if( result != SUCCESS )
+            {
+                status = result;
+                continue;
+            }
+
+            pt_cur_ch = work.m_Ratsnest;
+            segm_oX = pcb->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * work.m_FromCol);
+            segm_oY = pcb->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * work.m_FromRow);
+            segm_fX = pcb->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * work.m_ToCol);
+            segm_fY = pcb->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * work.m_ToRow);
+
+            /* Generate trace. */
+            if( Retrace( pcbframe, DC, searches[ii], work.m_FromRow, work.m_FromCol,
+                         work.m_ToRow, work.m_ToCol, targetSides[ii], work.m_NetCode ) )
+            {
+                aSuccessCount++;
+            }
+            else
+            {
+                work.m_Ratsnest->m_Status |= CH_UNROUTABLE;
+                aFailCount++;
+            }
+
+            aRoutedCount++;
+
+            wxLogTrace( traceAutorouter,
+                        wxT( "Route net %d (%d,%d)-(%d,%d) in window: open %d closed %d moved %d max %d" ),
+                        work.m_NetCode, work.m_FromRow, work.m_FromCol,
+                        work.m_ToRow, work.m_ToCol,
+                        searches[ii].OpenNodes, searches[ii].ClosNodes,
+                        searches[ii].MoveNodes, searches[ii].MaxNodes );
+        }
+
+        for( unsigned ii = 0; ii < batchPads.size(); ++ii )
+            PlacePad( batchPads[ii], ~CURRENT_PAD, marge, WRITE_AND_CELL );
+
+        pcbframe->EraseMsgBox();
+        msg.Printf( wxT( "%d / %d" ), aRoutedCount, RoutingMatrix.m_RouteCount );
+        pcbframe->AppendMsgPanel( wxT( "Activity" ), msg, BROWN );
+        showRouteCounts( pcbframe, aSuccessCount, aFailCount );
+
+        if( status != SUCCESS )
+            return status;
+    }
+
+    return SUCCESS;
+}
+
+
+/* Route all traces
+ * Return:
+ *  1 if OK
+ * -1 if escape (stop being routed) request
+ * -2 if default memory allocation
+ */
+int PCB_EDIT_FRAME::Solve( wxDC* DC, int aLayersCount )
+{
+    int           current_net_code;
+    int           row_source, col_source, row_target, col_target;
+    int           success, nbsucces = 0, nbunsucces = 0;
+    NETINFO_ITEM* net;
+    bool          stop = false;
+    wxString      msg;
+    int           routedCount = 0;      // routed ratsnest count
+    bool          two_sides = aLayersCount == 2;
+    ROUTE_WORK    work;
+    std::vector<ROUTE_WORK> works;
+    ROUTE_SEARCH  search;               // the search of the serial router
+
+    m_canvas->SetAbortRequest( false );
+
+    s_Clearance = GetBoard()->m_NetClasses.GetDefault()->GetClearance();
+
+    // Prepare the undo command info
+    s_ItemsListPicker.ClearListAndDeleteItems();  // Should not be necessary, but...
+
+    for( ;; )
+    {
+        GetWork( &work.m_FromRow, &work.m_FromCol, &work.m_NetCode,
+                 &work.m_ToRow, &work.m_ToCol, &work.m_Ratsnest );
+
+        if( work.m_FromRow == ILLEGAL )
+            break;
+
+        works.push_back( work );
+    }
+
+    /* With more than one thread, the connections far enough from each other
+     * are routed at the same time first, then the others one by one.
+     */
+    if( OpenMPThreadCount() > 1 && works.size() > 1 )
+    {
+        std::vector<ROUTE_WORK> retries;
+
+        success = solveInParallel( this, DC, two_sides, works, retries,
+                                   routedCount, nbsucces, nbunsucces );
+
+        if( success != SUCCESS )
+            stop = true;
+
+        works.swap( retries );
+    }
+
+    /* go until no more work to do */
+    for( unsigned ii = 0; ii < works.size() && !stop; ii++ )
+    {
+        row_source       = works[ii].m_FromRow;
+        col_source       = works[ii].m_FromCol;
+        row_target       = works[ii].m_ToRow;
+        col_target       = works[ii].m_ToCol;
+        current_net_code = works[ii].m_NetCode;
+        pt_cur_ch        = works[ii].m_Ratsnest;
+
+        /* Test to stop routing ( escape key pressed ) */
+        wxYield();
+
+        if( m_canvas->GetAbortRequest() )
+        {
+            if( IsOK( this, _( "Abort routing?" ) ) )
+            {
+                success = STOP_FROM_ESC;
+                stop    = true;
+                break;
+            }
+            else
+            {
+                m_canvas->SetAbortRequest( false );
+            }
+        }
+
+        EraseMsgBox();
+
+        routedCount++;
+        net = GetBoard()->FindNet( current_net_code );
+
+        if( net )
+        {
+            msg.Printf( wxT( "[%8.8s]" ), GetChars( net->GetNetname() ) );
+            AppendMsgPanel( wxT( "Net route" ), msg, BROWN );
+            msg.Printf( wxT( "%d / %d" ), routedCount, RoutingMatrix.m_RouteCount );
+            AppendMsgPanel( wxT( "Activity" ), msg, BROWN );
+        }
+
+        segm_oX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_source);
+        segm_oY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_source);
+        segm_fX = GetBoard()->GetBoundingBox().GetX() + (RoutingMatrix.m_GridRouting * col_target);
+        segm_fY = GetBoard()->GetBoundingBox().GetY() + (RoutingMatrix.m_GridRouting * row_target);
+
+        /* Draw segment. */
+        GRLine( m_canvas->GetClipBox(), DC,
+                segm_oX, segm_oY, segm_fX, segm_fY,
+                0, WHITE );
+        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_OR | GR_HIGHLIGHT );
+
+        success = Autoroute_One_Track( this, DC, search,
+                                       two_sides, row_source, col_source,
+                                       row_target, col_target, pt_cur_ch );
+
+        switch( success )
+        {
+        case NOSUCCESS:
+            pt_cur_ch->m_Status |= CH_UNROUTABLE;
+            nbunsucces++;
+            break;
+
+        case STOP_FROM_ESC:
+            stop = true;
+            break;
+
+        case ERR_MEMORY:
+            stop = true;
+            break;
+
+        default:
+            nbsucces++;
+            break;
+        }
+
+        showRouteCounts( this, nbsucces, nbunsucces );
+
+        /* Delete routing from display. */
+        pt_cur_ch->m_PadStart->Draw( m_canvas, DC, GR_AND );
+        pt_cur_ch->m_PadEnd->Draw( m_canvas, DC, GR_AND );
+    }
+
+    SaveCopyInUndoList( s_ItemsListPicker, UR_UNSPECIFIED );
+    s_ItemsListPicker.ClearItemsList(); // s_ItemsListPicker is no more owner of picked items
+
+    return SUCCESS;
+}
+
+
+/* Route a trace on the BOARD.
+ * Parameters:
+ * The search to use, on the whole routing matrix
+ * 1 side / 2 sides (0 / 1)
+ * Coord source (row, col)
+ * Coord destination (row, col)
+ * Net_code
+ * Pointer to the ratsnest reference
+ *
+ * Returns:
+ * SUCCESS if routed
+ * TRIVIAL_SUCCESS if pads are connected by overlay (no track needed)
+ * If failure NOSUCCESS
+ * Escape STOP_FROM_ESC if demand
+ * ERR_MEMORY if memory allocation failed.
+ */
+static int Autoroute_One_Track( PCB_EDIT_FRAME* pcbframe,
+                                wxDC*           DC,
+                                ROUTE_SEARCH&   search,
+                                int             two_sides,
+                                int             row_source,
+                                int             col_source,
+                                int             row_target,
+                                int             col_target,
+                                RATSNEST_ITEM*  pt_rat )
+{
+    int          result;
+    int          target_side;
+    int          current_net_code = pt_rat->GetNet();
+    int          marge;
+    wxString     msg;
+
+    wxBusyCursor dummy_cursor;      // Set an hourglass cursor while routing a
+                                    // track
+
+    marge = s_Clearance + ( pcbframe->GetBoard()->GetCurrentTrackWidth() / 2 );
+
+    search.InitMatrix(); /* initialize the search queue, maps and statistics */
+
+    pt_cur_ch = pt_rat;
+
+    result = checkConnection( pcbframe->GetBoard(), row_source, col_source,
+                              row_target, col_target, pt_rat );
+
+    if( result == SUCCESS )
+    {
+        /* Placing the bit to remove obstacles on 2 pads to a link. */
+        pcbframe->SetStatusText( wxT( "Gen Cells" ) );
+
+        PlacePad( pt_cur_ch->m_PadStart, CURRENT_PAD, marge, WRITE_OR_CELL );
+        PlacePad( pt_cur_ch->m_PadEnd, CURRENT_PAD, marge, WRITE_OR_CELL );
+
+        /* Regenerates the remaining barriers (which may encroach on the placement bits precedent)
+         */
+        for( unsigned ii = 0; ii < pcbframe->GetBoard()->GetPadCount(); ii++ )
+        {
+            D_PAD* ptr = pcbframe->GetBoard()->GetPad( ii );
+
+            if( ( pt_cur_ch->m_PadStart != ptr ) && ( pt_cur_ch->m_PadEnd != ptr ) )
+            {
+                PlacePad( ptr, ~CURRENT_PAD, marge, WRITE_AND_CELL );
+            }
+        }
+
+        search.AbortRequest = pcbframe->GetCanvas()->GetAbortRequest();
+
+        result = searchRoute( pcbframe, true, search, two_sides,
+                              row_source, col_source, row_target, col_target,
+                              pt_cur_ch->m_PadStart->GetLayerMask(),
+                              pt_cur_ch->m_PadEnd->GetLayerMask(), &target_side );
+
+        if( result == SUCCESS )
+        {
+            /* Remove link. */
+            GRSetDrawMode( DC, GR_XOR );
+            GRLine( pcbframe->GetCanvas()->GetClipBox(),
+                    DC,
+                    segm_oX,
+                    segm_oY,
+                    segm_fX,
+                    segm_fY,
+                    0,
+                    WHITE );
+
+            /* Generate trace. */
+            if( !Retrace( pcbframe, DC, search, row_source, col_source,
+                          row_target, col_target, target_side, current_net_code ) )
+            {
+                result = NOSUCCESS;
+            }
+        }
+    }
+
     PlacePad( pt_cur_ch->m_PadStart, ~CURRENT_PAD, marge, WRITE_AND_CELL );
     PlacePad( pt_cur_ch->m_PadEnd, ~CURRENT_PAD, marge, WRITE_AND_CELL );
 
-    msg.Printf( wxT( "Activity: Open %d   Closed %d   Moved %d"),
-                OpenNodes, ClosNodes, MoveNodes );
+    msg.Printf( wxT( "Activity: Open %d   Closed %d   Moved %d   Max %d" ),
+                search.OpenNodes, search.ClosNodes, search.MoveNodes, search.MaxNodes );
     pcbframe->SetStatusText( msg );
 
+    wxLogTrace( traceAutorouter,
+                wxT( "Route net %d (%d,%d)-(%d,%d): result %d, open %d closed %d moved %d max %d" ),
+                current_net_code, row_source, col_source, row_target, col_target,
+                result, search.OpenNodes, search.ClosNodes, search.MoveNodes, search.MaxNodes );
+
     return result;
 }
 
@@ -937,6 +1366,7 @@ static long bit[8][9] =
  * the starting point (source)
  * The router.
  *
+ * search = the search which found the route, with its directions
  * Target_side = symbol (TOP / BOTTOM) of departure
  * = Mask_layer_source mask layers Arrival
  *
@@ -945,6 +1375,7 @@ static long bit[8][9] =
  * > 0 if Ok
  */
 static int Retrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC,
+                    const ROUTE_SEARCH& search,
                     int row_source, int col_source,
                     int row_target, int col_target, int target_side,
                     int current_net_code )
@@ -966,7 +1397,7 @@ static int Retrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC,
     {
         /* find where we came from to get here */
         r2 = r1; c2 = c1; s2 = s1;
-        x  = RoutingMatrix.GetDir( r1, c1, s1 );
+        x  = search.GetDir( r1, c1, s1 );
 
         switch( x )
         {
@@ -1016,7 +1447,7 @@ static int Retrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC,
         }
 
         if( r0 != ILLEGAL )
-            y = RoutingMatrix.GetDir( r0, c0, s0 );
+            y = search.GetDir( r0, c0, s0 );
 
         /* see if target or hole */
         if( ( ( r1 == row_target ) && ( c1 == col_target ) ) || ( s1 != s0 ) )
@@ -1272,7 +1703,6 @@ static void AddNewTrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC )
     int dx0, dy0, dx1, dy1;
     int marge, via_marge;
     EDA_DRAW_PANEL* panel = pcbframe->GetCanvas();
-    PCB_SCREEN* screen = pcbframe->GetScreen();
 
     marge = s_Clearance + ( pcbframe->GetBoard()->GetCurrentTrackWidth() / 2 );
     via_marge = s_Clearance + ( pcbframe->GetBoard()->GetCurrentViaSize() / 2 );
@@ -1336,5 +1766,6 @@ static void AddNewTrace( PCB_EDIT_FRAME* pcbframe, wxDC* DC )
 
     pcbframe->TestNetConnection( DC, netcode );
 
-    screen->SetModify();
+    // the new tracks are not in the spatial index of the board
+    pcbframe->OnModify();
 }
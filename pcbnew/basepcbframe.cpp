@@ -42,6 +42,7 @@
 #include <pcbnew.h>
 #include <pcbnew_id.h>
 #include <class_board.h>
+#include <io_mgr.h>
 
 #include <collectors.h>
 #include <class_drawpanel.h>
@@ -102,12 +103,15 @@ PCB_BASE_FRAME::PCB_BASE_FRAME( wxWindow* aParent, ID_DRAWFRAME_TYPE aFrameType,
     m_FastGrid2           = 0;
 
     m_auxiliaryToolBar    = NULL;
+
+    m_footprintLibPlugin  = NULL;
 }
 
 
 PCB_BASE_FRAME::~PCB_BASE_FRAME()
 {
     delete m_Collector;
+    IO_MGR::PluginRelease( m_footprintLibPlugin );
 
     delete m_Pcb;       // is already NULL for FOOTPRINT_EDIT_FRAME
 }
@@ -748,6 +752,9 @@ void PCB_BASE_FRAME::OnModify()
 
     wxASSERT( m_Pcb );
     m_Pcb->GetTitleBlock().SetDate();
+
+    // items may have been moved in place, the next use of the index finds them
+    m_Pcb->InvalidateSpatialIndex();
 }
 
 
@@ -0,0 +1,481 @@
+/**
+ * @file board_spatial_index.cpp
+ * @brief a uniform grid spatial index of the copper items of a BOARD.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <fctsys.h>
+#include <convert_to_biu.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_zone.h>
+
+#include <board_spatial_index.h>
+
+
+/// Items covering more cells than this are kept in the "large" list.
+#define MAX_CELLS_PER_ITEM  64
+
+/// The cells are compacted when they hold more dead entries than this, and
+/// than live ones.
+#define MIN_DEAD_ENTRIES    256
+
+/// The index is built again when the board has this many times the items its
+/// cell size was chosen for.
+#define MAX_GROWTH          4
+
+
+// EDA_RECT::Intersects() normalizes copies of both rectangles on each call,
+// the index only stores normalized boxes.
+static inline bool intersects( const EDA_RECT& a, const EDA_RECT& b )
+{
+    return a.GetX() <= b.GetRight() && b.GetX() <= a.GetRight()
+        && a.GetY() <= b.GetBottom() && b.GetY() <= a.GetBottom();
+}
+
+
+static inline bool sameBox( const EDA_RECT& a, const EDA_RECT& b )
+{
+    return a.GetOrigin() == b.GetOrigin() && a.GetSize() == b.GetSize();
+}
+
+
+static bool isWantedType( KICAD_T aType, const KICAD_T aScanTypes[] )
+{
+    if( !aScanTypes )
+        return true;
+
+    for( const KICAD_T* p = aScanTypes;  *p != EOT;  ++p )
+    {
+        if( *p == aType )
+            return true;
+    }
+
+    return false;
+}
+
+
+BOARD_SPATIAL_INDEX::BOARD_SPATIAL_INDEX()
+{
+    m_cellSize   = 0;
+    m_builtCount = 0;
+    m_stale      = false;
+}
+
+
+void BOARD_SPATIAL_INDEX::Clear()
+{
+    m_cellSize   = 0;
+    m_builtCount = 0;
+    m_stale      = false;
+    m_entries.clear();
+    m_cells.clear();
+    m_large.clear();
+    m_itemMap.clear();
+}
+
+
+EDA_RECT BOARD_SPATIAL_INDEX::ItemBoundingBox( const BOARD_ITEM* aItem )
+{
+    EDA_RECT bbox;
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        {
+            const TRACK* track = (const TRACK*) aItem;
+            int radius = ( track->GetWidth() + 1 ) / 2;
+
+            bbox.SetOrigin( track->GetStart() );
+
+            if( aItem->Type() == PCB_TRACE_T )
+                bbox.SetEnd( track->GetEnd() );
+
+            bbox.Normalize();
+            bbox.Inflate( radius );
+        }
+        break;
+
+    case PCB_PAD_T:
+        {
+            D_PAD* pad = (D_PAD*) aItem;
+
+            // D_PAD::GetBoundingBox() is centered on the pad position and
+            // ignores the shape offset, and a hole can be larger than its pad.
+            bbox.SetOrigin( pad->ReturnShapePos() );
+            bbox.Inflate( pad->GetBoundingRadius() );
+
+            wxSize drill = pad->GetDrillSize();
+
+            if( drill.x > 0 || drill.y > 0 )
+            {
+                EDA_RECT hole( pad->GetPosition(), wxSize( 0, 0 ) );
+                hole.Inflate( std::max( drill.x, drill.y ) / 2 + 1 );
+                bbox.Merge( hole );
+            }
+        }
+        break;
+
+    case PCB_ZONE_AREA_T:
+        bbox = ( (const ZONE_CONTAINER*) aItem )->GetBoundingBox();
+        bbox.Normalize();
+        break;
+
+    default:
+        bbox = aItem->GetBoundingBox();
+        bbox.Normalize();
+        break;
+    }
+
+    return bbox;
+}
+
+
+void BOARD_SPATIAL_INDEX::Build( BOARD* aBoard )
+{
+    Clear();
+
+    // First pass: the extent and the count of the items, to choose a cell size
+    // which puts a few items in each cell on a uniformly populated board.
+    EDA_RECT    extent;
+    int         count = 0;
+
+    for( TRACK* track = aBoard->m_Track;  track;  track = track->Next() )
+    {
+        EDA_RECT bbox = ItemBoundingBox( track );
+
+        if( count++ == 0 )
+            extent = bbox;
+        else
+            extent.Merge( bbox );
+    }
+
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->m_Pads;  pad;  pad = pad->Next() )
+        {
+            EDA_RECT bbox = ItemBoundingBox( pad );
+
+            if( count++ == 0 )
+                extent = bbox;
+            else
+                extent.Merge( bbox );
+        }
+    }
+
+    double cellSize = Millimeter2iu( 5.0 );
+
+    if( count )
+        cellSize = 2.0 * sqrt( extent.GetArea() / count );
+
+    m_cellSize   = std::max( (int) cellSize, Millimeter2iu( 0.25 ) );
+    m_builtCount = count;
+
+    // Second pass: the insertion order gives the query order, keep it the
+    // order of the board lists.
+    for( TRACK* track = aBoard->m_Track;  track;  track = track->Next() )
+        insertEntry( track );
+
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->m_Pads;  pad;  pad = pad->Next() )
+            insertEntry( pad );
+    }
+
+    for( int ii = 0;  ii < aBoard->GetAreaCount();  ii++ )
+        insertEntry( aBoard->GetArea( ii ) );
+}
+
+
+void BOARD_SPATIAL_INDEX::Update( BOARD* aBoard )
+{
+    if( !IsBuilt() )
+        return;
+
+    int count = aBoard->m_Track.GetCount();
+
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+        count += module->m_Pads.GetCount();
+
+    // a board filled since the index was built: the cells would be crowded
+    if( count > MAX_GROWTH * std::max( m_builtCount, MIN_DEAD_ENTRIES ) )
+    {
+        Build( aBoard );
+        return;
+    }
+
+    std::vector<bool> seen( m_entries.size(), false );
+
+    for( TRACK* track = aBoard->m_Track;  track;  track = track->Next() )
+        updateEntry( track, seen );
+
+    for( MODULE* module = aBoard->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->m_Pads;  pad;  pad = pad->Next() )
+            updateEntry( pad, seen );
+    }
+
+    for( int ii = 0;  ii < aBoard->GetAreaCount();  ii++ )
+        updateEntry( aBoard->GetArea( ii ), seen );
+
+    // The items not found on the board were unlinked, and may be deleted.
+    for( unsigned ii = 0;  ii < seen.size();  ++ii )
+    {
+        if( !seen[ii] && m_entries[ii].m_Item )
+        {
+            m_itemMap.erase( m_entries[ii].m_Item );
+            m_entries[ii].m_Item = NULL;
+        }
+    }
+
+    compact();
+
+    m_stale = false;
+}
+
+
+void BOARD_SPATIAL_INDEX::updateEntry( BOARD_ITEM* aItem, std::vector<bool>& aSeen )
+{
+    ITEM_MAP::const_iterator it = m_itemMap.find( aItem );
+
+    // an other item can have the address of an item deleted since it was indexed
+    if( it != m_itemMap.end() )
+    {
+        const ENTRY& entry = m_entries[it->second];
+
+        if( entry.m_Type == aItem->Type() && sameBox( entry.m_BBox, ItemBoundingBox( aItem ) ) )
+        {
+            aSeen[it->second] = true;
+            return;
+        }
+    }
+
+    // the new entry is the last one
+    insertEntry( aItem );
+    aSeen.push_back( true );
+}
+
+
+void BOARD_SPATIAL_INDEX::Insert( BOARD_ITEM* aItem )
+{
+    if( !IsBuilt() )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+        for( D_PAD* pad = ( (MODULE*) aItem )->m_Pads;  pad;  pad = pad->Next() )
+            insertEntry( pad );
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+    case PCB_ZONE_AREA_T:
+        insertEntry( aItem );
+        break;
+
+    default:
+        break;
+    }
+
+    compact();
+}
+
+
+void BOARD_SPATIAL_INDEX::Remove( BOARD_ITEM* aItem )
+{
+    if( !IsBuilt() )
+        return;
+
+    if( aItem->Type() == PCB_MODULE_T )
+    {
+        for( D_PAD* pad = ( (MODULE*) aItem )->m_Pads;  pad;  pad = pad->Next() )
+            removeEntry( pad );
+    }
+    else
+    {
+        removeEntry( aItem );
+    }
+
+    compact();
+}
+
+
+void BOARD_SPATIAL_INDEX::insertEntry( BOARD_ITEM* aItem )
+{
+    // an item is indexed only once, re-inserting it refreshes its box
+    removeEntry( aItem );
+
+    unsigned    index = m_entries.size();
+    ENTRY       entry;
+
+    entry.m_Item = aItem;
+    entry.m_Type = aItem->Type();
+    entry.m_BBox = ItemBoundingBox( aItem );
+
+    m_entries.push_back( entry );
+    m_itemMap[aItem] = index;
+
+    addToCells( index );
+}
+
+
+void BOARD_SPATIAL_INDEX::addToCells( unsigned aIndex )
+{
+    const EDA_RECT& bbox = m_entries[aIndex].m_BBox;
+
+    int x0 = cellCoord( bbox.GetX() );
+    int y0 = cellCoord( bbox.GetY() );
+    int x1 = cellCoord( bbox.GetRight() );
+    int y1 = cellCoord( bbox.GetBottom() );
+
+    if( double( x1 - x0 + 1 ) * double( y1 - y0 + 1 ) > MAX_CELLS_PER_ITEM )
+    {
+        m_large.push_back( aIndex );
+        return;
+    }
+
+    for( int x = x0;  x <= x1;  ++x )
+    {
+        for( int y = y0;  y <= y1;  ++y )
+            m_cells[ cellKey( x, y ) ].push_back( aIndex );
+    }
+}
+
+
+void BOARD_SPATIAL_INDEX::removeEntry( const BOARD_ITEM* aItem )
+{
+    ITEM_MAP::iterator it = m_itemMap.find( aItem );
+
+    if( it == m_itemMap.end() )
+        return;
+
+    // the cells keep the entry index until compact(), Query() skips removed entries.
+    m_entries[it->second].m_Item = NULL;
+    m_itemMap.erase( it );
+}
+
+
+void BOARD_SPATIAL_INDEX::compact()
+{
+    unsigned live = m_itemMap.size();
+    unsigned dead = m_entries.size() - live;
+
+    if( dead <= std::max( live, (unsigned) MIN_DEAD_ENTRIES ) )
+        return;
+
+    // the live entries keep their order, so does Query()
+    std::vector<ENTRY> entries;
+
+    entries.reserve( live );
+
+    for( unsigned ii = 0;  ii < m_entries.size();  ++ii )
+    {
+        if( m_entries[ii].m_Item )
+            entries.push_back( m_entries[ii] );
+    }
+
+    m_entries.swap( entries );
+    m_cells.clear();
+    m_large.clear();
+    m_itemMap.clear();
+
+    for( unsigned ii = 0;  ii < m_entries.size();  ++ii )
+    {
+        m_itemMap[ m_entries[ii].m_Item ] = ii;
+        addToCells( ii );
+    }
+}
+
+
+void BOARD_SPATIAL_INDEX::Query( const EDA_RECT& aArea, std::vector<BOARD_ITEM*>& aResult,
+                                 const KICAD_T aScanTypes[] ) const
+{
+    if( !IsBuilt() )
+        return;
+
+    EDA_RECT area = aArea;
+    area.Normalize();
+
+    int x0 = cellCoord( area.GetX() );
+    int y0 = cellCoord( area.GetY() );
+    int x1 = cellCoord( area.GetRight() );
+    int y1 = cellCoord( area.GetBottom() );
+
+    std::vector<unsigned> found;
+
+    if( double( x1 - x0 + 1 ) * double( y1 - y0 + 1 ) > double( m_cells.size() ) )
+    {
+        // The area covers more cells than are populated, walking the entries
+        // is cheaper than probing mostly empty cells.
+        found.reserve( m_entries.size() );
+
+        for( unsigned ii = 0;  ii < m_entries.size();  ++ii )
+            found.push_back( ii );
+    }
+    else
+    {
+        for( int x = x0;  x <= x1;  ++x )
+        {
+            for( int y = y0;  y <= y1;  ++y )
+            {
+                CELLS::const_iterator cell = m_cells.find( cellKey( x, y ) );
+
+                if( cell != m_cells.end() )
+                    found.insert( found.end(), cell->second.begin(), cell->second.end() );
+            }
+        }
+
+        found.insert( found.end(), m_large.begin(), m_large.end() );
+
+        // an item spanning several cells is found once per cell
+        std::sort( found.begin(), found.end() );
+        found.erase( std::unique( found.begin(), found.end() ), found.end() );
+    }
+
+    for( unsigned ii = 0;  ii < found.size();  ++ii )
+    {
+        const ENTRY& entry = m_entries[ found[ii] ];
+
+        if( !entry.m_Item )
+            continue;
+
+        if( !intersects( entry.m_BBox, area ) )
+            continue;
+
+        if( !isWantedType( entry.m_Type, aScanTypes ) )
+            continue;
+
+        aResult.push_back( entry.m_Item );
+    }
+}
@@ -0,0 +1,211 @@
+/**
+ * @file board_spatial_index.h
+ * @brief a uniform grid spatial index of the copper items of a BOARD.
+ */
+
+#ifndef BOARD_SPATIAL_INDEX_H_
+#define BOARD_SPATIAL_INDEX_H_
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <vector>
+
+// fix a compile bug at line 97 of boost/detail/container_fwd.hpp
+#define BOOST_DETAIL_TEST_FORCE_CONTAINER_FWD
+
+#include <boost/unordered_map.hpp>
+
+#include <base_struct.h>
+
+
+class BOARD;
+class BOARD_ITEM;
+
+
+/**
+ * Class BOARD_SPATIAL_INDEX
+ * is a uniform grid over the tracks, vias, pads and zone outlines of a BOARD.
+ * <p>
+ * Each item is registered in every grid cell its bounding box overlaps, so a
+ * rectangular query only has to look at the items of the cells it covers
+ * instead of walking the whole track list.  Items whose bounding box is very
+ * large compared to a cell (zone outlines mostly) are kept in a separate
+ * list which every query walks.
+ * </p><p>
+ * The index stores the bounding box an item had when it was inserted, and
+ * items can be moved in place without the BOARD knowing about it.  The BOARD
+ * keeps the index current for BOARD::Add() and BOARD::Remove(), and marks it
+ * stale in BOARD_ITEM::UnLink() and PCB_BASE_FRAME::OnModify(); users get it
+ * through BOARD::GetSpatialIndex(), which then calls Update() to index again
+ * only the items which were moved, added or removed.
+ * </p><p>
+ * Removed items leave a dead entry in the cells until there are as many dead
+ * entries as live ones, then the cells are compacted.
+ * </p><p>
+ * Query() returns items in their insertion order, which for a freshly built
+ * index is the order of BOARD::m_Track, then the pads, then the zones.  An
+ * item indexed again goes to the end of this order.
+ * </p>
+ */
+class BOARD_SPATIAL_INDEX
+{
+public:
+    BOARD_SPATIAL_INDEX();
+
+    /**
+     * Function Build
+     * empties the index, then inserts all the tracks, vias, pads and zone
+     * outlines of \a aBoard.  The cell size is chosen from the board size and
+     * its item count.
+     * @param aBoard is the board to index.
+     */
+    void Build( BOARD* aBoard );
+
+    /**
+     * Function Clear
+     * empties the index.  IsBuilt() returns false afterwards.
+     */
+    void Clear();
+
+    /**
+     * Function IsBuilt
+     * @return bool - true if Build() has been called since the last Clear().
+     */
+    bool IsBuilt() const { return m_cellSize > 0; }
+
+    /**
+     * Function Invalidate
+     * tells the index that items may have been moved in place, or unlinked from
+     * the board lists, since they were indexed.  The index is kept, IsStale()
+     * returns true until the next Update().
+     */
+    void Invalidate() { m_stale = true; }
+
+    /**
+     * Function IsStale
+     * @return bool - true if Invalidate() has been called since the last Update().
+     */
+    bool IsStale() const { return m_stale; }
+
+    /**
+     * Function Update
+     * compares the items of \a aBoard to the index: the items whose bounding box
+     * changed are indexed again, the new items are indexed, and the items which
+     * are not on the board any more are removed without being dereferenced.
+     * The index is built again if the board grew too much for its cell size.
+     * @param aBoard is the indexed board.
+     */
+    void Update( BOARD* aBoard );
+
+    /**
+     * Function Insert
+     * adds \a aItem to the index.  A MODULE is not indexed itself, its pads are.
+     * Items of other types than those handled by Build() are ignored, as is
+     * everything while the index is not built.
+     * @param aItem is the item to add.
+     */
+    void Insert( BOARD_ITEM* aItem );
+
+    /**
+     * Function Remove
+     * removes \a aItem (or the pads of a MODULE) from the index.  Items which
+     * are not indexed are ignored.
+     * @param aItem is the item to remove.
+     */
+    void Remove( BOARD_ITEM* aItem );
+
+    /**
+     * Function Query
+     * collects the indexed items whose bounding box intersects \a aArea.
+     * @param aArea is the area to search, in internal units.
+     * @param aResult is where to append the items found, in insertion order.
+     * @param aScanTypes is an EOT terminated list of the item types wanted,
+     *                   or NULL for all indexed types.
+     */
+    void Query( const EDA_RECT& aArea, std::vector<BOARD_ITEM*>& aResult,
+                const KICAD_T aScanTypes[] = NULL ) const;
+
+    /**
+     * Function GetCount
+     * @return int - the number of items currently indexed.
+     */
+    int GetCount() const { return (int) m_itemMap.size(); }
+
+    /**
+     * Function ItemBoundingBox
+     * returns the box used to index \a aItem: the copper of a track or via
+     * without any clearance, the shape and the hole of a pad, the outline of
+     * a zone.  It does not depend on display options, unlike GetBoundingBox().
+     */
+    static EDA_RECT ItemBoundingBox( const BOARD_ITEM* aItem );
+
+private:
+    struct ENTRY
+    {
+        BOARD_ITEM* m_Item;         ///< NULL once the item has been removed
+        KICAD_T     m_Type;         ///< type of m_Item, filtering does not dereference it
+        EDA_RECT    m_BBox;         ///< bounding box at insertion time
+    };
+
+    typedef boost::unordered_map< unsigned long long, std::vector<unsigned> > CELLS;
+    typedef boost::unordered_map< const BOARD_ITEM*, unsigned > ITEM_MAP;
+
+    int                 m_cellSize;     ///< grid pitch in internal units, 0 = not built
+    int                 m_builtCount;   ///< the item count the cell size was chosen for
+    bool                m_stale;        ///< see Invalidate()
+    std::vector<ENTRY>  m_entries;      ///< indexed items, the index in this list is the sequence
+    CELLS               m_cells;        ///< grid cell -> entry indices
+    std::vector<unsigned> m_large;      ///< entries too large to be put in cells
+    ITEM_MAP            m_itemMap;      ///< item -> entry index
+
+    void insertEntry( BOARD_ITEM* aItem );
+    void removeEntry( const BOARD_ITEM* aItem );
+
+    /// adds the entry \a aIndex to the cells its box overlaps, or to m_large
+    void addToCells( unsigned aIndex );
+
+    /**
+     * Function updateEntry
+     * indexes \a aItem again if its box changed, or if it is not indexed.
+     * @param aSeen = the entries of the items found on the board, to be updated.
+     */
+    void updateEntry( BOARD_ITEM* aItem, std::vector<bool>& aSeen );
+
+    /// removes the dead entries from the cells, once they are as many as the live ones
+    void compact();
+
+    /// @return the grid coordinate of board coordinate \a aCoord
+    int cellCoord( int aCoord ) const
+    {
+        // round toward -infinity so that cells are all the same size around 0
+        return aCoord >= 0 ? aCoord / m_cellSize : -( ( -aCoord - 1 ) / m_cellSize ) - 1;
+    }
+
+    static unsigned long long cellKey( int aCellX, int aCellY )
+    {
+        return ( (unsigned long long) (unsigned) aCellX << 32 ) | (unsigned) aCellY;
+    }
+};
+
+#endif  // BOARD_SPATIAL_INDEX_H_
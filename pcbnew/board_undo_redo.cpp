@@ -33,6 +33,7 @@
 
 #include <pcbnew.h>
 #include <wxPcbStruct.h>
+#include <drc_stuff.h>
 
 #include <class_board.h>
 #include <class_track.h>
@@ -335,6 +336,9 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( BOARD_ITEM*    aItem,
     if( aItem == NULL )     // Nothing to save
         return;
 
+    // the next DRC tests again what is around the item before its change
+    m_drc->MarkDirty( aItem );
+
     PICKED_ITEMS_LIST* commandToUndo = new PICKED_ITEMS_LIST();
 
     commandToUndo->m_TransformPoint = aTransformPoint;
@@ -416,6 +420,8 @@ void PCB_EDIT_FRAME::SaveCopyInUndoList( PICKED_ITEMS_LIST& aItemsList,
 
         wxASSERT( item );
 
+        m_drc->MarkDirty( item );
+
         switch( command )
         {
         case UR_CHANGED:
@@ -516,6 +522,9 @@ void PCB_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool aRed
 
         item->ClearFlags();
 
+        // the next DRC tests again what is around the item before its change
+        m_drc->MarkDirty( item );
+
         // see if we must rebuild ratsnets and pointers lists
         switch( item->Type() )
         {
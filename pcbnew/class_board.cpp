@@ -824,8 +824,10 @@ void BOARD::Add( BOARD_ITEM* aBoardItem, int aControl )
                         aBoardItem->Type() );
             wxFAIL_MSG( msg );
         }
-        break;
+        return;
     }
+
+    m_spatialIndex.Insert( aBoardItem );
 }
 
 
@@ -889,6 +891,8 @@ BOARD_ITEM* BOARD::Remove( BOARD_ITEM* aBoardItem )
         wxFAIL_MSG( wxT( "BOARD::Remove() needs more ::Type() support" ) );
     }
 
+    m_spatialIndex.Remove( aBoardItem );
+
     return aBoardItem;
 }
 
@@ -932,6 +936,31 @@ unsigned BOARD::GetNodesCount() const
 }
 
 
+void BOARD::UpdateUnconnectedNetCount( const NETINFO_ITEM* aNet, unsigned aWasActive )
+{
+    if( m_unconnectedNetCount < aWasActive )
+    {
+        m_unconnectedNetCount = 0;
+
+        for( unsigned ii = 0; ii < m_FullRatsnest.size(); ii++ )
+        {
+            if( m_FullRatsnest[ii].IsActive() )
+                m_unconnectedNetCount++;
+        }
+
+        return;
+    }
+
+    m_unconnectedNetCount -= aWasActive;
+
+    for( unsigned ii = aNet->m_RatsnestStartIdx; ii < aNet->m_RatsnestEndIdx; ii++ )
+    {
+        if( m_FullRatsnest[ii].IsActive() )
+            m_unconnectedNetCount++;
+    }
+}
+
+
 EDA_RECT BOARD::ComputeBoundingBox( bool aBoardEdgesOnly )
 {
     bool hasItems = false;
@@ -18,6 +18,7 @@
 #include <class_title_block.h>
 #include <class_zone_settings.h>
 #include <pcb_plot_params.h>
+#include <board_spatial_index.h>
 
 
 class PCB_BASE_FRAME;
@@ -225,6 +226,9 @@ private:
     // Index for m_TrackWidthList to select the value.
     unsigned                m_trackWidthIndex;
 
+    /// Spatial index of tracks, vias, pads and zones, see GetSpatialIndex().
+    BOARD_SPATIAL_INDEX     m_spatialIndex;
+
     /**
      * Function chainMarkedSegments
      * is used by MarkTrace() to set the BUSY flag of connected segments of the trace
@@ -257,6 +261,10 @@ public:
     /// Ratsnest list for the BOARD
     std::vector<RATSNEST_ITEM>  m_FullRatsnest;
 
+    /// Minimum spanning trees of the nets, reused by Build_Board_Ratsnest()
+    /// for the nets whose pads did not change.
+    RATSNEST_CACHE              m_RatsnestCache;
+
     /// Ratsnest list relative to a given footprint (used while moving a footprint).
     std::vector<RATSNEST_ITEM>  m_LocalRatsnest;
 
@@ -710,6 +718,17 @@ public:
      */
     void SetUnconnectedNetCount( unsigned aCount ) { m_unconnectedNetCount = aCount; }
 
+    /**
+     * Function UpdateUnconnectedNetCount
+     * updates the number of unconnected nets after the active links of the ratsnest
+     * of \a aNet were computed again.
+     * @param aNet is the net of which the links changed.
+     * @param aWasActive is the number of links of \a aNet which were active before.
+     * If the number of unconnected nets is less than \a aWasActive, the links
+     * were changed without it, and it is counted again on all the ratsnest.
+     */
+    void UpdateUnconnectedNetCount( const NETINFO_ITEM* aNet, unsigned aWasActive );
+
     /**
      * Function SetCurrentNetClassName
      * sets the current net class name to \a aName.
@@ -904,6 +923,32 @@ public:
      */
     int GetSmallestClearanceValue();
 
+    /**
+     * Function GetSpatialIndex
+     * returns the spatial index of the tracks, vias, pads and zone outlines of
+     * this board, building it the first time, and updating the items changed
+     * if it was invalidated since its last use.
+     * @return const BOARD_SPATIAL_INDEX& - the index, valid until the board
+     *         is modified other than by Add() or Remove().
+     */
+    const BOARD_SPATIAL_INDEX& GetSpatialIndex()
+    {
+        if( !m_spatialIndex.IsBuilt() )
+            m_spatialIndex.Build( this );
+        else if( m_spatialIndex.IsStale() )
+            m_spatialIndex.Update( this );
+
+        return m_spatialIndex;
+    }
+
+    /**
+     * Function InvalidateSpatialIndex
+     * must be called after items were moved, or linked in or out of the board
+     * lists without using Add() or Remove(), so that the next
+     * GetSpatialIndex() indexes these items again.  BOARD_ITEM::UnLink() calls it.
+     */
+    void InvalidateSpatialIndex() { m_spatialIndex.Invalidate(); }
+
     /**
      * Function GetTrackWidthIndex
      * @return the current track width list index.
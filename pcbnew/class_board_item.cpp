@@ -57,6 +57,25 @@ void BOARD_ITEM::UnLink()
 
     if( list )
         list->Remove( this );
+
+    // The spatial index of the board may hold this item, or the pads of this module.
+    switch( Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+    case PCB_MODULE_T:
+        {
+            BOARD* board = GetBoard();
+
+            if( board )
+                board->InvalidateSpatialIndex();
+        }
+        break;
+
+    default:
+        break;
+    }
 }
 
 
@@ -86,9 +105,86 @@ wxString BOARD_ITEM::GetLayerName() const
 }
 
 
+/**
+ * Function formatUnsigned
+ * writes the decimal digits of \a aValue to \a aBuffer, without a null.
+ * @return int - the count of digits.
+ */
+static int formatUnsigned( char* aBuffer, unsigned aValue )
+{
+    char    digits[12];
+    int     count = 0;
+
+    do
+    {
+        digits[count++] = '0' + aValue % 10;
+        aValue /= 10;
+    } while( aValue );
+
+    for( int ii = 0;  ii < count;  ++ii )
+        aBuffer[ii] = digits[count - 1 - ii];
+
+    return count;
+}
+
+
 std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 {
-    char buf[50];
+    char buf[FMT_IU_BUFSIZE];
+
+    int len = FormatInternalUnits( buf, aValue );
+
+    return std::string( buf, len );
+}
+
+
+int BOARD_ITEM::FormatInternalUnits( char* aBuffer, int aValue )
+{
+    if( IU_PER_MM == 1e6 )
+    {
+        // In nanometers, aValue in mm has 10 significant digits at most, which the
+        // "%.10g" and "%.10f" below print exactly: the integer part, then the fraction
+        // without its trailing zeros are the same text.
+        const unsigned NM_PER_MM = 1000000;
+        const int      NM_DIGITS = 6;
+
+        char*       out = aBuffer;
+        unsigned    value = aValue;
+
+        if( aValue < 0 )
+        {
+            *out++ = '-';
+            value  = 0u - value;
+        }
+
+        out += formatUnsigned( out, value / NM_PER_MM );
+
+        unsigned    fraction = value % NM_PER_MM;
+
+        if( fraction )
+        {
+            int     count = NM_DIGITS;
+
+            while( fraction % 10 == 0 )
+            {
+                fraction /= 10;
+                --count;
+            }
+
+            *out++ = '.';
+
+            for( int ii = count - 1;  ii >= 0;  --ii )
+            {
+                out[ii]   = '0' + fraction % 10;
+                fraction /= 10;
+            }
+
+            out += count;
+        }
+
+        *out = '\0';
+        return out - aBuffer;
+    }
 
     double  mm = aValue / IU_PER_MM;
 
@@ -96,32 +192,64 @@ std::string BOARD_ITEM::FormatInternalUnits( int aValue )
 
     if( mm != 0.0 && fabs( mm ) <= 0.0001 )
     {
-        len = sprintf( buf, "%.10f", mm );
+        len = sprintf( aBuffer, "%.10f", mm );
 
-        while( --len > 0 && buf[len] == '0' )
-            buf[len] = '\0';
+        while( --len > 0 && aBuffer[len] == '0' )
+            aBuffer[len] = '\0';
 
         ++len;
     }
     else
     {
-        len = sprintf( buf, "%.10g", mm );
+        len = sprintf( aBuffer, "%.10g", mm );
     }
 
-    return std::string( buf, len );
+    return len;
 }
 
 
 std::string BOARD_ITEM::FormatAngle( double aAngle )
 {
-    char temp[50];
+    char temp[FMT_IU_BUFSIZE];
 
-    int len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
+    int len = FormatAngle( temp, aAngle );
 
     return std::string( temp, len );
 }
 
 
+int BOARD_ITEM::FormatAngle( char* aBuffer, double aAngle )
+{
+    // Angles are most often whole tenths of degree, printed by "%.10g" as their
+    // integer part and at most one decimal.  Zero is left to snprintf() for its sign.
+    if( aAngle != 0.0 && fabs( aAngle ) < 1e9 && aAngle == (int) aAngle )
+    {
+        int         tenths = (int) aAngle;
+        char*       out = aBuffer;
+        unsigned    value = tenths;
+
+        if( tenths < 0 )
+        {
+            *out++ = '-';
+            value  = 0u - value;
+        }
+
+        out += formatUnsigned( out, value / 10 );
+
+        if( value % 10 )
+        {
+            *out++ = '.';
+            *out++ = '0' + value % 10;
+        }
+
+        *out = '\0';
+        return out - aBuffer;
+    }
+
+    return snprintf( aBuffer, FMT_IU_BUFSIZE, "%.10g", aAngle / 10.0 );
+}
+
+
 std::string BOARD_ITEM::FormatInternalUnits( const wxPoint& aPoint )
 {
     return FormatInternalUnits( aPoint.x ) + " " + FormatInternalUnits( aPoint.y );
@@ -378,12 +378,16 @@ EDA_RECT DRAWSEGMENT::GetBoundingBox() const
         break;
 
     case S_ARC:
-        {
-            bbox.Merge( m_End );
-            wxPoint end = m_End;
-            RotatePoint( &end, m_Start, -m_Angle );
-            bbox.Merge( end );
-        }
+        // The box of the center and of the ends misses the part of the arc
+        // crossing an axis, use the whole circle: a box is never too small.
+        bbox.Inflate( GetRadius() );
+        break;
+
+    case S_CURVE:
+        // a Bezier curve is inside the polygon of its control points
+        bbox.Merge( m_BezierC1 );
+        bbox.Merge( m_BezierC2 );
+        bbox.Merge( m_End );
         break;
 
     case S_POLYGON:
@@ -591,6 +591,31 @@ D_PAD* MODULE::GetPad( const wxPoint& aPosition, int aLayerMask )
 }
 
 
+size_t MODULE::GetMemorySize() const
+{
+    size_t size = sizeof( MODULE ) + 2 * sizeof( TEXTE_MODULE );
+
+    for( const D_PAD* pad = m_Pads;  pad;  pad = pad->Next() )
+        size += sizeof( D_PAD );
+
+    for( const BOARD_ITEM* item = m_Drawings;  item;  item = item->Next() )
+    {
+        if( item->Type() == PCB_MODULE_EDGE_T )
+        {
+            const EDGE_MODULE* edge = (const EDGE_MODULE*) item;
+
+            size += sizeof( EDGE_MODULE ) + edge->GetPolyPoints().size() * sizeof( wxPoint );
+        }
+        else
+        {
+            size += sizeof( TEXTE_MODULE );
+        }
+    }
+
+    return size;
+}
+
+
 void MODULE::Add3DModel( S3D_MASTER* a3DModel )
 {
     a3DModel->SetParent( this );
@@ -323,6 +323,14 @@ public:
      */
     unsigned GetPadCount() const            { return m_Pads.GetCount() ; }
 
+    /**
+     * Function GetMemorySize
+     * returns an estimation of the memory used by the module, its texts, pads
+     * and drawings, used to bound the footprint library caches.
+     * @return size_t - the size in bytes.
+     */
+    size_t GetMemorySize() const;
+
     /**
      * Function Add3DModel
      * adds \a a3DModel definition to the end of the 3D model list.
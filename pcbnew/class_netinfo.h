@@ -11,6 +11,7 @@
 
 
 #include <vector>
+#include <map>
 #include <gr_basic.h>
 #include <class_netclass.h>
 
@@ -91,6 +92,25 @@ public:
 };
 
 
+/**
+ * Struct RATSNEST_NET_TREE
+ * is the minimum spanning tree Build_Board_Ratsnest() computed for a net,
+ * with the pads it was computed from.  The tree is reused as long as the net
+ * has the same pads, in the same order and at the same positions.
+ */
+struct RATSNEST_NET_TREE
+{
+    std::vector<D_PAD*>         m_Pads;         ///< the pads of the net, in net order
+    std::vector<wxPoint>        m_Positions;    ///< the positions of m_Pads
+    std::vector<RATSNEST_ITEM>  m_Ratsnest;     ///< the links of the tree
+    bool                        m_InUse;        ///< used to purge the trees of deleted nets
+};
+
+/// Trees of the nets of a board, by net name: net codes change when nets are
+/// added or removed, net names do not.
+typedef std::map<wxString, RATSNEST_NET_TREE> RATSNEST_CACHE;
+
+
 
 /**
  * Class NETINFO
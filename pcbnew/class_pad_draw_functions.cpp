@@ -32,6 +32,7 @@
 #include <gr_basic.h>
 #include <common.h>
 #include <trigo.h>
+#include <macros.h>
 #include <class_pcb_screen.h>
 #include <class_drawpanel.h>
 #include <drawtxt.h>
@@ -387,6 +388,38 @@ void D_PAD::DrawShape( EDA_RECT* aClipBox, wxDC* aDC, PAD_DRAWINFO& aDrawInfo )
     halfsize.x >>= 1;
     halfsize.y >>= 1;
 
+    // When zoomed out, a pad is drawn as a point or as its box, without its
+    // clearance, hole, number or net name.
+    GR_LOD_T lod = GRGetLOD( aDrawInfo.m_DrawPanel, aDC, std::max( m_Size.x, m_Size.y ) );
+
+    if( lod == GR_LOD_POINT )
+    {
+        GRPutPixel( aClipBox, aDC, shape_pos.x, shape_pos.y, aDrawInfo.m_Color );
+        return;
+    }
+
+    if( lod == GR_LOD_BOX )
+    {
+        // the box of the pad shape rotated by the pad orientation
+        double  orient = DEG2RAD( m_Orient / 10.0 );
+        double  cosine = fabs( cos( orient ) );
+        double  sine   = fabs( sin( orient ) );
+        double  sizex  = m_Size.x + 2 * aDrawInfo.m_Mask_margin.x;
+        double  sizey  = m_Size.y + 2 * aDrawInfo.m_Mask_margin.y;
+        int     dx = KiROUND( ( sizex * cosine + sizey * sine ) / 2 );
+        int     dy = KiROUND( ( sizex * sine + sizey * cosine ) / 2 );
+
+        if( aDrawInfo.m_ShowPadFilled )
+            GRFilledRect( aClipBox, aDC, shape_pos.x - dx, shape_pos.y - dy,
+                          shape_pos.x + dx, shape_pos.y + dy,
+                          aDrawInfo.m_Color, aDrawInfo.m_Color );
+        else
+            GRRect( aClipBox, aDC, shape_pos.x - dx, shape_pos.y - dy,
+                    shape_pos.x + dx, shape_pos.y + dy, aDrawInfo.m_Color );
+
+        return;
+    }
+
     switch( GetShape() )
     {
     case PAD_CIRCLE:
@@ -83,6 +83,33 @@ void TEXTE_PCB::Copy( TEXTE_PCB* source )
 }
 
 
+EDA_RECT TEXTE_PCB::GetBoundingBox() const
+{
+    EDA_RECT rect = GetTextBox( -1 );
+
+    if( m_Orient == 0 )
+        return rect;
+
+    // GetTextBox() is the box of the horizontal text, rotate its corners
+    wxPoint corners[4];
+
+    corners[0] = rect.GetOrigin();
+    corners[1] = wxPoint( rect.GetRight(), rect.GetY() );
+    corners[2] = rect.GetEnd();
+    corners[3] = wxPoint( rect.GetX(), rect.GetBottom() );
+
+    for( int ii = 0;  ii < 4;  ii++ )
+        RotatePoint( &corners[ii], m_Pos, m_Orient );
+
+    rect = EDA_RECT( corners[0], wxSize( 0, 0 ) );
+
+    for( int ii = 1;  ii < 4;  ii++ )
+        rect.Merge( corners[ii] );
+
+    return rect;
+}
+
+
 void TEXTE_PCB::Draw( EDA_DRAW_PANEL* panel, wxDC* DC,
                       GR_DRAWMODE DrawMode, const wxPoint& offset )
 {
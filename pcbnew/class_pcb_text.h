@@ -112,7 +112,11 @@ public:
 
     BITMAP_DEF GetMenuImage() const { return  add_text_xpm; }
 
-    EDA_RECT GetBoundingBox() const { return GetTextBox(); };
+    /**
+     * Function GetBoundingBox
+     * @return EDA_RECT - the box of the text with its orientation, all lines included.
+     */
+    EDA_RECT GetBoundingBox() const;
 
     EDA_ITEM* Clone() const;
 
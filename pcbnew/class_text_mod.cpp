@@ -312,8 +312,11 @@ void TEXTE_MODULE::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE draw_mode,
     if( m_Mirror )
         size.x = -size.x;
 
+    m_strokes.resize( 1 );
+
     DrawGraphicText( panel, DC, pos, (enum EDA_COLOR_T) color, m_Text, orient,
-                     size, m_HJustify, m_VJustify, width, m_Italic, m_Bold );
+                     size, m_HJustify, m_VJustify, width, m_Italic, m_Bold,
+                     NULL, NULL, &m_strokes[0] );
 }
 
 /* Draws a line from the TEXTE_MODULE origin to parent MODULE origin.
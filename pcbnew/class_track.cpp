@@ -656,6 +656,17 @@ void TRACK::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE draw_mode,
         return;
     }
 
+    // a segment smaller than a pixel is drawn as a point
+    int extent = m_Width + std::max( std::abs( m_End.x - m_Start.x ),
+                                     std::abs( m_End.y - m_Start.y ) );
+
+    if( GRGetLOD( panel, DC, extent ) == GR_LOD_POINT )
+    {
+        GRPutPixel( panel->GetClipBox(), DC, m_Start.x + aOffset.x, m_Start.y + aOffset.y,
+                    color );
+        return;
+    }
+
     if( DC->LogicalToDeviceXRel( l_trace ) < MIN_DRAW_WIDTH )
     {
         GRLine( panel->GetClipBox(), DC, m_Start + aOffset, m_End + aOffset, 0, color );
@@ -676,11 +687,14 @@ void TRACK::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE draw_mode,
     if( panel->GetScreen()->m_IsPrinting )
         return;
 
-    // Show clearance for tracks, not for zone segments
+    // Show clearance for tracks, not for zone segments, unless it is smaller than a pixel
     if( ShowClearance( this ) )
     {
-        GRCSegm( panel->GetClipBox(), DC, m_Start + aOffset, m_End + aOffset,
-                 m_Width + (GetClearance() * 2), color );
+        int clearance = GetClearance();
+
+        if( GRGetLOD( panel, DC, clearance ) != GR_LOD_POINT )
+            GRCSegm( panel->GetClipBox(), DC, m_Start + aOffset, m_End + aOffset,
+                     m_Width + (clearance * 2), color );
     }
 
     /* Display the short netname for tracks, not for zone segments.
@@ -784,9 +798,16 @@ void SEGVIA::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE draw_mode,
 
 
     radius = m_Width >> 1;
-    // for small via size on screen (radius < 4 pixels) draw a simplified shape
 
-    int radius_in_pixels = DC->LogicalToDeviceXRel( radius );
+    // for small via size on screen draw a point or a simplified shape
+    GR_LOD_T lod = GRGetLOD( panel, DC, m_Width );
+
+    if( lod == GR_LOD_POINT )
+    {
+        GRPutPixel( panel->GetClipBox(), DC, m_Start.x + aOffset.x, m_Start.y + aOffset.y,
+                    color );
+        return;
+    }
 
     bool fast_draw = false;
 
@@ -795,7 +816,7 @@ void SEGVIA::Draw( EDA_DRAW_PANEL* panel, wxDC* DC, GR_DRAWMODE draw_mode,
 
     int inner_radius = radius - DC->DeviceToLogicalXRel( 2 );
 
-    if( radius_in_pixels < 3 )
+    if( lod == GR_LOD_BOX )
     {
         fast_draw = true;
         fillvia = false;
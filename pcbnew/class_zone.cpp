@@ -60,6 +60,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( BOARD* aBoard ) :
     m_FillMode = 0;                             // How to fill areas: 0 = use filled polygons, != 0 fill with segments
     m_priority = 0;
     m_smoothedPoly = NULL;
+    m_fillHash = 0;
     m_cornerSmoothingType = ZONE_SETTINGS::SMOOTHING_NONE;
     SetIsKeepout( false );
     SetDoNotAllowCopperPour( false );           // has meaning only if m_isKeepout == true
@@ -92,6 +93,7 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
     m_FilledPolysList = aZone.m_FilledPolysList;
     m_FillSegmList = aZone.m_FillSegmList;
+    m_fillHash = aZone.m_fillHash;
 
     m_isKeepout = aZone.m_isKeepout;
     m_doNotAllowCopperPour = aZone.m_doNotAllowCopperPour;
@@ -126,6 +128,7 @@ bool ZONE_CONTAINER::UnFill()
     m_FilledPolysList.clear();
     m_FillSegmList.clear();
     m_IsFilled = false;
+    m_fillHash = 0;
 
     return change;
 }
@@ -882,6 +885,7 @@ void ZONE_CONTAINER::Copy( ZONE_CONTAINER* src )
     m_FilledPolysList = src->m_FilledPolysList;
     m_FillSegmList.clear();
     m_FillSegmList = src->m_FillSegmList;
+    m_fillHash = src->m_fillHash;
 }
 
 
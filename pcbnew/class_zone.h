@@ -257,11 +257,35 @@ public:
      * @param aPcb: the current board (can be NULL for non copper zones)
      * @param aCornerBuffer: A reference to a buffer to put polygon corners, or NULL
      * if NULL (default), uses m_FilledPolysList and fill current zone.
+     * @param aDummyPad: the dummy pad given to AddClearanceAreasPolygonsToPolysList()
      * @return number of polygons
      * This function does not add holes for pads and tracks but calls
      * AddClearanceAreasPolygonsToPolysList() to do that for copper layers
      */
-    int BuildFilledPolysListData( BOARD* aPcb, std::vector <CPolyPt>* aCornerBuffer = NULL );
+    int BuildFilledPolysListData( BOARD* aPcb, std::vector <CPolyPt>* aCornerBuffer = NULL,
+                                  D_PAD* aDummyPad = NULL );
+
+    /**
+     * Function BuildFillHash
+     * computes a hash of everything the filled areas of the zone depend on:
+     * the outline, the zone settings, the clearances, and the pads, tracks,
+     * graphic items and other zones which can cut the zone.
+     * When it is the hash stored by SetFillHash() after the last fill, the
+     * filled areas are up to date and do not need to be built again.
+     * It copies texts, call it from the main thread only.
+     * @param aPcb = the board of the zone
+     * @return unsigned long long - the hash, never 0
+     */
+    unsigned long long BuildFillHash( BOARD* aPcb ) const;
+
+    /**
+     * Function GetFillHash
+     * @return unsigned long long - the BuildFillHash() value of the board the
+     *  current filled areas were built from, or 0 if it is not known
+     */
+    unsigned long long GetFillHash() const { return m_fillHash; }
+
+    void SetFillHash( unsigned long long aHash ) { m_fillHash = aHash; }
 
     /**
      * Function CopyPolygonsFromKiPolygonListToFilledPolysList
@@ -288,8 +312,12 @@ public:
      * BuildFilledPolysListData() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @param aDummyPad: a pad of a dummy MODULE of aPcb, given the shape of the holes
+     *  of the pads which are not on the zone layer, or NULL to make one here.
+     *  When zones are filled by several threads, each thread needs its own dummy pad,
+     *  made before the threads start.
      */
-    void AddClearanceAreasPolygonsToPolysList( BOARD* aPcb );
+    void AddClearanceAreasPolygonsToPolysList( BOARD* aPcb, D_PAD* aDummyPad = NULL );
 
     /**
      * Function HitTestForCorner
@@ -468,6 +496,7 @@ public:
     void ClearFilledPolysList()
     {
         m_FilledPolysList.clear();
+        m_fillHash = 0;
     }
 
    /**
@@ -619,6 +648,9 @@ private:
      * described by m_Poly can have many filled areas
      */
     std::vector <CPolyPt> m_FilledPolysList;
+
+    /// BuildFillHash() value when m_FilledPolysList was built, 0 if unknown
+    unsigned long long    m_fillHash;
 };
 
 
@@ -28,19 +28,21 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+// fix a compile bug at line 97 of boost/detail/container_fwd.hpp
+#define BOOST_DETAIL_TEST_FORCE_CONTAINER_FWD
+
+#include <boost/unordered_map.hpp>
+
 #include <fctsys.h>
 #include <common.h>
 #include <pcbcommon.h>
 #include <macros.h>
-#include <wxBasePcbFrame.h>
 
 #include <pcbnew.h>
 
 // Helper classes to handle connection points
 #include <connect.h>
-
-extern void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb );
-extern void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode );
+#include <disjoint_set.h>
 
 // Local functions
 static void RebuildTrackChain( BOARD* pcb );
@@ -463,81 +465,6 @@ void CONNECTIONS::Build_CurrNet_SubNets_Connections( TRACK* aFirstTrack, TRACK*
 }
 
 
-/**
- * Change a subnet value to a new value, in m_sortedPads pad list
- * After that, 2 cluster (or subnets) are merged into only one.
- * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_PadsSubNets( int aOldSubNet, int aNewSubNet )
-{
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        EXCHG( aOldSubNet, aNewSubNet );
-
-    // Examine connections between intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
-    {
-        D_PAD * curr_pad = m_sortedPads[ii];
-        if( curr_pad->GetSubNet() != aOldSubNet )
-            continue;
-
-        change_count++;
-        curr_pad->SetSubNet( aNewSubNet );
-    }
-
-    return change_count;
-}
-
-/*
- * Change a subnet value to a new value, for tracks and pads which are connected to.
- * The result is merging 2 clusters (or subnets) into only one cluster.
- * Note: the resultig sub net value is the smallest between aOldSubNet et aNewSubNet
- */
-int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
-{
-    TRACK* curr_track;
-    int    change_count = 0;
-
-    if( aOldSubNet == aNewSubNet )
-        return 0;
-
-    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
-        EXCHG( aOldSubNet, aNewSubNet );
-
-    curr_track = (TRACK*)m_firstTrack;
-
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
-    {
-        if( curr_track->GetSubNet() != aOldSubNet )
-        {
-            if( curr_track == m_lastTrack )
-                break;
-
-            continue;
-        }
-
-        change_count++;
-        curr_track->SetSubNet( aNewSubNet );
-
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
-        {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
-            if( pad->GetSubNet() == aOldSubNet )
-                pad->SetSubNet( curr_track->GetSubNet() );
-        }
-
-        if( curr_track == m_lastTrack )
-            break;
-    }
-
-    return change_count;
-}
-
-
 /* Test a list of track segments, to create or propagate a sub netcode to pads and
  * segments connected together.
  * The track list must be sorted by nets, and all segments
@@ -549,282 +476,106 @@ int CONNECTIONS::Merge_SubNets( int aOldSubNet, int aNewSubNet )
  * For a given net, if all tracks are created, there is only one cluster.
  * but if not all tracks are created, there are more than one cluster,
  * and some ratsnests will be left active.
+ *
+ * Clusters are built in a DISJOINT_SET, so merging 2 clusters does not
+ * relabel their items: the cost is linear in the connection count, and not
+ * quadratic in the item count like successive merges of subnet ids were
+ * on nets with thousands of pads.
  */
 void CONNECTIONS::Propagate_SubNets()
 {
-    int sub_netcode = 0;
+    typedef boost::unordered_map<const BOARD_CONNECTED_ITEM*, int> ITEM_INDEX;
 
-    // Examine connections between intersecting pads
-    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
-    {
-        D_PAD * curr_pad = m_sortedPads[ii];
-        for( unsigned jj = 0; jj < curr_pad->m_PadsConnected.size(); jj++ )
-        {
-            D_PAD * pad = curr_pad->m_PadsConnected[jj];
-            if( curr_pad->GetSubNet() )
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    Merge_PadsSubNets( pad->GetSubNet(), curr_pad->GetSubNet() );
-                }
-                else
-                {
-                    // The pad is not yet attached to a cluster,
-                    // so we can add this pad to the cluster
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
-            else                              // the track segment is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // it is connected to a pad in a cluster, merge this pad
-                    curr_pad->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    // it is connected to a pad not in a cluster,
-                    // so we must create a new cluster (only with the 2 pads.
-                    sub_netcode++;
-                    curr_pad->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_pad->GetSubNet() );
-                }
-            }
-        }
-    }
+    std::vector<BOARD_CONNECTED_ITEM*> items;
+    ITEM_INDEX                         itemIndex;
 
-    sub_netcode++;
-    TRACK* curr_track = (TRACK*)m_firstTrack;
-    if( curr_track )
-        curr_track->SetSubNet( sub_netcode );
+    items.reserve( m_sortedPads.size() );
 
-    // Examine connections between trcaks and pads
-    for( ; curr_track != NULL; curr_track = curr_track->Next() )
+    for( unsigned ii = 0; ii < m_sortedPads.size(); ii++ )
     {
-        // First: handling connections to pads
-        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
-        {
-            D_PAD * pad = curr_track->m_PadsConnected[ii];
-
-            if( curr_track->GetSubNet() )        // the track segment is already a cluster member
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // The pad is already a cluster member, so we can merge the 2 clusters
-                    Merge_SubNets( pad->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    /* The pad is not yet attached to a cluster , so we can add this pad to
-                     * the cluster */
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else                              // the track segment is not attached to a cluster
-            {
-                if( pad->GetSubNet() > 0 )
-                {
-                    // it is connected to a pad in a cluster, merge this track
-                    curr_track->SetSubNet( pad->GetSubNet() );
-                }
-                else
-                {
-                    /* it is connected to a pad not in a cluster, so we must create a new
-                     * cluster (only with the 2 items: the track and the pad) */
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    pad->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-        }
-
-        // Test connections between segments
-        for( unsigned ii = 0; ii < curr_track->m_TracksConnected.size(); ii++ )
-        {
-            BOARD_CONNECTED_ITEM* track = curr_track->m_TracksConnected[ii];
-            if( curr_track->GetSubNet() )   // The current track is already a cluster member
-            {
-                // The other track is already a cluster member, so we can merge the 2 clusters
-                if( track->GetSubNet() )
-                {
-                    Merge_SubNets( track->GetSubNet(), curr_track->GetSubNet() );
-                }
-                else
-                {
-                    /* The other track is not yet attached to a cluster , so we can add this
-                     * other track to the cluster */
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-            else        // the current track segment is not yet attached to a cluster
-            {
-                if( track->GetSubNet() )
-                {
-                    // The other track is already a cluster member, so we can add
-                    // the current segment to the cluster
-                    curr_track->SetSubNet( track->GetSubNet() );
-                }
-                else
-                {
-                    /* it is connected to an other segment not in a cluster, so we must
-                     * create a new cluster (only with the 2 track segments) */
-                    sub_netcode++;
-                    curr_track->SetSubNet( sub_netcode );
-                    track->SetSubNet( curr_track->GetSubNet() );
-                }
-            }
-        }
-
-        if( curr_track == m_lastTrack )
-            break;
+        itemIndex[ m_sortedPads[ii] ] = items.size();
+        items.push_back( m_sortedPads[ii] );
     }
-}
 
-/*
- * Test all connections of the board,
- * and update subnet variable of pads and tracks
- * TestForActiveLinksInRatsnest must be called after this function
- * to update active/inactive ratsnest items status
- */
-void PCB_BASE_FRAME::TestConnections()
-{
-    // Clear the cluster identifier for all pads
-    for( unsigned i = 0;  i< m_Pcb->GetPadCount();  ++i )
+    for( TRACK* track = (TRACK*) m_firstTrack; track; track = track->Next() )
     {
-        D_PAD* pad = m_Pcb->GetPad(i);
+        itemIndex[ track ] = items.size();
+        items.push_back( track );
 
-        pad->SetZoneSubNet( 0 );
-        pad->SetSubNet( 0 );
+        if( track == m_lastTrack )
+            break;
     }
 
-    m_Pcb->Test_Connections_To_Copper_Areas();
+    DISJOINT_SET      clusters( items.size() );
+    std::vector<bool> connected( items.size(), false );
 
-    // Test existing connections net by net
-    // note some nets can have no tracks, and pads intersecting
-    // so Build_CurrNet_SubNets_Connections must be called for each net
-    CONNECTIONS connections( m_Pcb );
-    int last_net_tested = 0;
-    int current_net_code = 0;
-    for( TRACK* track = m_Pcb->m_Track; track; )
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        // At this point, track is the first track of a given net
-        current_net_code = track->GetNet();
-        // Get last track of the current net
-        TRACK* lastTrack = track->GetEndNetCode( current_net_code );
+        BOARD_CONNECTED_ITEM* item = items[ii];
 
-        if( current_net_code > 0 )  // do not spend time if net code = 0 ( dummy net )
+        // Items outside the current net or track range are not in the
+        // index, and are ignored, as they were when merging subnet ids.
+        for( unsigned jj = 0; jj < item->m_PadsConnected.size(); jj++ )
         {
-            // Test all previous nets having no tracks
-            for( int net = last_net_tested+1; net < current_net_code; net++ )
-                connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
-
-            connections.Build_CurrNet_SubNets_Connections( track, lastTrack, current_net_code );
-            last_net_tested = current_net_code;
-        }
-
-        track = lastTrack->Next();    // this is now the first track of the next net
-    }
-
-    // Test last nets without tracks, if any
-    int netsCount = m_Pcb->GetNetCount();
-    for( int net = last_net_tested+1; net < netsCount; net++ )
-        connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
+            ITEM_INDEX::const_iterator it = itemIndex.find( item->m_PadsConnected[jj] );
 
-    Merge_SubNets_Connected_By_CopperAreas( m_Pcb );
-
-    return;
-}
-
-
-void PCB_BASE_FRAME::TestNetConnection( wxDC* aDC, int aNetCode )
-{
-    wxString msg;
-
-    if( aNetCode <= 0 ) // -1 = not existing net, 0 = dummy net
-        return;
-
-    if( (m_Pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
-        Compile_Ratsnest( aDC, true );
+            if( it == itemIndex.end() )
+                continue;
 
-    // Clear the cluster identifier (subnet) of pads for this net
-    for( unsigned i = 0; i < m_Pcb->GetPadCount(); ++i )
-    {
-        D_PAD* pad = m_Pcb->GetPad(i);
-        int    pad_net_code = pad->GetNet();
+            clusters.Union( ii, it->second );
+            connected[ii] = connected[it->second] = true;
+        }
 
-        if( pad_net_code < aNetCode )
-            continue;
+        for( unsigned jj = 0; jj < item->m_TracksConnected.size(); jj++ )
+        {
+            ITEM_INDEX::const_iterator it = itemIndex.find( item->m_TracksConnected[jj] );
 
-        if( pad_net_code > aNetCode )
-            break;
+            if( it == itemIndex.end() )
+                continue;
 
-        pad->SetSubNet( 0 );
+            clusters.Union( ii, it->second );
+            connected[ii] = connected[it->second] = true;
+        }
     }
 
-    m_Pcb->Test_Connections_To_Copper_Areas( aNetCode );
+    // Number the clusters from 1, in item order.  A pad connected to nothing
+    // is not a cluster member (subnet 0), a track is always in a cluster, if
+    // only its own.
+    std::vector<int> clusterId( items.size(), 0 );
+    int              sub_netcode = 0;
 
-    // Search for the first and the last segment relative to the given net code
-    if( m_Pcb->m_Track )
+    for( unsigned ii = 0; ii < items.size(); ii++ )
     {
-        CONNECTIONS connections( m_Pcb );
-        TRACK* firstTrack;
-        TRACK* lastTrack = NULL;
-        firstTrack = m_Pcb->m_Track.GetFirst()->GetStartNetCode( aNetCode );
+        BOARD_CONNECTED_ITEM* item = items[ii];
 
-        if( firstTrack )
-            lastTrack = firstTrack->GetEndNetCode( aNetCode );
-
-        if( firstTrack && lastTrack ) // i.e. if there are segments
+        if( !connected[ii] && item->Type() == PCB_PAD_T )
         {
-            connections.Build_CurrNet_SubNets_Connections( firstTrack, lastTrack, firstTrack->GetNet() );
+            item->SetSubNet( 0 );
+            continue;
         }
-    }
-
-    Merge_SubNets_Connected_By_CopperAreas( m_Pcb, aNetCode );
 
-    // rebuild the active ratsnest for this net
-    DrawGeneralRatsnest( aDC, aNetCode );
-    TestForActiveLinksInRatsnest( aNetCode );
-    DrawGeneralRatsnest( aDC, aNetCode );
+        int root = clusters.Find( ii );
 
-    // Display results
-    int net_notconnected_count = 0;
-    NETINFO_ITEM* net = m_Pcb->FindNet( aNetCode );
-
-    if( net )       // Should not occur, but ...
-    {
-        for( unsigned ii = net->m_RatsnestStartIdx; ii < net->m_RatsnestEndIdx; ii++ )
-        {
-            if( m_Pcb->m_FullRatsnest[ii].IsActive() )
-                net_notconnected_count++;
-        }
+        if( clusterId[root] == 0 )
+            clusterId[root] = ++sub_netcode;
 
-        msg.Printf( wxT( "links %d nc %d  net:nc %d" ),
-                    m_Pcb->GetRatsnestsCount(), m_Pcb->GetUnconnectedNetCount(),
-                    net_notconnected_count );
+        item->SetSubNet( clusterId[root] );
     }
-    else
-        msg.Printf( wxT( "net not found: netcode %d" ),aNetCode );
-
-    SetStatusText( msg );
-    return;
 }
 
-
 /* search connections between tracks and pads and propagate pad net codes to the track
  * segments.
  * Pads netcodes are assumed to be up to date.
  */
-void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
+void CONNECTIONS::RecalculateAllTracksNetcode()
 {
     TRACK*              curr_track;
 
     // Build the net info list
-    GetBoard()->BuildListOfNets();
+    m_brd->BuildListOfNets();
 
     // Reset variables and flags used in computation
-    curr_track = m_Pcb->m_Track;
+    curr_track = m_brd->m_Track;
     for( ; curr_track != NULL; curr_track = curr_track->Next() )
     {
         curr_track->m_TracksConnected.clear();
@@ -837,20 +588,19 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     }
 
     // If no pad, reset pointers and netcode, and do nothing else
-    if( m_Pcb->GetPadCount() == 0 )
+    if( m_brd->GetPadCount() == 0 )
         return;
 
-    CONNECTIONS connections( m_Pcb );
-    connections.BuildPadsList();
-    connections.BuildTracksCandidatesList(m_Pcb->m_Track);
+    BuildPadsList();
+    BuildTracksCandidatesList( m_brd->m_Track );
 
     // First pass: build connections between track segments and pads.
-    connections.SearchTracksConnectedToPads();
+    SearchTracksConnectedToPads();
 
     /* For tracks connected to at least one pad,
      * set the track net code to the pad netcode
      */
-    curr_track = m_Pcb->m_Track;
+    curr_track = m_brd->m_Track;
     for( ; curr_track != NULL; curr_track = curr_track->Next() )
     {
         if( curr_track->m_PadsConnected.size() )
@@ -858,54 +608,70 @@ void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
     }
 
     // Pass 2: build connections between track ends
-    for( curr_track = m_Pcb->m_Track; curr_track != NULL; curr_track = curr_track->Next() )
+    for( curr_track = m_brd->m_Track; curr_track != NULL; curr_track = curr_track->Next() )
     {
-        connections.SearchConnectedTracks( curr_track );
-        connections.GetConnectedTracks( curr_track );
+        SearchConnectedTracks( curr_track );
+        GetConnectedTracks( curr_track );
     }
 
-    // Propagate net codes from a segment to other connected segments
-    bool new_pass_request = true;   // set to true if a track has its netcode changed from 0
-                                    // to a known netcode to re-evaluate netcodes
-                                    // of connected items
-    while( new_pass_request )
+    // Propagate net codes from a segment to other connected segments:
+    // gather the segments connected together in clusters, then give the
+    // segments without net code the net code of their cluster.  A cluster has
+    // the net of its segments which have one, and 2 clusters of different
+    // nets are never merged: segments of 2 shorted nets, or a segment without
+    // net bridging them, do not give their net codes to each other's
+    // neighbours.  The bridge takes the net of the first cluster it meets.
+    typedef boost::unordered_map<const TRACK*, int> TRACK_INDEX;
+
+    std::vector<TRACK*> tracks;
+    TRACK_INDEX         trackIndex;
+
+    for( curr_track = m_brd->m_Track; curr_track; curr_track = curr_track->Next() )
     {
-        new_pass_request = false;
+        trackIndex[ curr_track ] = tracks.size();
+        tracks.push_back( curr_track );
+    }
+
+    DISJOINT_SET     clusters( tracks.size() );
+    std::vector<int> clusterNet( tracks.size() );    // the net of each cluster root
 
-        for( curr_track = m_Pcb->m_Track; curr_track; curr_track = curr_track->Next() )
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+        clusterNet[ii] = tracks[ii]->GetNet();
+
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+    {
+        curr_track = tracks[ii];
+
+        for( unsigned kk = 0; kk < curr_track->m_TracksConnected.size(); kk++ )
         {
-            int netcode = curr_track->GetNet();
-            if( netcode == 0 )
-            {   // try to find a connected item having a netcode
-                for( unsigned kk = 0; kk < curr_track->m_TracksConnected.size(); kk++ )
-                {
-                    int altnetcode = curr_track->m_TracksConnected[kk]->GetNet();
-                    if( altnetcode )
-                    {
-                        new_pass_request = true;
-                        netcode = altnetcode;
-                        curr_track->SetNet(netcode);
-                        break;
-                    }
-                }
-            }
-            if( netcode )    // this track has a netcode
-            {   // propagate this netcode to connected tracks having no netcode
-                for( unsigned kk = 0; kk < curr_track->m_TracksConnected.size(); kk++ )
-                {
-                    int altnetcode = curr_track->m_TracksConnected[kk]->GetNet();
-                    if( altnetcode == 0 )
-                    {
-                        curr_track->m_TracksConnected[kk]->SetNet(netcode);
-                        new_pass_request = true;
-                    }
-                }
-            }
+            TRACK_INDEX::const_iterator other =
+                trackIndex.find( curr_track->m_TracksConnected[kk] );
+
+            if( other == trackIndex.end() )
+                continue;
+
+            int root    = clusters.Find( ii );
+            int altroot = clusters.Find( other->second );
+
+            int netcode    = clusterNet[root];
+            int altnetcode = clusterNet[altroot];
+
+            if( netcode && altnetcode && netcode != altnetcode )
+                continue;
+
+            clusters.Union( root, altroot );
+            clusterNet[ clusters.Find( root ) ] = netcode ? netcode : altnetcode;
         }
     }
 
+    for( unsigned ii = 0; ii < tracks.size(); ii++ )
+    {
+        if( tracks[ii]->GetNet() == 0 )
+            tracks[ii]->SetNet( clusterNet[ clusters.Find( ii ) ] );
+    }
+
     // Sort the track list by net codes:
-    RebuildTrackChain( m_Pcb );
+    RebuildTrackChain( m_brd );
 }
 
 
@@ -220,9 +220,19 @@ public:
      * For a given net, if all tracks are created, there is only one cluster.
      * but if not all tracks are created, there are more than one cluster,
      * and some ratsnests will be left active.
+     * Clusters are numbered from 1, pads connected to nothing get 0.
      */
     void Propagate_SubNets();
 
+    /**
+     * Function RecalculateAllTracksNetcode
+     * searches the connections between the tracks and the pads of the board, and
+     * gives the net codes of the pads to the tracks, and from them to the tracks
+     * connected to them.  The track list is then sorted by net codes.
+     * The pad net codes are assumed to be up to date.
+     */
+    void RecalculateAllTracksNetcode();
+
 private:
     /**
      * function searchEntryPointInCandidatesList
@@ -234,30 +244,6 @@ private:
      * @return the index of item found or -1 if no candidate
      */
     int searchEntryPointInCandidatesList( const wxPoint & aPoint);
-
-    /**
-     * Function Merge_SubNets
-     * Change a subnet old value to a new value, for tracks and pads which are connected to
-     * tracks from m_firstTrack to m_lastTrack and their connected pads.
-     * and modify the subnet parameter (change the old value to the new value).
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting sub net value is the smallest between aOldSubNet and aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
-     */
-    int Merge_SubNets( int aOldSubNet, int aNewSubNet );
-
-    /**
-     * Function Merge_PadsSubNets
-     * Change a subnet value to a new value, in m_sortedPads pad list
-     * After that, 2 cluster (or subnets) are merged into only one.
-     * Note: the resulting subnet value is the smallest between aOldSubNet et aNewSubNet
-     * @return modification count
-     * @param aOldSubNet = subnet value to modify
-     * @param aNewSubNet = new subnet value for each item which have old_val as subnet value
-     */
-    int Merge_PadsSubNets( int aOldSubNet, int aNewSubNet );
 };
 
 #endif      //  ifndef CONNECT_H
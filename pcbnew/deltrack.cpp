@@ -174,7 +174,7 @@ void PCB_EDIT_FRAME::Delete_net( wxDC* DC, TRACK* aTrack )
         if( segm->GetNet() != net_code_delete )
             break;
 
-        GetBoard()->m_Track.Remove( segm );
+        GetBoard()->Remove( segm );
 
         // redraw the area where the track was
         m_canvas->RefreshDrawingRect( segm->GetBoundingBox() );
@@ -219,7 +219,7 @@ void PCB_EDIT_FRAME::Remove_One_Track( wxDC* DC, TRACK* pt_segm )
                      << TO_UTF8( TRACK::ShowState( tracksegment->GetState( -1 ) ) ) \
                      << std::endl; )
 
-        GetBoard()->m_Track.Remove( tracksegment );
+        GetBoard()->Remove( tracksegment );
 
         // redraw the area where the track was
         m_canvas->RefreshDrawingRect( tracksegment->GetBoundingBox() );
@@ -228,6 +228,7 @@ void PCB_EDIT_FRAME::Remove_One_Track( wxDC* DC, TRACK* pt_segm )
     }
 
     SaveCopyInUndoList( itemsList, UR_DELETED );
+    OnModify();
 
     if( net_code > 0 )
         TestNetConnection( DC, net_code );
@@ -136,7 +136,11 @@ void DIALOG_DRC_CONTROL::OnStartdrcClick( wxCommandEvent& event )
                            true,        // DRC test for keepout areas enabled
                            reportName, m_CreateRptCtrl->IsChecked() );
 
-    DelDRCMarkers();
+    // RunTests() deletes the markers which are not valid anymore, and keeps
+    // the others when it only has to test the changes since its last run.
+    m_Parent->SetCurItem( NULL );           // clear curr item, because it could be a DRC marker
+    m_UnconnectedListBox->DeleteAllItems();
+    m_DeleteCurrentMarkerButton->Enable( false );
 
     wxBeginBusyCursor();
 
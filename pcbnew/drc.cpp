@@ -28,10 +28,15 @@
 /* DRC control              */
 /****************************/
 
+#include <algorithm>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <fctsys.h>
 #include <wxPcbStruct.h>
 #include <trigo.h>
 #include <base_units.h>
+#include <openmp_threads.h>
 #include <class_board_design_settings.h>
 
 #include <class_module.h>
@@ -106,13 +111,10 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
 
     m_currentMarker = NULL;
 
-    m_segmAngle  = 0;
-    m_segmLength = 0;
+    m_abortDRC      = false;
+    m_drcInProgress = false;
 
-    m_xcliplo = 0;
-    m_ycliplo = 0;
-    m_xcliphi = 0;
-    m_ycliphi = 0;
+    m_lastRunValid  = false;
 }
 
 
@@ -192,7 +194,30 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         m_mainWindow->Compile_Ratsnest( NULL, true );
     }
 
-    // someone should have cleared the two lists before calling this.
+    // someone should have cleared the unconnected list before calling this.
+    // The markers which are still valid are kept, the others are deleted here.
+
+    std::vector<int>        rules;
+    std::vector<EDA_RECT>   changes;
+    ITEM_SET                retest;
+
+    getRulesSignature( rules );
+
+    bool incremental = canUpdateLastRun( rules );
+
+    if( incremental )
+    {
+        collectChanges( changes, retest );
+        deleteStaleMarkers( retest );
+    }
+    else
+    {
+        m_pcb->DeleteMARKERs();
+        m_markerOwners.clear();
+    }
+
+    m_lastRunValid = false;     // until this run is complete
+    m_abortDRC     = false;
 
     if( !testNetClasses() )
     {
@@ -218,7 +243,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
-        testPad2Pad();
+        testPad2Pad( incremental ? &retest : NULL );
     }
 
     // test track and via clearances to other tracks, pads, and vias
@@ -227,17 +252,21 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         aMessages->AppendText( _( "Track clearances...\n" ) );
         wxSafeYield();
     }
-    testTracks( true );
+    testTracks( true, incremental ? &retest : NULL );
 
     // Before testing segments and unconnected, refill all zones:
     // this is a good caution, because filled areas can be outdated.
+    // Only the zones near the changes can be outdated after a previous run.
     if( aMessages )
     {
         aMessages->AppendText( _( "Fill zones...\n" ) );
         wxSafeYield();
     }
 
-    m_mainWindow->Fill_All_Zones( aMessages->GetParent(), false );
+    if( incremental )
+        refillZones( changes, aMessages ? aMessages->GetParent() : NULL );
+    else
+        m_mainWindow->Fill_All_Zones( aMessages ? aMessages->GetParent() : NULL, false );
 
     // test zone clearances to other zones
     if( aMessages )
@@ -272,6 +301,11 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         testKeepoutAreas();
     }
 
+    // a run aborted by the user has not tested everything, the next one
+    // has to start from scratch
+    saveRunState( rules );
+    m_lastRunValid = !m_abortDRC;
+
     // update the m_ui listboxes
     updatePointers();
 
@@ -427,42 +461,142 @@ bool DRC::testNetClasses()
 }
 
 
-void DRC::testPad2Pad()
+// Rank of items in the lists the DRC used to walk linearly.  Candidates found
+// by the spatial index are tested in this order so that the markers are the
+// ones the full scans created.
+typedef boost::unordered_map< const BOARD_ITEM*, unsigned > ITEM_RANKS;
+
+typedef boost::ptr_vector< DRC_WORKER > DRC_WORKERS;
+
+
+/* D_PAD::GetBoundingRadius() computes its value the first time it is needed.
+ * Compute it for all the pads before the threads share them.
+ */
+static void cachePadBoundingRadii( BOARD* aPcb )
+{
+    for( unsigned ii = 0; ii < aPcb->GetPadCount(); ++ii )
+        aPcb->GetPad( ii )->GetBoundingRadius();
+}
+
+
+static bool violationRankLess( const DRC_VIOLATION& a, const DRC_VIOLATION& b )
+{
+    return a.m_Rank < b.m_Rank;
+}
+
+
+/* Collects the violations found by all the workers, in the order a single
+ * thread would have found them.
+ */
+static void mergeViolations( const DRC_WORKERS& aWorkers, std::vector<DRC_VIOLATION>& aList )
+{
+    for( unsigned ii = 0; ii < aWorkers.size(); ++ii )
+    {
+        const std::vector<DRC_VIOLATION>& found = aWorkers[ii].GetViolations();
+        aList.insert( aList.end(), found.begin(), found.end() );
+    }
+
+    std::stable_sort( aList.begin(), aList.end(), violationRankLess );
+}
+
+
+int DRC::getClearanceHalo()
+{
+    int halo = m_pcb->GetBiggestClearanceValue();
+
+    // pads and footprints can have a local clearance bigger than any netclass
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+        halo = std::max( halo, m_pcb->GetPad( ii )->GetClearance() );
+
+    return halo;
+}
+
+
+void DRC::testPad2Pad( const ITEM_SET* aOnly )
 {
     std::vector<D_PAD*> sortedPads;
 
     m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
 
-    // find the max size of the pads (used to stop the test)
-    int max_size = 0;
+    // each pair of pads is tested once, from the pad which comes first
+    // in the list sorted by X then Y coordinate
+    ITEM_RANKS rank;
 
     for( unsigned i = 0; i < sortedPads.size(); ++i )
-    {
-        D_PAD* pad = sortedPads[i];
+        rank[ sortedPads[i] ] = i;
 
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
-        if( radius > max_size )
-            max_size = radius;
-    }
+    const BOARD_SPATIAL_INDEX&  index = m_pcb->GetSpatialIndex();
+    int                         halo = getClearanceHalo();
 
-    // Test the pads
-    D_PAD** listEnd = &sortedPads[ sortedPads.size() ];
+    static const KICAD_T        padTypes[] = { PCB_PAD_T, EOT };
 
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
-    {
-        D_PAD* pad = sortedPads[i];
+    cachePadBoundingRadii( m_pcb );
+
+    DRC_WORKERS workers;
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+    for( int ii = 0; ii < OpenMPThreadCount(); ++ii )
+        workers.push_back( new DRC_WORKER( m_pcb ) );
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+    int padCount = (int) sortedPads.size();
+
+#pragma omp parallel
+    {
+        DRC_WORKER&                 worker = workers[ OpenMPThreadNum() ];
+        std::vector<BOARD_ITEM*>    found;
+        std::vector<unsigned>       neighbours;
+        std::vector<D_PAD*>         candidates;
+
+#pragma omp for schedule( dynamic, 64 )
+        for( int i = 0; i < padCount; ++i )
         {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_currentMarker = 0;
+            D_PAD*   pad = sortedPads[i];
+
+            if( aOnly && !aOnly->count( pad ) )
+                continue;
+
+            EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( pad );
+
+            area.Inflate( halo );
+
+            found.clear();
+            index.Query( area, found, padTypes );
+
+            neighbours.clear();
+
+            for( unsigned jj = 0; jj < found.size(); ++jj )
+            {
+                ITEM_RANKS::const_iterator it = rank.find( found[jj] );
+
+                if( it != rank.end() && it->second > (unsigned) i )
+                    neighbours.push_back( it->second );
+            }
+
+            if( neighbours.empty() )
+                continue;
+
+            std::sort( neighbours.begin(), neighbours.end() );
+
+            candidates.clear();
+
+            for( unsigned jj = 0; jj < neighbours.size(); ++jj )
+                candidates.push_back( sortedPads[ neighbours[jj] ] );
+
+            worker.SetRank( i );
+            worker.TestPad( pad, &candidates[0], &candidates[0] + candidates.size() );
         }
     }
+
+    std::vector<DRC_VIOLATION> violations;
+
+    mergeViolations( workers, violations );
+
+    for( unsigned ii = 0; ii < violations.size(); ++ii )
+    {
+        m_currentMarker = fillMarker( violations[ii], m_currentMarker );
+        m_pcb->Add( m_currentMarker );
+        m_markerOwners[ m_currentMarker ] = sortedPads[ violations[ii].m_Rank ];
+        m_currentMarker = 0;
+    }
 }
 
 
@@ -472,14 +606,19 @@ void DRC::testPad2Pad()
  * because this test can take a while, a progress bar can be displayed
  * (Note: it is shown only if there are many tracks)
  */
-void DRC::testTracks( bool aShowProgressBar )
+void DRC::testTracks( bool aShowProgressBar, const ITEM_SET* aOnly )
 {
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
-    int count = 0;
+
+    // the last segment has no following segment to be tested against
+    std::vector<TRACK*> segments;
+
     for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
-        count++;
+        segments.push_back( segm );
+
+    int count = segments.size();
 
     int deltamax = count/delta;
     if( aShowProgressBar && deltamax > 3 )
@@ -490,29 +629,381 @@ void DRC::testTracks( bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
+    // A segment is tested against the pads in the board pad list order, and
+    // against the tracks which come after it in m_Track, in the list order.
+    ITEM_RANKS padRank;
+    ITEM_RANKS trackRank;
+    unsigned   rank = 0;
+
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+        padRank[ m_pcb->GetPad( ii ) ] = ii;
+
+    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+        trackRank[ segm ] = rank++;
+
+    const BOARD_SPATIAL_INDEX&  index = m_pcb->GetSpatialIndex();
+    int                         halo = getClearanceHalo();
+
+    static const KICAD_T        connectedTypes[] = { PCB_TRACE_T, PCB_VIA_T, PCB_PAD_T, EOT };
+
+    cachePadBoundingRadii( m_pcb );
+
+    DRC_WORKERS workers;
+
+    for( int ii = 0; ii < OpenMPThreadCount(); ++ii )
+        workers.push_back( new DRC_WORKER( m_pcb ) );
+
+    // The segments are tested by blocks of delta, the progress bar is updated
+    // and the abort button checked by the main thread between two blocks.
+    for( int first = 0; first < count; first += delta )
     {
-        if ( ii++ > delta )
+        int last = std::min( first + delta, count );
+
+#pragma omp parallel
         {
-            ii = 0;
-            count++;
-            if( progressDialog )
+            DRC_WORKER&                 worker = workers[ OpenMPThreadNum() ];
+            std::vector<BOARD_ITEM*>    found;
+            std::vector< std::pair<unsigned, D_PAD*> > padNeighbours;
+            std::vector< std::pair<unsigned, TRACK*> > trackNeighbours;
+            std::vector<D_PAD*>         pads;
+            std::vector<TRACK*>         tracks;
+
+#pragma omp for schedule( dynamic, 16 )
+            for( int ii = first; ii < last; ++ii )
             {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
+                TRACK*   segm = segments[ii];
+
+                if( aOnly && !aOnly->count( segm ) )
+                    continue;
+
+                EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( segm );
+
+                area.Inflate( halo );
+
+                found.clear();
+                index.Query( area, found, connectedTypes );
+
+                padNeighbours.clear();
+                trackNeighbours.clear();
+
+                for( unsigned jj = 0; jj < found.size(); ++jj )
+                {
+                    if( found[jj]->Type() == PCB_PAD_T )
+                    {
+                        ITEM_RANKS::const_iterator it = padRank.find( found[jj] );
+
+                        if( it != padRank.end() )
+                            padNeighbours.push_back( std::make_pair( it->second,
+                                                                     (D_PAD*) found[jj] ) );
+                    }
+                    else
+                    {
+                        ITEM_RANKS::const_iterator it = trackRank.find( found[jj] );
+
+                        if( it != trackRank.end() && it->second > (unsigned) ii )
+                            trackNeighbours.push_back( std::make_pair( it->second,
+                                                                       (TRACK*) found[jj] ) );
+                    }
+                }
+
+                std::sort( padNeighbours.begin(), padNeighbours.end() );
+                std::sort( trackNeighbours.begin(), trackNeighbours.end() );
+
+                pads.clear();
+                tracks.clear();
+
+                for( unsigned jj = 0; jj < padNeighbours.size(); ++jj )
+                    pads.push_back( padNeighbours[jj].second );
+
+                for( unsigned jj = 0; jj < trackNeighbours.size(); ++jj )
+                    tracks.push_back( trackNeighbours[jj].second );
+
+                worker.SetRank( ii );
+                worker.TestTrack( segm, pads, tracks );
             }
         }
-        if( !doTrackDrc( segm, segm->Next(), true ) )
+
+        if( progressDialog )
         {
-            wxASSERT( m_currentMarker );
-            m_pcb->Add( m_currentMarker );
-            m_currentMarker = 0;
+            if( !progressDialog->Update( last / delta, wxEmptyString ) )
+            {
+                m_abortDRC = true;
+                break;  // Aborted by user
+            }
         }
     }
+
     if( progressDialog )
         progressDialog->Destroy();
+
+    std::vector<DRC_VIOLATION> violations;
+
+    mergeViolations( workers, violations );
+
+    for( unsigned ii = 0; ii < violations.size(); ++ii )
+    {
+        m_currentMarker = fillMarker( violations[ii], m_currentMarker );
+        m_pcb->Add( m_currentMarker );
+        m_markerOwners[ m_currentMarker ] = segments[ violations[ii].m_Rank ];
+        m_currentMarker = 0;
+    }
+}
+
+
+void DRC::MarkDirty( BOARD_ITEM* aItem )
+{
+    // the next run tests everything anyway
+    if( !m_lastRunValid )
+        return;
+
+    switch( aItem->Type() )
+    {
+    case PCB_MODULE_T:
+        for( D_PAD* pad = ( (MODULE*) aItem )->m_Pads;  pad;  pad = pad->Next() )
+            m_dirtyRegions.push_back( BOARD_SPATIAL_INDEX::ItemBoundingBox( pad ) );
+        break;
+
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+        m_dirtyRegions.push_back( BOARD_SPATIAL_INDEX::ItemBoundingBox( aItem ) );
+        break;
+
+    case PCB_ZONE_AREA_T:
+        // zone outlines are not tested against tracks and pads, but the zone
+        // has to be filled again.  It is found again by its time stamp: its
+        // outline is the one before the change.
+        m_dirtyZones.push_back( aItem->GetTimeStamp() );
+        break;
+
+    default:    // drawings and texts are not tested
+        break;
+    }
+}
+
+
+void DRC::InvalidateLastRun()
+{
+    m_lastRunValid = false;
+
+    m_lastRules.clear();
+    m_lastItems.clear();
+    m_markerOwners.clear();
+    m_dirtyRegions.clear();
+    m_dirtyZones.clear();
+}
+
+
+void DRC::getRulesSignature( std::vector<int>& aSignature )
+{
+    aSignature.clear();
+
+    aSignature.push_back( m_doPad2PadTest );
+    aSignature.push_back( m_pcb->GetDesignSettings().GetCopperLayerCount() );
+    aSignature.push_back( getClearanceHalo() );
+
+    // the tests read the rules from the netclass of the net of each item
+    for( unsigned ii = 0; ii < m_pcb->GetNetCount(); ++ii )
+    {
+        NETINFO_ITEM*   net = m_pcb->FindNet( ii );
+        NETCLASS*       netclass = net ? net->GetNetClass() : NULL;
+
+        if( !netclass )
+            netclass = m_pcb->m_NetClasses.GetDefault();
+
+        aSignature.push_back( netclass->GetClearance() );
+        aSignature.push_back( netclass->GetTrackMinWidth() );
+        aSignature.push_back( netclass->GetViaMinDiameter() );
+        aSignature.push_back( netclass->GetViaDrill() );
+        aSignature.push_back( netclass->GetuViaMinDiameter() );
+        aSignature.push_back( netclass->GetuViaDrill() );
+    }
+}
+
+
+DRC::ITEM_STATE DRC::getItemState( BOARD_ITEM* aItem )
+{
+    ITEM_STATE state;
+
+    state.m_BBox      = BOARD_SPATIAL_INDEX::ItemBoundingBox( aItem );
+    state.m_NetCode   = ( (BOARD_CONNECTED_ITEM*) aItem )->GetNet();
+    state.m_TimeStamp = aItem->GetTimeStamp();
+
+    if( aItem->Type() == PCB_PAD_T )
+        state.m_LayerMask = ( (D_PAD*) aItem )->GetLayerMask();
+    else
+        state.m_LayerMask = ( (TRACK*) aItem )->ReturnMaskLayer();
+
+    return state;
+}
+
+
+bool DRC::canUpdateLastRun( const std::vector<int>& aRules )
+{
+    if( !m_lastRunValid || aRules != m_lastRules )
+        return false;
+
+    // The markers of the last run must all be there: a marker deleted by the
+    // user would not be found again for an item which did not change.
+    unsigned found = 0;
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+    {
+        if( m_markerOwners.count( m_pcb->GetMARKER( ii ) ) )
+            ++found;
+    }
+
+    return found == m_markerOwners.size();
+}
+
+
+void DRC::collectChanges( std::vector<EDA_RECT>& aRegions, ITEM_SET& aRetest )
+{
+    aRegions = m_dirtyRegions;
+
+    // Many commands change tracks and pads without saving them in the undo
+    // list, they are found by comparing the board to the last run.
+    ITEM_SET seen;
+
+    for( TRACK* track = m_pcb->m_Track; track; track = track->Next() )
+    {
+        ITEM_STATE              state = getItemState( track );
+        ITEM_STATES::iterator   it = m_lastItems.find( track );
+
+        seen.insert( track );
+
+        if( it == m_lastItems.end() )
+            aRegions.push_back( state.m_BBox );
+        else if( !( it->second == state ) )
+        {
+            aRegions.push_back( it->second.m_BBox );
+            aRegions.push_back( state.m_BBox );
+        }
+    }
+
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+    {
+        D_PAD*                  pad = m_pcb->GetPad( ii );
+        ITEM_STATE              state = getItemState( pad );
+        ITEM_STATES::iterator   it = m_lastItems.find( pad );
+
+        seen.insert( pad );
+
+        if( it == m_lastItems.end() )
+            aRegions.push_back( state.m_BBox );
+        else if( !( it->second == state ) )
+        {
+            aRegions.push_back( it->second.m_BBox );
+            aRegions.push_back( state.m_BBox );
+        }
+    }
+
+    // the place of the items deleted
+    for( ITEM_STATES::iterator it = m_lastItems.begin(); it != m_lastItems.end(); ++it )
+    {
+        if( !seen.count( it->first ) )
+            aRegions.push_back( it->second.m_BBox );
+    }
+
+    // An item has to be tested again if a change is closer to it than the
+    // biggest clearance.
+    const BOARD_SPATIAL_INDEX&  index = m_pcb->GetSpatialIndex();
+    int                         halo = getClearanceHalo();
+
+    static const KICAD_T        connectedTypes[] = { PCB_TRACE_T, PCB_VIA_T, PCB_PAD_T, EOT };
+    std::vector<BOARD_ITEM*>    found;
+
+    for( unsigned ii = 0; ii < aRegions.size(); ++ii )
+    {
+        EDA_RECT area = aRegions[ii];
+
+        area.Inflate( halo );
+
+        found.clear();
+        index.Query( area, found, connectedTypes );
+
+        aRetest.insert( found.begin(), found.end() );
+    }
+}
+
+
+void DRC::deleteStaleMarkers( const ITEM_SET& aRetest )
+{
+    ITEM_SET onBoard;
+
+    for( TRACK* track = m_pcb->m_Track; track; track = track->Next() )
+        onBoard.insert( track );
+
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+        onBoard.insert( m_pcb->GetPad( ii ) );
+
+    // walk backwards, Delete() removes the marker from the list
+    for( int ii = m_pcb->GetMARKERCount() - 1; ii >= 0; --ii )
+    {
+        MARKER_PCB*             marker = m_pcb->GetMARKER( ii );
+        MARKER_OWNERS::iterator it = m_markerOwners.find( marker );
+
+        if( it != m_markerOwners.end() && onBoard.count( it->second )
+            && !aRetest.count( it->second ) )
+            continue;
+
+        if( it != m_markerOwners.end() )
+            m_markerOwners.erase( it );
+
+        m_pcb->Delete( marker );
+    }
+}
+
+
+void DRC::refillZones( const std::vector<EDA_RECT>& aRegions, wxWindow* aActiveWindow )
+{
+    int                 halo = getClearanceHalo();
+    std::vector<time_t> outdatedZones;
+
+    for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* zone = m_pcb->GetArea( ii );
+
+        if( zone->GetIsKeepout() )
+            continue;
+
+        bool outdated = std::find( m_dirtyZones.begin(), m_dirtyZones.end(),
+                                   zone->GetTimeStamp() ) != m_dirtyZones.end();
+
+        EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( zone );
+
+        area.Inflate( std::max( halo, zone->GetZoneClearance() ) );
+
+        for( unsigned jj = 0; jj < aRegions.size() && !outdated; ++jj )
+            outdated = area.Intersects( aRegions[jj] );
+
+        if( outdated )
+            outdatedZones.push_back( zone->GetTimeStamp() );
+    }
+
+    // the zones are filled by the threads of Fill_All_Zones(), which also
+    // updates the connections and the ratsnest
+    if( !outdatedZones.empty() )
+        m_mainWindow->Fill_All_Zones( aActiveWindow, false, &outdatedZones );
+}
+
+
+void DRC::saveRunState( const std::vector<int>& aRules )
+{
+    m_lastRules = aRules;
+    m_lastItems.clear();
+
+    for( TRACK* track = m_pcb->m_Track; track; track = track->Next() )
+        m_lastItems[ track ] = getItemState( track );
+
+    for( unsigned ii = 0; ii < m_pcb->GetPadCount(); ++ii )
+    {
+        D_PAD* pad = m_pcb->GetPad( ii );
+        m_lastItems[ pad ] = getItemState( pad );
+    }
+
+    m_dirtyRegions.clear();
+    m_dirtyZones.clear();
 }
 
 
@@ -677,21 +1168,18 @@ bool DRC::doTrackKeepoutDrc( TRACK* aRefSeg )
 }
 
 
-bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit )
+bool DRC_WORKER::TestPad( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd )
 {
     int layerMask = aRefPad->GetLayerMask() & ALL_CU_LAYERS;
 
     /* used to test DRC pad to holes: this dummy pad has the size and shape of the hole
      * to test pad to pad hole DRC, using the pad to pad DRC test function.
      * Therefore, this dummy pad is a circle or an oval.
-     * A pad must have a parent because some functions expect a non null parent
-     * to find the parent board, and some other data
      */
-    MODULE dummymodule( m_pcb );    // Creates a dummy parent
-    D_PAD dummypad( &dummymodule );
+    D_PAD& dummypad = *m_dummyPad;
 
     // Ensure the hole is on all copper layers
-    dummypad.SetLayerMask( ALL_CU_LAYERS | dummypad.GetLayerMask() );
+    dummypad.SetLayerMask( PAD_STANDARD_DEFAULT_LAYERS );
 
     // Use the minimal local clearance value for the dummy pad.
     // The clearance of the active pad will be used as minimum distance to a hole
@@ -705,11 +1193,6 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
         if( pad == aRefPad )
             continue;
 
-        // We can stop the test when pad->GetPosition().x > x_limit
-        // because the list is sorted by X values
-        if( pad->GetPosition().x > x_limit )
-            break;
-
         // No problem if pads are on different copper layers,
         // but their hole (if any ) can create DRC error because they are on all
         // copper layers, so we test them
@@ -743,9 +1226,7 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
                 if( !checkClearancePadToPad( aRefPad, &dummypad ) )
                 {
                     // here we have a drc error on pad!
-                    m_currentMarker = fillMarker( pad, aRefPad,
-                                                  DRCE_HOLE_NEAR_PAD, m_currentMarker );
-                    return false;
+                    return report( pad, aRefPad, DRCE_HOLE_NEAR_PAD );
                 }
             }
 
@@ -759,9 +1240,7 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
                 if( !checkClearancePadToPad( pad, &dummypad ) )
                 {
                     // here we have a drc error on aRefPad!
-                    m_currentMarker = fillMarker( aRefPad, pad,
-                                                  DRCE_HOLE_NEAR_PAD, m_currentMarker );
-                    return false;
+                    return report( aRefPad, pad, DRCE_HOLE_NEAR_PAD );
                 }
             }
 
@@ -788,8 +1267,7 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
         if( !checkClearancePadToPad( aRefPad, pad ) )
         {
             // here we have a drc error!
-            m_currentMarker = fillMarker( aRefPad, pad, DRCE_PAD_NEAR_PAD1, m_currentMarker );
-            return false;
+            return report( aRefPad, pad, DRCE_PAD_NEAR_PAD1 );
         }
     }
 
@@ -152,7 +152,75 @@ bool trapezoid2pointDRC( wxPoint aTref[4], wxPoint aPcompare, int aDist )
     return true;
 }
 
+
+DRC_WORKER::DRC_WORKER( BOARD* aPcb )
+{
+    m_pcb  = aPcb;
+    m_rank = 0;
+
+    /* used to test DRC tracks and pads versus holes: this dummy pad takes the
+     * size and shape of the hole to test, using the pad tests.
+     * A pad must have a parent because some functions expect a non null parent
+     * to find the parent board, and some other data
+     */
+    m_dummyModule = new MODULE( m_pcb );
+    m_dummyPad    = new D_PAD( m_dummyModule );
+
+    m_segmAngle  = 0;
+    m_segmLength = 0;
+
+    m_xcliplo = 0;
+    m_ycliplo = 0;
+    m_xcliphi = 0;
+    m_ycliphi = 0;
+}
+
+
+DRC_WORKER::~DRC_WORKER()
+{
+    delete m_dummyPad;
+    delete m_dummyModule;
+}
+
+
+bool DRC_WORKER::report( BOARD_ITEM* aItemA, BOARD_ITEM* aItemB, int aErrorCode )
+{
+    DRC_VIOLATION violation;
+
+    violation.m_ErrorCode = aErrorCode;
+    violation.m_ItemA     = aItemA;
+    violation.m_ItemB     = aItemB;
+    violation.m_Rank      = m_rank;
+
+    m_violations.push_back( violation );
+
+    return false;
+}
+
+
 bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
+{
+    std::vector<D_PAD*> pads;
+    std::vector<TRACK*> tracks;
+
+    if( testPads )
+        pads = m_pcb->GetPads();
+
+    for( TRACK* track = aStart; track; track = track->Next() )
+        tracks.push_back( track );
+
+    DRC_WORKER worker( m_pcb );
+
+    if( worker.TestTrack( aRefSeg, pads, tracks ) )
+        return true;
+
+    m_currentMarker = fillMarker( worker.GetViolations().back(), m_currentMarker );
+    return false;
+}
+
+
+bool DRC_WORKER::TestTrack( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                            const std::vector<TRACK*>& aTracks )
 {
     TRACK*    track;
     wxPoint   delta;           // lenght on X and Y axis of segments
@@ -181,18 +249,14 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
         {
             if( aRefSeg->GetWidth() < netclass->GetuViaMinDiameter() )
             {
-                m_currentMarker = fillMarker( aRefSeg, NULL,
-                                              DRCE_TOO_SMALL_MICROVIA, m_currentMarker );
-                return false;
+                return report( aRefSeg, NULL, DRCE_TOO_SMALL_MICROVIA );
             }
         }
         else
         {
             if( aRefSeg->GetWidth() < netclass->GetViaMinDiameter() )
             {
-                m_currentMarker = fillMarker( aRefSeg, NULL,
-                                              DRCE_TOO_SMALL_VIA, m_currentMarker );
-                return false;
+                return report( aRefSeg, NULL, DRCE_TOO_SMALL_VIA );
             }
         }
 
@@ -201,9 +265,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
         // and a default via hole can be bigger than some vias sizes
         if( aRefSeg->GetDrillValue() > aRefSeg->GetWidth() )
         {
-            m_currentMarker = fillMarker( aRefSeg, NULL,
-                                          DRCE_VIA_HOLE_BIGGER, m_currentMarker );
-            return false;
+            return report( aRefSeg, NULL, DRCE_VIA_HOLE_BIGGER );
         }
 
         // For microvias: test if they are blind vias and only between 2 layers
@@ -229,9 +291,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
             if( err )
             {
-                m_currentMarker = fillMarker( aRefSeg, NULL,
-                                              DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR, m_currentMarker );
-                return false;
+                return report( aRefSeg, NULL, DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR );
             }
         }
     }
@@ -239,9 +299,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
     {
         if( aRefSeg->GetWidth() < netclass->GetTrackMinWidth() )
         {
-            m_currentMarker = fillMarker( aRefSeg, NULL,
-                                          DRCE_TOO_SMALL_TRACK_WIDTH, m_currentMarker );
-            return false;
+            return report( aRefSeg, NULL, DRCE_TOO_SMALL_TRACK_WIDTH );
         }
     }
 
@@ -268,20 +326,18 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
      * This dummy pad has the size and shape of the hole
      * to test tracks to pad hole DRC, using checkClearanceSegmToPad test function.
      * Therefore, this dummy pad is a circle or an oval.
-     * A pad must have a parent because some functions expect a non null parent
-     * to find the parent board, and some other data
      */
-    MODULE dummymodule( m_pcb );    // Creates a dummy parent
-    D_PAD dummypad( &dummymodule );
+    D_PAD& dummypad = *m_dummyPad;
 
     dummypad.SetLayerMask( ALL_CU_LAYERS );     // Ensure the hole is on all layers
+    dummypad.SetLocalClearance( 0 );
 
     // Compute the min distance to pads
-    if( testPads )
+    if( aPads.size() )
     {
-        for( unsigned ii = 0;  ii<m_pcb->GetPadCount();  ++ii )
+        for( unsigned ii = 0;  ii<aPads.size();  ++ii )
         {
-            D_PAD* pad = m_pcb->GetPad( ii );
+            D_PAD* pad = aPads[ii];
 
             /* No problem if pads are on an other layer,
              * But if a drill hole exists	(a pad on a single layer can have a hole!)
@@ -306,9 +362,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
                 if( !checkClearanceSegmToPad( &dummypad, aRefSeg->GetWidth(),
                                               netclass->GetClearance() ) )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, pad,
-                                                  DRCE_TRACK_NEAR_THROUGH_HOLE, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, pad, DRCE_TRACK_NEAR_THROUGH_HOLE );
                 }
 
                 continue;
@@ -326,9 +380,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
             if( !checkClearanceSegmToPad( pad, aRefSeg->GetWidth(), aRefSeg->GetClearance( pad ) ) )
             {
-                m_currentMarker = fillMarker( aRefSeg, pad,
-                                              DRCE_TRACK_NEAR_PAD, m_currentMarker );
-                return false;
+                return report( aRefSeg, pad, DRCE_TRACK_NEAR_PAD );
             }
         }
     }
@@ -342,8 +394,10 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
     // Test the reference segment with other track segments
     wxPoint segStartPoint;
     wxPoint segEndPoint;
-    for( track = aStart; track; track = track->Next() )
+    for( unsigned ii = 0; ii < aTracks.size(); ++ii )
     {
+        track = aTracks[ii];
+
         // No problem if segments have the same net code:
         if( net_code_ref == track->GetNet() )
             continue;
@@ -370,9 +424,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
                 // Test distance between two vias, i.e. two circles, trivial case
                 if( (int) hypot( segStartPoint.x, segStartPoint.y ) < w_dist )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_VIA_NEAR_VIA, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_VIA_NEAR_VIA );
                 }
             }
             else    // test via to segment
@@ -386,9 +438,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
                 if( !checkMarginToCircle( segStartPoint, w_dist, delta.x ) )
                 {
-                    m_currentMarker = fillMarker( track, aRefSeg,
-                                                  DRCE_VIA_NEAR_TRACK, m_currentMarker );
-                    return false;
+                    return report( track, aRefSeg, DRCE_VIA_NEAR_TRACK );
                 }
             }
 
@@ -408,9 +458,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
             if( checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
                 continue;
 
-            m_currentMarker = fillMarker( aRefSeg, track,
-                                          DRCE_TRACK_NEAR_VIA, m_currentMarker );
-            return false;
+            return report( aRefSeg, track, DRCE_TRACK_NEAR_VIA );
         }
 
         /*	We have changed axis:
@@ -431,16 +479,12 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
                 // Fine test : we consider the rounded shape of each end of the track segment:
                 if( segStartPoint.x >= 0 && segStartPoint.x <= m_segmLength )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_TRACK_ENDS1, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_TRACK_ENDS1 );
                 }
 
                 if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_TRACK_ENDS2, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_TRACK_ENDS2 );
                 }
             }
 
@@ -449,24 +493,18 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
                 /* Fine test : we consider the rounded shape of the ends */
                 if( segEndPoint.x >= 0 && segEndPoint.x <= m_segmLength )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_TRACK_ENDS3, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_TRACK_ENDS3 );
                 }
 
                 if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_TRACK_ENDS4, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_TRACK_ENDS4 );
                 }
             }
 
             if( segStartPoint.x <=0 && segEndPoint.x >= 0 )
             {
-                m_currentMarker = fillMarker( aRefSeg, track,
-                                              DRCE_TRACK_UNKNOWN1, m_currentMarker );
-                return false;
+                return report( aRefSeg, track, DRCE_TRACK_UNKNOWN1 );
             }
         }
         else if( segStartPoint.x == segEndPoint.x ) // perpendicular segments
@@ -480,23 +518,17 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
             if( (segStartPoint.y < 0) && (segEndPoint.y > 0) )
             {
-                m_currentMarker = fillMarker( aRefSeg, track,
-                                              DRCE_TRACKS_CROSSING, m_currentMarker );
-                return false;
+                return report( aRefSeg, track, DRCE_TRACKS_CROSSING );
             }
 
             // At this point the drc error is due to an end near a reference segm end
             if( !checkMarginToCircle( segStartPoint, w_dist, m_segmLength ) )
             {
-                m_currentMarker = fillMarker( aRefSeg, track,
-                                              DRCE_ENDS_PROBLEM1, m_currentMarker );
-                return false;
+                return report( aRefSeg, track, DRCE_ENDS_PROBLEM1 );
             }
             if( !checkMarginToCircle( segEndPoint, w_dist, m_segmLength ) )
             {
-                m_currentMarker = fillMarker( aRefSeg, track,
-                                              DRCE_ENDS_PROBLEM2, m_currentMarker );
-                return false;
+                return report( aRefSeg, track, DRCE_ENDS_PROBLEM2 );
             }
         }
         else    // segments quelconques entre eux
@@ -522,9 +554,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
                 if( !checkLine( segStartPoint, segEndPoint ) )
                 {
-                    m_currentMarker = fillMarker( aRefSeg, track,
-                                                  DRCE_ENDS_PROBLEM3, m_currentMarker );
-                    return false;
+                    return report( aRefSeg, track, DRCE_ENDS_PROBLEM3 );
                 }
                 else    // The drc error is due to the starting or the ending point of the reference segment
                 {
@@ -550,16 +580,12 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
 
                     if( !checkMarginToCircle( relStartPos, w_dist, delta.x ) )
                     {
-                        m_currentMarker = fillMarker( aRefSeg, track,
-                                                      DRCE_ENDS_PROBLEM4, m_currentMarker );
-                        return false;
+                        return report( aRefSeg, track, DRCE_ENDS_PROBLEM4 );
                     }
 
                     if( !checkMarginToCircle( relEndPos, w_dist, delta.x ) )
                     {
-                        m_currentMarker = fillMarker( aRefSeg, track,
-                                                      DRCE_ENDS_PROBLEM5, m_currentMarker );
-                        return false;
+                        return report( aRefSeg, track, DRCE_ENDS_PROBLEM5 );
                     }
                 }
             }
@@ -574,7 +600,7 @@ bool DRC::doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool testPads )
  * this function can be also used to test DRC between a pas and a hole,
  * because a hole is like a round pad.
  */
-bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
+bool DRC_WORKER::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
 {
     int     dist;
 
@@ -788,7 +814,7 @@ bool DRC::checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad )
  * and its orientation is m_segmAngle (m_segmAngle must be already initialized)
  * and have aSegmentWidth.
  */
-bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist )
+bool DRC_WORKER::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist )
 {
     wxSize  padHalfsize;        // half the dimension of the pad
     int     orient;
@@ -990,7 +1016,7 @@ bool DRC::checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMi
  * and a segment. the segment is expected starting at 0,0, and on the X axis
  * return true if distance >= aRadius
  */
-bool DRC::checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength )
+bool DRC_WORKER::checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength )
 {
     if( abs( aCentre.y ) > aRadius )     // trivial case
         return true;
@@ -1028,7 +1054,7 @@ static inline int USCALE( unsigned arg, unsigned num, unsigned den )
  * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
  * return true if the line from aSegStart to aSegEnd is outside the bounding box
  */
-bool DRC::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
+bool DRC_WORKER::checkLine( wxPoint aSegStart, wxPoint aSegEnd )
 {
 #define WHEN_OUTSIDE return true
 #define WHEN_INSIDE
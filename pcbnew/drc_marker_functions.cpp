@@ -131,6 +131,19 @@ MARKER_PCB* DRC::fillMarker( D_PAD* aPad, D_PAD* bPad, int aErrorCode, MARKER_PC
 }
 
 
+MARKER_PCB* DRC::fillMarker( const DRC_VIOLATION& aViolation, MARKER_PCB* fillMe )
+{
+    // DRC_WORKER reports pad to pad problems between two pads, all the others
+    // with a track or a via first
+    if( aViolation.m_ItemA->Type() == PCB_PAD_T )
+        return fillMarker( (D_PAD*) aViolation.m_ItemA, (D_PAD*) aViolation.m_ItemB,
+                           aViolation.m_ErrorCode, fillMe );
+
+    return fillMarker( (TRACK*) aViolation.m_ItemA, aViolation.m_ItemB,
+                       aViolation.m_ErrorCode, fillMe );
+}
+
+
 MARKER_PCB* DRC::fillMarker( ZONE_CONTAINER* aArea, int aErrorCode, MARKER_PCB* fillMe )
 {
     wxString textA = aArea->GetSelectMenuText();
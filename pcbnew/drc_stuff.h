@@ -32,6 +32,14 @@
 
 #include <vector>
 
+// fix a compile bug at line 97 of boost/detail/container_fwd.hpp
+#define BOOST_DETAIL_TEST_FORCE_CONTAINER_FWD
+
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <base_struct.h>
+
 #define OK_DRC  0
 #define BAD_DRC 1
 
@@ -88,6 +96,7 @@ class TRACK;
 class MARKER_PCB;
 class DRC_ITEM;
 class NETCLASS;
+class MODULE;
 
 
 /**
@@ -138,34 +147,78 @@ typedef std::vector<DRC_ITEM*> DRC_LIST;
 
 
 /**
- * Class DRC
- * is the Design Rule Checker, and performs all the DRC tests.  The output of
- * the checking goes to the BOARD file in the form of two MARKER lists.  Those
- * two lists are displayable in the drc dialog box.  And they can optionally
- * be sent to a text file on disk.
- * This class is given access to the windows and the BOARD
- * that it needs via its constructor or public access functions.
+ * Struct DRC_VIOLATION
+ * is what a DRC_WORKER records of a clearance problem.  It holds no text, the
+ * DRC turns it into a MARKER_PCB once the workers are done.
  */
-class DRC
+struct DRC_VIOLATION
 {
-    friend class DIALOG_DRC_CONTROL;
+    int         m_ErrorCode;    ///< one of the DRCE_ codes
+    BOARD_ITEM* m_ItemA;        ///< a TRACK, a SEGVIA or a D_PAD
+    BOARD_ITEM* m_ItemB;        ///< the other item involved, can be NULL
+    unsigned    m_Rank;         ///< position of the item under test in the serial test order
+};
 
-private:
 
-    //  protected or private functions() are lowercase first character.
+/**
+ * Class DRC_WORKER
+ * runs the track and pad clearance tests of the DRC for one thread.
+ * <p>
+ * The tests keep the geometry of the reference segment in member variables
+ * and use a dummy pad to test holes, so each thread needs its own worker.
+ * Problems are recorded as DRC_VIOLATIONs rather than as MARKER_PCBs because
+ * markers build wxStrings, which must not be done outside of the main thread.
+ * A worker must also be created and destroyed in the main thread.
+ * </p>
+ */
+class DRC_WORKER
+{
+public:
+    DRC_WORKER( BOARD* aPcb );
 
-    bool     m_doPad2PadTest;
-    bool     m_doUnconnectedTest;
-    bool     m_doZonesTest;
-    bool     m_doKeepoutTest;
-    bool     m_doCreateRptFile;
+    ~DRC_WORKER();
 
-    wxString m_rptFilename;
+    /**
+     * Function SetRank
+     * sets the rank given to the violations found from now on.
+     */
+    void SetRank( unsigned aRank ) { m_rank = aRank; }
 
-    MARKER_PCB* m_currentMarker;
+    /**
+     * Function GetViolations
+     * @return the violations found since the worker was created, in the order
+     *         they were found.
+     */
+    const std::vector<DRC_VIOLATION>& GetViolations() const { return m_violations; }
 
-    bool        m_abortDRC;
-    bool        m_drcInProgress;
+    /**
+     * Function TestPad
+     * tests the clearance between aRefPad and other pads.
+     * @param aRefPad The pad to test
+     * @param aStart The start of the pad list to test against
+     * @param aEnd Marks the end of the list and is not included
+     * @return bool - true if no problems, else false and a violation is recorded.
+     */
+    bool TestPad( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd );
+
+    /**
+     * Function TestTrack
+     * tests the current segment against given candidates, in their order.
+     * @param aRefSeg The segment to test
+     * @param aPads The pads to test against
+     * @param aTracks The tracks and vias to test against
+     * @return bool - true if no problems, else false and a violation is recorded.
+     */
+    bool TestTrack( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                    const std::vector<TRACK*>& aTracks );
+
+private:
+    BOARD*      m_pcb;
+    MODULE*     m_dummyModule;  ///< parent of m_dummyPad
+    D_PAD*      m_dummyPad;     ///< takes the size and shape of the holes to test
+
+    unsigned    m_rank;
+    std::vector<DRC_VIOLATION> m_violations;
 
     /* In DRC functions, many calculations are using coordinates relative
      * to the position of the segment under test (segm to segm DRC, segm to pad DRC
@@ -190,12 +243,143 @@ private:
     int                 m_xcliphi;
     int                 m_ycliphi;
 
+    // a worker owns its dummy pad, it is not copyable
+    DRC_WORKER( const DRC_WORKER& );
+    DRC_WORKER& operator=( const DRC_WORKER& );
+
+    /**
+     * Function report
+     * records a violation with the current rank.
+     * @return bool - always false, so that a test can return report( ... )
+     */
+    bool report( BOARD_ITEM* aItemA, BOARD_ITEM* aItemB, int aErrorCode );
+
+    //-----<single tests>----------------------------------------------
+
+    /**
+     * Function checkClearancePadToPad
+     * @param aRefPad The reference pad to check
+     * @param aPad Another pad to check against
+     * @return bool - true if clearance between aRefPad and aPad is >= dist_min, else false
+     */
+    bool checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad );
+
+
+    /**
+     * Function checkClearanceSegmToPad
+     * check the distance from a pad to segment.  This function uses several
+     * instance variable not passed in:
+     *      m_segmLength = length of the segment being tested
+     *      m_segmAngle  = angle of the segment with the X axis;
+     *      m_segmEnd    = end coordinate of the segment
+     *      m_padToTestPos = position of pad relative to the origin of segment
+     * @param aPad Is the pad involved in the check
+     * @param aSegmentWidth width of the segment to test
+     * @param aMinDist Is the minimum clearance needed
+     *
+     * @return true distance >= dist_min,
+     *         false if distance < dist_min
+     */
+    bool checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist );
+
+
+    /**
+     * Helper function checkMarginToCircle
+     * Check the distance from a point to
+     * a segment. the segment is expected starting at 0,0, and on the X axis
+     * (used to test DRC between a segment and a round pad, via or round end of a track
+     * @param aCentre The coordinate of the circle's center
+     * @param aRadius A "keep out" radius centered over the circle
+     * @param aLength The length of the segment (i.e. coordinate of end, becuase it is on
+     *                the X axis)
+     * @return bool - true if distance >= radius, else
+     *                false when distance < aRadius
+     */
+    static bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
+
+
+    /**
+     * Function checkLine
+     * (helper function used in drc calculations to see if one track is in contact with
+     *  another track).
+     * Test if a line intersects a bounding box (a rectangle)
+     * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
+     * return true if the line from aSegStart to aSegEnd is outside the bounding box
+     */
+    bool        checkLine( wxPoint aSegStart, wxPoint aSegEnd );
+
+    //-----</single tests>---------------------------------------------
+};
+
+
+/**
+ * Class DRC
+ * is the Design Rule Checker, and performs all the DRC tests.  The output of
+ * the checking goes to the BOARD file in the form of two MARKER lists.  Those
+ * two lists are displayable in the drc dialog box.  And they can optionally
+ * be sent to a text file on disk.
+ * This class is given access to the windows and the BOARD
+ * that it needs via its constructor or public access functions.
+ */
+class DRC
+{
+    friend class DIALOG_DRC_CONTROL;
+
+private:
+
+    //  protected or private functions() are lowercase first character.
+
+    bool     m_doPad2PadTest;
+    bool     m_doUnconnectedTest;
+    bool     m_doZonesTest;
+    bool     m_doKeepoutTest;
+    bool     m_doCreateRptFile;
+
+    wxString m_rptFilename;
+
+    MARKER_PCB* m_currentMarker;
+
+    bool        m_abortDRC;
+    bool        m_drcInProgress;
+
     PCB_EDIT_FRAME*     m_mainWindow;
     BOARD*              m_pcb;
     DIALOG_DRC_CONTROL* m_ui;
 
     DRC_LIST            m_unconnected;  ///< list of unconnected pads, as DRC_ITEMs
 
+    /* RunTests() only tests again the tracks and pads near the changes made
+     * since its last run, and keeps the other markers.  What the last run saw
+     * is kept here.
+     */
+    struct ITEM_STATE
+    {
+        EDA_RECT    m_BBox;         ///< BOARD_SPATIAL_INDEX::ItemBoundingBox()
+        int         m_NetCode;
+        int         m_LayerMask;
+        time_t      m_TimeStamp;    ///< an other item at the address of a deleted one differs
+
+        bool operator==( const ITEM_STATE& aOther ) const
+        {
+            return m_TimeStamp == aOther.m_TimeStamp
+                && m_BBox.GetOrigin() == aOther.m_BBox.GetOrigin()
+                && m_BBox.GetSize() == aOther.m_BBox.GetSize()
+                && m_NetCode == aOther.m_NetCode
+                && m_LayerMask == aOther.m_LayerMask;
+        }
+    };
+
+    typedef boost::unordered_map< const BOARD_ITEM*, ITEM_STATE > ITEM_STATES;
+    typedef boost::unordered_map< const MARKER_PCB*, const BOARD_ITEM* > MARKER_OWNERS;
+    typedef boost::unordered_set< const BOARD_ITEM* > ITEM_SET;
+
+    bool                  m_lastRunValid;   ///< false if the next run must test everything
+    std::vector<int>      m_lastRules;      ///< the rules of the last run, see getRulesSignature()
+    ITEM_STATES           m_lastItems;      ///< the tracks and pads of the last run
+    MARKER_OWNERS         m_markerOwners;   ///< track and pad markers -> item under test
+    std::vector<EDA_RECT> m_dirtyRegions;   ///< copper changed since the last run
+    std::vector<time_t>   m_dirtyZones;     ///< time stamps of the zones changed since the last run
+
 
     /**
      * Function updatePointers
@@ -223,6 +407,13 @@ private:
 
     MARKER_PCB* fillMarker( D_PAD* aPad, D_PAD* bPad, int aErrorCode, MARKER_PCB* fillMe );
 
+    /**
+     * Function fillMarker
+     * optionally creates a marker and fills it in with a violation found by
+     * a DRC_WORKER.
+     */
+    MARKER_PCB* fillMarker( const DRC_VIOLATION& aViolation, MARKER_PCB* fillMe );
+
     MARKER_PCB* fillMarker( ZONE_CONTAINER* aArea, int aErrorCode, MARKER_PCB* fillMe );
 
     /**
@@ -270,10 +461,18 @@ private:
      * because this test can take a while, a progress bar can be displayed
      * @param aShowProgressBar = true to show a progrsse bar
      * (Note: it is shown only if there are many tracks)
+     * @param aOnly = if not NULL, only the tracks and vias of this set are
+     *  tested (against all the others).
      */
-    void testTracks( bool aShowProgressBar );
+    void testTracks( bool aShowProgressBar, const ITEM_SET* aOnly = NULL );
 
-    void testPad2Pad();
+    /**
+     * Function testPad2Pad
+     * performs the pad to pad DRC.
+     * @param aOnly = if not NULL, only the pads of this set are tested
+     *  (against all the others).
+     */
+    void testPad2Pad( const ITEM_SET* aOnly = NULL );
 
     void testUnconnected();
 
@@ -285,17 +484,6 @@ private:
 
     bool doNetClass( NETCLASS* aNetClass, wxString& msg );
 
-    /**
-     * Function doPadToPadsDrc
-     * tests the clearance between aRefPad and other pads.
-     * The pad list must be sorted by x coordinate.
-     * @param aRefPad The pad to test
-     * @param aStart The start of the pad list to test against
-     * @param aEnd Marks the end of the list and is not included
-     * @param x_limit is used to stop the test (when the any pad's X coord exceeds this)
-     */
-    bool doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_limit );
-
     /**
      * Function DoTrackDrc
      * tests the current segment.
@@ -307,82 +495,96 @@ private:
      */
     bool doTrackDrc( TRACK* aRefSeg, TRACK* aStart, bool doPads = true );
 
+    //-----<incremental runs>-------------------------------------------
+
     /**
-     * Function doTrackKeepoutDrc
-     * tests the current segment or via.
-     * @param aRefSeg The segment to test
-     * @return bool - true if no poblems, else false and m_currentMarker is
-     *          filled in with the problem information.
+     * Function getRulesSignature
+     * collects all the rules values the track and pad tests depend on: when
+     * they change, all the items must be tested again.
      */
-    bool doTrackKeepoutDrc( TRACK* aRefSeg );
+    void getRulesSignature( std::vector<int>& aSignature );
 
+    /**
+     * Function getItemState
+     * @return ITEM_STATE - what a track, via or pad looks like to the
+     *  incremental runs.
+     */
+    static ITEM_STATE getItemState( BOARD_ITEM* aItem );
 
     /**
-     * Function doEdgeZoneDrc
-     * tests a segment in ZONE_CONTAINER * aArea:
-     *      Test Edge inside other areas
-     *      Test Edge too close other areas
-     * @param aArea The current area.
-     * @param aCornerIndex The first corner of the segment to test.
-     * @return bool - false if DRC error  or true if OK
+     * Function canUpdateLastRun
+     * @return bool - true if the markers of the last run are still on the
+     *  board and were found with \a aRules, so that only the items near
+     *  the changes have to be tested again.
      */
-    bool doEdgeZoneDrc( ZONE_CONTAINER* aArea, int aCornerIndex );
+    bool canUpdateLastRun( const std::vector<int>& aRules );
 
-    //-----<single tests>----------------------------------------------
+    /**
+     * Function collectChanges
+     * finds the copper changed since the last run, from MarkDirty() and by
+     * comparing the tracks and pads to the state they had, and the tracks and
+     * pads near enough to these changes to have different clearance problems.
+     * @param aRegions = where to put the changed areas.
+     * @param aRetest = where to put the tracks and pads to test again.
+     */
+    void collectChanges( std::vector<EDA_RECT>& aRegions, ITEM_SET& aRetest );
 
     /**
-     * Function checkClearancePadToPad
-     * @param aRefPad The reference pad to check
-     * @param aPad Another pad to check against
-     * @return bool - true if clearance between aRefPad and aPad is >= dist_min, else false
+     * Function deleteStaleMarkers
+     * deletes the markers which are not valid anymore: those of the items of
+     * \a aRetest, of items which are not on the board anymore, and those of
+     * the tests which are always run in full (zones, keepout areas, netclasses).
      */
-    bool checkClearancePadToPad( D_PAD* aRefPad, D_PAD* aPad );
+    void deleteStaleMarkers( const ITEM_SET& aRetest );
 
+    /**
+     * Function refillZones
+     * refills the zones near \a aRegions and the zones whose outline changed,
+     * instead of all the zones, with PCB_EDIT_FRAME::Fill_All_Zones().
+     * @param aRegions = the changed areas.
+     * @param aActiveWindow = the window of the progress bar, or NULL.
+     */
+    void refillZones( const std::vector<EDA_RECT>& aRegions, wxWindow* aActiveWindow );
 
     /**
-     * Function checkClearanceSegmToPad
-     * check the distance from a pad to segment.  This function uses several
-     * instance variable not passed in:
-     *      m_segmLength = length of the segment being tested
-     *      m_segmAngle  = angle of the segment with the X axis;
-     *      m_segmEnd    = end coordinate of the segment
-     *      m_padToTestPos = position of pad relative to the origin of segment
-     * @param aPad Is the pad involved in the check
-     * @param aSegmentWidth width of the segment to test
-     * @param aMinDist Is the minimum clearance needed
-     *
-     * @return true distance >= dist_min,
-     *         false if distance < dist_min
+     * Function saveRunState
+     * remembers the state of the tracks and pads which have been tested, and
+     * forgets the recorded changes.
      */
-    bool checkClearanceSegmToPad( const D_PAD* aPad, int aSegmentWidth, int aMinDist );
+    void saveRunState( const std::vector<int>& aRules );
 
+    //-----</incremental runs>------------------------------------------
 
     /**
-     * Helper function checkMarginToCircle
-     * Check the distance from a point to
-     * a segment. the segment is expected starting at 0,0, and on the X axis
-     * (used to test DRC between a segment and a round pad, via or round end of a track
-     * @param aCentre The coordinate of the circle's center
-     * @param aRadius A "keep out" radius centered over the circle
-     * @param aLength The length of the segment (i.e. coordinate of end, becuase it is on
-     *                the X axis)
-     * @return bool - true if distance >= radius, else
-     *                false when distance < aRadius
+     * Function getClearanceHalo
+     * @return int - the largest clearance two items of the board can require,
+     *  i.e. the biggest NETCLASS clearance or pad or footprint local clearance.
+     *  Items whose bounding boxes are further apart cannot violate clearances,
+     *  this is how far BOARD_SPATIAL_INDEX queries are inflated.
      */
-    static bool checkMarginToCircle( wxPoint aCentre, int aRadius, int aLength );
+    int getClearanceHalo();
+
+    /**
+     * Function doTrackKeepoutDrc
+     * tests the current segment or via.
+     * @param aRefSeg The segment to test
+     * @return bool - true if no poblems, else false and m_currentMarker is
+     *          filled in with the problem information.
+     */
+    bool doTrackKeepoutDrc( TRACK* aRefSeg );
 
 
     /**
-     * Function checkLine
-     * (helper function used in drc calculations to see if one track is in contact with
-     *  another track).
-     * Test if a line intersects a bounding box (a rectangle)
-     * The rectangle is defined by m_xcliplo, m_ycliplo and m_xcliphi, m_ycliphi
-     * return true if the line from aSegStart to aSegEnd is outside the bounding box
+     * Function doEdgeZoneDrc
+     * tests a segment in ZONE_CONTAINER * aArea:
+     *      Test Edge inside other areas
+     *      Test Edge too close other areas
+     * @param aArea The current area.
+     * @param aCornerIndex The first corner of the segment to test.
+     * @return bool - false if DRC error  or true if OK
      */
-    bool        checkLine( wxPoint aSegStart, wxPoint aSegEnd );
+    bool doEdgeZoneDrc( ZONE_CONTAINER* aArea, int aCornerIndex );
 
-    //-----</single tests>---------------------------------------------
 
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
@@ -430,6 +632,24 @@ public:
     }
 
 
+    /**
+     * Function MarkDirty
+     * records the area of \a aItem as changed, so that the next RunTests()
+     * tests again the tracks and pads around it.  It is called by the undo
+     * and redo functions, with the item in the state it is going to leave.
+     * Changes of position or net are also found without it, but not changes
+     * of a pad shape or of a via drill, for instance.
+     * @param aItem is the item about to be changed, added or deleted.
+     */
+    void MarkDirty( BOARD_ITEM* aItem );
+
+    /**
+     * Function InvalidateLastRun
+     * forgets the results of the last run, so that the next RunTests() tests
+     * everything.  Must be called when the BOARD is replaced.
+     */
+    void InvalidateLastRun();
+
     /**
      * Function ShowDialog
      * opens a dialog and prompts the user, then if a test run button is
@@ -473,7 +693,10 @@ public:
     /**
      * Function RunTests
      * will actually run all the tests specified with a previous call to
-     * SetSettings()
+     * SetSettings().  The markers of the last run which are still valid are
+     * kept, and only the tracks and pads near the changes made since then are
+     * tested again, unless the rules have changed.  The other markers are
+     * deleted.
      * @param aMessages = a wxTextControl where to display some activity messages. Can be NULL
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
@@ -67,6 +67,7 @@ Load() TODO's
 #include <macros.h>
 #include <fctsys.h>
 #include <trigo.h>
+#include <parse_double.h>
 #include <wx/filename.h>
 
 #include <class_board.h>
@@ -230,11 +231,10 @@ static EROT erot( const std::string& aRot )
 
     rot.spin    = aRot.find( 'S' ) != aRot.npos;
     rot.mirror  = aRot.find( 'M' ) != aRot.npos;
-    rot.degrees = strtod( aRot.c_str()
-                        + 1                     // skip leading 'R'
-                        + int( rot.spin )       // skip optional leading 'S'
-                        + int( rot.mirror ),    // skip optional leading 'M'
-                        NULL );
+    rot.degrees = ParseDouble( aRot.c_str()
+                             + 1                     // skip leading 'R'
+                             + int( rot.spin )       // skip optional leading 'S'
+                             + int( rot.mirror ) );  // skip optional leading 'M'
     return rot;
 }
 
@@ -958,7 +958,7 @@ ELAYER::ELAYER( CPTREE& aLayer )
 /// parse an eagle distance which is either straight mm or mils if there is "mil" suffix.
 static double parseEagle( const std::string& aDistance )
 {
-    double ret = strtod( aDistance.c_str(), NULL );
+    double ret = ParseDouble( aDistance.c_str() );
     if( aDistance.npos != aDistance.find( "mil" ) )
         ret = IU_PER_MILS * ret;
     else
@@ -48,6 +48,7 @@
 #include <wildcards_and_files_ext.h>
 
 #include <class_board.h>
+#include <drc_stuff.h>
 #include <build_version.h>      // LEGACY_BOARD_FILE_VERSION
 
 
@@ -96,6 +97,7 @@ void PCB_EDIT_FRAME::Files_io( wxCommandEvent& event )
             {
                 wxString rec_name = autosaveFilePrefix + fn.GetName();
                 fn.SetName( rec_name );
+                fn.SetExt( SnapshotPcbFileExtension );
             }
             else
             {
@@ -234,6 +236,8 @@ the changes?" ) ) )
         if( fileName.GetExt() == IO_MGR::GetFileExtension( IO_MGR::KICAD ) ||
             fileName.GetExt() == backup_ext )
             pluginType = IO_MGR::KICAD;
+        else if( fileName.GetExt() == SnapshotPcbFileExtension )
+            pluginType = IO_MGR::SNAPSHOT;
     }
 
     PLUGIN::RELEASER pi( IO_MGR::PluginFind( pluginType ) );
@@ -300,6 +304,7 @@ the changes?" ) ) )
             }
 
             SetBoard( loadedBoard );
+            m_drc->InvalidateLastRun();
         }
     }
     catch( IO_ERROR ioe )
@@ -478,6 +483,8 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
 
         if( pcbFileName.GetExt() == LegacyPcbFileExtension )
             pluginType = IO_MGR::LEGACY;
+        else if( pcbFileName.GetExt() == SnapshotPcbFileExtension )
+            pluginType = IO_MGR::SNAPSHOT;
         else
         {
             pluginType = IO_MGR::KICAD;
@@ -574,6 +581,7 @@ bool PCB_EDIT_FRAME::SavePcbFile( const wxString& aFileName, bool aCreateBackupF
         // Delete auto save file on successful save.
         wxFileName autoSaveFileName = pcbFileName;
         autoSaveFileName.SetName( autosaveFilePrefix + pcbFileName.GetName() );
+        autoSaveFileName.SetExt( SnapshotPcbFileExtension );
 
         if( autoSaveFileName.FileExists() )
             wxRemoveFile( autoSaveFileName.GetFullPath() );
@@ -603,8 +611,10 @@ bool PCB_EDIT_FRAME::doAutoSave()
     wxFileName fn = tmpFileName;
 
     // Auto save file name is the normal file name prepended with
-    // autosaveFilePrefix string.
+    // autosaveFilePrefix string, and the auto save is a board snapshot,
+    // which is much quicker to write than a .kicad_pcb file.
     fn.SetName( autosaveFilePrefix + fn.GetName() );
+    fn.SetExt( SnapshotPcbFileExtension );
 
     wxLogTrace( traceAutoSave,
                 wxT( "Creating auto save file <" + fn.GetFullPath() ) + wxT( ">" ) );
@@ -0,0 +1,62 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file footprint_lib_caches.cpp
+ * @brief the counts of the footprint library writes the caches of all the PLUGINs see.
+ */
+
+#include <map>
+
+#include <footprint_lib_caches.h>
+
+
+// The footprint libraries can be read by several threads, see FOOTPRINT_LIST.
+static std::map< wxString, unsigned > s_writeCounts;
+
+
+unsigned FootprintLibWriteCount( const wxString& aLibraryPath )
+{
+    unsigned count = 0;
+
+#pragma omp critical( footprintLibWrites )
+    {
+        std::map< wxString, unsigned >::const_iterator it = s_writeCounts.find( aLibraryPath );
+
+        if( it != s_writeCounts.end() )
+            count = it->second;
+    }
+
+    return count;
+}
+
+
+unsigned CountFootprintLibWrite( const wxString& aLibraryPath )
+{
+    unsigned count;
+
+#pragma omp critical( footprintLibWrites )
+    count = ++s_writeCounts[ aLibraryPath ];
+
+    return count;
+}
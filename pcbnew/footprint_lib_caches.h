@@ -0,0 +1,253 @@
+/**
+ * @file footprint_lib_caches.h
+ * @brief the footprint library caches of a PLUGIN, the least recently used ones
+ *  discarded first.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef FOOTPRINT_LIB_CACHES_H_
+#define FOOTPRINT_LIB_CACHES_H_
+
+#include <list>
+#include <wx/string.h>
+
+
+/// The default memory size of the footprint libraries cached by a PLUGIN.
+#define FOOTPRINT_LIB_CACHES_MAX_SIZE   ( 128 * 1024 * 1024 )
+
+
+/**
+ * Function FootprintLibWriteCount
+ * @return unsigned - the count of the writes of the library \a aLibraryPath by the
+ *  PLUGINs of the program, counted by CountFootprintLibWrite().
+ */
+unsigned FootprintLibWriteCount( const wxString& aLibraryPath );
+
+/**
+ * Function CountFootprintLibWrite
+ * counts a write of the library \a aLibraryPath, so that the caches of it of all the
+ * PLUGINs are reloaded.  See FOOTPRINT_LIB_CACHES::Written().
+ * @return unsigned - the new count of the writes of the library.
+ */
+unsigned CountFootprintLibWrite( const wxString& aLibraryPath );
+
+
+/**
+ * Class FOOTPRINT_LIB_CACHES
+ * holds the caches of several footprint libraries for a PLUGIN, so that footprints
+ * looked up in several libraries in turn do not reload the libraries.  When the
+ * caches use more than their maximum memory size, the least recently used ones are
+ * deleted, but the last one.  A CACHE which loads its footprints lazily tells its
+ * growth with UpdateSize().
+ * <p>
+ * A cache is reloaded when its library was modified: when a PLUGIN of the program
+ * wrote the library since it was loaded, see Written(), or else when the library
+ * modification time changed.  The time may only count seconds, and cannot show the
+ * writes of the same second.
+ * </p><p>
+ * A CACHE is owned once added, and must have:
+ *   bool IsModified();         true if its library was modified since it was loaded
+ *   size_t GetMemorySize();    an estimation of the memory it uses
+ * </p>
+ */
+template< class CACHE >
+class FOOTPRINT_LIB_CACHES
+{
+public:
+    FOOTPRINT_LIB_CACHES( size_t aMaxSize = FOOTPRINT_LIB_CACHES_MAX_SIZE ) :
+        m_maxSize( aMaxSize ),
+        m_size( 0 ),
+        m_hitCount( 0 ),
+        m_missCount( 0 )
+    {
+    }
+
+    ~FOOTPRINT_LIB_CACHES()
+    {
+        Clear();
+    }
+
+    /**
+     * Function Find
+     * returns the cache of \a aLibraryPath and makes it the most recently used one.
+     * A cache whose library was written or modified is deleted.  Counts a hit or a miss.
+     *
+     * @param aLibraryPath is the library path, as given to Add().
+     * @return CACHE* - the cache, or NULL if the library must be loaded.
+     */
+    CACHE* Find( const wxString& aLibraryPath )
+    {
+        for( ITER it = m_caches.begin();  it != m_caches.end();  ++it )
+        {
+            if( it->m_Path != aLibraryPath )
+                continue;
+
+            if( it->m_WriteCount != FootprintLibWriteCount( aLibraryPath )
+                || it->m_Cache->IsModified() )
+            {
+                erase( it );
+                break;
+            }
+
+            m_caches.splice( m_caches.begin(), m_caches, it );
+            m_hitCount++;
+            return m_caches.front().m_Cache;
+        }
+
+        m_missCount++;
+        return NULL;
+    }
+
+    /**
+     * Function Add
+     * adds a loaded cache as the most recently used one, in place of any other cache
+     * of the same library, and deletes the least recently used caches over the
+     * maximum memory size.
+     */
+    void Add( const wxString& aLibraryPath, CACHE* aCache )
+    {
+        Remove( aLibraryPath );
+
+        ENTRY entry;
+
+        entry.m_Path  = aLibraryPath;
+        entry.m_Cache = aCache;
+        entry.m_Size  = aCache->GetMemorySize();
+        entry.m_WriteCount = FootprintLibWriteCount( aLibraryPath );
+
+        m_caches.push_front( entry );
+        m_size += entry.m_Size;
+
+        while( m_size > m_maxSize && m_caches.size() > 1 )
+            erase( --m_caches.end() );
+    }
+
+    /**
+     * Function UpdateSize
+     * adds to the memory size of \a aCache the \a aAddedSize of the footprints it
+     * loaded since it was added, and deletes the least recently used caches over the
+     * maximum memory size.  \a aCache, which is in use, is kept.
+     */
+    void UpdateSize( const CACHE* aCache, size_t aAddedSize )
+    {
+        ITER it = m_caches.begin();
+
+        while( it != m_caches.end() && it->m_Cache != aCache )
+            ++it;
+
+        if( it == m_caches.end() )
+            return;
+
+        it->m_Size += aAddedSize;
+        m_size += aAddedSize;
+
+        // the least recently used first
+        ITER victim = m_caches.end();
+
+        while( m_size > m_maxSize && victim != m_caches.begin() )
+        {
+            --victim;
+
+            if( victim->m_Cache != aCache )
+                erase( victim++ );
+        }
+    }
+
+    /**
+     * Function Written
+     * tells the caches of all the PLUGINs that the library \a aLibraryPath was written,
+     * or deleted.  The other PLUGINs will reload it.  The cache of it here, if any, must
+     * hold the library as written, it is kept.
+     */
+    void Written( const wxString& aLibraryPath )
+    {
+        unsigned count = CountFootprintLibWrite( aLibraryPath );
+
+        for( ITER it = m_caches.begin();  it != m_caches.end();  ++it )
+        {
+            if( it->m_Path == aLibraryPath )
+                it->m_WriteCount = count;
+        }
+    }
+
+    /**
+     * Function Remove
+     * deletes the cache of \a aLibraryPath, if any.
+     */
+    void Remove( const wxString& aLibraryPath )
+    {
+        for( ITER it = m_caches.begin();  it != m_caches.end();  ++it )
+        {
+            if( it->m_Path == aLibraryPath )
+            {
+                erase( it );
+                return;
+            }
+        }
+    }
+
+    void Clear()
+    {
+        while( m_caches.size() )
+            erase( m_caches.begin() );
+    }
+
+    unsigned GetCount() const           { return m_caches.size(); }
+
+    /// @return the memory size of the caches, see Add() and UpdateSize()
+    size_t GetMemorySize() const        { return m_size; }
+
+    /// @return the count of the libraries found in the caches by Find()
+    unsigned GetHitCount() const        { return m_hitCount; }
+
+    /// @return the count of the libraries Find() did not find in the caches
+    unsigned GetMissCount() const       { return m_missCount; }
+
+private:
+    struct ENTRY
+    {
+        wxString    m_Path;
+        CACHE*      m_Cache;
+        size_t      m_Size;
+        unsigned    m_WriteCount;   ///< FootprintLibWriteCount() of m_Path when loaded
+    };
+
+    typedef typename std::list< ENTRY >::iterator ITER;
+
+    std::list< ENTRY >  m_caches;       ///< the most recently used first
+    size_t              m_maxSize;
+    size_t              m_size;
+    unsigned            m_hitCount;
+    unsigned            m_missCount;
+
+    void erase( ITER aEntry )
+    {
+        m_size -= aEntry->m_Size;
+        delete aEntry->m_Cache;
+        m_caches.erase( aEntry );
+    }
+};
+
+#endif  // FOOTPRINT_LIB_CACHES_H_
@@ -210,6 +210,8 @@ public:
     wxDateTime GetLibModificationTime();
 
     bool IsModified();
+
+    size_t GetMemorySize();
 };
 
 
@@ -258,7 +260,11 @@ void GPCB_FPL_CACHE::Load()
             module->Reference().SetText( fn.GetName() );
         }
 
-        m_modules.insert( name, new GPCB_FPL_CACHE_ITEM( module, fn.GetName() ) );
+        GPCB_FPL_CACHE_ITEM* item = new GPCB_FPL_CACHE_ITEM( module, fn );
+
+        // the module is the file, IsModified() must be false until the file changes
+        item->UpdateModificationTime();
+        m_modules.insert( name, item );
 
     } while( dir.GetNext( &fpFileName ) );
 
@@ -319,6 +325,17 @@ bool GPCB_FPL_CACHE::IsModified()
 }
 
 
+size_t GPCB_FPL_CACHE::GetMemorySize()
+{
+    size_t size = sizeof( *this );
+
+    for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
+        size += sizeof( GPCB_FPL_CACHE_ITEM ) + it->second->GetModule()->GetMemorySize();
+
+    return size;
+}
+
+
 MODULE* GPCB_FPL_CACHE::parseMODULE( LINE_READER* aLineReader ) throw( IO_ERROR, PARSE_ERROR )
 {
     #define TEXT_DEFAULT_SIZE  ( 40*IU_PER_MILS )
@@ -801,7 +818,6 @@ GPCB_PLUGIN::GPCB_PLUGIN( int aControlFlags ) :
 
 GPCB_PLUGIN::~GPCB_PLUGIN()
 {
-    delete m_cache;
 }
 
 
@@ -813,12 +829,16 @@ void GPCB_PLUGIN::init( PROPERTIES* aProperties )
 
 void GPCB_PLUGIN::cacheLib( const wxString& aLibraryPath )
 {
-    if( !m_cache || m_cache->GetPath() != aLibraryPath || m_cache->IsModified() )
+    m_cache = m_caches.Find( aLibraryPath );
+
+    if( !m_cache )
     {
-        // a spectacular episode in memory management:
-        delete m_cache;
-        m_cache = new GPCB_FPL_CACHE( this, aLibraryPath );
-        m_cache->Load();
+        auto_ptr< GPCB_FPL_CACHE > cache( new GPCB_FPL_CACHE( this, aLibraryPath ) );
+
+        cache->Load();
+
+        m_cache = cache.release();
+        m_caches.Add( aLibraryPath, m_cache );
     }
 }
 
@@ -883,6 +903,7 @@ void GPCB_PLUGIN::FootprintDelete( const wxString& aLibraryPath, const wxString&
     }
 
     m_cache->Remove( aFootprintName );
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -953,11 +974,9 @@ bool GPCB_PLUGIN::FootprintLibDelete( const wxString& aLibraryPath, PROPERTIES*
     wxMilliSleep( 250L );
 #endif
 
-    if( m_cache && m_cache->GetPath() == aLibraryPath )
-    {
-        delete m_cache;
-        m_cache = NULL;
-    }
+    m_caches.Remove( aLibraryPath );
+    m_caches.Written( aLibraryPath );
+    m_cache = NULL;
 
     return true;
 }
@@ -33,6 +33,8 @@
 #include <io_mgr.h>
 #include <string>
 
+#include <footprint_lib_caches.h>
+
 
 class GPCB_FPL_CACHE;
 
@@ -87,14 +89,15 @@ protected:
 
     wxString        m_error;        ///< for throwing exceptions
     PROPERTIES*     m_props;        ///< passed via Save() or Load(), no ownership, may be NULL.
-    GPCB_FPL_CACHE* m_cache;        ///< Footprint library cache.
+    GPCB_FPL_CACHE* m_cache;        ///< the cache of the last library used, in m_caches
+    FOOTPRINT_LIB_CACHES< GPCB_FPL_CACHE > m_caches;   ///< Footprint library caches.
     int             m_ctl;
 
     LINE_READER*    m_reader;       ///< no ownership here.
     wxString        m_filename;     ///< for saves only, name is in m_reader for loads
 
 private:
-    /// we only cache one footprint library for now, this determines which one.
+    /// makes m_cache the cache of @a aLibraryPath, loading the library if needed.
     void cacheLib( const wxString& aLibraryPath );
 
     void init( PROPERTIES* aProperties );
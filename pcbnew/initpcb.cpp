@@ -11,6 +11,7 @@
 
 #include <pcbnew.h>
 #include <module_editor_frame.h>
+#include <drc_stuff.h>
 
 
 /**
@@ -45,6 +46,7 @@ bool PCB_EDIT_FRAME::Clear_Pcb( bool aQuery )
     // delete the old BOARD and create a new BOARD so that the default
     // layer names are put into the BOARD.
     SetBoard( new BOARD() );
+    m_drc->InvalidateLastRun();
     SetElementVisibility( GRID_VISIBLE, showGrid );
     SetElementVisibility( RATSNEST_VISIBLE, showRats );
 
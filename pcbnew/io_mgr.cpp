@@ -30,6 +30,7 @@
 #include <eagle_plugin.h>
 #include <pcad2kicadpcb_plugin/pcad_plugin.h>
 #include <gpcb_plugin.h>
+#include <snapshot_plugin.h>
 #include <wildcards_and_files_ext.h>
 
 #define FMT_UNIMPLEMENTED   _( "Plugin '%s' does not implement the '%s' function." )
@@ -72,6 +73,9 @@ PLUGIN* IO_MGR::PluginFind( PCB_FILE_T aFileType )
 
     case GEDA_PCB:
         return new GPCB_PLUGIN();
+
+    case SNAPSHOT:
+        return new SNAPSHOT_PLUGIN();
     }
 
     return NULL;
@@ -113,6 +117,9 @@ const wxString IO_MGR::ShowType( PCB_FILE_T aType )
 
     case GEDA_PCB:
         return wxString( wxT( "Geda-PCB" ) );
+
+    case SNAPSHOT:
+        return wxString( wxT( "Snapshot" ) );
     }
 }
 
@@ -138,6 +145,9 @@ IO_MGR::PCB_FILE_T IO_MGR::EnumFromStr( const wxString& aType )
     if( aType == wxT( "Geda-PCB" ) )
         return GEDA_PCB;
 
+    if( aType == wxT( "Snapshot" ) )
+        return SNAPSHOT;
+
     // wxASSERT( blow up here )
 
     return PCB_FILE_T( -1 );
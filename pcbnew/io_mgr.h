@@ -53,6 +53,7 @@ public:
         EAGLE,
         PCAD,
         GEDA_PCB,           //< Geda PCB file formats.
+        SNAPSHOT,           //< Binary board snapshot, for the auto save.
 
         // add your type here.
 
@@ -71,13 +71,16 @@ static const wxString traceFootprintLibrary( wxT( "KicadFootprintLib" ) );
  * that contain a single module per file.  This class is a helper only for the
  * footprint portion of the PLUGIN API, and only for the #PCB_IO plugin.  It is
  * private to this implementation file so it is not placed into a header.
+ *
+ * The module file is parsed only the first time the module is needed, see
+ * FP_CACHE::GetModule(), so that enumerating a library only lists its files.
  */
 class FP_CACHE_ITEM
 {
     wxFileName              m_file_name; ///< The the full file name and path of the footprint to cache.
     bool                    m_writable;  ///< Writability status of the footprint file.
     wxDateTime              m_mod_time;  ///< The last file modified time stamp.
-    auto_ptr< MODULE >      m_module;
+    auto_ptr< MODULE >      m_module;    ///< NULL until the module file is parsed.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const wxFileName& aFileName );
@@ -86,6 +89,7 @@ public:
     wxFileName  GetFileName() const { return m_file_name; }
     bool        IsModified() const;
     MODULE*     GetModule() const { return m_module.get(); }
+    void        SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
     void        UpdateModificationTime() { m_mod_time = m_file_name.GetModificationTime(); }
 };
 
@@ -124,6 +128,12 @@ public:
     bool IsWritable() const { return m_lib_path.IsOk() && m_lib_path.IsDirWritable(); }
     MODULE_MAP& GetModules() { return m_modules; }
 
+    /**
+     * Function GetModule
+     * returns the module of \a aItem, parsing its file the first time.
+     */
+    MODULE* GetModule( FP_CACHE_ITEM* aItem );
+
     // Most all functions in this class throw IO_ERROR exceptions.  There are no
     // error codes nor user interface calls from here, nor in any PLUGIN.
     // Catch these exceptions higher up please.
@@ -138,6 +148,8 @@ public:
     wxDateTime GetLibModificationTime();
 
     bool IsModified();
+
+    size_t GetMemorySize();
 };
 
 
@@ -172,7 +184,8 @@ void FP_CACHE::Save()
     {
         wxFileName fn = it->second->GetFileName();
 
-        if( fn.FileExists() && !it->second->IsModified() )
+        // a module which was never parsed is still only in its file
+        if( !it->second->GetModule() || ( fn.FileExists() && !it->second->IsModified() ) )
             continue;
 
         wxString tempFileName = fn.CreateTempFileName( fn.GetPath() );
@@ -222,14 +235,16 @@ void FP_CACHE::Load()
 
     do
     {
-        // reader now owns fp, will close on exception or return
-        FILE_LINE_READER    reader( fpFileName );
-
-        m_owner->m_parser->SetLineReader( &reader );
+        wxFileName fn( m_lib_path.GetPath(), fpFileName );
 
         std::string name = TO_UTF8( fpFileName );
 
-        m_modules.insert( name, new FP_CACHE_ITEM( (MODULE*) m_owner->m_parser->Parse(), fpFileName ) );
+        // the module is parsed by GetModule(), when it is needed
+        FP_CACHE_ITEM* item = new FP_CACHE_ITEM( NULL, fn );
+
+        // the module is the file, IsModified() must be false until the file changes
+        item->UpdateModificationTime();
+        m_modules.insert( name, item );
 
     } while( dir.GetNext( &fpFileName ) );
 
@@ -240,6 +255,24 @@ void FP_CACHE::Load()
 }
 
 
+MODULE* FP_CACHE::GetModule( FP_CACHE_ITEM* aItem )
+{
+    if( !aItem->GetModule() )
+    {
+        // reader now owns fp, will close on exception or return
+        FILE_LINE_READER    reader( aItem->GetFileName().GetFullPath() );
+
+        m_owner->m_parser->SetLineReader( &reader );
+
+        aItem->SetModule( (MODULE*) m_owner->m_parser->Parse() );
+
+        m_owner->m_caches.UpdateSize( this, aItem->GetModule()->GetMemorySize() );
+    }
+
+    return aItem->GetModule();
+}
+
+
 void FP_CACHE::Remove( const wxString& aFootprintName )
 {
 
@@ -290,18 +323,41 @@ bool FP_CACHE::IsModified()
 }
 
 
+size_t FP_CACHE::GetMemorySize()
+{
+    size_t size = sizeof( *this );
+
+    for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
+    {
+        size += sizeof( FP_CACHE_ITEM );
+
+        if( it->second->GetModule() )
+            size += it->second->GetModule()->GetMemorySize();
+    }
+
+    return size;
+}
+
+
 void PCB_IO::Save( const wxString& aFileName, BOARD* aBoard, PROPERTIES* aProperties )
 {
     LOCALE_IO   toggle;     // toggles on, then off, the C locale.
 
-    m_board = aBoard;
-
     FILE_OUTPUTFORMATTER    formatter( aFileName );
 
-    m_out = &formatter;     // no ownership
+    FormatBoard( aBoard, &formatter );
+}
+
+
+void PCB_IO::FormatBoard( BOARD* aBoard, OUTPUTFORMATTER* aFormatter ) throw( IO_ERROR )
+{
+    LOCALE_IO   toggle;     // public API function, perform anything convenient for caller
+
+    m_board = aBoard;
+    m_out   = aFormatter;   // no ownership
 
     m_out->Print( 0, "(kicad_pcb (version %d) (host pcbnew %s)\n", SEXPR_BOARD_FILE_VERSION,
-                  formatter.Quotew( GetBuildVersion() ).c_str() );
+                  m_out->Quotew( GetBuildVersion() ).c_str() );
 
     Format( aBoard, 1 );
 
@@ -612,11 +668,14 @@ void PCB_IO::format( BOARD* aBoard, int aNestLevel ) const
     // Do not save MARKER_PCBs, they can be regenerated easily.
 
     // Save the tracks and vias.
-    for( TRACK* track = aBoard->m_Track;  track; track = track->Next() )
-        Format( track, aNestLevel );
+    if( !( m_ctl & CTL_OMIT_TRACKS ) )
+    {
+        for( TRACK* track = aBoard->m_Track;  track; track = track->Next() )
+            Format( track, aNestLevel );
 
-    if( aBoard->m_Track.GetCount() )
-        m_out->Print( 0, "\n" );
+        if( aBoard->m_Track.GetCount() )
+            m_out->Print( 0, "\n" );
+    }
 
     /// @todo Add warning here that the old segment filed zones are no longer supported and
     ///       will not be saved.
@@ -1450,7 +1509,7 @@ void PCB_IO::format( ZONE_CONTAINER* aZone, int aNestLevel ) const
     const std::vector< CPolyPt >& fv = aZone->GetFilledPolysList();
     newLine = 0;
 
-    if( fv.size() )
+    if( fv.size() && !( m_ctl & CTL_OMIT_ZONE_FILLS ) )
     {
         m_out->Print( aNestLevel+1, "(filled_polygon\n" );
         m_out->Print( aNestLevel+2, "(pts\n" );
@@ -1537,14 +1596,13 @@ PCB_IO::PCB_IO( int aControlFlags ) :
 
 PCB_IO::~PCB_IO()
 {
-    delete m_cache;
     delete m_parser;
 }
 
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    MMAP_LINE_READER    reader( aFileName );
 
     m_parser->SetLineReader( &reader );
     m_parser->SetBoard( aAppendToMe );
@@ -1569,12 +1627,16 @@ void PCB_IO::init( PROPERTIES* aProperties )
 
 void PCB_IO::cacheLib( const wxString& aLibraryPath )
 {
-    if( !m_cache || m_cache->GetPath() != aLibraryPath || m_cache->IsModified() )
+    m_cache = m_caches.Find( aLibraryPath );
+
+    if( !m_cache )
     {
-        // a spectacular episode in memory management:
-        delete m_cache;
-        m_cache = new FP_CACHE( this, aLibraryPath );
-        m_cache->Load();
+        auto_ptr< FP_CACHE > cache( new FP_CACHE( this, aLibraryPath ) );
+
+        cache->Load();
+
+        m_cache = cache.release();
+        m_caches.Add( aLibraryPath, m_cache );
     }
 }
 
@@ -1609,17 +1671,17 @@ MODULE* PCB_IO::FootprintLoad( const wxString& aLibraryPath, const wxString& aFo
 
     cacheLib( aLibraryPath );
 
-    const MODULE_MAP& mods = m_cache->GetModules();
+    MODULE_MAP& mods = m_cache->GetModules();
 
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE_ITER it = mods.find( TO_UTF8( aFootprintName ) );
 
     if( it == mods.end() )
     {
         return NULL;
     }
 
-    // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second->GetModule() );
+    // copy constructor to clone the cached MODULE
+    return new MODULE( *m_cache->GetModule( it->second ) );
 }
 
 
@@ -1687,6 +1749,7 @@ void PCB_IO::FootprintSave( const wxString& aLibraryPath, const MODULE* aFootpri
                 fn.GetFullPath().GetData() );
     mods.insert( footprintName, new FP_CACHE_ITEM( module, fn ) );
     m_cache->Save();
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -1705,6 +1768,7 @@ void PCB_IO::FootprintDelete( const wxString& aLibraryPath, const wxString& aFoo
     }
 
     m_cache->Remove( aFootprintName );
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -1720,9 +1784,13 @@ void PCB_IO::FootprintLibCreate( const wxString& aLibraryPath, PROPERTIES* aProp
 
     init( aProperties );
 
-    delete m_cache;
-    m_cache = new FP_CACHE( this, aLibraryPath );
-    m_cache->Save();
+    auto_ptr< FP_CACHE > cache( new FP_CACHE( this, aLibraryPath ) );
+
+    cache->Save();
+
+    m_cache = cache.release();
+    m_caches.Add( aLibraryPath, m_cache );
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -1793,11 +1861,9 @@ bool PCB_IO::FootprintLibDelete( const wxString& aLibraryPath, PROPERTIES* aProp
     wxMilliSleep( 250L );
 #endif
 
-    if( m_cache && m_cache->GetPath() == aLibraryPath )
-    {
-        delete m_cache;
-        m_cache = NULL;
-    }
+    m_caches.Remove( aLibraryPath );
+    m_caches.Written( aLibraryPath );
+    m_cache = NULL;
 
     return true;
 }
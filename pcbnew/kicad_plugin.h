@@ -27,6 +27,8 @@
 #include <io_mgr.h>
 #include <string>
 
+#include <footprint_lib_caches.h>
+
 class BOARD;
 class BOARD_ITEM;
 class FP_CACHE;
@@ -43,6 +45,12 @@ class PCB_PARSER;
 
 #define CTL_OMIT_TSTAMPS            (1 << 2)
 
+/// Omit the tracks and vias of a BOARD
+#define CTL_OMIT_TRACKS             (1 << 3)
+
+/// Omit the filled polygons of the zones
+#define CTL_OMIT_ZONE_FILLS         (1 << 4)
+
 // common combinations of the above:
 
 /// Format output for the clipboard instead of footprint library or BOARD
@@ -121,6 +129,16 @@ public:
     void Format( BOARD_ITEM* aItem, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
+    /**
+     * Function FormatBoard
+     * outputs \a aBoard to \a aFormatter as Save() does to a file.
+     *
+     * @param aBoard The #BOARD to format.
+     * @param aFormatter Where to output the board, no ownership.
+     * @throw IO_ERROR on write error.
+     */
+    void FormatBoard( BOARD* aBoard, OUTPUTFORMATTER* aFormatter ) throw( IO_ERROR );
+
     std::string GetStringOutput( bool doClear )
     {
         std::string ret = m_sf.GetString();
@@ -140,7 +158,8 @@ protected:
     wxString        m_error;        ///< for throwing exceptions
     BOARD*          m_board;        ///< which BOARD, no ownership here
     PROPERTIES*     m_props;        ///< passed via Save() or Load(), no ownership, may be NULL.
-    FP_CACHE*       m_cache;        ///< Footprint library cache.
+    FP_CACHE*       m_cache;        ///< the cache of the last library used, in m_caches
+    FOOTPRINT_LIB_CACHES< FP_CACHE > m_caches;  ///< Footprint library caches.
 
     LINE_READER*    m_reader;       ///< no ownership here.
     wxString        m_filename;     ///< for saves only, name is in m_reader for loads
@@ -192,7 +211,7 @@ private:
     void formatLayers( int aLayerMask, int aNestLevel = 0 ) const
         throw( IO_ERROR );
 
-    /// we only cache one footprint library for now, this determines which one.
+    /// makes m_cache the cache of @a aLibraryPath, loading the library if needed.
     void cacheLib( const wxString& aLibraryPath );
 
     void init( PROPERTIES* aProperties );
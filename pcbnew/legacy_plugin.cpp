@@ -62,9 +62,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <algorithm>
 #include <wx/ffile.h>
 
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <legacy_plugin.h>   // implement this here
+#include <openmp_threads.h>
+#include <parallel_loader.h>
 
 #include <kicad_string.h>
 #include <macros.h>
@@ -83,6 +88,7 @@
 #include <pcb_plot_params.h>
 #include <drawtxt.h>
 #include <convert_to_biu.h>
+#include <parse_double.h>
 #include <trigo.h>
 #include <build_version.h>
 
@@ -108,6 +114,27 @@ typedef LEGACY_PLUGIN::BIU      BIU;
 static const char delims[] = " \t\r\n";
 
 
+/// The bytes of board sections read before loading them in parallel.
+static const size_t LOAD_BATCH_SIZE = 4 * 1024 * 1024;
+
+/// The lines of a $TRACK or $ZONE list loaded as one section, two lines per segment.
+static const int TRACK_SECTION_LINES = 4096;
+
+
+/**
+ * Struct SECTION_TEXT
+ * is the text of a $MODULE, $CZONE_OUTLINE, or of a part of a $TRACK or $ZONE list,
+ * read by LEGACY_PLUGIN::readSectionText(), and its items once loaded.
+ */
+struct LEGACY_PLUGIN::SECTION_TEXT
+{
+    std::string                 m_Text;         ///< the lines after the first one, to its end
+    int                         m_LineNumber;   ///< the line number before the first line of m_Text
+    int                         m_Type;         ///< the type given to readSectionText()
+    std::vector<BOARD_ITEM*>    m_Items;        ///< the loaded items
+};
+
+
 static bool inline isSpace( int c ) { return strchr( delims, c ) != 0; }
 
 
@@ -238,7 +265,7 @@ BOARD* LEGACY_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe, PROPE
     // delete on exception, iff I own m_board, according to aAppendToMe
     auto_ptr<BOARD> deleter( aAppendToMe ? NULL : m_board );
 
-    FILE_LINE_READER    reader( aFileName );
+    MMAP_LINE_READER    reader( aFileName );
 
     m_reader = &reader;          // member function accessibility
 
@@ -262,8 +289,49 @@ void LEGACY_PLUGIN::loadAllSections( bool doAppend )
     // Then follows $EQUIPOT and all the rest
     char* line;
 
+    // The modules, tracks and zones are read without being loaded, and loaded in
+    // parallel by batches of LOAD_BATCH_SIZE bytes.
+    bool                        parallel = OpenMPThreadCount() > 1;
+    std::vector<SECTION_TEXT>   sections;
+    size_t                      sectionsSize = 0;
+
     while( ( line = READLINE( m_reader ) ) != NULL )
     {
+        if( parallel )
+        {
+            int type = NOT_USED;
+
+            if( TESTLINE( "$MODULE" ) )
+                type = PCB_MODULE_T;
+            else if( TESTLINE( "$TRACK" ) )
+                type = PCB_TRACE_T;
+            else if( TESTLINE( "$ZONE" ) )
+                type = PCB_ZONE_T;
+            else if( TESTLINE( "$CZONE_OUTLINE" ) )
+                type = PCB_ZONE_AREA_T;
+
+            if( type != NOT_USED )
+            {
+                sectionsSize += readSectionText( sections, type );
+
+                if( sectionsSize >= LOAD_BATCH_SIZE )
+                {
+                    loadSections( sections );
+                    sectionsSize = 0;
+                }
+
+                continue;
+            }
+
+            // The sections read so far are added to the board before the next
+            // section is loaded, as they are when loaded one by one.
+            if( sections.size() )
+            {
+                loadSections( sections );
+                sectionsSize = 0;
+            }
+        }
+
         // put the more frequent ones at the top, but realize TRACKs are loaded as a group
 
         if( TESTLINE( "$MODULE" ) )
@@ -352,6 +420,187 @@ void LEGACY_PLUGIN::loadAllSections( bool doAppend )
 }
 
 
+void LEGACY_PLUGIN::addBoardItem( BOARD_ITEM* aItem )
+{
+    if( m_detached )
+    {
+        m_detached->push_back( aItem );
+        return;
+    }
+
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        m_board->m_Track.Append( (TRACK*) aItem );
+        break;
+
+    case PCB_ZONE_T:
+        m_board->m_Zone.Append( (SEGZONE*) aItem );
+        break;
+
+    default:
+        m_board->Add( aItem, ADD_APPEND );
+    }
+}
+
+
+size_t LEGACY_PLUGIN::readSectionText( std::vector<SECTION_TEXT>& aSections, int aType )
+{
+    bool    trackList = aType == PCB_TRACE_T || aType == PCB_ZONE_T;
+    int     lineCount = 0;
+    size_t  size = 0;
+    char*   line;
+
+    aSections.push_back( SECTION_TEXT() );
+    aSections.back().m_LineNumber = m_reader->LineNumber();
+    aSections.back().m_Type       = aType;
+
+    while( ( line = READLINE( m_reader ) ) != NULL )
+    {
+        if( trackList )
+        {
+            // a list is split before a "Po" line, the first line of a segment, and
+            // each part but the last one is ended as the list, for loadTrackList().
+            if( lineCount >= TRACK_SECTION_LINES && TESTLINE( "Po" ) )
+            {
+                aSections.back().m_Text += aType == PCB_TRACE_T ? "$EndTRACK\n" : "$EndZONE\n";
+                size += aSections.back().m_Text.size();
+
+                aSections.push_back( SECTION_TEXT() );
+                aSections.back().m_LineNumber = m_reader->LineNumber() - 1;
+                aSections.back().m_Type       = aType;
+                            lineCount = 0;
+            }
+
+            ++lineCount;
+        }
+
+        aSections.back().m_Text.append( line, m_reader->Length() );
+
+        if( trackList )
+        {
+            if( line[0] == '$' )    // $EndTRACK or $EndZONE
+                break;
+        }
+        else if( aType == PCB_MODULE_T )
+        {
+            if( TESTLINE( "$EndMODULE" ) )
+                break;
+        }
+        else if( TESTLINE( "$endCZONE_OUTLINE" ) )
+            break;
+    }
+
+    // At the end of the file, the section is not ended, and its error is reported by
+    // loadSections().
+    return size + aSections.back().m_Text.size();
+}
+
+
+void LEGACY_PLUGIN::loadSectionText( SECTION_TEXT& aSection, const wxString& aSource )
+{
+    STRING_LINE_READER  reader( aSection.m_Text, aSource, aSection.m_LineNumber );
+
+    m_reader   = &reader;
+    m_detached = &aSection.m_Items;
+
+    try
+    {
+        switch( aSection.m_Type )
+        {
+        case PCB_MODULE_T:
+            addBoardItem( LoadMODULE() );
+            break;
+
+        case PCB_TRACE_T:
+        case PCB_ZONE_T:
+            loadTrackList( aSection.m_Type );
+            break;
+
+        case PCB_ZONE_AREA_T:
+            loadZONE_CONTAINER();
+            break;
+        }
+    }
+    catch( ... )
+    {
+        for( unsigned ii = 0; ii < aSection.m_Items.size(); ++ii )
+            delete aSection.m_Items[ii];
+
+        aSection.m_Items.clear();
+
+        m_reader   = NULL;
+        m_detached = NULL;
+        throw;
+    }
+
+    m_reader   = NULL;
+    m_detached = NULL;
+}
+
+
+/**
+ * Class SECTION_LOADER
+ * loads the sections of loadSections() with one LEGACY_PLUGIN per thread.
+ */
+class LEGACY_PLUGIN::SECTION_LOADER : public PARALLEL_LOADER<SECTION_TEXT>
+{
+public:
+    SECTION_LOADER( LEGACY_PLUGIN* aPlugin ) :
+        m_plugin( aPlugin ),
+        m_source( aPlugin->m_reader->GetSource() )
+    {
+    }
+
+protected:
+    // The plugins of the threads, with the units and the version of the file.
+    void makeLoaders( int aCount )
+    {
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            LEGACY_PLUGIN* loader = new LEGACY_PLUGIN();
+
+            loader->m_board     = m_plugin->m_board;
+            loader->m_props     = m_plugin->m_props;
+            loader->diskToBiu   = m_plugin->diskToBiu;
+            loader->m_loading_format_version = m_plugin->m_loading_format_version;
+            m_loaders.push_back( loader );
+        }
+    }
+
+    void loadPart( SECTION_TEXT& aSection, int aLoader )
+    {
+        m_loaders[aLoader].loadSectionText( aSection, m_source );
+    }
+
+    void addPart( SECTION_TEXT& aSection )
+    {
+        for( unsigned ii = 0; ii < aSection.m_Items.size(); ++ii )
+            m_plugin->addBoardItem( aSection.m_Items[ii] );
+    }
+
+    void deletePart( SECTION_TEXT& aSection )
+    {
+        for( unsigned ii = 0; ii < aSection.m_Items.size(); ++ii )
+            delete aSection.m_Items[ii];
+    }
+
+private:
+    LEGACY_PLUGIN*                      m_plugin;
+    const wxString                      m_source;
+    boost::ptr_vector<LEGACY_PLUGIN>    m_loaders;
+};
+
+
+void LEGACY_PLUGIN::loadSections( std::vector<SECTION_TEXT>& aSections )
+{
+    SECTION_LOADER loader( this );
+
+    loader.Load( aSections, 1 );
+}
+
+
 void LEGACY_PLUGIN::checkVersion()
 {
     // Read first line and TEST if it is a PCB file format header like this:
@@ -395,7 +644,8 @@ void LEGACY_PLUGIN::loadGENERAL()
         if( TESTLINE( "Units" ) )
         {
             // what are the engineering units of the lengths in the BOARD?
-            data = strtok( line + SZ("Units"), delims );
+            char*   saveptr;
+            data = strtok_r( line + SZ("Units"), delims, &saveptr );
 
             if( !strcmp( data, "mm" ) )
             {
@@ -518,7 +768,8 @@ void LEGACY_PLUGIN::loadSHEET()
             // width and height are in 1/1000th of an inch, always
 
             PAGE_INFO   page;
-            char*       sname  = strtok( line + SZ( "Sheet" ), delims );
+            char*       saveptr;
+            char*       sname  = strtok_r( line + SZ( "Sheet" ), delims, &saveptr );
 
             if( sname )
             {
@@ -530,9 +781,9 @@ void LEGACY_PLUGIN::loadSHEET()
                     THROW_IO_ERROR( m_error );
                 }
 
-                char*   width  = strtok( NULL, delims );
-                char*   height = strtok( NULL, delims );
-                char*   orient = strtok( NULL, delims );
+                char*   width  = strtok_r( NULL, delims, &saveptr );
+                char*   height = strtok_r( NULL, delims, &saveptr );
+                char*   orient = strtok_r( NULL, delims, &saveptr );
 
                 // only parse the width and height if page size is custom ("User")
                 if( wname == PAGE_INFO::Custom )
@@ -659,13 +910,14 @@ void LEGACY_PLUGIN::loadSETUP()
 
             int   layer = intParse( line + SZ( "Layer[" ), &data );
 
-            data = strtok( (char*) data+1, delims );    // +1 for ']'
+            char*   saveptr;
+            data = strtok_r( (char*) data+1, delims, &saveptr );    // +1 for ']'
             if( data )
             {
                 wxString layerName = FROM_UTF8( data );
                 m_board->SetLayerName( layer, layerName );
 
-                data = strtok( NULL, delims );
+                data = strtok_r( NULL, delims, &saveptr );
                 if( data )  // optional in old board files
                 {
                     LAYER_T type = LAYER::ParseType( data );
@@ -735,7 +987,8 @@ void LEGACY_PLUGIN::loadSETUP()
             BIU drill    = 0;
             BIU diameter = biuParse( line + SZ( "ViaSizeList" ), &data );
 
-            data = strtok( (char*) data, delims );
+            char*   saveptr;
+            data = strtok_r( (char*) data, delims, &saveptr );
             if( data )  // DRILL may not be present ?
                 drill = biuParse( data );
 
@@ -840,7 +1093,7 @@ void LEGACY_PLUGIN::loadSETUP()
 
         else if( TESTLINE( "Pad2PasteClearanceRatio" ) )
         {
-            double ratio = atof( line + SZ( "Pad2PasteClearanceRatio" ) );
+            double ratio = ParseDouble( line + SZ( "Pad2PasteClearanceRatio" ) );
             bds.m_SolderPasteMarginRatio = ratio;
         }
 
@@ -974,7 +1227,8 @@ MODULE* LEGACY_PLUGIN::LoadMODULE()
             long edittime  = hexParse( data, &data );
             time_t timestamp = hexParse( data, &data );
 
-            data = strtok( (char*) data+1, delims );
+            char*   saveptr;
+            data = strtok_r( (char*) data+1, delims, &saveptr );
 
             // data is now a two character long string
             // Note: some old files do not have this field
@@ -1044,7 +1298,8 @@ MODULE* LEGACY_PLUGIN::LoadMODULE()
         else if( TESTLINE( "AR" ) )         // Alternate Reference
         {
             // e.g. "AR /47BA2624/45525076"
-            data = strtok( line + SZ( "AR" ), delims );
+            char*   saveptr;
+            data = strtok_r( line + SZ( "AR" ), delims, &saveptr );
             module->SetPath( FROM_UTF8( data ) );
         }
 
@@ -1066,7 +1321,7 @@ MODULE* LEGACY_PLUGIN::LoadMODULE()
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             // Due to a bug in dialog editor in Modedit, fixed in BZR version 3565
             // this parameter can be broken.
             // It should be >= -50% (no solder paste) and <= 0% (full area of the pad)
@@ -1212,17 +1467,18 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
 
             PAD_SHAPE_T drShape = PAD_CIRCLE;
 
-            data = strtok( (char*) data, delims );
+            char*   saveptr;
+            data = strtok_r( (char*) data, delims, &saveptr );
             if( data )  // optional shape
             {
                 if( data[0] == 'O' )
                 {
                     drShape = PAD_OVAL;
 
-                    data    = strtok( NULL, delims );
+                    data    = strtok_r( NULL, delims, &saveptr );
                     drill_x = biuParse( data );
 
-                    data    = strtok( NULL, delims );
+                    data    = strtok_r( NULL, delims, &saveptr );
                     drill_y = biuParse( data );
                 }
             }
@@ -1240,7 +1496,8 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
             PAD_ATTR_T  attribute;
             int         layer_mask;
 
-            data = strtok( line + SZ( "At" ), delims );
+            char*   saveptr;
+            data = strtok_r( line + SZ( "At" ), delims, &saveptr );
 
             if( !strcmp( data, "SMD" ) )
                 attribute = PAD_SMD;
@@ -1251,8 +1508,8 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
             else
                 attribute = PAD_STANDARD;
 
-            data = strtok( NULL, delims );  // skip BufCar
-            data = strtok( NULL, delims );
+            data = strtok_r( NULL, delims, &saveptr );  // skip BufCar
+            data = strtok_r( NULL, delims, &saveptr );
 
             layer_mask = hexParse( data );
 
@@ -1300,7 +1557,7 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             pad->SetLocalSolderPasteMarginRatio( tmp );
         }
 
@@ -1540,14 +1797,15 @@ void LEGACY_PLUGIN::loadMODULE_TEXT( TEXTE_MODULE* aText )
 
     // after switching to strtok, there's no easy coming back because of the
     // embedded nul(s?) placed to the right of the current field.
-    char*   mirror  = strtok( (char*) data, delims );
-    char*   hide    = strtok( NULL, delims );
-    char*   tmp     = strtok( NULL, delims );
+    char*   saveptr;
+    char*   mirror  = strtok_r( (char*) data, delims, &saveptr );
+    char*   hide    = strtok_r( NULL, delims, &saveptr );
+    char*   tmp     = strtok_r( NULL, delims, &saveptr );
     int     layer   = tmp ? intParse( tmp ) : SILKSCREEN_N_FRONT;
-    char*   italic  = strtok( NULL, delims );
+    char*   italic  = strtok_r( NULL, delims, &saveptr );
 
-    char*   hjust   = strtok( (char*) txt_end, delims );
-    char*   vjust   = strtok( NULL, delims );
+    char*   hjust   = strtok_r( (char*) txt_end, delims, &saveptr );
+    char*   vjust   = strtok_r( NULL, delims, &saveptr );
 
     if( type != TEXT_is_REFERENCE && type != TEXT_is_VALUE )
         type = TEXT_is_DIVERS;
@@ -1695,8 +1953,9 @@ void LEGACY_PLUGIN::loadPCB_LINE()
             BIU     x = 0;
             BIU     y;
 
-            data = strtok( line + SZ( "De" ), delims );
-            for( int i = 0;  data;  ++i, data = strtok( NULL, delims ) )
+            char*   saveptr;
+            data = strtok_r( line + SZ( "De" ), delims, &saveptr );
+            for( int i = 0;  data;  ++i, data = strtok_r( NULL, delims, &saveptr ) )
             {
                 switch( i )
                 {
@@ -1896,9 +2155,10 @@ void LEGACY_PLUGIN::loadPCB_TEXT()
             int     layer       = intParse( line + SZ( "De" ), &data );
             int     notMirrored = intParse( data, &data );
             time_t  timestamp   = hexParse( data, &data );
-            char*   style       = strtok( (char*) data, delims );
-            char*   hJustify    = strtok( NULL, delims );
-            char*   vJustify    = strtok( NULL, delims );
+            char*   saveptr;
+            char*   style       = strtok_r( (char*) data, delims, &saveptr );
+            char*   hJustify    = strtok_r( NULL, delims, &saveptr );
+            char*   vJustify    = strtok_r( NULL, delims, &saveptr );
 
             pcbtxt->SetMirrored( !notMirrored );
             pcbtxt->SetTimeStamp( timestamp );
@@ -1961,7 +2221,8 @@ void LEGACY_PLUGIN::loadTrackList( int aStructType )
         BIU width   = biuParse( data, &data );
 
         // optional 7th drill parameter (must be optional in an old format?)
-        data = strtok( (char*) data, delims );
+        char*   saveptr;
+        data = strtok_r( (char*) data, delims, &saveptr );
 
         BIU drill   = data ? biuParse( data ) : -1;     // SetDefault() if < 0
 
@@ -2007,20 +2268,19 @@ void LEGACY_PLUGIN::loadTrackList( int aStructType )
         default:
         case PCB_TRACE_T:
             newTrack = new TRACK( m_board );
-            m_board->m_Track.Append( newTrack );
             break;
 
         case PCB_VIA_T:
             newTrack = new SEGVIA( m_board );
-            m_board->m_Track.Append( newTrack );
             break;
 
         case PCB_ZONE_T:     // this is now deprecated, but exist in old boards
             newTrack = new SEGZONE( m_board );
-            m_board->m_Zone.Append( (SEGZONE*) newTrack );
             break;
         }
 
+        addBoardItem( newTrack );
+
         newTrack->SetTimeStamp( timeStamp );
 
         newTrack->SetPosition( wxPoint( start_x, start_y ) );
@@ -2205,7 +2465,8 @@ void LEGACY_PLUGIN::loadZONE_CONTAINER()
         {
             // e.g. "ZAux 7 E"
             int     ignore = intParse( line + SZ( "ZAux" ), &data );
-            char*   hopt   = strtok( (char*) data, delims );
+            char*   saveptr;
+            char*   hopt   = strtok_r( (char*) data, delims, &saveptr );
 
             if( !hopt )
             {
@@ -2249,27 +2510,28 @@ void LEGACY_PLUGIN::loadZONE_CONTAINER()
         {
             zc->SetIsKeepout( true );
             // e.g. "ZKeepout tracks N vias N pads Y"
-           data = strtok( line + SZ( "ZKeepout" ), delims );
+            char*   saveptr;
+            data = strtok_r( line + SZ( "ZKeepout" ), delims, &saveptr );
 
             while( data )
             {
                 if( !strcmp( data, "tracks" ) )
                 {
-                    data = strtok( NULL, delims );
+                    data = strtok_r( NULL, delims, &saveptr );
                     zc->SetDoNotAllowTracks( data && *data == 'N' );
                 }
                 else if( !strcmp( data, "vias" ) )
                 {
-                    data = strtok( NULL, delims );
+                    data = strtok_r( NULL, delims, &saveptr );
                     zc->SetDoNotAllowVias( data && *data == 'N' );
                 }
                 else if( !strcmp( data, "copperpour" ) )
                 {
-                    data = strtok( NULL, delims );
+                    data = strtok_r( NULL, delims, &saveptr );
                     zc->SetDoNotAllowCopperPour( data && *data == 'N' );
                 }
 
-                data = strtok( NULL, delims );
+                data = strtok_r( NULL, delims, &saveptr );
             }
         }
 
@@ -2300,7 +2562,8 @@ void LEGACY_PLUGIN::loadZONE_CONTAINER()
         {
             // e.g. "ZClearance 40 I"
             BIU     clearance = biuParse( line + SZ( "ZClearance" ), &data );
-            char*   padoption = strtok( (char*) data, delims );  // data: " I"
+            char*   saveptr;
+            char*   padoption = strtok_r( (char*) data, delims, &saveptr );  // data: " I"
 
             ZoneConnection popt;
             switch( *padoption )
@@ -2392,7 +2655,7 @@ void LEGACY_PLUGIN::loadZONE_CONTAINER()
                                       Mils2iu( CPolyLine::GetDefaultHatchPitchMils() ),
                                       true );
 
-                m_board->Add( zc.release() );
+                addBoardItem( zc.release() );
             }
 
             return;     // preferred exit
@@ -2462,7 +2725,8 @@ void LEGACY_PLUGIN::loadDIMENSION()
             BIU     height = biuParse( data, &data );
             BIU     thickn = biuParse( data, &data );
             double  orient = degParse( data, &data );
-            char*   mirror = strtok( (char*) data, delims );
+            char*   saveptr;
+            char*   mirror = strtok_r( (char*) data, delims, &saveptr );
 
             // This sets both DIMENSION's position and internal m_Text's.
             // @todo: But why do we even know about internal m_Text?
@@ -2714,13 +2978,12 @@ std::string LEGACY_PLUGIN::fmtBIUPair( BIU first, BIU second ) const
 
 BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
+    const char* nptr;
+    bool        outOfRange;
 
-    errno = 0;
+    double fval = ParseDouble( aValue, &nptr, &outOfRange );
 
-    double fval = strtod( aValue, &nptr );
-
-    if( errno )
+    if( outOfRange )
     {
         m_error.Printf( _( "invalid float number in\nfile: '%s'\nline: %d\noffset: %d" ),
             m_reader->GetSource().GetData(), m_reader->LineNumber(), aValue - m_reader->Line() + 1 );
@@ -2749,13 +3012,12 @@ BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 
 double LEGACY_PLUGIN::degParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
-
-    errno = 0;
+    const char* nptr;
+    bool        outOfRange;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = ParseDouble( aValue, &nptr, &outOfRange );
 
-    if( errno )
+    if( outOfRange )
     {
         m_error.Printf( _( "invalid float number in\nfile: '%s'\nline: %d\noffset: %d" ),
             m_reader->GetSource().GetData(), m_reader->LineNumber(), aValue - m_reader->Line() + 1 );
@@ -3838,13 +4100,14 @@ void LEGACY_PLUGIN::savePCB_TEXT( const TEXTE_PCB* me ) const
 
     The legacy file format is being obsoleted and this code will have a short
     lifetime, so it only needs to be good enough for a short duration of time.
-    Caching all the MODULEs is a bit memory intensive, but it is a considerably
-    faster way of fulfilling the API contract. Otherwise, without the cache, you
-    would have to re-read the file when searching for any MODULE, and this would
-    be very problematic filling a FOOTPRINT_LIST via this PLUGIN API. If memory
-    becomes a concern, consider the cache lifetime policy, which determines the
-    time that a FPL_CACHE is in RAM. Note PLUGIN lifetime also plays a role in
-    cache lifetime.
+    The cache holds where each footprint is in the library file, found by a light
+    scan of its lines, and a footprint is parsed into a MODULE only the first time
+    it is loaded: enumerating or searching a huge library does not build all of
+    its MODULEs. Otherwise, without the cache, you would have to re-read the file
+    when searching for any MODULE, and this would be very problematic filling a
+    FOOTPRINT_LIST via this PLUGIN API. If memory becomes a concern, consider the
+    cache lifetime policy, which determines the time that a FPL_CACHE is in RAM.
+    Note PLUGIN lifetime also plays a role in cache lifetime.
 
 */
 
@@ -3852,9 +4115,31 @@ void LEGACY_PLUGIN::savePCB_TEXT( const TEXTE_PCB* me ) const
 #include <boost/ptr_container/ptr_map.hpp>
 #include <wx/filename.h>
 
-typedef boost::ptr_map< std::string, MODULE >   MODULE_MAP;
-typedef MODULE_MAP::iterator                    MODULE_ITER;
-typedef MODULE_MAP::const_iterator              MODULE_CITER;
+/**
+ * Struct FPL_CACHE_ITEM
+ * is a footprint of a FPL_CACHE: where its lines are in the library file, and its
+ * MODULE once it is loaded.
+ */
+struct FPL_CACHE_ITEM
+{
+    long                m_offset;   ///< of its $MODULE line in the library file
+    long                m_size;     ///< of its lines, up to its $EndMODULE line
+    unsigned            m_line;     ///< the line number of its $MODULE line
+    auto_ptr< MODULE >  m_module;   ///< NULL until loaded by FPL_CACHE::GetModule()
+
+    FPL_CACHE_ITEM( MODULE* aModule = NULL ) :
+        m_offset( 0 ),
+        m_size( 0 ),
+        m_line( 0 ),
+        m_module( aModule )
+    {
+    }
+};
+
+
+typedef boost::ptr_map< std::string, FPL_CACHE_ITEM >   MODULE_MAP;
+typedef MODULE_MAP::iterator                            MODULE_ITER;
+typedef MODULE_MAP::const_iterator                      MODULE_CITER;
 
 
 /**
@@ -3868,8 +4153,9 @@ struct FPL_CACHE
     LEGACY_PLUGIN*  m_owner;        // my owner, I need its LEGACY_PLUGIN::LoadMODULE()
     wxString        m_lib_path;
     wxDateTime      m_mod_time;
-    MODULE_MAP      m_modules;      // map or tuple of footprint_name vs. MODULE*
+    MODULE_MAP      m_modules;      // map or tuple of footprint_name vs. FPL_CACHE_ITEM*
     bool            m_writable;
+    double          m_disk_to_biu;  // the units of the library file, for GetModule()
 
     FPL_CACHE( LEGACY_PLUGIN* aOwner, const wxString& aLibraryPath );
 
@@ -3897,16 +4183,37 @@ struct FPL_CACHE
 
     void SkipIndex( LINE_READER* aReader );
 
-    void LoadModules( LINE_READER* aReader );
+    /**
+     * Function ScanModules
+     * notes where the lines of each footprint are in the library file, without
+     * parsing them.
+     */
+    void ScanModules( MMAP_LINE_READER* aReader );
+
+    /**
+     * Function GetModule
+     * returns the MODULE of a footprint, parsing its lines in the library file the
+     * first time.
+     */
+    MODULE* GetModule( const std::string& aFootprintName, FPL_CACHE_ITEM* aItem );
+
+    /// parses the footprints which are not yet loaded, before saving the library.
+    void LoadAllModules();
 
     wxDateTime  GetLibModificationTime();
+
+    /// @return bool - true if somebody else on a network touched the library.
+    bool IsModified()   { return m_mod_time != GetLibModificationTime(); }
+
+    size_t GetMemorySize();
 };
 
 
 FPL_CACHE::FPL_CACHE( LEGACY_PLUGIN* aOwner, const wxString& aLibraryPath ) :
     m_owner( aOwner ),
     m_lib_path( aLibraryPath ),
-    m_writable( true )
+    m_writable( true ),
+    m_disk_to_biu( IU_PER_DECIMILS )
 {
 }
 
@@ -3923,13 +4230,33 @@ wxDateTime FPL_CACHE::GetLibModificationTime()
 }
 
 
+size_t FPL_CACHE::GetMemorySize()
+{
+    size_t size = sizeof( *this );
+
+    for( MODULE_CITER it = m_modules.begin();  it != m_modules.end();  ++it )
+    {
+        size += sizeof( FPL_CACHE_ITEM ) + it->first.size();
+
+        if( it->second->m_module.get() )
+            size += it->second->m_module->GetMemorySize();
+    }
+
+    return size;
+}
+
+
 void FPL_CACHE::Load()
 {
-    FILE_LINE_READER    reader( m_lib_path );
+    MMAP_LINE_READER    reader( m_lib_path );
 
     ReadAndVerifyHeader( &reader );
+
+    // ReadAndVerifyHeader() set the units of the library file in m_owner
+    m_disk_to_biu = m_owner->diskToBiu;
+
     SkipIndex( &reader );
-    LoadModules( &reader );
+    ScanModules( &reader );
 
     // Remember the file modification time of library file when the
     // cache snapshot was made, so that in a networked environment we will
@@ -3952,7 +4279,8 @@ void FPL_CACHE::ReadAndVerifyHeader( LINE_READER* aReader )
     {
         if( TESTLINE( "Units" ) )
         {
-            const char* units = strtok( line + SZ( "Units" ), delims );
+            char*       saveptr;
+            const char* units = strtok_r( line + SZ( "Units" ), delims, &saveptr );
 
             if( !strcmp( units, "mm" ) )
             {
@@ -4003,10 +4331,8 @@ void FPL_CACHE::SkipIndex( LINE_READER* aReader )
 }
 
 
-void FPL_CACHE::LoadModules( LINE_READER* aReader )
+void FPL_CACHE::ScanModules( MMAP_LINE_READER* aReader )
 {
-    m_owner->SetReader( aReader );
-
     char*   line = aReader->Line();
 
     do
@@ -4014,9 +4340,28 @@ void FPL_CACHE::LoadModules( LINE_READER* aReader )
         // test first for the $MODULE, even before reading because of INDEX bug.
         if( TESTLINE( "$MODULE" ) )
         {
-            MODULE* m = m_owner->LoadMODULE();
+            auto_ptr< FPL_CACHE_ITEM > item( new FPL_CACHE_ITEM() );
+
+            item->m_offset = aReader->LineOffset();
+            item->m_line   = aReader->LineNumber();
+
+            // LoadMODULE() names the footprint by its "Li" line, which
+            // normally repeats the name of the $MODULE line.
+            std::string footprintName = StrPurge( line + SZ( "$MODULE" ) );
+
+            while( ( line = aReader->ReadLine() ) != NULL )
+            {
+                if( TESTLINE( "Li" ) )
+                    footprintName = StrPurge( line + SZ( "Li" ) );
+
+                else if( TESTLINE( "$EndMODULE" ) )
+                    break;
+            }
+
+            if( !line )
+                THROW_IO_ERROR( "Missing '$EndMODULE'" );
 
-            std::string footprintName = TO_UTF8( m->GetLibRef() );
+            item->m_size = aReader->Offset() - item->m_offset;
 
             /*
 
@@ -4027,7 +4372,7 @@ void FPL_CACHE::LoadModules( LINE_READER* aReader )
             strategies that could be used. (Note: footprints must have unique
             names to be accepted into this cache.) The strategy used here is to
             append a differentiating version counter to the end of the name as:
-            _v2, _v3, etc.
+            _v2, _v3, etc.  GetModule() gives the new name to the MODULE.
 
             */
 
@@ -4035,7 +4380,7 @@ void FPL_CACHE::LoadModules( LINE_READER* aReader )
 
             if( it == m_modules.end() )  // footprintName is not present in cache yet.
             {
-                std::pair<MODULE_ITER, bool> r = m_modules.insert( footprintName, m );
+                std::pair<MODULE_ITER, bool> r = m_modules.insert( footprintName, item.release() );
 
                 wxASSERT_MSG( r.second, wxT( "error doing cache insert using guaranteed unique name" ) );
                 (void) r;
@@ -4063,8 +4408,7 @@ void FPL_CACHE::LoadModules( LINE_READER* aReader )
                     {
                         nameOK = true;
 
-                        m->SetLibRef( FROM_UTF8( newName.c_str() ) );
-                        std::pair<MODULE_ITER, bool> r = m_modules.insert( newName, m );
+                        std::pair<MODULE_ITER, bool> r = m_modules.insert( newName, item.release() );
 
                         wxASSERT_MSG( r.second, wxT( "error doing cache insert using guaranteed unique name" ) );
                         (void) r;
@@ -4077,6 +4421,56 @@ void FPL_CACHE::LoadModules( LINE_READER* aReader )
 }
 
 
+MODULE* FPL_CACHE::GetModule( const std::string& aFootprintName, FPL_CACHE_ITEM* aItem )
+{
+    if( aItem->m_module.get() )
+        return aItem->m_module.get();
+
+    FILE* fp = wxFopen( m_lib_path, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        THROW_IO_ERROR( wxString::Format(
+            _( "Unable to open legacy library file '%s'" ), m_lib_path.GetData() ) );
+    }
+
+    // wxf now owns fp, will close on exception or return
+    wxFFile     wxf( fp );
+    std::string lines( aItem->m_size, '\0' );
+
+    if( fseek( fp, aItem->m_offset, SEEK_SET )
+     || fread( &lines[0], aItem->m_size, 1, fp ) != 1 )
+    {
+        THROW_IO_ERROR( wxString::Format(
+            _( "Unable to read footprint '%s' in legacy library file '%s'" ),
+            GetChars( FROM_UTF8( aFootprintName.c_str() ) ), m_lib_path.GetData() ) );
+    }
+
+    STRING_LINE_READER  reader( lines, m_lib_path, aItem->m_line - 1 );
+
+    reader.ReadLine();      // the $MODULE line
+
+    m_owner->SetReader( &reader );
+    m_owner->diskToBiu = m_disk_to_biu;
+
+    MODULE* m = m_owner->LoadMODULE();
+
+    m->SetLibRef( FROM_UTF8( aFootprintName.c_str() ) );
+    aItem->m_module.reset( m );
+
+    m_owner->m_caches.UpdateSize( this, m->GetMemorySize() );
+
+    return m;
+}
+
+
+void FPL_CACHE::LoadAllModules()
+{
+    for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
+        GetModule( it->first, it->second );
+}
+
+
 void FPL_CACHE::Save()
 {
     if( !m_writable )
@@ -4085,6 +4479,9 @@ void FPL_CACHE::Save()
             _( "Legacy library file '%s' is read only" ), m_lib_path.GetData() ) );
     }
 
+    // the footprints which were never loaded are still only in m_lib_path
+    LoadAllModules();
+
     wxString tempFileName;
 
     // a block {} scope to fire wxFFile wxf()'s destructor
@@ -4166,21 +4563,23 @@ void FPL_CACHE::SaveModules( FILE* aFile )
 
     for( MODULE_CITER it = m_modules.begin();  it != m_modules.end();  ++it )
     {
-        m_owner->SaveMODULE( it->second );
+        m_owner->SaveMODULE( it->second->m_module.get() );
     }
 }
 
 
 void LEGACY_PLUGIN::cacheLib( const wxString& aLibraryPath )
 {
-    if( !m_cache || m_cache->m_lib_path != aLibraryPath ||
-        // somebody else on a network touched the library:
-        m_cache->m_mod_time != m_cache->GetLibModificationTime() )
+    m_cache = m_caches.Find( aLibraryPath );
+
+    if( !m_cache )
     {
-        // a spectacular episode in memory management:
-        delete m_cache;
-        m_cache = new FPL_CACHE( this, aLibraryPath );
-        m_cache->Load();
+        auto_ptr< FPL_CACHE > cache( new FPL_CACHE( this, aLibraryPath ) );
+
+        cache->Load();
+
+        m_cache = cache.release();
+        m_caches.Add( aLibraryPath, m_cache );
     }
 }
 
@@ -4215,9 +4614,9 @@ MODULE* LEGACY_PLUGIN::FootprintLoad( const wxString& aLibraryPath, const wxStri
 
     cacheLib( aLibraryPath );
 
-    const MODULE_MAP&   mods = m_cache->m_modules;
+    MODULE_MAP&     mods = m_cache->m_modules;
 
-    MODULE_CITER it = mods.find( TO_UTF8( aFootprintName ) );
+    MODULE_ITER it = mods.find( TO_UTF8( aFootprintName ) );
 
     if( it == mods.end() )
     {
@@ -4229,8 +4628,8 @@ MODULE* LEGACY_PLUGIN::FootprintLoad( const wxString& aLibraryPath, const wxStri
         return NULL;
     }
 
-    // copy constructor to clone the already loaded MODULE
-    return new MODULE( *it->second );
+    // copy constructor to clone the cached MODULE
+    return new MODULE( *m_cache->GetModule( it->first, it->second ) );
 }
 
 
@@ -4272,9 +4671,10 @@ void LEGACY_PLUGIN::FootprintSave( const wxString& aLibraryPath, const MODULE* a
     if( my_module->GetLayer() != LAYER_N_FRONT )
         my_module->Flip( my_module->GetPosition() );
 
-    mods.insert( footprintName, my_module );
+    mods.insert( footprintName, new FPL_CACHE_ITEM( my_module ) );
 
     m_cache->Save();
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -4303,6 +4703,7 @@ void LEGACY_PLUGIN::FootprintDelete( const wxString& aLibraryPath, const wxStrin
     }
 
     m_cache->Save();
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -4319,10 +4720,14 @@ void LEGACY_PLUGIN::FootprintLibCreate( const wxString& aLibraryPath, PROPERTIES
 
     init( NULL );
 
-    delete m_cache;
-    m_cache = new FPL_CACHE( this, aLibraryPath );
-    m_cache->Save();
-    m_cache->Load();    // update m_writable and m_mod_time
+    auto_ptr< FPL_CACHE > cache( new FPL_CACHE( this, aLibraryPath ) );
+
+    cache->Save();
+    cache->Load();      // update m_writable and m_mod_time
+
+    m_cache = cache.release();
+    m_caches.Add( aLibraryPath, m_cache );
+    m_caches.Written( aLibraryPath );
 }
 
 
@@ -4342,11 +4747,9 @@ bool LEGACY_PLUGIN::FootprintLibDelete( const wxString& aLibraryPath, PROPERTIES
             aLibraryPath.GetData() ) );
     }
 
-    if( m_cache && m_cache->m_lib_path == aLibraryPath )
-    {
-        delete m_cache;
-        m_cache = 0;
-    }
+    m_caches.Remove( aLibraryPath );
+    m_caches.Written( aLibraryPath );
+    m_cache = 0;
 
     return true;
 }
@@ -4369,7 +4772,8 @@ LEGACY_PLUGIN::LEGACY_PLUGIN() :
     m_props( 0 ),
     m_reader( 0 ),
     m_fp( 0 ),
-    m_cache( 0 )
+    m_cache( 0 ),
+    m_detached( 0 )
 {
     init( NULL );
 }
@@ -4377,5 +4781,4 @@ LEGACY_PLUGIN::LEGACY_PLUGIN() :
 
 LEGACY_PLUGIN::~LEGACY_PLUGIN()
 {
-    delete m_cache;
 }
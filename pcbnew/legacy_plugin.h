@@ -27,6 +27,9 @@
 
 #include <io_mgr.h>
 #include <string>
+#include <vector>
+
+#include <footprint_lib_caches.h>
 
 
 #define FOOTPRINT_LIBRARY_HEADER       "PCBNEW-LibModule-V1"
@@ -124,7 +127,11 @@ protected:
 
     wxString        m_field;        ///< reused to stuff MODULE fields.
     int             m_loading_format_version;   ///< which BOARD_FORMAT_VERSION am I Load()ing?
-    FPL_CACHE*      m_cache;
+    FPL_CACHE*      m_cache;        ///< the cache of the last library used, in m_caches
+    FOOTPRINT_LIB_CACHES< FPL_CACHE > m_caches;
+
+    /// where addBoardItem() puts the items, instead of m_board, if not NULL
+    std::vector<BOARD_ITEM*>* m_detached;
 
     /// initialize PLUGIN like a constructor would, and futz with fresh BOARD if needed.
     void    init( PROPERTIES* aProperties );
@@ -200,6 +207,52 @@ protected:
     void loadDIMENSION();           // "$COTATION"
     void loadPCB_TARGET();          // "$PCB_TARGET"
 
+    /// the text of a section of board items, defined in legacy_plugin.cpp
+    struct SECTION_TEXT;
+
+    /// the PARALLEL_LOADER of loadSections(), defined in legacy_plugin.cpp
+    class SECTION_LOADER;
+
+    /**
+     * Function addBoardItem
+     * adds a module, a track, a via, a zone segment or a zone to #m_board, at the end
+     * of its list, or to #m_detached if not NULL.
+     */
+    void addBoardItem( BOARD_ITEM* aItem );
+
+    /**
+     * Function readSectionText
+     * reads the lines of the section whose first line is the current line, up to its
+     * end, without parsing them.  A list of tracks or of zone segments is split in
+     * several sections, which can be loaded one by one.
+     *
+     * @param aSections is where to add the section, or sections.
+     * @param aType is PCB_MODULE_T for a $MODULE, PCB_TRACE_T for a $TRACK, PCB_ZONE_T
+     *  for a $ZONE and PCB_ZONE_AREA_T for a $CZONE_OUTLINE.
+     * @return size_t - the number of bytes read.
+     */
+    size_t readSectionText( std::vector<SECTION_TEXT>& aSections, int aType );
+
+    /**
+     * Function loadSectionText
+     * loads the items of a section read by readSectionText(), in place of the
+     * LINE_READER of this plugin, into the section instead of #m_board.
+     *
+     * @throw IO_ERROR if the section cannot be loaded, the section then has no items.
+     */
+    void loadSectionText( SECTION_TEXT& aSection, const wxString& aSource );
+
+    /**
+     * Function loadSections
+     * loads the sections read by readSectionText() with one LEGACY_PLUGIN per thread,
+     * and adds their items to #m_board in the order of the file.  If a section cannot
+     * be loaded, it is loaded again by this plugin to throw the error.
+     *
+     * @param aSections are the sections to load, cleared after loading.
+     * @throw IO_ERROR the error of the first section which cannot be loaded.
+     */
+    void loadSections( std::vector<SECTION_TEXT>& aSections );
+
     //-----</ load/parse functions>---------------------------------------------
 
 
@@ -270,7 +323,7 @@ protected:
 
     //-----</save functions>----------------------------------------------------
 
-    /// we only cache one footprint library for now, this determines which one.
+    /// makes m_cache the cache of @a aLibraryPath, loading the library if needed.
     void cacheLib( const wxString& aLibraryPath );
 
     friend struct FPL_CACHE;
@@ -278,6 +278,15 @@ MODULE* PCB_BASE_FRAME::GetModuleLibrary( const wxString& aLibraryPath,
 }
 
 
+PLUGIN* PCB_BASE_FRAME::footprintLibPlugin()
+{
+    if( !m_footprintLibPlugin )
+        m_footprintLibPlugin = IO_MGR::PluginFind( IO_MGR::LEGACY );
+
+    return m_footprintLibPlugin;
+}
+
+
 /* loads aFootprintName from aLibraryPath.
  * If found the module is added to the BOARD, just for good measure.
  *
@@ -291,7 +300,7 @@ MODULE* PCB_BASE_FRAME::loadFootprintFromLibrary( const wxString& aLibraryPath,
 {
     try
     {
-        PLUGIN::RELEASER pi( IO_MGR::PluginFind( IO_MGR::LEGACY ) );
+        PLUGIN* pi = footprintLibPlugin();
 
         wxString libPath = wxGetApp().FindLibraryPath( aLibraryPath );
 
@@ -338,7 +347,7 @@ MODULE* PCB_BASE_FRAME::loadFootprintFromLibraries(
 
     try
     {
-        PLUGIN::RELEASER pi( IO_MGR::PluginFind( IO_MGR::LEGACY ) );
+        PLUGIN* pi = footprintLibPlugin();
 
         for( unsigned ii = 0; ii < g_LibraryNames.GetCount(); ii++ )
         {
@@ -31,8 +31,14 @@
 
 #include <limits.h>
 
+#include <algorithm>
+#include <map>
+
 #include <minimun_spanning_tree.h>
-#include <class_pad.h>
+#include <disjoint_set.h>
+
+/// Below this node count, the Prim's algorithm is as fast as the sparse one.
+#define MST_DENSE_MAX_NODES     32
 
 /*
  * The class MIN_SPAN_TREE calculates the rectilinear minimum spanning tree
@@ -120,6 +126,15 @@ void MIN_SPAN_TREE::updateDistances( int target )
 
 
 void MIN_SPAN_TREE::BuildTree()
+{
+    if( m_Size > MST_DENSE_MAX_NODES && buildSparseTree() )
+        return;
+
+    buildDenseTree();
+}
+
+
+void MIN_SPAN_TREE::buildDenseTree()
 {
     /* Add the first node to the tree */
     inTree[0] = 1;
@@ -142,3 +157,193 @@ void MIN_SPAN_TREE::BuildTree()
         updateDistances( min );
     }
 }
+
+
+/*
+ * The sparse tree:
+ * For the rectilinear distance, the minimum spanning tree only uses links
+ * from a point to its nearest neighbour in one of the 8 octants around it
+ * (Zhou, Shenoy and Nicholls, "Efficient minimum spanning tree construction
+ * without Delaunay triangulation").  The nearest neighbours of all points in
+ * one octant are found by a sweep in O(n log n), and 4 sweeps (the 4 other
+ * octants give the same links from the other end) build a graph of at most
+ * 4n links.  The Kruskal's algorithm then keeps the shortest links which do
+ * not close a cycle.
+ */
+
+struct MST_POINT
+{
+    long long x, y;     // long long: x + y must not overflow
+};
+
+
+struct MST_LINK
+{
+    long long m_Length;
+    int       m_Start;
+    int       m_End;
+
+    bool operator<( const MST_LINK& aOther ) const
+    {
+        if( m_Length != aOther.m_Length )
+            return m_Length < aOther.m_Length;
+
+        if( m_Start != aOther.m_Start )
+            return m_Start < aOther.m_Start;
+
+        return m_End < aOther.m_End;
+    }
+};
+
+
+// Sort function used by buildSparseTree: sort point indexes by x + y
+struct MST_SORT_BY_DIAGONAL
+{
+    const std::vector<MST_POINT>& m_Points;
+
+    MST_SORT_BY_DIAGONAL( const std::vector<MST_POINT>& aPoints ) :
+        m_Points( aPoints ) {}
+
+    bool operator()( int aFirst, int aSecond ) const
+    {
+        return m_Points[aFirst].x + m_Points[aFirst].y < m_Points[aSecond].x + m_Points[aSecond].y;
+    }
+};
+
+
+bool MIN_SPAN_TREE::buildSparseTree()
+{
+    std::vector<MST_POINT> points( m_Size );
+
+    for( int ii = 0; ii < m_Size; ii++ )
+    {
+        int x, y;
+
+        if( !GetPosition( ii, x, y ) )
+            return false;
+
+        points[ii].x = x;
+        points[ii].y = y;
+    }
+
+    std::vector<MST_LINK> links;
+    links.reserve( 4 * m_Size );
+
+    std::vector<int> order( m_Size );
+
+    for( int ii = 0; ii < m_Size; ii++ )
+        order[ii] = ii;
+
+    for( int octant = 0; octant < 4; octant++ )
+    {
+        std::sort( order.begin(), order.end(), MST_SORT_BY_DIAGONAL( points ) );
+
+        // the points already seen which have not found their nearest
+        // neighbour in this octant yet, by decreasing y
+        std::map<long long, int> active;
+
+        for( int ii = 0; ii < m_Size; ii++ )
+        {
+            int                 curr = order[ii];
+            const MST_POINT&    pt   = points[curr];
+
+            std::map<long long, int>::iterator it = active.lower_bound( -pt.y );
+
+            while( it != active.end() )
+            {
+                int       other = it->second;
+                long long dx    = pt.x - points[other].x;
+                long long dy    = pt.y - points[other].y;
+
+                if( dy > dx )
+                    break;
+
+                // curr is the nearest neighbour of other in this octant
+                MST_LINK link;
+                link.m_Length = dx + dy;
+                link.m_Start  = std::min( curr, other );
+                link.m_End    = std::max( curr, other );
+                links.push_back( link );
+
+                active.erase( it++ );
+            }
+
+            active[ -pt.y ] = curr;
+        }
+
+        // Transform the points so that the next sweep looks in the next octant
+        for( int jj = 0; jj < m_Size; jj++ )
+        {
+            if( octant & 1 )
+                points[jj].x = -points[jj].x;
+            else
+                std::swap( points[jj].x, points[jj].y );
+        }
+    }
+
+    std::sort( links.begin(), links.end() );
+
+    // Kruskal's algorithm, the tree is stored as a list of neighbours per node
+    DISJOINT_SET        clusters( m_Size );
+    std::vector<int>    neighbours;
+    std::vector<int>    degree( m_Size + 1, 0 );
+    std::vector<int>    treeLinks;
+    int                 linkCount = 0;
+
+    treeLinks.reserve( 2 * m_Size );
+
+    for( unsigned ii = 0; ii < links.size() && linkCount < m_Size - 1; ii++ )
+    {
+        if( !clusters.Union( links[ii].m_Start, links[ii].m_End ) )
+            continue;
+
+        treeLinks.push_back( links[ii].m_Start );
+        treeLinks.push_back( links[ii].m_End );
+        degree[ links[ii].m_Start + 1 ]++;
+        degree[ links[ii].m_End + 1 ]++;
+        linkCount++;
+    }
+
+    if( linkCount != m_Size - 1 )   // Should not occur
+        return false;
+
+    // degree[ii] becomes the start of the neighbours of node ii
+    for( int ii = 0; ii < m_Size; ii++ )
+        degree[ii + 1] += degree[ii];
+
+    neighbours.resize( 2 * linkCount );
+    std::vector<int> nextSlot( degree.begin(), degree.end() - 1 );
+
+    for( unsigned ii = 0; ii < treeLinks.size(); ii += 2 )
+    {
+        neighbours[ nextSlot[ treeLinks[ii] ]++ ] = treeLinks[ii + 1];
+        neighbours[ nextSlot[ treeLinks[ii + 1] ]++ ] = treeLinks[ii];
+    }
+
+    // Orient the tree from node 0, as the Prim's algorithm does:
+    // the link of node ii is ii to linkedTo[ii]
+    std::vector<int> queue;
+    queue.reserve( m_Size );
+    queue.push_back( 0 );
+    inTree[0] = 1;
+
+    for( unsigned head = 0; head < queue.size(); head++ )
+    {
+        int node = queue[head];
+
+        for( int ii = degree[node]; ii < degree[node + 1]; ii++ )
+        {
+            int next = neighbours[ii];
+
+            if( inTree[next] )
+                continue;
+
+            inTree[next]   = 1;
+            linkedTo[next] = node;
+            distTo[next]   = GetWeight( next, node );
+            queue.push_back( next );
+        }
+    }
+
+    return true;
+}
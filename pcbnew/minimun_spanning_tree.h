@@ -12,6 +12,10 @@
  * that calculate the distance between 2 items
  * MIN_SPAN_TREE does not know anything about the actual items to link
  * by the tree
+ * If you also provide GetPosition(), and the weight is the rectilinear
+ * distance between the positions (plus a constant for 2 different items),
+ * large trees are built from the links between close items only, in
+ * O(n log n) instead of O(n^2).
  */
 class MIN_SPAN_TREE
 {
@@ -37,6 +41,8 @@ private:
                                */
 public:
     MIN_SPAN_TREE();
+    virtual ~MIN_SPAN_TREE() {}
+
     void MSP_Init( int aNodesCount );
     void BuildTree();
 
@@ -62,8 +68,36 @@ public:
      */
     virtual int  GetWeight( int aItem1, int aItem2 ) = 0;
 
+    /**
+     * Function GetPosition
+     * gives the position of an item, used to build large trees from the
+     * links between close items only.  The default returns false: all the
+     * links are weighed.
+     * @param aItem = the item
+     * @param aX = where to store the X coordinate of aItem
+     * @param aY = where to store the Y coordinate of aItem
+     * @return true if the position is known
+     */
+    virtual bool GetPosition( int aItem, int& aX, int& aY ) { return false; }
+
 private:
 
+    /**
+     * Function buildDenseTree
+     * builds the tree with the Prim's algorithm, weighing all the links.
+     */
+    void buildDenseTree();
+
+    /**
+     * Function buildSparseTree
+     * builds the tree with the Kruskal's algorithm, from the links between each
+     * item and its nearest neighbour in each octant around it.  This graph
+     * contains a rectilinear minimum spanning tree, and has at most 4 links
+     * per item.
+     * @return false if the positions are not known (nothing is done)
+     */
+    bool buildSparseTree();
+
     /**
      * Function updateDistances
      *   should be called immediately after target is added to the tree;
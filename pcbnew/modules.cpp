@@ -275,7 +275,7 @@ bool PCB_EDIT_FRAME::Delete_Module( MODULE* aModule, wxDC* aDC, bool aAskBeforeD
     OnModify();
 
     /* Remove module from list, and put it in undo command list */
-    m_Pcb->m_Modules.Remove( aModule );
+    m_Pcb->Remove( aModule );
     aModule->SetState( IS_DELETED, ON );
     SaveCopyInUndoList( aModule, UR_DELETED );
 
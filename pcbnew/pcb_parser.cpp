@@ -27,9 +27,14 @@
  */
 
 #include <errno.h>
+#include <algorithm>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <common.h>
 #include <macros.h>
 #include <convert_from_iu.h>
+#include <parse_double.h>
 #include <trigo.h>
 #include <3d_struct.h>
 #include <class_title_block.h>
@@ -47,12 +52,31 @@
 #include <kicad_plugin.h>
 #include <pcb_plot_params.h>
 #include <zones.h>
+#include <openmp_threads.h>
+#include <parallel_loader.h>
 #include <pcb_parser.h>
 
 
 using namespace std;
 
 
+/// The bytes of board item text read before parsing them in parallel.
+static const size_t PARSE_BATCH_SIZE = 4 * 1024 * 1024;
+
+
+/**
+ * Struct ITEM_TEXT
+ * is the text of a top level board item, read by PCB_PARSER::readItemText(), and
+ * the item once parsed.
+ */
+struct PCB_PARSER::ITEM_TEXT
+{
+    std::string     m_Text;
+    int             m_LineNumber;   ///< the line number before the first line of m_Text
+    BOARD_ITEM*     m_Item;         ///< the parsed item, NULL if not parsed (yet)
+};
+
+
 void PCB_PARSER::init()
 {
     m_layerIndices.clear();
@@ -80,13 +104,12 @@ void PCB_PARSER::init()
 
 double PCB_PARSER::parseDouble() throw( IO_ERROR )
 {
-    char* tmp;
+    const char* tmp;
+    bool        outOfRange;
 
-    errno = 0;
+    double fval = ParseDouble( CurText(), &tmp, &outOfRange );
 
-    double fval = strtod( CurText(), &tmp );
-
-    if( errno )
+    if( outOfRange )
     {
         wxString error;
         error.Printf( _( "invalid floating point number in\nfile: '%s'\nline: %d\noffset: %d" ),
@@ -362,7 +385,13 @@ BOARD_ITEM* PCB_PARSER::Parse() throw( IO_ERROR, PARSE_ERROR )
 
 BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
 {
-    T token;
+    T       token;
+    bool    parallel = OpenMPThreadCount() > 1;
+
+    // The top level items are read without being parsed, and parsed in parallel
+    // by batches of PARSE_BATCH_SIZE bytes.
+    std::vector<ITEM_TEXT>  items;
+    size_t                  itemsSize = 0;
 
     parseHeader();
 
@@ -373,6 +402,51 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
 
         token = NextTok();
 
+        switch( token )
+        {
+        case T_gr_arc:
+        case T_gr_circle:
+        case T_gr_curve:
+        case T_gr_line:
+        case T_gr_poly:
+        case T_gr_text:
+        case T_dimension:
+        case T_module:
+        case T_segment:
+        case T_via:
+        case T_zone:
+        case T_target:
+            if( parallel )
+            {
+                items.push_back( ITEM_TEXT() );
+                readItemText( items.back() );
+                itemsSize += items.back().m_Text.size();
+
+                if( itemsSize >= PARSE_BATCH_SIZE || CurTok() == T_EOF )
+                {
+                    parseBoardItems( items );
+                    itemsSize = 0;
+                }
+            }
+            else
+            {
+                appendBoardItem( parseBoardItem() );
+            }
+
+            continue;
+
+        default:
+            break;
+        }
+
+        // The items read so far are added to the board before the next section is
+        // parsed, as they are when parsed one by one.
+        if( items.size() )
+        {
+            parseBoardItems( items );
+            itemsSize = 0;
+        }
+
         switch( token )
         {
         case T_general:
@@ -403,50 +477,227 @@ BOARD* PCB_PARSER::parseBOARD() throw( IO_ERROR, PARSE_ERROR )
             parseNETCLASS();
             break;
 
-        case T_gr_arc:
-        case T_gr_circle:
-        case T_gr_curve:
-        case T_gr_line:
-        case T_gr_poly:
-            m_board->Add( parseDRAWSEGMENT(), ADD_APPEND );
-            break;
+        default:
+            wxString err;
+            err.Printf( _( "unknown token \"%s\"" ), GetChars( FromUTF8() ) );
+            THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+        }
+    }
 
-        case T_gr_text:
-            m_board->Add( parseTEXTE_PCB(), ADD_APPEND );
-            break;
+    if( items.size() )
+        parseBoardItems( items );
 
-        case T_dimension:
-            m_board->Add( parseDIMENSION(), ADD_APPEND );
-            break;
+    return m_board;
+}
 
-        case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
 
-        case T_segment:
-            m_board->m_Track.Append( parseTRACK() );
-            break;
+BOARD_ITEM* PCB_PARSER::parseBoardItem() throw( IO_ERROR, PARSE_ERROR )
+{
+    switch( CurTok() )
+    {
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
 
-        case T_via:
-            m_board->m_Track.Append( parseSEGVIA() );
-            break;
+    case T_gr_text:
+        return parseTEXTE_PCB();
 
-        case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
-            break;
+    case T_dimension:
+        return parseDIMENSION();
 
-        case T_target:
-            m_board->Add( parsePCB_TARGET(), ADD_APPEND );
-            break;
+    case T_module:
+        return parseMODULE();
 
-        default:
-            wxString err;
-            err.Printf( _( "unknown token \"%s\"" ), GetChars( FromUTF8() ) );
-            THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    case T_segment:
+        return parseTRACK();
+
+    case T_via:
+        return parseSEGVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER();
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        wxString err;
+        err.Printf( _( "unknown token \"%s\"" ), GetChars( FromUTF8() ) );
+        THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+}
+
+
+void PCB_PARSER::appendBoardItem( BOARD_ITEM* aItem )
+{
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+        m_board->m_Track.Append( (TRACK*) aItem );
+        break;
+
+    default:
+        m_board->Add( aItem, ADD_APPEND );
+    }
+}
+
+
+void PCB_PARSER::readItemText( ITEM_TEXT& aItem ) throw( IO_ERROR )
+{
+    // The text starts with the '(' before the keyword, at its offset in the line,
+    // so that the errors are reported at the same line and offset as in the file.
+    int offset = std::max( curOffset - 1, 0 );
+
+    aItem.m_LineNumber = CurLineNumber() - 1;
+    aItem.m_Item       = NULL;
+    aItem.m_Text.assign( offset, ' ' );
+    aItem.m_Text += '(';
+
+    const char* cur    = start + curOffset;
+    int         depth  = 1;
+    bool        quoted = false;
+
+    for( ;; )
+    {
+        const char* head = cur;
+
+        while( cur < limit && depth > 0 )
+        {
+            char cc = *cur++;
+
+            if( quoted )
+            {
+                if( cc == '\\' && cur < limit )
+                    ++cur;
+                else if( cc == '"' )
+                    quoted = false;
+            }
+            else if( cc == '"' )
+                quoted = true;
+            else if( cc == '(' )
+                ++depth;
+            else if( cc == ')' )
+                --depth;
+        }
+
+        aItem.m_Text.append( head, cur );
+
+        if( depth == 0 )
+        {
+            next = cur;
+            return;
+        }
+
+        // A quoted string does not continue on the next line, see NextTok().
+        quoted = false;
+
+        if( readLine() == 0 )
+        {
+            // The end of the file: the item cannot be parsed, and its error will
+            // be reported by parseBoardItems().
+            curTok = DSN_EOF;
+            return;
+        }
+
+        cur = start;
+
+        while( cur < limit && ( *cur == ' ' || *cur == '\t' ) )
+            ++cur;
+
+        // the parentheses of a comment line do not count
+        if( cur < limit && *cur == '#' )
+        {
+            aItem.m_Text.append( start, limit );
+            cur = limit;
+        }
+        else
+        {
+            cur = start;
         }
     }
+}
 
-    return m_board;
+
+BOARD_ITEM* PCB_PARSER::parseItemText( const ITEM_TEXT& aItem, const wxString& aSource )
+    throw( IO_ERROR, PARSE_ERROR )
+{
+    STRING_LINE_READER reader( aItem.m_Text, aSource, aItem.m_LineNumber );
+
+    SetLineReader( &reader );
+
+    // The previous text may have ended in error, at its end.
+    curTok = DSN_NONE;
+
+    NeedLEFT();
+    NextTok();
+
+    BOARD_ITEM* item = parseBoardItem();
+
+    PopReader();
+    return item;
+}
+
+
+/**
+ * Class ITEM_LOADER
+ * parses the texts of parseBoardItems() with one PCB_PARSER per thread.
+ */
+class PCB_PARSER::ITEM_LOADER : public PARALLEL_LOADER<ITEM_TEXT>
+{
+public:
+    ITEM_LOADER( PCB_PARSER* aParser ) :
+        m_parser( aParser ),
+        m_source( aParser->CurSource() )
+    {
+    }
+
+protected:
+    // The parsers of the threads, made here because init() translates the layer
+    // names, with the layer names of the board.
+    void makeLoaders( int aCount )
+    {
+        for( int ii = 0; ii < aCount; ++ii )
+        {
+            PCB_PARSER* parser = new PCB_PARSER();
+
+            parser->m_board        = m_parser->m_board;
+            parser->m_layerIndices = m_parser->m_layerIndices;
+            parser->m_layerMasks   = m_parser->m_layerMasks;
+            m_parsers.push_back( parser );
+        }
+    }
+
+    void loadPart( ITEM_TEXT& aItem, int aLoader )
+    {
+        aItem.m_Item = m_parsers[aLoader].parseItemText( aItem, m_source );
+    }
+
+    void addPart( ITEM_TEXT& aItem )
+    {
+        m_parser->appendBoardItem( aItem.m_Item );
+    }
+
+    void deletePart( ITEM_TEXT& aItem )
+    {
+        delete aItem.m_Item;
+    }
+
+private:
+    PCB_PARSER*                     m_parser;
+    const wxString                  m_source;
+    boost::ptr_vector<PCB_PARSER>   m_parsers;
+};
+
+
+void PCB_PARSER::parseBoardItems( std::vector<ITEM_TEXT>& aItems ) throw( IO_ERROR, PARSE_ERROR )
+{
+    ITEM_LOADER loader( this );
+
+    loader.Load( aItems, 16 );
 }
 
 
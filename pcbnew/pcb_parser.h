@@ -94,6 +94,63 @@ class PCB_PARSER : public PCB_LEXER
     PCB_TARGET* parsePCB_TARGET() throw( IO_ERROR, PARSE_ERROR );
     BOARD* parseBOARD() throw( IO_ERROR, PARSE_ERROR );
 
+    /// the text of a top level board item, defined in pcb_parser.cpp
+    struct ITEM_TEXT;
+
+    /// the PARALLEL_LOADER of parseBoardItems(), defined in pcb_parser.cpp
+    class ITEM_LOADER;
+
+    /**
+     * Function parseBoardItem
+     * parses the top level board item whose keyword is the current token: a graphic
+     * item, a dimension, a module, a track segment, a via, a zone or a target.
+     *
+     * @throw IO_ERROR if an error occurs reading the item.
+     * @throw PARSE_ERROR if the item syntax is incorrect.
+     * @return BOARD_ITEM* - the item, not yet added to #m_board.
+     */
+    BOARD_ITEM* parseBoardItem() throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function appendBoardItem
+     * adds an item returned by parseBoardItem() at the end of its list in #m_board.
+     */
+    void appendBoardItem( BOARD_ITEM* aItem );
+
+    /**
+     * Function readItemText
+     * reads the text of the top level board item whose keyword is the current token,
+     * up to its closing parenthesis, without parsing it.  The quoted strings and the
+     * comment lines are skipped when matching the parentheses.
+     *
+     * @param aItem is where to put the text and the line number it starts at.
+     * @throw IO_ERROR if an error occurs reading the item.
+     */
+    void readItemText( ITEM_TEXT& aItem ) throw( IO_ERROR );
+
+    /**
+     * Function parseItemText
+     * parses a text read by readItemText(), in place of the LINE_READER of this parser.
+     *
+     * @param aItem is the text to parse.
+     * @param aSource is the source of the text, for the error messages.
+     * @throw IO_ERROR, PARSE_ERROR if the item cannot be parsed.
+     * @return BOARD_ITEM* - the item, not yet added to #m_board.
+     */
+    BOARD_ITEM* parseItemText( const ITEM_TEXT& aItem, const wxString& aSource )
+        throw( IO_ERROR, PARSE_ERROR );
+
+    /**
+     * Function parseBoardItems
+     * parses the texts read by readItemText() with one PCB_PARSER per thread, and
+     * adds the items to #m_board in the order of the file.  If an item cannot be
+     * parsed, it is parsed again in this parser to throw the error.
+     *
+     * @param aItems are the texts to parse, cleared after parsing.
+     * @throw IO_ERROR, PARSE_ERROR the error of the first item which cannot be parsed.
+     */
+    void parseBoardItems( std::vector<ITEM_TEXT>& aItems ) throw( IO_ERROR, PARSE_ERROR );
+
 
     /**
      * Function lookUpLayer
@@ -17,6 +17,10 @@
 #include <pcbnew.h>
 
 #include <minimun_spanning_tree.h>
+#include <connect.h>
+
+extern void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb );
+extern void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode );
 
 /**
  * @brief class MIN_SPAN_TREE_PADS (derived from MIN_SPAN_TREE) specialize
@@ -64,6 +68,20 @@ public:
      * @return the weight between items ( the rectilinear distance )
      */
     int GetWeight( int aItem1, int aItem2 );
+
+    /**
+     * Function GetPosition
+     * gives the position of a pad, the weight is the rectilinear distance
+     * between pad positions.
+     */
+    bool GetPosition( int aItem, int& aX, int& aY )
+    {
+        const wxPoint& pos = (*m_PadsList)[aItem]->GetPosition();
+
+        aX = pos.x;
+        aY = pos.y;
+        return true;
+    }
 };
 
 
@@ -182,6 +200,29 @@ static bool sortByNetcode( const D_PAD* const & ref, const D_PAD* const & item )
 }
 
 
+/**
+ * Function isRatsnestTreeValid
+ * @return true if \a aTree was built from the pads of \a aPadList, in the same
+ * order and at their current positions.
+ * The pads of aTree are compared but never used: a pad deleted since
+ * aTree was built cannot be in aPadList.
+ */
+static bool isRatsnestTreeValid( const RATSNEST_NET_TREE&   aTree,
+                                 const std::vector<D_PAD*>& aPadList )
+{
+    if( aTree.m_Pads != aPadList )
+        return false;
+
+    for( unsigned ii = 0; ii < aPadList.size(); ii++ )
+    {
+        if( aTree.m_Positions[ii] != aPadList[ii]->GetPosition() )
+            return false;
+    }
+
+    return true;
+}
+
+
 /**
  * Function to compute the full ratsnest
  * This is the "basic" ratsnest depending only on pads.
@@ -199,7 +240,6 @@ static bool sortByNetcode( const D_PAD* const & ref, const D_PAD* const & item )
 void PCB_BASE_FRAME::Build_Board_Ratsnest()
 {
     D_PAD* pad;
-    int    noconn;
 
     m_Pcb->SetUnconnectedNetCount( 0 );
 
@@ -221,10 +261,14 @@ void PCB_BASE_FRAME::Build_Board_Ratsnest()
     if( m_Pcb->GetNodesCount() == 0 )
         return;                       // No useful connections.
 
+    RATSNEST_CACHE& cache = m_Pcb->m_RatsnestCache;
+
+    for( RATSNEST_CACHE::iterator it = cache.begin(); it != cache.end(); ++it )
+        it->second.m_InUse = false;
+
     // Ratsnest computation
     unsigned current_net_code = 1;      // First net code is analyzed.
                                         // (net_code = 0 -> no connect)
-    noconn = 0;
     MIN_SPAN_TREE_PADS min_spanning_tree;
     for( ; current_net_code < m_Pcb->GetNetCount(); current_net_code++ )
     {
@@ -238,13 +282,50 @@ void PCB_BASE_FRAME::Build_Board_Ratsnest()
 
         net->m_RatsnestStartIdx = m_Pcb->GetRatsnestsCount();
 
-        min_spanning_tree.MSP_Init( &net->m_PadInNetList );
-        min_spanning_tree.BuildTree();
-        min_spanning_tree.AddTreeToRatsnest( m_Pcb->m_FullRatsnest );
+        // Only the nets which have pads added, removed or moved since the last
+        // call need a new minimum spanning tree, which is quadratic in the pad
+        // count of the net.  The other nets reuse the tree they had.
+        RATSNEST_NET_TREE& tree = cache[ net->GetNetname() ];
+
+        if( !isRatsnestTreeValid( tree, net->m_PadInNetList ) )
+        {
+            tree.m_Pads = net->m_PadInNetList;
+            tree.m_Positions.resize( tree.m_Pads.size() );
+
+            for( unsigned ii = 0; ii < tree.m_Pads.size(); ii++ )
+                tree.m_Positions[ii] = tree.m_Pads[ii]->GetPosition();
+
+            tree.m_Ratsnest.clear();
+
+            min_spanning_tree.MSP_Init( &net->m_PadInNetList );
+            min_spanning_tree.BuildTree();
+            min_spanning_tree.AddTreeToRatsnest( tree.m_Ratsnest );
+        }
+
+        tree.m_InUse = true;
+
+        for( unsigned ii = 0; ii < tree.m_Ratsnest.size(); ii++ )
+        {
+            RATSNEST_ITEM link = tree.m_Ratsnest[ii];
+            link.SetNet( current_net_code );
+            link.m_Status = CH_ACTIF | CH_VISIBLE;
+            m_Pcb->m_FullRatsnest.push_back( link );
+        }
+
         net->m_RatsnestEndIdx = m_Pcb->GetRatsnestsCount();
     }
 
-    m_Pcb->SetUnconnectedNetCount( noconn );
+    // Forget the trees of the nets which do not exist any more.
+    for( RATSNEST_CACHE::iterator it = cache.begin(); it != cache.end(); )
+    {
+        if( it->second.m_InUse )
+            ++it;
+        else
+            cache.erase( it++ );
+    }
+
+    // All the links are active until TestForActiveLinksInRatsnest() is called
+    m_Pcb->SetUnconnectedNetCount( m_Pcb->GetRatsnestsCount() );
     m_Pcb->m_Status_Pcb |= LISTE_RATSNEST_ITEM_OK;
 
     // Update the ratsnest display option (visible/invisible) flag
@@ -444,6 +525,11 @@ void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
     if( (m_Pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
         Build_Board_Ratsnest();
 
+    // When only one net is tested, the count of active links is updated by
+    // the change of this net, the count is right for the other nets.  Else
+    // it is counted on all the nets.
+    unsigned unconnected = 0;
+
     for( int net_code = 1; net_code < (int) m_Pcb->GetNetCount(); net_code++ )
     {
         net = m_Pcb->FindNet( net_code );
@@ -464,8 +550,13 @@ void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
             subratsnest = std::max( subratsnest, subnet );
         }
 
+        unsigned wasActive = 0;
+
         for( unsigned ii = net->m_RatsnestStartIdx; ii < net->m_RatsnestEndIdx; ii++ )
         {
+            if( m_Pcb->m_FullRatsnest[ii].IsActive() )
+                wasActive++;
+
             m_Pcb->m_FullRatsnest[ii].m_Status &= ~CH_ACTIF;
         }
 
@@ -480,19 +571,164 @@ void PCB_BASE_FRAME::TestForActiveLinksInRatsnest( int aNetCode )
         {
             subratsnest = tst_links_between_blocks( net, m_Pcb->m_FullRatsnest );
         }
+
+        if( aNetCode )
+        {
+            m_Pcb->UpdateUnconnectedNetCount( net, wasActive );
+            return;
+        }
+
+        for( unsigned ii = net->m_RatsnestStartIdx; ii < net->m_RatsnestEndIdx; ii++ )
+        {
+            if( m_Pcb->m_FullRatsnest[ii].IsActive() )
+                unconnected++;
+        }
     }
 
-    m_Pcb->SetUnconnectedNetCount( 0 );
+    m_Pcb->SetUnconnectedNetCount( unconnected );
+}
 
-    unsigned cnt = 0;
 
-    for( unsigned ii = 0; ii < m_Pcb->GetRatsnestsCount(); ii++ )
+/*
+ * Test all connections of the board,
+ * and update subnet variable of pads and tracks
+ * TestForActiveLinksInRatsnest must be called after this function
+ * to update active/inactive ratsnest items status
+ */
+void PCB_BASE_FRAME::TestConnections()
+{
+    // Clear the cluster identifier for all pads
+    for( unsigned i = 0;  i< m_Pcb->GetPadCount();  ++i )
+    {
+        D_PAD* pad = m_Pcb->GetPad(i);
+
+        pad->SetZoneSubNet( 0 );
+        pad->SetSubNet( 0 );
+    }
+
+    m_Pcb->Test_Connections_To_Copper_Areas();
+
+    // Test existing connections net by net
+    // note some nets can have no tracks, and pads intersecting
+    // so Build_CurrNet_SubNets_Connections must be called for each net
+    CONNECTIONS connections( m_Pcb );
+    int last_net_tested = 0;
+    int current_net_code = 0;
+    for( TRACK* track = m_Pcb->m_Track; track; )
     {
-        if( m_Pcb->m_FullRatsnest[ii].IsActive() )
-            cnt++;
+        // At this point, track is the first track of a given net
+        current_net_code = track->GetNet();
+        // Get last track of the current net
+        TRACK* lastTrack = track->GetEndNetCode( current_net_code );
+
+        if( current_net_code > 0 )  // do not spend time if net code = 0 ( dummy net )
+        {
+            // Test all previous nets having no tracks
+            for( int net = last_net_tested+1; net < current_net_code; net++ )
+                connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
+
+            connections.Build_CurrNet_SubNets_Connections( track, lastTrack, current_net_code );
+            last_net_tested = current_net_code;
+        }
+
+        track = lastTrack->Next();    // this is now the first track of the next net
     }
 
-    m_Pcb->SetUnconnectedNetCount( cnt );
+    // Test last nets without tracks, if any
+    int netsCount = m_Pcb->GetNetCount();
+    for( int net = last_net_tested+1; net < netsCount; net++ )
+        connections.Build_CurrNet_SubNets_Connections( NULL, NULL, net );
+
+    Merge_SubNets_Connected_By_CopperAreas( m_Pcb );
+
+    return;
+}
+
+
+void PCB_BASE_FRAME::TestNetConnection( wxDC* aDC, int aNetCode )
+{
+    wxString msg;
+
+    if( aNetCode <= 0 ) // -1 = not existing net, 0 = dummy net
+        return;
+
+    if( (m_Pcb->m_Status_Pcb & LISTE_RATSNEST_ITEM_OK) == 0 )
+        Compile_Ratsnest( aDC, true );
+
+    // Clear the cluster identifier (subnet) of pads for this net
+    for( unsigned i = 0; i < m_Pcb->GetPadCount(); ++i )
+    {
+        D_PAD* pad = m_Pcb->GetPad(i);
+        int    pad_net_code = pad->GetNet();
+
+        if( pad_net_code < aNetCode )
+            continue;
+
+        if( pad_net_code > aNetCode )
+            break;
+
+        pad->SetSubNet( 0 );
+    }
+
+    m_Pcb->Test_Connections_To_Copper_Areas( aNetCode );
+
+    // Search for the first and the last segment relative to the given net code
+    if( m_Pcb->m_Track )
+    {
+        CONNECTIONS connections( m_Pcb );
+        TRACK* firstTrack;
+        TRACK* lastTrack = NULL;
+        firstTrack = m_Pcb->m_Track.GetFirst()->GetStartNetCode( aNetCode );
+
+        if( firstTrack )
+            lastTrack = firstTrack->GetEndNetCode( aNetCode );
+
+        if( firstTrack && lastTrack ) // i.e. if there are segments
+        {
+            connections.Build_CurrNet_SubNets_Connections( firstTrack, lastTrack, firstTrack->GetNet() );
+        }
+    }
+
+    Merge_SubNets_Connected_By_CopperAreas( m_Pcb, aNetCode );
+
+    // rebuild the active ratsnest for this net
+    DrawGeneralRatsnest( aDC, aNetCode );
+    TestForActiveLinksInRatsnest( aNetCode );
+    DrawGeneralRatsnest( aDC, aNetCode );
+
+    // Display results
+    int net_notconnected_count = 0;
+    NETINFO_ITEM* net = m_Pcb->FindNet( aNetCode );
+
+    if( net )       // Should not occur, but ...
+    {
+        for( unsigned ii = net->m_RatsnestStartIdx; ii < net->m_RatsnestEndIdx; ii++ )
+        {
+            if( m_Pcb->m_FullRatsnest[ii].IsActive() )
+                net_notconnected_count++;
+        }
+
+        msg.Printf( wxT( "links %d nc %d  net:nc %d" ),
+                    m_Pcb->GetRatsnestsCount(), m_Pcb->GetUnconnectedNetCount(),
+                    net_notconnected_count );
+    }
+    else
+        msg.Printf( wxT( "net not found: netcode %d" ),aNetCode );
+
+    SetStatusText( msg );
+    return;
+}
+
+
+/* search connections between tracks and pads and propagate pad net codes to the track
+ * segments.
+ * Pads netcodes are assumed to be up to date.
+ */
+void PCB_BASE_FRAME::RecalculateAllTracksNetcode()
+{
+    CONNECTIONS connections( m_Pcb );
+
+    connections.RecalculateAllTracksNetcode();
 }
 
 
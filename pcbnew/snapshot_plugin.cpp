@@ -0,0 +1,512 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file snapshot_plugin.cpp
+ * @brief The binary board snapshot PLUGIN.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+#include <fctsys.h>
+#include <common.h>
+#include <richio.h>
+
+#include <class_board.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <snapshot_plugin.h>
+
+using namespace std;    // auto_ptr
+
+
+static const char   SNAPSHOT_MAGIC[8] = { 'K', 'i', 'C', 'a', 'd', 'S', 'n', 'p' };
+
+/// written as is, read back as an other value on a machine of an other byte order
+static const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+
+/// the section data are aligned on this size in the file
+#define SNAPSHOT_ALIGNMENT  8
+
+
+/// the section tags, in their order in the file
+enum SNAPSHOT_TAG
+{
+    SNAPSHOT_TEXT = 1,          ///< the board s-expressions, bytes
+    SNAPSHOT_TRACKS,            ///< SNAPSHOT_TRACKs
+    SNAPSHOT_ZONE_FILL_SIZES,   ///< the count of filled polygon corners of each zone, uint32_t
+    SNAPSHOT_ZONE_FILLS,        ///< SNAPSHOT_CORNERs
+    SNAPSHOT_END
+};
+
+
+struct SNAPSHOT_HEADER
+{
+    char        m_Magic[8];     ///< SNAPSHOT_MAGIC
+    uint32_t    m_Version;      ///< SNAPSHOT_VERSION
+    uint32_t    m_ByteOrder;    ///< SNAPSHOT_BYTE_ORDER
+    uint32_t    m_Checksum;     ///< Adler-32 of the sections
+    uint32_t    m_Reserved;
+    uint64_t    m_Size;         ///< the size of the sections
+};
+
+
+struct SNAPSHOT_SECTION
+{
+    uint32_t    m_Tag;          ///< a SNAPSHOT_TAG
+    uint32_t    m_ItemSize;     ///< the size of an item of the section
+    uint64_t    m_Count;        ///< the count of items, followed by the alignment padding
+};
+
+
+/// a track or a via
+struct SNAPSHOT_TRACK
+{
+    int32_t     m_IsVia;
+    int32_t     m_Shape;
+    int32_t     m_StartX;
+    int32_t     m_StartY;
+    int32_t     m_EndX;
+    int32_t     m_EndY;
+    int32_t     m_Width;
+    int32_t     m_Drill;
+    int32_t     m_Layer;        ///< the layer pair of a via
+    int32_t     m_Net;
+    uint32_t    m_TimeStamp;
+    uint32_t    m_Status;
+};
+
+
+/// a corner of a zone filled polygon
+struct SNAPSHOT_CORNER
+{
+    int32_t     m_X;
+    int32_t     m_Y;
+    int32_t     m_EndContour;
+    int32_t     m_Utility;
+};
+
+
+/**
+ * Function adler32
+ * updates the Adler-32 checksum \a aAdler with \a aSize bytes of \a aData.  The
+ * checksum of no data is 1.
+ */
+static uint32_t adler32( uint32_t aAdler, const char* aData, size_t aSize )
+{
+    const uint32_t  MOD_ADLER = 65521;
+    const size_t    NMAX = 5552;    // the bytes which can be summed before the sums overflow
+
+    uint32_t a = aAdler & 0xffff;
+    uint32_t b = aAdler >> 16;
+
+    const unsigned char* data = (const unsigned char*) aData;
+
+    while( aSize )
+    {
+        size_t count = std::min( aSize, NMAX );
+
+        aSize -= count;
+
+        while( count-- )
+        {
+            a += *data++;
+            b += a;
+        }
+
+        a %= MOD_ADLER;
+        b %= MOD_ADLER;
+    }
+
+    return ( b << 16 ) | a;
+}
+
+
+/**
+ * Class SNAPSHOT_WRITER
+ * writes the sections of a snapshot to a file, then its header, once the checksum
+ * of the sections is known.
+ */
+class SNAPSHOT_WRITER
+{
+    FILE*       m_fp;
+    wxString    m_filename;
+    uint32_t    m_checksum;
+    uint64_t    m_size;
+
+    void write( const void* aData, size_t aSize, bool aSum = true )
+    {
+        if( aSize && fwrite( aData, aSize, 1, m_fp ) != 1 )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "error writing to file '%s'" ),
+                                              GetChars( m_filename ) ) );
+        }
+
+        if( aSum )
+        {
+            m_checksum = adler32( m_checksum, (const char*) aData, aSize );
+            m_size += aSize;
+        }
+    }
+
+public:
+    SNAPSHOT_WRITER( const wxString& aFileName ) :
+        m_filename( aFileName ),
+        m_checksum( 1 ),
+        m_size( 0 )
+    {
+        m_fp = wxFopen( aFileName, wxT( "wb" ) );
+
+        if( !m_fp )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "cannot open or save file '%s'" ),
+                                              GetChars( aFileName ) ) );
+        }
+
+        // room for the header
+        SNAPSHOT_HEADER header;
+
+        memset( &header, 0, sizeof( header ) );
+        write( &header, sizeof( header ), false );
+    }
+
+    ~SNAPSHOT_WRITER()
+    {
+        if( m_fp )
+            fclose( m_fp );
+    }
+
+    void WriteSection( SNAPSHOT_TAG aTag, size_t aItemSize, size_t aCount, const void* aItems )
+    {
+        static const char padding[SNAPSHOT_ALIGNMENT] = { 0 };
+
+        SNAPSHOT_SECTION section;
+
+        section.m_Tag      = aTag;
+        section.m_ItemSize = aItemSize;
+        section.m_Count    = aCount;
+
+        write( &section, sizeof( section ) );
+        write( aItems, aItemSize * aCount );
+        write( padding, ( SNAPSHOT_ALIGNMENT - aItemSize * aCount % SNAPSHOT_ALIGNMENT )
+                        % SNAPSHOT_ALIGNMENT );
+    }
+
+    /// writes the end of the sections and the header, and closes the file
+    void Finish()
+    {
+        WriteSection( SNAPSHOT_END, 1, 0, NULL );
+
+        SNAPSHOT_HEADER header;
+
+        memcpy( header.m_Magic, SNAPSHOT_MAGIC, sizeof( header.m_Magic ) );
+        header.m_Version   = SNAPSHOT_VERSION;
+        header.m_ByteOrder = SNAPSHOT_BYTE_ORDER;
+        header.m_Checksum  = m_checksum;
+        header.m_Reserved  = 0;
+        header.m_Size      = m_size;
+
+        rewind( m_fp );
+        write( &header, sizeof( header ), false );
+
+        FILE* fp = m_fp;
+
+        m_fp = NULL;
+
+        if( fclose( fp ) )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "error writing to file '%s'" ),
+                                              GetChars( m_filename ) ) );
+        }
+    }
+};
+
+
+void SNAPSHOT_PLUGIN::Save( const wxString& aFileName, BOARD* aBoard, PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    // All of the board, but what goes in the arrays.
+    STRING_FORMATTER    text;
+    PCB_IO              io( CTL_OMIT_TRACKS | CTL_OMIT_ZONE_FILLS );
+
+    io.FormatBoard( aBoard, &text );
+
+    std::vector< SNAPSHOT_TRACK > tracks;
+
+    tracks.reserve( aBoard->m_Track.GetCount() );
+
+    for( TRACK* track = aBoard->m_Track;  track;  track = track->Next() )
+    {
+        SNAPSHOT_TRACK item;
+
+        item.m_IsVia     = track->Type() == PCB_VIA_T;
+        item.m_Shape     = track->GetShape();
+        item.m_StartX    = track->GetStart().x;
+        item.m_StartY    = track->GetStart().y;
+        item.m_EndX      = track->GetEnd().x;
+        item.m_EndY      = track->GetEnd().y;
+        item.m_Width     = track->GetWidth();
+        item.m_Drill     = track->GetDrill();
+        item.m_Layer     = track->GetLayer();
+        item.m_Net       = track->GetNet();
+        item.m_TimeStamp = track->GetTimeStamp();
+        item.m_Status    = track->GetStatus();
+
+        tracks.push_back( item );
+    }
+
+    std::vector< uint32_t >         fillSizes;
+    std::vector< SNAPSHOT_CORNER >  corners;
+
+    for( int ii = 0;  ii < aBoard->GetAreaCount();  ++ii )
+    {
+        const std::vector< CPolyPt >& fill = aBoard->GetArea( ii )->GetFilledPolysList();
+
+        fillSizes.push_back( fill.size() );
+
+        for( unsigned jj = 0;  jj < fill.size();  ++jj )
+        {
+            SNAPSHOT_CORNER corner;
+
+            corner.m_X          = fill[jj].x;
+            corner.m_Y          = fill[jj].y;
+            corner.m_EndContour = fill[jj].end_contour;
+            corner.m_Utility    = fill[jj].m_utility;
+
+            corners.push_back( corner );
+        }
+    }
+
+    SNAPSHOT_WRITER writer( aFileName );
+
+    writer.WriteSection( SNAPSHOT_TEXT, 1, text.GetString().size(), text.GetString().data() );
+    writer.WriteSection( SNAPSHOT_TRACKS, sizeof( SNAPSHOT_TRACK ), tracks.size(),
+                         tracks.size() ? &tracks[0] : NULL );
+    writer.WriteSection( SNAPSHOT_ZONE_FILL_SIZES, sizeof( uint32_t ), fillSizes.size(),
+                         fillSizes.size() ? &fillSizes[0] : NULL );
+    writer.WriteSection( SNAPSHOT_ZONE_FILLS, sizeof( SNAPSHOT_CORNER ), corners.size(),
+                         corners.size() ? &corners[0] : NULL );
+    writer.Finish();
+}
+
+
+/**
+ * Function readFile
+ * reads all of \a aFileName into \a aData.
+ * @throw IO_ERROR if the file cannot be read.
+ */
+static void readFile( const wxString& aFileName, std::vector< char >& aData )
+{
+    FILE* fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Unable to open file '%s'" ),
+                                          GetChars( aFileName ) ) );
+    }
+
+    long size = -1;
+
+    if( fseek( fp, 0, SEEK_END ) == 0 )
+        size = ftell( fp );
+
+    rewind( fp );
+
+    bool ok = size >= 0;
+
+    if( ok )
+    {
+        aData.resize( size );
+        ok = !size || fread( &aData[0], size, 1, fp ) == 1;
+    }
+
+    fclose( fp );
+
+    if( !ok )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "error reading file '%s'" ),
+                                          GetChars( aFileName ) ) );
+    }
+}
+
+
+BOARD* SNAPSHOT_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
+                              PROPERTIES* aProperties )
+{
+    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
+
+    std::vector< char > data;
+
+    readFile( aFileName, data );
+
+    // &data[0] is only valid if the file is not empty
+    const SNAPSHOT_HEADER* header = data.size() < sizeof( SNAPSHOT_HEADER ) ? NULL
+                                  : (const SNAPSHOT_HEADER*) &data[0];
+
+    if( !header || memcmp( header->m_Magic, SNAPSHOT_MAGIC, sizeof( header->m_Magic ) ) )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "File '%s' is not a board snapshot" ),
+                                          GetChars( aFileName ) ) );
+    }
+
+    if( header->m_Version != SNAPSHOT_VERSION || header->m_ByteOrder != SNAPSHOT_BYTE_ORDER )
+    {
+        THROW_IO_ERROR( wxString::Format(
+            _( "Board snapshot '%s' was written by an other version of Pcbnew or machine" ),
+            GetChars( aFileName ) ) );
+    }
+
+    const char* sections = &data[0] + sizeof( SNAPSHOT_HEADER );
+    size_t      size     = data.size() - sizeof( SNAPSHOT_HEADER );
+
+    if( header->m_Size != size || header->m_Checksum != adler32( 1, sections, size ) )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Board snapshot '%s' is damaged" ),
+                                          GetChars( aFileName ) ) );
+    }
+
+    // The sections, in the order they are written.
+    const char* items[SNAPSHOT_END]  = { NULL };
+    size_t      counts[SNAPSHOT_END] = { 0 };
+    size_t      itemSizes[SNAPSHOT_END] =
+    {
+        0, 1, sizeof( SNAPSHOT_TRACK ), sizeof( uint32_t ), sizeof( SNAPSHOT_CORNER )
+    };
+
+    const char* end = sections + size;
+    int         tag = 0;
+
+    for( const char* next = sections;  tag != SNAPSHOT_END;  )
+    {
+        const SNAPSHOT_SECTION* section = (const SNAPSHOT_SECTION*) next;
+
+        if( end - next < (ptrdiff_t) sizeof( SNAPSHOT_SECTION ) || (int) section->m_Tag != tag + 1 )
+            break;
+
+        tag = section->m_Tag;
+        next += sizeof( SNAPSHOT_SECTION );
+
+        // The count is checked before it is multiplied by the item size: the
+        // product of a damaged count could overflow and look small.
+        uint64_t available = end - next;
+
+        if( ( tag != SNAPSHOT_END && section->m_ItemSize != itemSizes[tag] )
+         || section->m_ItemSize == 0 || section->m_Count > available / section->m_ItemSize )
+            break;
+
+        // the data and their alignment padding
+        uint64_t dataSize = ( section->m_ItemSize * section->m_Count + SNAPSHOT_ALIGNMENT - 1 )
+                            / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+
+        if( dataSize > available )
+            break;
+
+        items[tag]  = next;
+        counts[tag] = section->m_Count;
+
+        next += dataSize;
+    }
+
+    if( tag != SNAPSHOT_END )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Board snapshot '%s' is damaged" ),
+                                          GetChars( aFileName ) ) );
+    }
+
+    // All of the board, but its tracks and zone fills.
+    STRING_LINE_READER  reader( std::string( items[SNAPSHOT_TEXT], counts[SNAPSHOT_TEXT] ),
+                                aFileName );
+    PCB_PARSER          parser( &reader );
+    int                 firstZone = aAppendToMe ? aAppendToMe->GetAreaCount() : 0;
+
+    parser.SetBoard( aAppendToMe );
+
+    BOARD* board = dynamic_cast< BOARD* >( parser.Parse() );
+    wxASSERT( board );
+
+    // delete a fresh board on an exception
+    auto_ptr< BOARD > deleter( aAppendToMe ? NULL : board );
+
+    if( (size_t) ( board->GetAreaCount() - firstZone ) != counts[SNAPSHOT_ZONE_FILL_SIZES] )
+    {
+        THROW_IO_ERROR( wxString::Format( _( "Board snapshot '%s' is damaged" ),
+                                          GetChars( aFileName ) ) );
+    }
+
+    const SNAPSHOT_TRACK* tracks = (const SNAPSHOT_TRACK*) items[SNAPSHOT_TRACKS];
+
+    for( size_t ii = 0;  ii < counts[SNAPSHOT_TRACKS];  ++ii )
+    {
+        const SNAPSHOT_TRACK& item = tracks[ii];
+
+        TRACK* track = item.m_IsVia ? new SEGVIA( board ) : new TRACK( board );
+
+        track->SetShape( item.m_Shape );
+        track->SetStart( wxPoint( item.m_StartX, item.m_StartY ) );
+        track->SetEnd( wxPoint( item.m_EndX, item.m_EndY ) );
+        track->SetWidth( item.m_Width );
+        track->SetDrill( item.m_Drill );
+        track->SetLayer( item.m_Layer );
+        track->SetNet( item.m_Net );
+        track->SetTimeStamp( item.m_TimeStamp );
+        track->SetStatus( item.m_Status );
+
+        board->m_Track.Append( track );
+    }
+
+    const uint32_t*         fillSizes = (const uint32_t*) items[SNAPSHOT_ZONE_FILL_SIZES];
+    const SNAPSHOT_CORNER*  corner    = (const SNAPSHOT_CORNER*) items[SNAPSHOT_ZONE_FILLS];
+    const SNAPSHOT_CORNER*  lastCorner = corner + counts[SNAPSHOT_ZONE_FILLS];
+
+    for( size_t ii = 0;  ii < counts[SNAPSHOT_ZONE_FILL_SIZES];  ++ii )
+    {
+        if( fillSizes[ii] > size_t( lastCorner - corner ) )
+        {
+            THROW_IO_ERROR( wxString::Format( _( "Board snapshot '%s' is damaged" ),
+                                              GetChars( aFileName ) ) );
+        }
+
+        std::vector< CPolyPt > fill;
+
+        fill.reserve( fillSizes[ii] );
+
+        for( uint32_t jj = 0;  jj < fillSizes[ii];  ++jj, ++corner )
+            fill.push_back( CPolyPt( corner->m_X, corner->m_Y, corner->m_EndContour,
+                                     corner->m_Utility ) );
+
+        board->GetArea( firstZone + ii )->AddFilledPolysList( fill );
+    }
+
+    deleter.release();
+
+    // Give the filename to the board if it's new
+    if( !aAppendToMe )
+        board->SetFileName( aFileName );
+
+    return board;
+}
@@ -0,0 +1,76 @@
+#ifndef SNAPSHOT_PLUGIN_H_
+#define SNAPSHOT_PLUGIN_H_
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <io_mgr.h>
+#include <wildcards_and_files_ext.h>
+
+
+/// Current board snapshot version.  A snapshot of an other version is not loaded.
+#define SNAPSHOT_VERSION    1
+
+
+/**
+ * Class SNAPSHOT_PLUGIN
+ * is a PLUGIN which saves and loads a BOARD as a binary snapshot, a file which is
+ * quick to write and to read back, for the auto save and the reopening of huge
+ * boards.  The .kicad_pcb file remains the file to exchange boards.
+ * <p>
+ * A snapshot is a header, with the snapshot version and a checksum, then sections:
+ * <ul>
+ * <li> the board without its tracks and zone fills, in s-expressions by PCB_IO,
+ * <li> the tracks and vias, an array of fixed size records,
+ * <li> the filled polygons of the zones, an array of corners.
+ * </ul>
+ * The arrays, which are most of a huge board, are read without any parsing.  The
+ * numbers are in the byte order of the machine: a snapshot is a local file, not
+ * loaded on a machine of an other byte order.
+ * </p>
+ */
+class SNAPSHOT_PLUGIN : public PLUGIN
+{
+public:
+
+    //-----<PLUGIN API>---------------------------------------------------------
+
+    const wxString& PluginName() const
+    {
+        static const wxString name = wxT( "Snapshot" );
+        return name;
+    }
+
+    const wxString& GetFileExtension() const
+    {
+        return SnapshotPcbFileExtension;
+    }
+
+    void Save( const wxString& aFileName, BOARD* aBoard, PROPERTIES* aProperties = NULL );
+
+    BOARD* Load( const wxString& aFileName, BOARD* aAppendToMe, PROPERTIES* aProperties = NULL );
+
+    //-----</PLUGIN API>--------------------------------------------------------
+};
+
+#endif  // SNAPSHOT_PLUGIN_H_
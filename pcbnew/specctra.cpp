@@ -56,6 +56,7 @@
 #include <class_track.h>
 
 #include <specctra.h>
+#include <parse_double.h>
 
 
 namespace DSN {
@@ -569,7 +570,7 @@ void SPECCTRA_DB::doLAYER_PAIR( LAYER_PAIR* growth ) throw( IO_ERROR )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->layer_weight = strtod( CurText(), 0 );
+    growth->layer_weight = ParseDouble( CurText() );
 
     NeedRIGHT();
 }
@@ -1006,7 +1007,7 @@ void SPECCTRA_DB::doPATH( PATH* growth ) throw( IO_ERROR )
     if( NextTok() != T_NUMBER )
         Expecting( "aperture_width" );
 
-    growth->aperture_width = strtod( CurText(), NULL );
+    growth->aperture_width = ParseDouble( CurText() );
 
     POINT   ptTemp;
 
@@ -1016,11 +1017,11 @@ void SPECCTRA_DB::doPATH( PATH* growth ) throw( IO_ERROR )
     {
         if( tok != T_NUMBER )
             Expecting( T_NUMBER );
-        ptTemp.x = strtod( CurText(), NULL );
+        ptTemp.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        ptTemp.y = strtod( CurText(), NULL );
+        ptTemp.y = ParseDouble( CurText() );
 
         growth->points.push_back( ptTemp );
 
@@ -1049,19 +1050,19 @@ void SPECCTRA_DB::doRECTANGLE( RECTANGLE* growth ) throw( IO_ERROR )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point0.x = strtod( CurText(), NULL );
+    growth->point0.x = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point0.y = strtod( CurText(), NULL );
+    growth->point0.y = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point1.x = strtod( CurText(), NULL );
+    growth->point1.x = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point1.y = strtod( CurText(), NULL );
+    growth->point1.y = ParseDouble( CurText() );
 
     NeedRIGHT();
 }
@@ -1076,16 +1077,16 @@ void SPECCTRA_DB::doCIRCLE( CIRCLE* growth ) throw( IO_ERROR )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->diameter = strtod( CurText(), 0 );
+    growth->diameter = ParseDouble( CurText() );
 
     tok = NextTok();
     if( tok == T_NUMBER )
     {
-        growth->vertex.x = strtod( CurText(), 0 );
+        growth->vertex.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex.y = strtod( CurText(), 0 );
+        growth->vertex.y = ParseDouble( CurText() );
 
         tok = NextTok();
     }
@@ -1102,17 +1103,17 @@ void SPECCTRA_DB::doQARC( QARC* growth ) throw( IO_ERROR )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->aperture_width = strtod( CurText(), 0 );
+    growth->aperture_width = ParseDouble( CurText() );
 
     for( int i=0;  i<3;  ++i )
     {
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex[i].x = strtod( CurText(), 0 );
+        growth->vertex[i].x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex[i].y = strtod( CurText(), 0 );
+        growth->vertex[i].y = ParseDouble( CurText() );
     }
 
     NeedRIGHT();
@@ -1644,7 +1645,7 @@ void SPECCTRA_DB::doGRID( GRID* growth ) throw( IO_ERROR )
         growth->grid_type = tok;
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->dimension = strtod( CurText(), 0 );
+        growth->dimension = ParseDouble( CurText() );
         tok = NextTok();
         if( tok == T_LEFT )
         {
@@ -1669,7 +1670,7 @@ void SPECCTRA_DB::doGRID( GRID* growth ) throw( IO_ERROR )
                     if( NextTok() != T_NUMBER )
                         Expecting( T_NUMBER );
 
-                    growth->offset = strtod( CurText(), 0 );
+                    growth->offset = ParseDouble( CurText() );
 
                     if( NextTok() != T_RIGHT )
                         Expecting(T_RIGHT);
@@ -1734,11 +1735,11 @@ void SPECCTRA_DB::doPLACE( PLACE* growth ) throw( IO_ERROR )
     {
         POINT   point;
 
-        point.x = strtod( CurText(), 0 );
+        point.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        point.y = strtod( CurText(), 0 );
+        point.y = ParseDouble( CurText() );
 
         growth->SetVertex( point );
 
@@ -1749,7 +1750,7 @@ void SPECCTRA_DB::doPLACE( PLACE* growth ) throw( IO_ERROR )
 
         if( NextTok() != T_NUMBER )
             Expecting( "rotation" );
-        growth->SetRotation( strtod( CurText(), 0)  );
+        growth->SetRotation( ParseDouble( CurText() )  );
     }
 
     while( (tok = NextTok()) != T_RIGHT )
@@ -2228,7 +2229,7 @@ void SPECCTRA_DB::doPIN( PIN* growth ) throw( IO_ERROR )
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->SetRotation( strtod( CurText(), 0 ) );
+            growth->SetRotation( ParseDouble( CurText() ) );
             NeedRIGHT();
         }
         else
@@ -2240,11 +2241,11 @@ void SPECCTRA_DB::doPIN( PIN* growth ) throw( IO_ERROR )
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->vertex.x = strtod( CurText(), 0 );
+            growth->vertex.x = ParseDouble( CurText() );
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->vertex.y = strtod( CurText(), 0 );
+            growth->vertex.y = ParseDouble( CurText() );
         }
     }
 }
@@ -2888,12 +2889,12 @@ void SPECCTRA_DB::doWIRE_VIA( WIRE_VIA* growth ) throw( IO_ERROR )
 
     while( (tok = NextTok()) == T_NUMBER )
     {
-        point.x = strtod( CurText(), 0 );
+        point.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( "vertex.y" );
 
-        point.y = strtod( CurText(), 0 );
+        point.y = ParseDouble( CurText() );
 
         growth->vertexes.push_back( point );
     }
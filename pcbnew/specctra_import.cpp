@@ -45,6 +45,7 @@
 #include <class_drawsegment.h>
 
 #include <specctra.h>
+#include <parse_double.h>
 
 
 using namespace DSN;
@@ -267,7 +268,7 @@ SEGVIA* SPECCTRA_DB::makeVIA( PADSTACK* aPadstack, const POINT& aPoint, int aNet
         {
             std::string diamTxt( aPadstack->padstack_id, drillStartNdx, drillEndNdx-drillStartNdx );
             const char* sdiamTxt = diamTxt.c_str();
-            double drillMils = strtod( sdiamTxt, 0 );
+            double drillMils = ParseDouble( sdiamTxt );
 
             // drillMils is not in the session units, but actual mils so we don't use scale()
             drillDiam = (int) (drillMils * 10);
@@ -41,6 +41,7 @@
 #include <class_marker_pcb.h>
 
 #include <pcbnew.h>
+#include <board_spatial_index.h>
 #include <module_editor_frame.h>
 #include <pcbplot.h>
 #include <protos.h>
@@ -48,6 +49,14 @@
 #include <wx/overlay.h>
 
 
+/**
+ * Trace mask used to log the redraw time of the board editor.  Setting the
+ * WXTRACE environment variable to "KicadRedraw" shows it at each repaint, with
+ * the zoom level and the size of the area redrawn.
+ */
+static const wxChar* traceRedraw = wxT( "KicadRedraw" );
+
+
 // Local functions:
 /* Trace the pads of a module in sketch mode.
  * Used to display pads when when the module visibility is set to not visible
@@ -102,6 +111,8 @@ void PCB_EDIT_FRAME::RedrawActiveWindow( wxDC* DC, bool EraseBg )
     if( !GetBoard() || !screen )
         return;
 
+    unsigned startTime = GetRunningMicroSecs();
+
     GRSetDrawMode( DC, GR_COPY );
 
     m_canvas->DrawBackGround( DC );
@@ -113,6 +124,12 @@ void PCB_EDIT_FRAME::RedrawActiveWindow( wxDC* DC, bool EraseBg )
 
     DrawGeneralRatsnest( DC );
 
+    EDA_RECT* clipBox = m_canvas->GetClipBox();
+
+    wxLogTrace( traceRedraw, wxT( "Board redraw: %u usecs, zoom %g, area %d x %d" ),
+                GetRunningMicroSecs() - startTime, screen->GetZoom(),
+                clipBox->GetWidth(), clipBox->GetHeight() );
+
 #ifdef USE_WX_OVERLAY
     if( IsShown() )
     {
@@ -130,7 +147,36 @@ void PCB_EDIT_FRAME::RedrawActiveWindow( wxDC* DC, bool EraseBg )
 }
 
 
-// Redraw the BOARD items but not cursors, axis or grid
+/**
+ * Function drawArea
+ * tells if the board items can be culled against the clip box of \a aPanel, that is
+ * if the items are where the spatial index and their bounding boxes say they are.
+ * While the mouse is captured, an edit command may have moved items in place, which
+ * the index learns only at the next PCB_BASE_FRAME::OnModify(), so nothing is culled.
+ * @param aPanel is the panel drawn, or NULL.
+ * @param aArea is where to put the area to draw, in internal units.
+ * @return bool - true if only the items intersecting \a aArea have to be drawn.
+ */
+static bool drawArea( EDA_DRAW_PANEL* aPanel, EDA_RECT& aArea )
+{
+    if( !aPanel || aPanel->IsMouseCaptured() )
+        return false;
+
+    aArea = *aPanel->GetClipBox();
+    aArea.Normalize();
+
+    return aArea.GetWidth() > 0 && aArea.GetHeight() > 0;
+}
+
+
+static inline bool isInArea( const EDA_ITEM* aItem, const EDA_RECT& aArea )
+{
+    return aItem->GetBoundingBox().Intersects( aArea );
+}
+
+
+// Redraw the BOARD items but not cursors, axis or grid.  Only the items in the
+// clip box of aPanel are drawn, the tracks and vias are found by the spatial index.
 void BOARD::Draw( EDA_DRAW_PANEL* aPanel, wxDC* DC, GR_DRAWMODE aDrawMode, const wxPoint& offset )
 {
     /* The order of drawing is flexible on some systems and not on others.  For
@@ -143,18 +189,42 @@ void BOARD::Draw( EDA_DRAW_PANEL* aPanel, wxDC* DC, GR_DRAWMODE aDrawMode, const
      * below is chosen to give MODULEs the highest visible priority.
      */
 
+    EDA_RECT    area;
+    bool        cull = drawArea( aPanel, area );
+
     /* Draw all tracks and zones.  As long as dark colors are used for the
      * tracks,  Then the OR draw mode should show tracks underneath other
      * tracks.  But a white track will cover any other color since it has
      * more bits to OR in.
      */
-    for( TRACK* track = m_Track;  track;   track = track->Next() )
+    if( cull )
     {
-        track->Draw( aPanel, DC, aDrawMode );
+        // The index boxes have no clearance, the query area is inflated by the
+        // biggest one so that clearance outlines entering the area are drawn.
+        static const KICAD_T trackTypes[] = { PCB_TRACE_T, PCB_VIA_T, EOT };
+
+        std::vector<BOARD_ITEM*> tracks;
+        EDA_RECT query = area;
+
+        query.Inflate( GetBiggestClearanceValue() );
+        GetSpatialIndex().Query( query, tracks, trackTypes );
+
+        for( unsigned ii = 0;  ii < tracks.size();  ++ii )
+            tracks[ii]->Draw( aPanel, DC, aDrawMode );
+    }
+    else
+    {
+        for( TRACK* track = m_Track;  track;   track = track->Next() )
+        {
+            track->Draw( aPanel, DC, aDrawMode );
+        }
     }
 
     for( SEGZONE* zone = m_Zone;  zone;   zone = zone->Next() )
     {
+        if( cull && !isInArea( zone, area ) )
+            continue;
+
         zone->Draw( aPanel, DC, aDrawMode );
     }
 
@@ -164,6 +234,9 @@ void BOARD::Draw( EDA_DRAW_PANEL* aPanel, wxDC* DC, GR_DRAWMODE aDrawMode, const
         if( item->IsMoving() )
             continue;
 
+        if( cull && !isInArea( item, area ) )
+            continue;
+
         switch( item->Type() )
         {
         case PCB_DIMENSION_T:
@@ -183,6 +256,9 @@ void BOARD::Draw( EDA_DRAW_PANEL* aPanel, wxDC* DC, GR_DRAWMODE aDrawMode, const
     {
         ZONE_CONTAINER* zone = GetArea(ii);
 
+        if( cull && !isInArea( zone, area ) )
+            continue;
+
         // Areas must be drawn here only if not moved or dragged,
         // because these areas are drawn by ManageCursor() in a specific manner
         if ( (zone->GetFlags() & (IN_EDIT | IS_DRAGGED | IS_MOVED)) == 0 )
@@ -200,6 +276,9 @@ void BOARD::Draw( EDA_DRAW_PANEL* aPanel, wxDC* DC, GR_DRAWMODE aDrawMode, const
         if( module->IsMoving() )
             continue;
 
+        if( cull && !isInArea( module, area ) )
+            continue;
+
         if( !IsElementVisible( PCB_VISIBLE(MOD_FR_VISIBLE) ) )
         {
             if( module->GetLayer() == LAYER_N_FRONT )
@@ -0,0 +1,307 @@
+/**
+ * @file zone_fill_hash.cpp
+ * @brief the hash of the data a zone filling depends on, to reuse filled areas.
+ */
+
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 1992-2012 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <algorithm>
+
+#include <fctsys.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_track.h>
+#include <class_pad.h>
+#include <class_edge_mod.h>
+#include <class_drawsegment.h>
+#include <class_pcb_text.h>
+#include <class_zone.h>
+
+#include <board_spatial_index.h>
+
+
+/**
+ * Class FILL_HASH
+ * is a 64 bits FNV-1a hash of the values given to Add().
+ */
+class FILL_HASH
+{
+public:
+    FILL_HASH() : m_hash( 14695981039346656037ULL ) {}
+
+    void Add( const void* aData, size_t aSize )
+    {
+        const unsigned char* data = (const unsigned char*) aData;
+
+        for( size_t ii = 0; ii < aSize; ++ii )
+        {
+            m_hash ^= data[ii];
+            m_hash *= 1099511628211ULL;
+        }
+    }
+
+    void Add( int aValue )                  { Add( &aValue, sizeof( aValue ) ); }
+    void Add( double aValue )               { Add( &aValue, sizeof( aValue ) ); }
+    void Add( const wxPoint& aPoint )       { Add( aPoint.x ); Add( aPoint.y ); }
+    void Add( const wxSize& aSize )         { Add( aSize.x ); Add( aSize.y ); }
+
+    void Add( const EDA_RECT& aRect )
+    {
+        Add( aRect.GetOrigin() );
+        Add( aRect.GetSize() );
+    }
+
+    void Add( const std::vector<wxPoint>& aPoints )
+    {
+        Add( (int) aPoints.size() );
+
+        for( unsigned ii = 0; ii < aPoints.size(); ++ii )
+            Add( aPoints[ii] );
+    }
+
+    unsigned long long GetHash() const      { return m_hash; }
+
+private:
+    unsigned long long m_hash;
+};
+
+
+static void addDrawSegment( FILL_HASH& aHash, const DRAWSEGMENT* aSegment )
+{
+    aHash.Add( (int) aSegment->Type() );
+    aHash.Add( aSegment->GetLayer() );
+    aHash.Add( (int) aSegment->GetShape() );
+    aHash.Add( aSegment->GetStart() );
+    aHash.Add( aSegment->GetEnd() );
+    aHash.Add( aSegment->GetWidth() );
+    aHash.Add( aSegment->GetAngle() );
+    aHash.Add( aSegment->GetPolyPoints() );
+}
+
+
+static void addZoneOutline( FILL_HASH& aHash, const ZONE_CONTAINER* aZone )
+{
+    const std::vector<CPolyPt>& corners = aZone->m_Poly->m_CornersList;
+
+    aHash.Add( (int) corners.size() );
+
+    for( unsigned ii = 0; ii < corners.size(); ++ii )
+    {
+        aHash.Add( corners[ii] );
+        aHash.Add( (int) corners[ii].end_contour );
+    }
+
+    aHash.Add( aZone->GetCornerSmoothingType() );
+    aHash.Add( (int) aZone->GetCornerRadius() );
+    aHash.Add( aZone->m_ArcToSegmentsCount );
+}
+
+
+unsigned long long ZONE_CONTAINER::BuildFillHash( BOARD* aPcb ) const
+{
+    FILL_HASH hash;
+
+    // The settings of the zone
+    addZoneOutline( hash, this );
+
+    hash.Add( GetLayer() );
+    hash.Add( GetNet() );
+    hash.Add( m_ZoneClearance );
+    hash.Add( m_ZoneMinThickness );
+    hash.Add( m_FillMode );
+    hash.Add( (int) m_PadConnection );
+    hash.Add( m_ThermalReliefGap );
+    hash.Add( m_ThermalReliefCopperBridge );
+    hash.Add( (int) GetPriority() );
+
+    if( !IsOnCopperLayer() )
+        return std::max( hash.GetHash(), 1ULL );
+
+    // The netclass clearances, as AddClearanceAreasPolygonsToPolysList() uses them
+    int margin         = m_ZoneMinThickness / 2;
+    int zone_clearance = std::max( m_ZoneClearance, GetClearance() ) + margin;
+    int biggest_clearance = std::max( aPcb->GetBiggestClearanceValue(), zone_clearance );
+
+    hash.Add( zone_clearance );
+    hash.Add( biggest_clearance );
+
+    EDA_RECT zone_boundingbox = GetBoundingBox();
+    zone_boundingbox.Inflate( biggest_clearance );
+
+    // The items which can cut the zone.  The board lists are in an arbitrary
+    // order, the hashes of the items are summed so that the result does not
+    // depend on it.
+    unsigned long long items = 0;
+
+    for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->m_Pads;  pad;  pad = pad->Next() )
+        {
+            if( !pad->IsOnLayer( GetLayer() )
+              && pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
+
+            int thermalGap = GetThermalReliefGap( pad );
+
+            EDA_RECT item_boundingbox = BOARD_SPATIAL_INDEX::ItemBoundingBox( pad );
+            item_boundingbox.Inflate( std::max( pad->GetClearance(), thermalGap ) + margin );
+
+            if( !item_boundingbox.Intersects( zone_boundingbox ) )
+                continue;
+
+            FILL_HASH item;
+
+            item.Add( (int) PCB_PAD_T );
+            item.Add( pad->GetPosition() );
+            item.Add( pad->GetOffset() );
+            item.Add( pad->GetSize() );
+            item.Add( pad->GetDelta() );
+            item.Add( pad->GetOrientation() );
+            item.Add( (int) pad->GetShape() );
+            item.Add( pad->GetDrillSize() );
+            item.Add( (int) pad->GetDrillShape() );
+            item.Add( pad->GetLayerMask() );
+            item.Add( (int) pad->GetAttribute() );
+            item.Add( pad->GetNet() );
+            item.Add( pad->GetClearance() );
+            item.Add( (int) GetPadConnection( pad ) );
+            item.Add( thermalGap );
+            item.Add( GetThermalReliefCopperBridge( pad ) );
+
+            items += item.GetHash();
+        }
+
+        for( BOARD_ITEM* edge = module->m_Drawings;  edge;  edge = edge->Next() )
+        {
+            if( edge->Type() != PCB_MODULE_EDGE_T || !edge->IsOnLayer( GetLayer() ) )
+                continue;
+
+            if( !edge->GetBoundingBox().Intersects( zone_boundingbox ) )
+                continue;
+
+            FILL_HASH item;
+
+            addDrawSegment( item, (EDGE_MODULE*) edge );
+            items += item.GetHash();
+        }
+    }
+
+    for( TRACK* track = aPcb->m_Track;  track;  track = track->Next() )
+    {
+        if( !track->IsOnLayer( GetLayer() ) )
+            continue;
+
+        EDA_RECT item_boundingbox = BOARD_SPATIAL_INDEX::ItemBoundingBox( track );
+        item_boundingbox.Inflate( track->GetClearance() + margin );
+
+        if( !item_boundingbox.Intersects( zone_boundingbox ) )
+            continue;
+
+        FILL_HASH item;
+
+        item.Add( (int) track->Type() );
+        item.Add( track->GetLayer() );
+        item.Add( track->GetShape() );
+        item.Add( track->GetStart() );
+        item.Add( track->GetEnd() );
+        item.Add( track->GetWidth() );
+        item.Add( track->GetNet() );
+        item.Add( track->GetClearance() );
+
+        items += item.GetHash();
+    }
+
+    for( BOARD_ITEM* drawing = aPcb->m_Drawings;  drawing;  drawing = drawing->Next() )
+    {
+        if( drawing->GetLayer() != GetLayer() && drawing->GetLayer() != EDGE_N )
+            continue;
+
+        FILL_HASH item;
+
+        switch( drawing->Type() )
+        {
+        case PCB_LINE_T:
+            {
+                EDA_RECT item_boundingbox = drawing->GetBoundingBox();
+                item_boundingbox.Inflate( zone_clearance );
+
+                if( !item_boundingbox.Intersects( zone_boundingbox ) )
+                    continue;
+
+                addDrawSegment( item, (DRAWSEGMENT*) drawing );
+            }
+            break;
+
+        case PCB_TEXT_T:
+            {
+                TEXTE_PCB* text = (TEXTE_PCB*) drawing;
+
+                item.Add( (int) PCB_TEXT_T );
+                item.Add( text->GetLayer() );
+                item.Add( text->GetTextBox( -1 ) );
+                item.Add( text->GetPosition() );
+                item.Add( text->GetOrientation() );
+            }
+            break;
+
+        default:
+            continue;
+        }
+
+        items += item.GetHash();
+    }
+
+    for( int ii = 0; ii < aPcb->GetAreaCount(); ii++ )
+    {
+        const ZONE_CONTAINER* zone = aPcb->GetArea( ii );
+
+        if( zone == this || zone->GetLayer() != GetLayer() )
+            continue;
+
+        // the zones AddClearanceAreasPolygonsToPolysList() does not remove
+        if( !zone->GetIsKeepout() && zone->GetPriority() <= GetPriority() )
+            continue;
+
+        if( zone->GetIsKeepout() && !zone->GetDoNotAllowCopperPour() )
+            continue;
+
+        if( !zone->GetBoundingBox().Intersects( zone_boundingbox ) )
+            continue;
+
+        FILL_HASH item;
+
+        item.Add( (int) PCB_ZONE_AREA_T );
+        addZoneOutline( item, zone );
+        item.Add( zone->GetNet() );
+        item.Add( (int) zone->GetIsKeepout() );
+
+        items += item.GetHash();
+    }
+
+    hash.Add( &items, sizeof( items ) );
+
+    // 0 means "unknown"
+    return std::max( hash.GetHash(), 1ULL );
+}
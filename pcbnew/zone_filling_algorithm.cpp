@@ -51,11 +51,13 @@
  * @param aPcb: the current board (can be NULL for non copper zones)
  * @param aCornerBuffer: A reference to a buffer to put polygon corners, or NULL
  * if NULL (default), uses m_FilledPolysList and fill current zone.
+ * @param aDummyPad: the dummy pad given to AddClearanceAreasPolygonsToPolysList()
  * @return number of polygons
  * This function does not add holes for pads and tracks but calls
  * AddClearanceAreasPolygonsToPolysList() to do that for copper layers
  */
-int ZONE_CONTAINER::BuildFilledPolysListData( BOARD* aPcb, std::vector <CPolyPt>* aCornerBuffer )
+int ZONE_CONTAINER::BuildFilledPolysListData( BOARD* aPcb, std::vector <CPolyPt>* aCornerBuffer,
+                                              D_PAD* aDummyPad )
 {
     if( aCornerBuffer == NULL )
         m_FilledPolysList.clear();
@@ -69,64 +71,66 @@ int ZONE_CONTAINER::BuildFilledPolysListData( BOARD* aPcb, std::vector <CPolyPt>
         return 0;
 
     // Make a smoothed polygon out of the user-drawn polygon if required
-    if( m_smoothedPoly )
-    {
-        delete m_smoothedPoly;
-        m_smoothedPoly = NULL;
-    }
+    CPolyLine* smoothedPoly;
 
     switch( m_cornerSmoothingType )
     {
     case ZONE_SETTINGS::SMOOTHING_CHAMFER:
-        m_smoothedPoly = m_Poly->Chamfer( m_cornerRadius );
+        smoothedPoly = m_Poly->Chamfer( m_cornerRadius );
         break;
     case ZONE_SETTINGS::SMOOTHING_FILLET:
-        m_smoothedPoly = m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
+        smoothedPoly = m_Poly->Fillet( m_cornerRadius, m_ArcToSegmentsCount );
         break;
     default:
-        m_smoothedPoly = new CPolyLine;
-        m_smoothedPoly->Copy( m_Poly );
+        smoothedPoly = new CPolyLine;
+        smoothedPoly->Copy( m_Poly );
         break;
     }
 
+    // Only the outline is wanted: do not modify the zone, the outlines of
+    // the other zones are used while filling a zone, maybe from an other thread.
     if( aCornerBuffer )
-        ConvertPolysListWithHolesToOnePolygon( m_smoothedPoly->m_CornersList,
+    {
+        ConvertPolysListWithHolesToOnePolygon( smoothedPoly->m_CornersList,
                                                *aCornerBuffer );
-    else
-        ConvertPolysListWithHolesToOnePolygon( m_smoothedPoly->m_CornersList,
-                                               m_FilledPolysList );
+        delete smoothedPoly;
+        return 1;
+    }
+
+    delete m_smoothedPoly;
+    m_smoothedPoly = smoothedPoly;
+
+    ConvertPolysListWithHolesToOnePolygon( m_smoothedPoly->m_CornersList,
+                                           m_FilledPolysList );
 
     /* For copper layers, we now must add holes in the Polygon list.
      * holes are pads and tracks with their clearance area
      * for non copper layers just recalculate the m_FilledPolysList
      * with m_ZoneMinThickness taken in account
      */
-    if( ! aCornerBuffer )
+    if( IsOnCopperLayer() )
+        AddClearanceAreasPolygonsToPolysList( aPcb, aDummyPad );
+    else
     {
-        if( IsOnCopperLayer() )
-            AddClearanceAreasPolygonsToPolysList( aPcb );
-        else
-        {
-            // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
-            KI_POLYGON_SET polyset_zone_solid_areas;
-            int         margin = m_ZoneMinThickness / 2;
-
-            /* First, creates the main polygon (i.e. the filled area using only one outline)
-             * to reserve a m_ZoneMinThickness/2 margin around the outlines and holes
-             * this margin is the room to redraw outlines with segments having a width set to
-             * m_ZoneMinThickness
-             * so m_ZoneMinThickness is the min thickness of the filled zones areas
-             * the polygon is stored in polyset_zone_solid_areas
-             */
-            CopyPolygonsFromFilledPolysListToKiPolygonList( polyset_zone_solid_areas );
-            polyset_zone_solid_areas -= margin;
-            // put solid area in m_FilledPolysList:
-            m_FilledPolysList.clear();
-            CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
-        }
-        if ( m_FillMode )   // if fill mode uses segments, create them:
-            Fill_Zone_Areas_With_Segments( );
+        // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
+        KI_POLYGON_SET polyset_zone_solid_areas;
+        int         margin = m_ZoneMinThickness / 2;
+
+        /* First, creates the main polygon (i.e. the filled area using only one outline)
+         * to reserve a m_ZoneMinThickness/2 margin around the outlines and holes
+         * this margin is the room to redraw outlines with segments having a width set to
+         * m_ZoneMinThickness
+         * so m_ZoneMinThickness is the min thickness of the filled zones areas
+         * the polygon is stored in polyset_zone_solid_areas
+         */
+        CopyPolygonsFromFilledPolysListToKiPolygonList( polyset_zone_solid_areas );
+        polyset_zone_solid_areas -= margin;
+        // put solid area in m_FilledPolysList:
+        m_FilledPolysList.clear();
+        CopyPolygonsFromKiPolygonListToFilledPolysList( polyset_zone_solid_areas );
     }
+    if ( m_FillMode )   // if fill mode uses segments, create them:
+        Fill_Zone_Areas_With_Segments( );
 
     return 1;
 }
@@ -26,15 +26,23 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
  */
 
+#include <algorithm>
+#include <vector>
+
 #include <wx/progdlg.h>
 
+#include <boost/ptr_container/ptr_vector.hpp>
+
 #include <fctsys.h>
 #include <appl_wxstruct.h>
 #include <class_drawpanel.h>
 #include <wxPcbStruct.h>
 #include <macros.h>
+#include <openmp_threads.h>
 
 #include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
 #include <class_track.h>
 #include <class_zone.h>
 
@@ -87,6 +95,17 @@ void PCB_EDIT_FRAME::Delete_OldZone_Fill( SEGZONE* aZone, time_t aTimestamp )
 
 int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
 {
+    unsigned long long fillHash = 0;
+
+    if( !aZone->GetIsKeepout() )
+    {
+        fillHash = aZone->BuildFillHash( GetBoard() );
+
+        // Nothing the filled areas depend on has changed since the last fill
+        if( fillHash == aZone->GetFillHash() )
+            return 0;
+    }
+
     aZone->ClearFilledPolysList();
     aZone->UnFill();
 
@@ -113,6 +132,7 @@ int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
     wxBusyCursor dummy;     // Shows an hourglass cursor (removed by its destructor)
 
     aZone->BuildFilledPolysListData( GetBoard() );
+    aZone->SetFillHash( fillHash );
 
     OnModify();
 
@@ -120,7 +140,21 @@ int PCB_EDIT_FRAME::Fill_Zone( ZONE_CONTAINER* aZone )
 }
 
 
-int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
+/* D_PAD::GetBoundingRadius() computes its value the first time it is needed.
+ * Compute it for all the pads before the threads filling the zones share them.
+ */
+static void cachePadBoundingRadii( BOARD* aPcb )
+{
+    for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
+    {
+        for( D_PAD* pad = module->m_Pads;  pad;  pad = pad->Next() )
+            pad->GetBoundingRadius();
+    }
+}
+
+
+int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose,
+                                    const std::vector<time_t>* aZones )
 {
     int errorLevel = 0;
     int areaCount = GetBoard()->GetAreaCount();
@@ -142,30 +176,113 @@ int PCB_EDIT_FRAME::Fill_All_Zones( wxWindow * aActiveWindow, bool aVerbose )
     // Remove segment zones
     GetBoard()->m_Zone.DeleteAll();
 
-    int ii;
+    // The zones to fill, and the hashes of what their filled areas will be
+    // built from.  The up to date zones are kept as they are.
+    std::vector<ZONE_CONTAINER*>     zones;
+    std::vector<unsigned long long>  fillHashes;
 
-    for( ii = 0; ii < areaCount; ii++ )
+    for( int ii = 0; ii < areaCount; ii++ )
     {
         ZONE_CONTAINER* zoneContainer = GetBoard()->GetArea( ii );
-        if( zoneContainer->GetIsKeepout() )
+
+        if( aZones && std::find( aZones->begin(), aZones->end(),
+                                 zoneContainer->GetTimeStamp() ) == aZones->end() )
             continue;
 
-        msg.Printf( FORMAT_STRING, ii+1, areaCount, GetChars( zoneContainer->GetNetName() ) );
+        // Cannot fill keepout zones:
+        if( zoneContainer->GetIsKeepout() )
+        {
+            zoneContainer->ClearFilledPolysList();
+            zoneContainer->UnFill();
+        }
+        else
+        {
+            unsigned long long fillHash = zoneContainer->BuildFillHash( GetBoard() );
+
+            if( fillHash != zoneContainer->GetFillHash() )
+            {
+                zones.push_back( zoneContainer );
+                fillHashes.push_back( fillHash );
+            }
+        }
+    }
+
+    cachePadBoundingRadii( GetBoard() );
+
+    // The zones are filled by one loop shared by the threads: each thread fills
+    // whole zones and only writes to the zone it fills.  The progress bar is
+    // updated and the abort button checked by the master thread, which is the
+    // main thread, between two of its zones.  When the fill is aborted, by the
+    // user or by an error if not aVerbose, the zones not yet started are kept
+    // as they are.
+    int  count  = zones.size();
+    int  started  = 0;          // the count of the zones of which the fill started
+    bool modified = false;
+    bool abort    = false;
+
+    // The dummy pad of each thread, for the pad holes of
+    // AddClearanceAreasPolygonsToPolysList(): MODULEs are not made in the threads.
+    MODULE                  dummymodule( GetBoard() );
+    boost::ptr_vector<D_PAD> dummypads;
+
+    for( int ii = 0; ii < OpenMPThreadCount(); ii++ )
+        dummypads.push_back( new D_PAD( &dummymodule ) );
+
+#pragma omp parallel for schedule( dynamic, 1 )
+    for( int ii = 0; ii < count; ii++ )
+    {
+        bool skip;
+        int  current;
+
+#pragma omp critical( fillAllZones )
+        {
+            skip = abort;
+
+            if( !skip )
+                current = ++started;
+        }
+
+        if( skip )
+            continue;
 
-        if( progressDialog )
+        if( progressDialog && OpenMPThreadNum() == 0 )
         {
-            if( !progressDialog->Update( ii+1, msg ) )
-                break;  // Aborted by user
+            msg.Printf( FORMAT_STRING, current, count, GetChars( zones[ii]->GetNetName() ) );
+
+            if( !progressDialog->Update( current, msg ) )
+            {
+#pragma omp critical( fillAllZones )
+                abort = true;   // Aborted by user
+
+                continue;
+            }
         }
 
-        errorLevel = Fill_Zone( zoneContainer );
+        zones[ii]->ClearFilledPolysList();
+        zones[ii]->UnFill();
+
+        // 0 polygons: a malformed zone outline
+        int zoneErrorLevel = zones[ii]->BuildFilledPolysListData( GetBoard(), NULL,
+                                                 &dummypads[ OpenMPThreadNum() ] ) ? 0 : 1;
+
+        if( zoneErrorLevel == 0 )
+            zones[ii]->SetFillHash( fillHashes[ii] );
 
-        if( errorLevel && !aVerbose )
-            break;
+#pragma omp critical( fillAllZones )
+        {
+            modified = true;
+            errorLevel = std::max( errorLevel, zoneErrorLevel );
+
+            if( errorLevel && !aVerbose )
+                abort = true;
+        }
     }
 
+    if( modified )
+        OnModify();
+
     if( progressDialog )
-        progressDialog->Update( ii+2, _( "Updating ratsnest..." ) );
+        progressDialog->Update( areaCount+1, _( "Updating ratsnest..." ) );
     TestConnections();
 
     // Recalculate the active ratsnest, i.e. the unconnected links
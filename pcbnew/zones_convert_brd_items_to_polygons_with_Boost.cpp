@@ -45,6 +45,7 @@
  */
 
 #include <cmath>
+#include <memory>
 
 #include <fctsys.h>
 #include <polygons_defs.h>
@@ -85,17 +86,9 @@ void AddPolygonCornersToKiPolygonList( std::vector <CPolyPt>& aCornersBuffer,
                                        KI_POLYGON_SET&        aKiPolyList );
 
 // Local Variables:
-static int s_thermalRot = 450;  // angle of stubs in thermal reliefs for round pads
-
-// how many segments are used to create a polygon from a circle:
-static int s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;   /* default value. the real value will be changed to
-                                                                           * ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF
-                                                                           * if m_ArcToSegmentsCount == ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF
-                                                                           */
-double s_Correction;     /* mult coeff used to enlarge rounded and oval pads (and vias)
-                          * because the segment approximation for arcs and circles
-                          * create a smaller gap than a true circle
-                          */
+// AddClearanceAreasPolygonsToPolysList() can fill several zones at once, from
+// several threads: all the other variables it needs are local to a call.
+static const int s_thermalRot = 450;  // angle of stubs in thermal reliefs for round pads
 
 /**
  * Function AddClearanceAreasPolygonsToPolysList
@@ -126,20 +119,22 @@ double s_Correction;     /* mult coeff used to enlarge rounded and oval pads (an
  *     sub them to the filled areas.
  *     Remove new insulated copper islands
  */
-void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
+void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb, D_PAD* aDummyPad )
 {
     // Set the number of segments in arc approximations
+    int circleToSegmentsCount;      // how many segments are used to create a polygon from a circle
+
     if( m_ArcToSegmentsCount == ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF  )
-        s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF;
+        circleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_HIGHT_DEF;
     else
-        s_CircleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;
+        circleToSegmentsCount = ARC_APPROX_SEGMENTS_COUNT_LOW_DEF;
 
     /* calculates the coeff to compensate radius reduction of holes clearance
      * due to the segment approx.
-     * For a circle the min radius is radius * cos( 2PI / s_CircleToSegmentsCount / 2)
-     * s_Correction is 1 /cos( PI/s_CircleToSegmentsCount  )
+     * For a circle the min radius is radius * cos( 2PI / circleToSegmentsCount / 2)
+     * correction is 1 /cos( PI/circleToSegmentsCount  )
      */
-    s_Correction = 1.0 / cos( M_PI / s_CircleToSegmentsCount );
+    double correction = 1.0 / cos( M_PI / circleToSegmentsCount );
 
     // This KI_POLYGON_SET is the area(s) to fill, with m_ZoneMinThickness/2
     KI_POLYGON_SET polyset_zone_solid_areas;
@@ -189,19 +184,27 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
      */
     int item_clearance;
 
-    // static to avoid unnecessary memory allocation when filling many zones.
-    static std::vector <CPolyPt> cornerBufferPolysToSubstract;
-    cornerBufferPolysToSubstract.clear();
+    std::vector <CPolyPt> cornerBufferPolysToSubstract;
 
     /* Use a dummy pad to calculate hole clerance when a pad is not on all copper layers
      * and this pad has a hole
      * This dummy pad has the size and shape of the hole
     * Therefore, this dummy pad is a circle or an oval.
      * A pad must have a parent because some functions expect a non null parent
-     * to find the parent board, and some other data
+     * to find the parent board, and some other data.
+     * When filling from several threads, the caller gives the dummy pad of the thread.
      */
-    MODULE dummymodule( aPcb );    // Creates a dummy parent
-    D_PAD dummypad( &dummymodule );
+    std::auto_ptr<MODULE>   dummymodule;
+    std::auto_ptr<D_PAD>    ownDummyPad;
+
+    if( !aDummyPad )
+    {
+        dummymodule.reset( new MODULE( aPcb ) );    // Creates a dummy parent
+        ownDummyPad.reset( new D_PAD( dummymodule.get() ) );
+        aDummyPad = ownDummyPad.get();
+    }
+
+    D_PAD& dummypad = *aDummyPad;
     D_PAD* nextpad;
     for( MODULE* module = aPcb->m_Modules;  module;  module = module->Next() )
     {
@@ -241,8 +244,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                     int clearance = std::max( zone_clearance, item_clearance );
                     pad->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                                clearance,
-                                                               s_CircleToSegmentsCount,
-                                                               s_Correction );
+                                                               circleToSegmentsCount,
+                                                               correction );
                 }
 
                 continue;
@@ -262,8 +265,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                 {
                     pad->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                                gap,
-                                                               s_CircleToSegmentsCount,
-                                                               s_Correction );
+                                                               circleToSegmentsCount,
+                                                               correction );
                 }
             }
         }
@@ -288,8 +291,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
             int clearance = std::max( zone_clearance, item_clearance );
             track->TransformShapeWithClearanceToPolygon( cornerBufferPolysToSubstract,
                                                          clearance,
-                                                         s_CircleToSegmentsCount,
-                                                         s_Correction );
+                                                         circleToSegmentsCount,
+                                                         correction );
         }
     }
 
@@ -313,7 +316,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
             {
                 ( (EDGE_MODULE*) item )->TransformShapeWithClearanceToPolygon(
                     cornerBufferPolysToSubstract, zone_clearance,
-                    s_CircleToSegmentsCount, s_Correction );
+                    circleToSegmentsCount, correction );
             }
         }
     }
@@ -330,16 +333,19 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
             ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
                 cornerBufferPolysToSubstract,
                 zone_clearance,
-                s_CircleToSegmentsCount,
-                s_Correction );
+                circleToSegmentsCount,
+                correction );
             break;
 
         case PCB_TEXT_T:
+            // The text box is calculated from a copy of the text, and wxString
+            // reference counts are not thread safe.
+#pragma omp critical( zoneFillTexts )
             ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygon(
                 cornerBufferPolysToSubstract,
                 zone_clearance,
-                s_CircleToSegmentsCount,
-                s_Correction );
+                circleToSegmentsCount,
+                correction );
             break;
 
         default:
@@ -381,8 +387,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
 
         zone->TransformShapeWithClearanceToPolygon(
                     cornerBufferPolysToSubstract,
-                    clearance, s_CircleToSegmentsCount,
-                    s_Correction, addclearance );
+                    clearance, circleToSegmentsCount,
+                    correction, addclearance );
     }
 
    // Remove thermal symbols
@@ -414,8 +420,8 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
                                                *pad, thermalGap,
                                                GetThermalReliefCopperBridge( pad ),
                                                m_ZoneMinThickness,
-                                               s_CircleToSegmentsCount,
-                                               s_Correction, s_thermalRot );
+                                               circleToSegmentsCount,
+                                               correction, s_thermalRot );
             }
         }
     }
@@ -445,7 +451,7 @@ void ZONE_CONTAINER::AddClearanceAreasPolygonsToPolysList( BOARD* aPcb )
     // Test thermal stubs connections and add polygons to remove unconnected stubs.
     if( GetNet() > 0 )
         BuildUnconnectedThermalStubsPolygonList( cornerBufferPolysToSubstract, aPcb, this,
-                                                 s_Correction, s_thermalRot );
+                                                 correction, s_thermalRot );
 
     // remove copper areas
     if( cornerBufferPolysToSubstract.size() )
@@ -40,6 +40,7 @@
 #include <pcbnew.h>
 #include <zones.h>
 #include <polygon_test_point_inside.h>
+#include <disjoint_set.h>
 
 static bool CmpZoneSubnetValue( const BOARD_CONNECTED_ITEM* a, const BOARD_CONNECTED_ITEM* b );
 void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode );
@@ -254,6 +255,13 @@ void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb )
 }
 
 
+// Helper function: the index of aSubnet in aSubnets, sorted by increasing values
+static int subnetIndex( const std::vector<int>& aSubnets, int aSubnet )
+{
+    return std::lower_bound( aSubnets.begin(), aSubnets.end(), aSubnet ) - aSubnets.begin();
+}
+
+
 /**
  * Function Merge_SubNets_Connected_By_CopperAreas(BOARD* aPcb, int aNetcode)
  * Used after connections by tracks calculations
@@ -337,7 +345,23 @@ void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode )
     }
 
     // Now, for each zone subnet, we search for 2 items with different subnets.
-    // if found, the 2 subnet are merged in the whole candidate list.
+    // if found, the 2 subnets are merged.  Subnets are merged in a DISJOINT_SET
+    // over the subnet values used in the net, so that a merge does not need
+    // to scan the whole candidate list.
+    std::vector<int> subnets;
+    subnets.reserve( Candidates.size() );
+
+    for( unsigned ii = 0; ii < Candidates.size(); ii++ )
+    {
+        if( Candidates[ii]->GetSubNet() > 0 )
+            subnets.push_back( Candidates[ii]->GetSubNet() );
+    }
+
+    std::sort( subnets.begin(), subnets.end() );
+    subnets.erase( std::unique( subnets.begin(), subnets.end() ), subnets.end() );
+
+    DISJOINT_SET clusters( subnets.size() );
+
     int old_subnet      = 0;
     int old_zone_subnet = 0;
     for( unsigned ii = 0; ii < Candidates.size(); ii++ )
@@ -357,25 +381,32 @@ void Merge_SubNets_Connected_By_CopperAreas( BOARD* aPcb, int aNetcode )
             continue;
         }
 
-        zone_subnet = old_zone_subnet;
-
         // 2 successive items already from the same cluster: nothing to do
         if( subnet == old_subnet )
             continue;
 
         // Here we have 2 items connected by the same area have 2 differents subnets: merge subnets
-        if( (subnet > old_subnet) || ( subnet <= 0) )
-            EXCHG( subnet, old_subnet );
+        clusters.Union( subnetIndex( subnets, subnet ), subnetIndex( subnets, old_subnet ) );
+    }
 
-        for( unsigned jj = 0; jj < Candidates.size(); jj++ )
-        {
-            BOARD_CONNECTED_ITEM * item_to_merge = Candidates[jj];
+    // The subnet of a merged cluster is the smallest of the merged subnets.
+    // subnets is sorted, so this is the first one found for each cluster.
+    std::vector<int> mergedSubnet( subnets.size(), 0 );
 
-            if( item_to_merge->GetSubNet() == old_subnet )
-                item_to_merge->SetSubNet( subnet );
-        }
+    for( unsigned ii = 0; ii < subnets.size(); ii++ )
+    {
+        int root = clusters.Find( ii );
+
+        if( mergedSubnet[root] == 0 )
+            mergedSubnet[root] = subnets[ii];
+    }
+
+    for( unsigned ii = 0; ii < Candidates.size(); ii++ )
+    {
+        BOARD_CONNECTED_ITEM* item = Candidates[ii];
 
-        old_subnet = subnet;
+        if( item->GetSubNet() > 0 )
+            item->SetSubNet( mergedSubnet[ clusters.Find( subnetIndex( subnets, item->GetSubNet() ) ) ] );
     }
 }
 
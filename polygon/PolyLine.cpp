@@ -824,8 +824,9 @@ void CPolyLine::Hatch()
     #define MAXPTS 200      // Usually we store only few values per one hatch line
                             // depending on the compexity of the zone outline
 
-    static std::vector <wxPoint> pointbuffer;
-    pointbuffer.clear();
+    // A local buffer: the zones of a board file are hatched by the threads
+    // which parse them.
+    std::vector <wxPoint> pointbuffer;
     pointbuffer.reserve( MAXPTS + 2 );
 
     for( int a = min_a; a < max_a; a += spacing )
@@ -0,0 +1,391 @@
+/*
+    A test program which compares the search queue the autorouter used, a
+    list sorted by distance, with ROUTE_QUEUE, the indexed binary heap which
+    replaced it.  The same wavefront search as solve.cpp is run with both on a
+    dense two sided routing matrix: 8 neighbours, vias to the other side, and
+    random blocked cells.  Both queues must find a route between the same
+    cells.  The cells of a tie are not always expanded in the same order,
+    and the autorouter estimate of the distance to the target can be larger
+    than the real distance, so the routes and their lengths can be different.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <autorouter/route_queue.h>
+
+
+struct STATS
+{
+    int m_Open;
+    int m_Closed;
+    int m_Moved;
+    int m_Max;
+};
+
+
+/**
+ * the former queue.cpp: a list sorted by distance, walked to insert a node
+ * and to find the node to move.
+ */
+class LIST_QUEUE
+{
+public:
+    LIST_QUEUE() : m_head( NULL ), m_save( NULL ), m_qlen( 0 ) {}
+
+    ~LIST_QUEUE()
+    {
+        Init();
+
+        while( PCB_QUEUE* p = m_save )
+        {
+            m_save = p->Next;
+            delete p;
+        }
+    }
+
+    void Init()
+    {
+        PCB_QUEUE* p;
+
+        while( ( p = m_head ) != NULL )
+        {
+            m_head  = p->Next;
+            p->Next = m_save; m_save = p;
+        }
+
+        m_qlen = 0;
+    }
+
+    bool Get( int* r, int* c, int* s, int* d, int* a )
+    {
+        PCB_QUEUE* p = m_head;
+
+        if( !p )
+            return false;
+
+        *r = p->Row; *c = p->Col; *s = p->Side; *d = p->Dist; *a = p->ApxDist;
+        m_head = p->Next;
+        p->Next = m_save; m_save = p;
+        m_qlen--;
+        return true;
+    }
+
+    void Set( int r, int c, int side, int d, int a, int r2, int c2 )
+    {
+        PCB_QUEUE* p, * q, * t;
+        int i, j = 0;
+
+        if( ( p = m_save ) != NULL )
+            m_save = p->Next;
+        else
+            p = new PCB_QUEUE;
+
+        p->Row  = r;
+        p->Col  = c;
+        p->Side = side;
+        i = ( p->Dist = d ) + ( p->ApxDist = a );
+        p->Next = NULL;
+
+        if( ( q = m_head ) != NULL )
+        {
+            if( q->Dist + q->ApxDist > i )
+            {
+                p->Next = q; m_head = p;
+            }
+            else
+            {
+                for( t = q, q = q->Next; q && i > ( j = q->Dist + q->ApxDist ); t = q, q = q->Next )
+                    ;
+
+                if( q && i == j && q->Row == r2 && q->Col == c2 )
+                {
+                    p->Next = q->Next;
+                    q->Next = p;
+                }
+                else
+                {
+                    p->Next = q;
+                    t->Next = p;
+                }
+            }
+        }
+        else
+        {
+            m_head = p;
+        }
+
+        m_qlen++;
+    }
+
+    /// @return true if the node was found and moved
+    bool Reset( int r, int c, int s, int d, int a, int r2, int c2 )
+    {
+        PCB_QUEUE* p, * q;
+
+        for( q = NULL, p = m_head; p; q = p, p = p->Next )
+        {
+            if( p->Row == r && p->Col == c && p->Side == s )
+            {
+                if( q )
+                    q->Next = p->Next;
+                else
+                    m_head = p->Next;
+
+                p->Next = m_save; m_save = p;
+                m_qlen--;
+                break;
+            }
+        }
+
+        Set( r, c, s, d, a, r2, c2 );
+        return p != NULL;
+    }
+
+    int GetCount() const { return m_qlen; }
+
+private:
+    struct PCB_QUEUE
+    {
+        PCB_QUEUE*  Next;
+        int         Row, Col, Side, Dist, ApxDist;
+    };
+
+    PCB_QUEUE*  m_head;
+    PCB_QUEUE*  m_save;
+    int         m_qlen;
+};
+
+
+/// ROUTE_QUEUE behind the LIST_QUEUE interface
+class HEAP_QUEUE
+{
+public:
+    HEAP_QUEUE( int aRows, int aCols ) : m_rows( aRows ), m_cols( aCols ) {}
+
+    void Init() { m_queue.Init( m_rows, m_cols ); }
+
+    bool Get( int* r, int* c, int* s, int* d, int* a )
+    {
+        ROUTE_QUEUE::NODE node;
+
+        if( !m_queue.Pop( node ) )
+            return false;
+
+        *r = node.m_Row; *c = node.m_Col; *s = node.m_Side;
+        *d = node.m_Dist; *a = node.m_ApxDist;
+        return true;
+    }
+
+    void Set( int r, int c, int s, int d, int a, int r2, int c2 )
+    {
+        m_queue.Push( r, c, s, d, a, r2, c2 );
+    }
+
+    bool Reset( int r, int c, int s, int d, int a, int r2, int c2 )
+    {
+        return m_queue.Push( r, c, s, d, a, r2, c2 );
+    }
+
+    int GetCount() const { return m_queue.GetCount(); }
+
+private:
+    ROUTE_QUEUE m_queue;
+    int         m_rows;
+    int         m_cols;
+};
+
+
+class MATRIX
+{
+public:
+    int                 m_Rows;
+    int                 m_Cols;
+    std::vector<char>   m_Blocked;
+    std::vector<int>    m_Dist;
+    std::vector<char>   m_Visited;
+
+    MATRIX( int aRows, int aCols, int aBlockedPercent ) :
+        m_Rows( aRows ), m_Cols( aCols )
+    {
+        m_Blocked.resize( aRows * aCols * 2 );
+
+        for( unsigned ii = 0; ii < m_Blocked.size(); ii++ )
+            m_Blocked[ii] = rand() % 100 < aBlockedPercent;
+    }
+
+    int Index( int r, int c, int s ) const { return ( r * m_Cols + c ) * 2 + s; }
+
+    static int ApxDist( int r1, int c1, int r2, int c2 )
+    {
+        return ( abs( r1 - r2 ) + abs( c1 - c2 ) ) * 50;
+    }
+};
+
+
+static const int s_delta[8][2] =
+{
+    { 1, -1 }, { 1, 0 }, { 1, 1 }, { 0, -1 }, { 0, 1 }, { -1, -1 }, { -1, 0 }, { -1, 1 }
+};
+
+
+/// @return the distance to the target, or -1 if there is no path
+template <class QUEUE>
+static int route( MATRIX& aMatrix, QUEUE& aQueue, int r1, int c1, int r2, int c2,
+                  STATS& aStats )
+{
+    aMatrix.m_Visited.assign( aMatrix.m_Blocked.size(), 0 );
+    aMatrix.m_Dist.assign( aMatrix.m_Blocked.size(), 0 );
+    aMatrix.m_Blocked[ aMatrix.Index( r1, c1, 0 ) ] = 0;
+    aMatrix.m_Blocked[ aMatrix.Index( r2, c2, 0 ) ] = 0;
+    aMatrix.m_Blocked[ aMatrix.Index( r2, c2, 1 ) ] = 0;
+
+    aQueue.Init();
+    aStats.m_Open = aStats.m_Closed = aStats.m_Moved = aStats.m_Max = 0;
+
+    aQueue.Set( r1, c1, 0, 0, MATRIX::ApxDist( r1, c1, r2, c2 ), r2, c2 );
+    aStats.m_Open++;
+    aStats.m_Max = 1;
+
+    int r, c, s, d, a;
+
+    while( aQueue.Get( &r, &c, &s, &d, &a ) )
+    {
+        aStats.m_Closed++;
+
+        if( r == r2 && c == c2 )
+            return d;
+
+        // the neighbours on this side, then the via to the other side
+        for( int ii = 0; ii < 9; ii++ )
+        {
+            int nr = r, nc = c, ns = s, cost = 50;
+
+            if( ii < 8 )
+            {
+                nr += s_delta[ii][0];
+                nc += s_delta[ii][1];
+                cost = s_delta[ii][0] && s_delta[ii][1] ? 70 : 50;
+            }
+            else
+            {
+                ns = 1 - s;
+                cost = 500;
+            }
+
+            if( nr < 0 || nr >= aMatrix.m_Rows || nc < 0 || nc >= aMatrix.m_Cols )
+                continue;
+
+            int cell = aMatrix.Index( nr, nc, ns );
+
+            if( aMatrix.m_Blocked[cell] )
+                continue;
+
+            int newdist = d + cost;
+
+            if( !aMatrix.m_Visited[cell] )
+            {
+                aMatrix.m_Visited[cell] = 1;
+                aMatrix.m_Dist[cell] = newdist;
+                aQueue.Set( nr, nc, ns, newdist, MATRIX::ApxDist( nr, nc, r2, c2 ), r2, c2 );
+                aStats.m_Open++;
+            }
+            else if( newdist < aMatrix.m_Dist[cell] )
+            {
+                aMatrix.m_Dist[cell] = newdist;
+
+                if( aQueue.Reset( nr, nc, ns, newdist,
+                                  MATRIX::ApxDist( nr, nc, r2, c2 ), r2, c2 ) )
+                {
+                    aStats.m_Moved++;
+                }
+                else
+                {
+                    aStats.m_Closed--;
+                    aStats.m_Open++;
+                }
+            }
+
+            if( aQueue.GetCount() > aStats.m_Max )
+                aStats.m_Max = aQueue.GetCount();
+        }
+    }
+
+    return -1;
+}
+
+
+static double elapsedMs( clock_t aStart )
+{
+    return 1000.0 * ( clock() - aStart ) / CLOCKS_PER_SEC;
+}
+
+
+static int runTest( int aSize, int aRouteCount )
+{
+    MATRIX      matrix( aSize, aSize, 25 );
+    LIST_QUEUE  listQueue;
+    HEAP_QUEUE  heapQueue( aSize, aSize );
+    double      listTime = 0;
+    double      heapTime = 0;
+    int         mismatches = 0;
+    long long   listLength = 0;
+    long long   heapLength = 0;
+    long long   closed = 0;
+    int         maxNodes = 0;
+
+    for( int ii = 0; ii < aRouteCount; ii++ )
+    {
+        int r1 = rand() % aSize, c1 = rand() % aSize;
+        int r2 = rand() % aSize, c2 = rand() % aSize;
+
+        STATS listStats, heapStats;
+
+        clock_t start = clock();
+        int listDist = route( matrix, listQueue, r1, c1, r2, c2, listStats );
+        listTime += elapsedMs( start );
+
+        start = clock();
+        int heapDist = route( matrix, heapQueue, r1, c1, r2, c2, heapStats );
+        heapTime += elapsedMs( start );
+
+        if( ( listDist < 0 ) != ( heapDist < 0 ) )
+            mismatches++;
+
+        if( listDist > 0 && heapDist > 0 )
+        {
+            listLength += listDist;
+            heapLength += heapDist;
+        }
+
+        closed += heapStats.m_Closed;
+
+        if( heapStats.m_Max > maxNodes )
+            maxNodes = heapStats.m_Max;
+    }
+
+    printf( "%4dx%-4d 2 sides, %d routes: list %9.1f ms  heap %7.1f ms  "
+            "(%lld nodes closed, max queue %d)  length %+.1f%%  %s\n",
+            aSize, aSize, aRouteCount, listTime, heapTime, closed, maxNodes,
+            100.0 * ( heapLength - listLength ) / std::max( listLength, 1LL ),
+            mismatches ? "ROUTED NETS DIFFER" : "same routed nets" );
+
+    return mismatches;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = runTest( 100, 50 );
+
+    errors += runTest( 300, 20 );
+    errors += runTest( 600, 10 );
+
+    return errors ? 1 : 0;
+}
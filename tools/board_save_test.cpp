@@ -0,0 +1,239 @@
+/*
+    A test program for the board file output: the numbers formatted by FMT_IU
+    and FMT_ANGLE, which no longer use sprintf() nor a std::string, must be the
+    same text as the former BOARD_ITEM::FormatInternalUnits() and FormatAngle().
+    Then a synthetic board of 100k and 1M track segments is written by PCB_IO,
+    and each segment must be the same text as a segment written with the former
+    formatting.  The time of PCB_IO::Save() is compared with the former way of
+    writing the same segments: a std::string per number, and vsnprintf() and
+    fwrite() for every Print().
+*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <math.h>
+
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <kicad_plugin.h>
+
+
+/// the former BOARD_ITEM::FormatInternalUnits()
+static std::string formerFormatIU( int aValue )
+{
+    char buf[50];
+
+    double  mm = aValue / IU_PER_MM;
+    int     len;
+
+    if( mm != 0.0 && fabs( mm ) <= 0.0001 )
+    {
+        len = sprintf( buf, "%.10f", mm );
+
+        while( --len > 0 && buf[len] == '0' )
+            buf[len] = '\0';
+
+        ++len;
+    }
+    else
+    {
+        len = sprintf( buf, "%.10g", mm );
+    }
+
+    return std::string( buf, len );
+}
+
+
+/// the former BOARD_ITEM::FormatAngle()
+static std::string formerFormatAngle( double aAngle )
+{
+    char temp[50];
+
+    int len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
+
+    return std::string( temp, len );
+}
+
+
+/// the former OUTPUTFORMATTER::Print() to a FILE_OUTPUTFORMATTER
+static void formerPrint( FILE* aFile, int aNestLevel, const char* aFmt, ... )
+{
+    char        buf[500];
+    va_list     args;
+
+    for( int i = 0;  i < aNestLevel;  ++i )
+    {
+        int len = snprintf( buf, sizeof(buf), "%*c", 2, ' ' );
+        fwrite( buf, len, 1, aFile );
+    }
+
+    va_start( args, aFmt );
+    int len = vsnprintf( buf, sizeof(buf), aFmt, args );
+    va_end( args );
+
+    fwrite( buf, len, 1, aFile );
+}
+
+
+static std::string formerSegment( TRACK* aTrack )
+{
+    char buf[500];
+
+    snprintf( buf, sizeof(buf), "  (segment (start %s %s) (end %s %s) (width %s) (layer %s) (net %d))\n",
+              formerFormatIU( aTrack->GetStart().x ).c_str(),
+              formerFormatIU( aTrack->GetStart().y ).c_str(),
+              formerFormatIU( aTrack->GetEnd().x ).c_str(),
+              formerFormatIU( aTrack->GetEnd().y ).c_str(),
+              formerFormatIU( aTrack->GetWidth() ).c_str(),
+              TO_UTF8( aTrack->GetLayerName() ),
+              aTrack->GetNet() );
+
+    return buf;
+}
+
+
+static int checkNumber( int aValue )
+{
+    std::string former = formerFormatIU( aValue );
+
+    if( former == FMT_IU( aValue ).c_str() )
+        return 0;
+
+    printf( "FMT_IU( %d ): '%s' instead of '%s'\n", aValue, FMT_IU( aValue ).c_str(),
+            former.c_str() );
+    return 1;
+}
+
+
+static int checkAngle( double aAngle )
+{
+    std::string former = formerFormatAngle( aAngle );
+
+    if( former == FMT_ANGLE( aAngle ).c_str() )
+        return 0;
+
+    printf( "FMT_ANGLE( %g ): '%s' instead of '%s'\n", aAngle, FMT_ANGLE( aAngle ).c_str(),
+            former.c_str() );
+    return 1;
+}
+
+
+static int checkNumbers()
+{
+    int errors = 0;
+
+    for( int value = -2000000;  value <= 2000000 && errors < 10;  ++value )
+        errors += checkNumber( value );
+
+    errors += checkNumber( INT_MAX ) + checkNumber( INT_MIN ) + checkNumber( INT_MIN + 1 );
+
+    for( int i = 0;  i < 10000000 && errors < 10;  ++i )
+        errors += checkNumber( (int) ( ( (unsigned) rand() << 16 ) ^ rand() ) );
+
+    for( int angle = -36000;  angle <= 36000 && errors < 10;  ++angle )
+        errors += checkAngle( angle );
+
+    errors += checkAngle( 0.0 ) + checkAngle( -0.0 ) + checkAngle( 0.5 ) + checkAngle( 1e12 );
+
+    printf( "numbers: %s\n", errors ? "DIFFERENT" : "identical" );
+    return errors;
+}
+
+
+static void fillBoard( BOARD* aBoard, int aCount )
+{
+    for( int i = 0;  i < aCount;  ++i )
+    {
+        TRACK* track = new TRACK( aBoard );
+
+        // any nanometer, not only the grid ones
+        wxPoint start( rand() % Millimeter2iu( 300 ), rand() % Millimeter2iu( 200 ) );
+
+        track->SetStart( start );
+        track->SetEnd( start + wxPoint( rand() % Millimeter2iu( 10 ), rand() % 1000 ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( i % 2 ? LAYER_N_FRONT : LAYER_N_BACK );
+        track->SetNet( i % 1000 );
+
+        aBoard->m_Track.PushBack( track );
+    }
+}
+
+
+static int runTest( int aCount )
+{
+    BOARD   board;
+    PCB_IO  io;
+    int     errors = 0;
+
+    fillBoard( &board, aCount );
+
+    for( TRACK* track = board.m_Track;  track && errors < 10;  track = track->Next() )
+    {
+        io.Format( track, 1 );
+
+        std::string segment = io.GetStringOutput( true );
+        std::string former  = formerSegment( track );
+
+        if( segment != former )
+        {
+            printf( "segment\n%sinstead of\n%s", segment.c_str(), former.c_str() );
+            errors++;
+        }
+    }
+
+    wxString    fileName = wxFileName::CreateTempFileName( wxT( "board_save_test" ) );
+    unsigned    start = GetRunningMicroSecs();
+
+    io.Save( fileName, &board );
+
+    unsigned    saveTime = GetRunningMicroSecs() - start;
+
+    start = GetRunningMicroSecs();
+
+    FILE* file = wxFopen( fileName, wxT( "wt" ) );
+
+    for( TRACK* track = board.m_Track;  track;  track = track->Next() )
+    {
+        formerPrint( file, 1, "(segment (start %s %s) (end %s %s) (width %s)",
+                     formerFormatIU( track->GetStart().x ).c_str(),
+                     formerFormatIU( track->GetStart().y ).c_str(),
+                     formerFormatIU( track->GetEnd().x ).c_str(),
+                     formerFormatIU( track->GetEnd().y ).c_str(),
+                     formerFormatIU( track->GetWidth() ).c_str() );
+        formerPrint( file, 0, " (layer %s)", TO_UTF8( track->GetLayerName() ) );
+        formerPrint( file, 0, " (net %d)", track->GetNet() );
+        formerPrint( file, 0, ")\n" );
+    }
+
+    fclose( file );
+
+    unsigned    formerTime = GetRunningMicroSecs() - start;
+
+    wxRemoveFile( fileName );
+
+    printf( "%8d segments: PCB_IO::Save() %u usecs, former segment output %u usecs, %s\n",
+            aCount, saveTime, formerTime, errors ? "DIFFERENT" : "same text" );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = checkNumbers();
+
+    errors += runTest( 100000 );
+    errors += runTest( 1000000 );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+/*
+    A benchmark of the keyword lookup of DSNLEXER::findToken() over large
+    .kicad_pcb files: all the tokens of a file are read by a PCB_LEXER, first
+    finding the keywords with the perfect hash generated by
+    TokenList2DsnLexer.cmake, then with the bsearch() of the keyword table the
+    lexer used before.  Both must give the same tokens.
+
+    The file is the one given on the command line, else synthetic boards of
+    100k and 1M track segments written by PCB_IO.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <kicad_plugin.h>
+#include <pcb_lexer.h>
+
+
+/// a PCB_LEXER which finds its keywords by their hash, or by bsearch()
+class BENCH_LEXER : public PCB_LEXER
+{
+public:
+    BENCH_LEXER( LINE_READER* aReader, bool aUseHash ) :
+        PCB_LEXER( aReader )
+    {
+        if( !aUseHash )
+            keywordHash = NULL;
+    }
+};
+
+
+/**
+ * Function lexFile
+ * reads all the tokens of @a aFileName, @a aPassCount times.
+ * @return double - the milliseconds of a pass.
+ */
+static double lexFile( const wxString& aFileName, bool aUseHash, int aPassCount,
+                       std::vector<int>& aTokens )
+{
+    unsigned start = GetRunningMicroSecs();
+
+    for( int pass = 0;  pass < aPassCount;  ++pass )
+    {
+        MMAP_LINE_READER    reader( aFileName );
+        BENCH_LEXER         lexer( &reader, aUseHash );
+        int                 token;
+
+        aTokens.clear();
+
+        while( ( token = lexer.NextTok() ) != DSN_EOF )
+            aTokens.push_back( token );
+    }
+
+    return ( GetRunningMicroSecs() - start ) / 1000.0 / aPassCount;
+}
+
+
+/// @return int - 1 if the tokens found by the hash and by bsearch() differ, else 0
+static int benchFile( const wxString& aFileName, const char* aName )
+{
+    static const int passCount = 5;
+
+    std::vector<int> hashTokens;
+    std::vector<int> searchTokens;
+    int              keywords = 0;
+
+    try
+    {
+        double hashTime   = lexFile( aFileName, true, passCount, hashTokens );
+        double searchTime = lexFile( aFileName, false, passCount, searchTokens );
+
+        for( unsigned ii = 0;  ii < hashTokens.size();  ++ii )
+        {
+            if( hashTokens[ii] >= 0 )
+                ++keywords;
+        }
+
+        bool same = hashTokens == searchTokens;
+
+        printf( "%s: %u tokens, %d keywords: hash %.1f ms  bsearch %.1f ms  %s\n",
+                aName, (unsigned) hashTokens.size(), keywords, hashTime, searchTime,
+                same ? "same tokens" : "TOKENS DIFFER" );
+
+        return same ? 0 : 1;
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "%s: %s\n", aName, TO_UTF8( ioe.errorText ) );
+        return 1;
+    }
+}
+
+
+static void fillBoard( BOARD* aBoard, int aCount )
+{
+    for( int i = 0;  i < aCount;  ++i )
+    {
+        TRACK* track = new TRACK( aBoard );
+
+        // any nanometer, not only the grid ones
+        wxPoint start( rand() % Millimeter2iu( 300 ), rand() % Millimeter2iu( 200 ) );
+
+        track->SetStart( start );
+        track->SetEnd( start + wxPoint( rand() % Millimeter2iu( 10 ), rand() % 1000 ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( i % 2 ? LAYER_N_FRONT : LAYER_N_BACK );
+        track->SetNet( i % 1000 );
+
+        aBoard->m_Track.PushBack( track );
+    }
+}
+
+
+static int runTest( int aCount )
+{
+    BOARD   board;
+    PCB_IO  io;
+    char    name[50];
+
+    fillBoard( &board, aCount );
+
+    wxString fileName = wxFileName::CreateTempFileName( wxT( "dsnlexer_bench" ) );
+
+    io.Save( fileName, &board );
+
+    sprintf( name, "%d segments", aCount );
+
+    int errors = benchFile( fileName, name );
+
+    wxRemoveFile( fileName );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    if( argc > 1 )
+        return benchFile( FROM_UTF8( argv[1] ), argv[1] );
+
+    srand( 1 );
+
+    int errors = runTest( 100000 );
+
+    errors += runTest( 1000000 );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+/*
+    A test program for the memory limit of FOOTPRINT_LIB_CACHES when the
+    caches load their footprints lazily, as FPL_CACHE and FP_CACHE do: a
+    cache is added with the size of its footprint list only, and grows as its
+    footprints are loaded, telling it with UpdateSize().  The least recently
+    used caches must be deleted as soon as the caches are over their maximum
+    size, the cache loading a footprint never.
+*/
+
+#include <stdio.h>
+
+#include <footprint_lib_caches.h>
+
+
+/// a library cache of which the footprints are loaded one by one
+class TEST_CACHE
+{
+public:
+    TEST_CACHE( size_t aSize ) :
+        m_size( aSize )
+    {
+        s_count++;
+    }
+
+    ~TEST_CACHE()
+    {
+        s_count--;
+    }
+
+    bool IsModified()           { return false; }
+
+    size_t GetMemorySize()      { return m_size; }
+
+    /// loads a footprint of @a aSize bytes, as FPL_CACHE::GetModule() does
+    void LoadFootprint( FOOTPRINT_LIB_CACHES<TEST_CACHE>& aCaches, size_t aSize )
+    {
+        m_size += aSize;
+        aCaches.UpdateSize( this, aSize );
+    }
+
+    static int  s_count;        ///< the count of the caches not deleted
+
+private:
+    size_t      m_size;
+};
+
+
+int TEST_CACHE::s_count = 0;
+
+
+static wxString libraryPath( int aIndex )
+{
+    return wxString::Format( wxT( "/lib/footprints%d.mod" ), aIndex );
+}
+
+
+/// @return int - 1 if the caches do not hold @a aCount caches of @a aSize bytes, else 0
+static int checkCaches( FOOTPRINT_LIB_CACHES<TEST_CACHE>& aCaches, unsigned aCount,
+                        size_t aSize, const char* aName )
+{
+    bool same = aCaches.GetCount() == aCount && TEST_CACHE::s_count == (int) aCount
+                && aCaches.GetMemorySize() == aSize;
+
+    printf( "%s: %u caches of %u bytes, %d not deleted  %s\n", aName,
+            aCaches.GetCount(), (unsigned) aCaches.GetMemorySize(), TEST_CACHE::s_count,
+            same ? "expected caches" : "CACHES DIFFER" );
+
+    return same ? 0 : 1;
+}
+
+
+int main( int argc, char** argv )
+{
+    FOOTPRINT_LIB_CACHES<TEST_CACHE> caches( 1000 );
+    int errors = 0;
+
+    // 10 footprint lists of 100 bytes, the library 0 the least recently used
+    for( int ii = 0;  ii < 10;  ++ii )
+        caches.Add( libraryPath( ii ), new TEST_CACHE( 100 ) );
+
+    errors += checkCaches( caches, 10, 1000, "10 libraries enumerated" );
+
+    // 5 footprints of 60 bytes loaded from the library 0, now the most recently
+    // used one: the libraries 1, 2 and 3 are deleted.
+    TEST_CACHE* cache = caches.Find( libraryPath( 0 ) );
+
+    for( int ii = 0;  ii < 5;  ++ii )
+        cache->LoadFootprint( caches, 60 );
+
+    errors += checkCaches( caches, 7, 1000, "5 footprints loaded" );
+
+    for( int ii = 1;  ii < 10;  ++ii )
+    {
+        if( ( caches.Find( libraryPath( ii ) ) != NULL ) != ( ii > 3 ) )
+        {
+            printf( "library %d %s\n", ii, ii > 3 ? "DELETED" : "KEPT" );
+            errors++;
+        }
+    }
+
+    // a footprint larger than the caches: the library loading it is kept alone
+    cache = caches.Find( libraryPath( 0 ) );
+    cache->LoadFootprint( caches, 2000 );
+
+    errors += checkCaches( caches, 1, 2400, "a footprint of 2000 bytes loaded" );
+
+    if( caches.Find( libraryPath( 0 ) ) != cache )
+    {
+        printf( "library 0 DELETED\n" );
+        errors++;
+    }
+
+    caches.Clear();
+
+    errors += checkCaches( caches, 0, 0, "caches cleared" );
+
+    return errors ? 1 : 0;
+}
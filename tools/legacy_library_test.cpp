@@ -0,0 +1,194 @@
+/*
+    A test program for the footprint library cache of LEGACY_PLUGIN: the same
+    legacy library of footprints, with comments between the footprints and
+    pads at known positions, is written with LF line endings, then with CRLF
+    line endings.  Every footprint of both files is enumerated and loaded
+    through the offsets of the cache, and must be the footprint written: its
+    name, description and pads, the same from both files.
+*/
+
+#include <stdio.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <legacy_plugin.h>
+
+
+/// @return std::string - a library of @a aCount footprints, of lines ended by @a aEnd
+static std::string makeLibrary( int aCount, const char* aEnd )
+{
+    std::string library;
+    char        buf[200];
+
+    library += std::string( "PCBNEW-LibModule-V1  2012-10-20 12:13:07" ) + aEnd;
+    library += std::string( "# encoding utf-8" ) + aEnd;
+    library += std::string( "Units deci-mils" ) + aEnd;
+    library += std::string( "$INDEX" ) + aEnd;
+
+    for( int ii = 0;  ii < aCount;  ++ii )
+    {
+        sprintf( buf, "FP%d", ii );
+        library += buf + std::string( aEnd );
+    }
+
+    library += std::string( "$EndINDEX" ) + aEnd;
+
+    for( int ii = 0;  ii < aCount;  ++ii )
+    {
+        static const char* const body[] =
+        {
+            "#",
+            "# FP%d",
+            "#",
+            "$MODULE FP%d",
+            "Po 0 0 0 15 50827920 00000000 ~~",
+            "Li FP%d",
+            "Cd Footprint %d of the test library",
+            "Kw CONN",
+            "Sc 0",
+            "Op 0 0 0",
+            "T0 0 -800 249 249 0 62 N V 21 N \"FP%d\"",
+            "T1 0 800 249 249 0 62 N I 21 N \"VAL**\"",
+        };
+
+        for( unsigned jj = 0;  jj < sizeof( body ) / sizeof( body[0] );  ++jj )
+        {
+            sprintf( buf, body[jj], ii );
+            library += buf + std::string( aEnd );
+        }
+
+        // ii % 7 + 1 pads, at x = 1000 * the pad number
+        for( int pad = 1;  pad <= ii % 7 + 1;  ++pad )
+        {
+            sprintf( buf, "$PAD%sSh \"%d\" C 600 600 0 0 0%sDr 400 0 0%s"
+                     "At STD N 00E0FFFF%sNe 0 \"\"%sPo %d 0%s$EndPAD%s",
+                     aEnd, pad, aEnd, aEnd, aEnd, aEnd, pad * 1000, aEnd, aEnd );
+            library += buf;
+        }
+
+        sprintf( buf, "$EndMODULE  FP%d", ii );
+        library += buf + std::string( aEnd );
+    }
+
+    library += std::string( "$EndLIBRARY" ) + aEnd;
+
+    return library;
+}
+
+
+/// @return int - the number of differences of @a aModule from the footprint @a aIndex
+static int checkModule( MODULE* aModule, int aIndex, const char* aName )
+{
+    wxString    name = wxString::Format( wxT( "FP%d" ), aIndex );
+    wxString    description = wxString::Format( wxT( "Footprint %d of the test library" ),
+                                                aIndex );
+    int         errors = 0;
+
+    if( !aModule )
+    {
+        printf( "%s: footprint %d not loaded\n", aName, aIndex );
+        return 1;
+    }
+
+    if( aModule->GetLibRef() != name || aModule->GetDescription() != description
+        || aModule->Reference().GetText() != name
+        || aModule->GetPadCount() != unsigned( aIndex % 7 + 1 ) )
+    {
+        printf( "%s: footprint %d is '%s' '%s' '%s' with %u pads\n", aName, aIndex,
+                TO_UTF8( aModule->GetLibRef() ), TO_UTF8( aModule->GetDescription() ),
+                TO_UTF8( aModule->Reference().GetText() ), aModule->GetPadCount() );
+        errors++;
+    }
+
+    int pitch = aModule->m_Pads ? aModule->m_Pads->GetPosition().x : 0;
+    int number = 1;
+
+    for( D_PAD* pad = aModule->m_Pads;  pad;  pad = pad->Next(), ++number )
+    {
+        if( pitch <= 0 || pad->GetPadName() != wxString::Format( wxT( "%d" ), number )
+            || pad->GetPosition() != wxPoint( number * pitch, 0 ) )
+        {
+            printf( "%s: footprint %d pad '%s' at %d,%d\n", aName, aIndex,
+                    TO_UTF8( pad->GetPadName() ), pad->GetPosition().x, pad->GetPosition().y );
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+/// @return int - the number of errors loading the library @a aLibrary of @a aCount footprints
+static int loadLibrary( const std::string& aLibrary, int aCount, const char* aName )
+{
+    wxString    fileName = wxFileName::CreateTempFileName( wxT( "legacy_library_test" ) );
+    wxString    libPath = fileName + wxT( ".mod" );
+    FILE*       file = wxFopen( libPath, wxT( "wb" ) );
+
+    fwrite( aLibrary.data(), 1, aLibrary.size(), file );
+    fclose( file );
+
+    int errors = 0;
+
+    try
+    {
+        LEGACY_PLUGIN   plugin;
+        unsigned        start = GetRunningMicroSecs();
+        wxArrayString   names = plugin.FootprintEnumerate( libPath );
+
+        if( names.GetCount() != unsigned( aCount ) )
+        {
+            printf( "%s: %u footprints instead of %d\n", aName, (unsigned) names.GetCount(),
+                    aCount );
+            errors++;
+        }
+
+        for( int ii = 0;  ii < aCount && errors < 10;  ++ii )
+        {
+            std::auto_ptr<MODULE> module( plugin.FootprintLoad( libPath,
+                                        wxString::Format( wxT( "FP%d" ), ii ) ) );
+
+            errors += checkModule( module.get(), ii, aName );
+        }
+
+        printf( "%6d footprints, %s: %u usecs  %s\n", aCount, aName,
+                GetRunningMicroSecs() - start,
+                errors ? "FOOTPRINTS DIFFER" : "same footprints" );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "%s: %s\n", aName, TO_UTF8( ioe.errorText ) );
+        errors++;
+    }
+
+    wxRemoveFile( libPath );
+    wxRemoveFile( fileName );
+
+    return errors;
+}
+
+
+static int runTest( int aCount )
+{
+    return loadLibrary( makeLibrary( aCount, "\n" ), aCount, "LF" )
+         + loadLibrary( makeLibrary( aCount, "\r\n" ), aCount, "CRLF" );
+}
+
+
+int main( int argc, char** argv )
+{
+    int errors = runTest( 1 );
+
+    errors += runTest( 100 );
+    errors += runTest( 10000 );
+
+    return errors ? 1 : 0;
+}
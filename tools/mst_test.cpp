@@ -0,0 +1,109 @@
+/*
+    A test program which compares the two ways MIN_SPAN_TREE builds the
+    rectilinear minimum spanning tree of a net: the Prim's algorithm on all
+    the links, and the Kruskal's algorithm on the links between octant
+    nearest neighbours.  The nets are random pads on a 100 mm square, on a
+    0.1 mm grid so that there are equal distances and coincident pads.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include <minimun_spanning_tree.h>
+
+
+class MST_POINTS : public MIN_SPAN_TREE
+{
+public:
+    std::vector<int>    m_X;
+    std::vector<int>    m_Y;
+    bool                m_Sparse;
+
+    MST_POINTS( bool aSparse ) : m_Sparse( aSparse ) {}
+
+    int GetWeight( int aItem1, int aItem2 )
+    {
+        if( aItem1 == aItem2 )
+            return 0;
+
+        return abs( m_X[aItem1] - m_X[aItem2] ) + abs( m_Y[aItem1] - m_Y[aItem2] ) + 1;
+    }
+
+    bool GetPosition( int aItem, int& aX, int& aY )
+    {
+        aX = m_X[aItem];
+        aY = m_Y[aItem];
+        return m_Sparse;
+    }
+
+    long long TotalLength()
+    {
+        long long length = 0;
+
+        for( int ii = 1; ii < m_Size; ii++ )
+            length += GetDist( ii );
+
+        return length;
+    }
+};
+
+
+static double elapsedMs( clock_t aStart )
+{
+    return 1000.0 * ( clock() - aStart ) / CLOCKS_PER_SEC;
+}
+
+
+static int runTest( int aPadCount )
+{
+    MST_POINTS dense( false );
+    MST_POINTS sparse( true );
+
+    for( int ii = 0; ii < aPadCount; ii++ )
+    {
+        // 0.1 mm grid, in nanometers
+        int x = ( rand() % 1000 ) * 100000;
+        int y = ( rand() % 1000 ) * 100000;
+
+        dense.m_X.push_back( x );
+        dense.m_Y.push_back( y );
+    }
+
+    sparse.m_X = dense.m_X;
+    sparse.m_Y = dense.m_Y;
+
+    clock_t start = clock();
+    dense.MSP_Init( aPadCount );
+    dense.BuildTree();
+    double denseTime = elapsedMs( start );
+
+    start = clock();
+    sparse.MSP_Init( aPadCount );
+    sparse.BuildTree();
+    double sparseTime = elapsedMs( start );
+
+    bool same = dense.TotalLength() == sparse.TotalLength();
+
+    printf( "%6d pads: Prim %8.1f ms  octant Kruskal %6.1f ms  length %s\n",
+            aPadCount, denseTime, sparseTime, same ? "identical" : "DIFFERENT" );
+
+    return same ? 0 : 1;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = runTest( 50 );
+
+    errors += runTest( 300 );
+    errors += runTest( 3000 );
+    errors += runTest( 10000 );
+    errors += runTest( 20000 );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+/*
+    The part of wxWidgets the net list builder uses, for netlist_test: without
+    an application, a wxBusyCursor or a wxMessageBox cannot be made.
+*/
+
+#ifndef NETLIST_TEST_FCTSYS_H_
+#define NETLIST_TEST_FCTSYS_H_
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define wxT( x )    x
+#define _( x )      x
+
+#define wxNOT_FOUND ( -1 )
+
+
+struct wxPoint
+{
+    int x, y;
+
+    wxPoint( int aX = 0, int aY = 0 ) : x( aX ), y( aY ) {}
+
+    bool operator==( const wxPoint& aOther ) const { return x == aOther.x && y == aOther.y; }
+    bool operator!=( const wxPoint& aOther ) const { return !( *this == aOther ); }
+
+    wxPoint operator-( const wxPoint& aOther ) const
+    {
+        return wxPoint( x - aOther.x, y - aOther.y );
+    }
+};
+
+
+struct wxString : public std::string
+{
+    wxString() {}
+    wxString( const char* aText ) : std::string( aText ) {}
+    wxString( const std::string& aText ) : std::string( aText ) {}
+
+    int Cmp( const wxString& aOther ) const
+    {
+        int result = compare( aOther );
+
+        return result < 0 ? -1 : result > 0;
+    }
+
+    int CmpNoCase( const wxString& aOther ) const
+    {
+        size_t len = std::min( size(), aOther.size() );
+
+        for( size_t ii = 0; ii < len; ii++ )
+        {
+            int a = tolower( (unsigned char) (*this)[ii] );
+            int b = tolower( (unsigned char) aOther[ii] );
+
+            if( a != b )
+                return a < b ? -1 : 1;
+        }
+
+        return size() < aOther.size() ? -1 : size() > aOther.size();
+    }
+
+    int Find( char aChar ) const
+    {
+        size_t pos = find( aChar );
+
+        return pos == npos ? wxNOT_FOUND : (int) pos;
+    }
+
+    size_t Length() const { return size(); }
+
+    wxString& operator<<( const char* aText ) { append( aText ); return *this; }
+    wxString& operator<<( size_t ) { return *this; }
+};
+
+
+struct wxBusyCursor
+{
+    wxBusyCursor() {}
+};
+
+inline void wxMessageBox( const char* aMessage ) {}
+
+#endif  // NETLIST_TEST_FCTSYS_H_
@@ -0,0 +1,184 @@
+/*
+    The schematic items the net list builder uses, for netlist_test: a sheet
+    path is a sheet number, with the depth and the time stamp Cmp() sorts
+    the sheets by, and the items of the screen of a sheet give a copy of
+    their NETLIST_OBJECT to the net list.
+*/
+
+#ifndef NETLIST_TEST_GENERAL_H_
+#define NETLIST_TEST_GENERAL_H_
+
+#include <fctsys.h>
+
+
+class SCH_ITEM;
+
+
+struct SCH_SCREEN
+{
+    SCH_ITEM*   m_Items;
+
+    SCH_SCREEN() : m_Items( NULL ) {}
+
+    SCH_ITEM* GetDrawItems() const { return m_Items; }
+};
+
+
+struct SCH_SHEET_PATH
+{
+    int         m_Number;
+    int         m_TimeStamp;
+    int         m_Depth;
+    SCH_SCREEN* m_Screen;
+
+    SCH_SHEET_PATH( int aNumber = 0, int aTimeStamp = 0, int aDepth = 1 ) :
+        m_Number( aNumber ), m_TimeStamp( aTimeStamp ), m_Depth( aDepth ), m_Screen( NULL )
+    {
+    }
+
+    int Cmp( const SCH_SHEET_PATH& aOther ) const
+    {
+        if( m_Depth != aOther.m_Depth )
+            return m_Depth > aOther.m_Depth ? 1 : -1;
+
+        if( m_TimeStamp != aOther.m_TimeStamp )
+            return m_TimeStamp > aOther.m_TimeStamp ? 1 : -1;
+
+        return 0;
+    }
+
+    bool operator==( const SCH_SHEET_PATH& aOther ) const { return m_Number == aOther.m_Number; }
+    bool operator!=( const SCH_SHEET_PATH& aOther ) const { return m_Number != aOther.m_Number; }
+
+    wxString Path() const { return std::string( 9 * m_Depth, 'x' ); }
+
+    wxString PathHumanReadable() const
+    {
+        char buf[32];
+
+        sprintf( buf, "/sheet%d/", m_Number );
+        return buf;
+    }
+
+    SCH_SCREEN* LastScreen() { return m_Screen; }
+};
+
+
+/// The sheets of the schematic the test builds the net list of.
+extern std::vector<SCH_SHEET_PATH> g_TestSheets;
+
+
+struct SCH_SHEET_LIST
+{
+    unsigned m_Index;
+
+    SCH_SHEET_LIST() : m_Index( 0 ) {}
+
+    SCH_SHEET_PATH* GetFirst()
+    {
+        m_Index = 0;
+        return GetNext();
+    }
+
+    SCH_SHEET_PATH* GetNext()
+    {
+        return m_Index < g_TestSheets.size() ? &g_TestSheets[m_Index++] : NULL;
+    }
+};
+
+
+enum NETLIST_ITEM_T {
+    NET_ITEM_UNSPECIFIED,
+    NET_SEGMENT,
+    NET_BUS,
+    NET_JUNCTION,
+    NET_LABEL,
+    NET_GLOBLABEL,
+    NET_HIERLABEL,
+    NET_SHEETLABEL,
+    NET_BUSLABELMEMBER,
+    NET_GLOBBUSLABELMEMBER,
+    NET_HIERBUSLABELMEMBER,
+    NET_SHEETBUSLABELMEMBER,
+    NET_PINLABEL,
+    NET_PIN,
+    NET_NOCONNECT
+};
+
+
+enum NET_CONNECTION_T {
+    UNCONNECTED = 0,
+    NOCONNECT_SYMBOL_PRESENT,
+    PAD_CONNECT
+};
+
+
+#define ISBUS 1
+
+
+struct NETLIST_OBJECT
+{
+    int                 m_TestId;   ///< the number of the item in the test schematic
+    NETLIST_ITEM_T      m_Type;
+    SCH_SHEET_PATH      m_SheetList;
+    int                 m_NetCode;
+    int                 m_BusNetCode;
+    int                 m_Member;
+    NET_CONNECTION_T    m_FlagOfConnection;
+    SCH_SHEET_PATH      m_SheetListInclude;
+    wxString            m_Label;
+    wxPoint             m_Start;
+    wxPoint             m_End;
+    NETLIST_OBJECT*     m_NetNameCandidate;
+
+    void SetNet( int aNetCode ) { m_NetCode = aNetCode; }
+    int GetNet() const { return m_NetCode; }
+
+    void Show( std::ostream& out, int ndx ) const {}
+};
+
+
+typedef std::vector<NETLIST_OBJECT*> NETLIST_OBJECT_LIST;
+
+extern NETLIST_OBJECT_LIST g_NetObjectslist;
+
+
+class SCH_ITEM
+{
+public:
+    NETLIST_OBJECT  m_Object;   ///< the item given to the net list, but its sheet
+    SCH_ITEM*       m_Next;
+
+    SCH_ITEM* Next() const { return m_Next; }
+
+    void GetNetListItem( NETLIST_OBJECT_LIST& aNetListItems, SCH_SHEET_PATH* aSheetPath )
+    {
+        NETLIST_OBJECT* item = new NETLIST_OBJECT( m_Object );
+
+        item->m_SheetList = *aSheetPath;
+        aNetListItems.push_back( item );
+    }
+};
+
+
+class SCH_TEXT : public SCH_ITEM
+{
+public:
+    wxString GetText() const { return m_Object.m_Label; }
+};
+
+
+class BOM_LABEL
+{
+    SCH_ITEM*   m_label;
+
+    static const SCH_SHEET_PATH emptySheetPath;
+
+public:
+    wxString GetText() const;
+};
+
+
+bool SegmentIntersect( wxPoint aSegStart, wxPoint aSegEnd, wxPoint aTestPoint );
+
+#endif  // NETLIST_TEST_GENERAL_H_
@@ -0,0 +1,3 @@
+/* The schematic items of netlist_test are all in general.h. */
+
+#include <general.h>
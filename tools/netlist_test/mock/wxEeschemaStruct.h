@@ -0,0 +1,19 @@
+/*
+    The schematic editor frame, for netlist_test.
+*/
+
+#ifndef NETLIST_TEST_WXEESCHEMASTRUCT_H_
+#define NETLIST_TEST_WXEESCHEMASTRUCT_H_
+
+#include <general.h>
+
+
+class SCH_EDIT_FRAME
+{
+public:
+    void BuildNetListBase();
+
+    void SetStatusText( const wxString& aText ) {}
+};
+
+#endif  // NETLIST_TEST_WXEESCHEMASTRUCT_H_
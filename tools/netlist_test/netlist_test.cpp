@@ -0,0 +1,221 @@
+/*
+    A test program for the net list builder of eeschema/netlist.cpp, which
+    connects the items with a disjoint-set forest of net codes and position
+    indexes: random schematics of wires, buses, junctions, pins, labels,
+    sheet labels and bus members, on a few sheets and a small grid so that
+    most items are connected, are built by SCH_EDIT_FRAME::BuildNetListBase()
+    and by the former builder of former_netlist.cpp, which rescanned the
+    item list at each connection.  The items must be in the same order, with
+    the same net codes, bus net codes, connection flags and net names.
+
+    netlist.cpp is built as it is, with the schematic items and the part of
+    wxWidgets it uses replaced by the ones of mock/.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+#include <wxEeschemaStruct.h>
+
+
+std::vector<SCH_SHEET_PATH> g_TestSheets;
+
+namespace FORMER
+{
+    extern NETLIST_OBJECT_LIST g_NetObjectslist;
+    void BuildNetListBase();
+}
+
+
+static double elapsedMs( clock_t aStart )
+{
+    return 1000.0 * ( clock() - aStart ) / CLOCKS_PER_SEC;
+}
+
+
+/**
+ * Function makeSchematic
+ * fills @a aItems with @a aCount random items, on 1 to 5 sheets of which some sort
+ * the same, and links them to the screens @a aScreens of the sheets of g_TestSheets.
+ */
+static void makeSchematic( int aCount, std::vector<SCH_SCREEN>& aScreens,
+                           std::vector<SCH_ITEM>& aItems )
+{
+    static const char* const names[] =
+    {
+        "a", "A", "b", "B", "vcc", "VCC", "d0", "gnd", "GND", "x"
+    };
+
+    int sheetCount = 1 + rand() % 5;
+    int grid = 3 + rand() % 8 + aCount / 100;
+
+    g_TestSheets.clear();
+    aScreens.assign( sheetCount, SCH_SCREEN() );
+
+    for( int ii = 0; ii < sheetCount; ii++ )
+    {
+        // a sheet may have the time stamp and the depth of the previous one
+        bool same = ii > 0 && rand() % 4 == 0;
+        int  timeStamp = same ? g_TestSheets[ii - 1].m_TimeStamp : 100 + rand() % 50;
+
+        same = ii > 0 && rand() % 4 == 0;
+        int  depth = same ? g_TestSheets[ii - 1].m_Depth : 1 + rand() % 3;
+
+        g_TestSheets.push_back( SCH_SHEET_PATH( ii + 1, timeStamp, depth ) );
+        g_TestSheets.back().m_Screen = &aScreens[ii];
+    }
+
+    aItems.assign( aCount, SCH_ITEM() );
+
+    std::vector<SCH_ITEM*> lasts( sheetCount, (SCH_ITEM*) NULL );
+
+    for( int ii = 0; ii < aCount; ii++ )
+    {
+        NETLIST_OBJECT& item = aItems[ii].m_Object;
+
+        item.m_TestId           = ii;
+        item.m_Type             = (NETLIST_ITEM_T) ( 1 + rand() % NET_NOCONNECT );
+        item.m_NetCode          = 0;
+        item.m_BusNetCode       = 0;
+        item.m_Member           = rand() % 3;
+        item.m_FlagOfConnection = UNCONNECTED;
+        item.m_SheetListInclude = g_TestSheets[ rand() % sheetCount ];
+        item.m_Label            = names[ rand() % 10 ];
+        item.m_Start            = wxPoint( rand() % grid, rand() % grid );
+        item.m_End              = item.m_Start;
+        item.m_NetNameCandidate = NULL;
+
+        if( item.m_Type == NET_SEGMENT || item.m_Type == NET_BUS )
+        {
+            // horizontal, vertical, slanted or null
+            int len = rand() % grid;
+
+            switch( rand() % 4 )
+            {
+            case 0: item.m_End.x += len; break;
+            case 1: item.m_End.y -= len; break;
+            case 2: item.m_End.x += len; item.m_End.y += len * ( 1 + rand() % 2 ); break;
+            default: break;
+            }
+        }
+        else if( rand() % 8 == 0 )
+        {
+            item.m_End = wxPoint( rand() % grid, rand() % grid );
+        }
+
+        int sheet = rand() % sheetCount;
+
+        aItems[ii].m_Next = NULL;
+
+        if( lasts[sheet] )
+            lasts[sheet]->m_Next = &aItems[ii];
+        else
+            aScreens[sheet].m_Items = &aItems[ii];
+
+        lasts[sheet] = &aItems[ii];
+    }
+}
+
+
+/// @return int - the test number of the net name of @a aItem, -1 if none
+static int netName( const NETLIST_OBJECT* aItem )
+{
+    return aItem->m_NetNameCandidate ? aItem->m_NetNameCandidate->m_TestId : -1;
+}
+
+
+/// @return int - the number of items of @a aList which differ from the ones of @a aFormer
+static int compareNetLists( const NETLIST_OBJECT_LIST& aFormer, const NETLIST_OBJECT_LIST& aList )
+{
+    if( aFormer.size() != aList.size() )
+    {
+        printf( "%u items instead of %u\n", (unsigned) aList.size(), (unsigned) aFormer.size() );
+        return 1;
+    }
+
+    int errors = 0;
+
+    for( unsigned ii = 0; ii < aList.size() && errors < 10; ii++ )
+    {
+        const NETLIST_OBJECT* former = aFormer[ii];
+        const NETLIST_OBJECT* item   = aList[ii];
+
+        if( item->m_TestId != former->m_TestId || item->GetNet() != former->GetNet()
+            || item->m_BusNetCode != former->m_BusNetCode
+            || item->m_FlagOfConnection != former->m_FlagOfConnection
+            || netName( item ) != netName( former ) )
+        {
+            printf( "item %u: item %d net %d bus %d flag %d name %d "
+                    "instead of item %d net %d bus %d flag %d name %d\n", ii,
+                    item->m_TestId, item->GetNet(), item->m_BusNetCode,
+                    item->m_FlagOfConnection, netName( item ),
+                    former->m_TestId, former->GetNet(), former->m_BusNetCode,
+                    former->m_FlagOfConnection, netName( former ) );
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+
+static void freeNetList( NETLIST_OBJECT_LIST& aList )
+{
+    for( unsigned ii = 0; ii < aList.size(); ii++ )
+        delete aList[ii];
+
+    aList.clear();
+}
+
+
+static int runTest( int aCount )
+{
+    int     schematicCount = std::max( 1, 20000 / aCount );
+    double  formerTime = 0;
+    double  time = 0;
+    int     errors = 0;
+
+    for( int ii = 0; ii < schematicCount && errors < 10; ii++ )
+    {
+        std::vector<SCH_SCREEN> screens;
+        std::vector<SCH_ITEM>   items;
+        SCH_EDIT_FRAME          frame;
+
+        makeSchematic( aCount, screens, items );
+
+        clock_t start = clock();
+
+        FORMER::BuildNetListBase();
+        formerTime += elapsedMs( start );
+
+        start = clock();
+        frame.BuildNetListBase();
+        time += elapsedMs( start );
+
+        errors += compareNetLists( FORMER::g_NetObjectslist, g_NetObjectslist );
+
+        freeNetList( FORMER::g_NetObjectslist );
+        freeNetList( g_NetObjectslist );
+    }
+
+    printf( "%5d schematics of %5d items: former builder %.1f ms, disjoint sets %.1f ms  %s\n",
+            schematicCount, aCount, formerTime, time, errors ? "NETS DIFFER" : "same nets" );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = runTest( 30 );
+
+    errors += runTest( 300 );
+    errors += runTest( 3000 );
+
+    return errors ? 1 : 0;
+}
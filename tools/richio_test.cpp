@@ -0,0 +1,184 @@
+/*
+    A test program for MMAP_LINE_READER: files of lines ending with "\n" or
+    "\r\n" in a random mix, a last line with or without its newline, are read,
+    and each line must be the line written, "\r\n" returned as '\n', and must
+    begin at LineOffset() and end at Offset() in the file.  Built twice: with
+    the file mapped where there is mmap(), and read whole into memory with
+    MMAP_LINE_READER_NO_MMAP.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include <wx/filename.h>
+
+#include <macros.h>
+#include <richio.h>
+
+
+static double elapsedMs( clock_t aStart )
+{
+    return 1000.0 * ( clock() - aStart ) / CLOCKS_PER_SEC;
+}
+
+
+struct LINE
+{
+    std::string m_Text;         ///< the line as ReadLine() must return it
+    size_t      m_Begin;        ///< offset of the line in the file
+    size_t      m_End;          ///< offset of the byte after the line in the file
+};
+
+
+/// @return int - the number of errors reading the file of @a aContents
+static int readFile( const std::string& aContents, const std::vector<LINE>& aLines,
+                     const char* aName )
+{
+    wxString fileName = wxFileName::CreateTempFileName( wxT( "richio_test" ) );
+    FILE*    file = wxFopen( fileName, wxT( "wb" ) );
+
+    fwrite( aContents.data(), 1, aContents.size(), file );
+    fclose( file );
+
+    int errors = 0;
+
+    try
+    {
+        MMAP_LINE_READER reader( fileName );
+
+        for( unsigned ii = 0;  ii <= aLines.size() && errors < 10;  ++ii )
+        {
+            char* line = reader.ReadLine();
+
+            if( ii == aLines.size() )
+            {
+                if( line )
+                {
+                    printf( "%s: a line after the end of the file: '%s'\n", aName, line );
+                    errors++;
+                }
+
+                break;
+            }
+
+            const LINE& expected = aLines[ii];
+
+            if( !line || expected.m_Text != line
+                || reader.Length() != expected.m_Text.size()
+                || reader.LineOffset() != expected.m_Begin
+                || reader.Offset() != expected.m_End )
+            {
+                printf( "%s: line %u '%s' length %u at %u..%u instead of '%s' length %u at %u..%u\n",
+                        aName, ii + 1, line ? line : "(null)",
+                        (unsigned) reader.Length(),
+                        (unsigned) reader.LineOffset(), (unsigned) reader.Offset(),
+                        expected.m_Text.c_str(), (unsigned) expected.m_Text.size(),
+                        (unsigned) expected.m_Begin, (unsigned) expected.m_End );
+                errors++;
+            }
+        }
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "%s: %s\n", aName, TO_UTF8( ioe.errorText ) );
+        errors++;
+    }
+
+    wxRemoveFile( fileName );
+
+    return errors;
+}
+
+
+/// adds to @a aContents a line of @a aText ended by @a aEnd
+static void addLine( std::string& aContents, std::vector<LINE>& aLines,
+                     const std::string& aText, const char* aEnd )
+{
+    LINE line;
+
+    line.m_Begin = aContents.size();
+    line.m_Text  = aText + ( *aEnd ? "\n" : "" );
+
+    aContents += aText + aEnd;
+
+    line.m_End = aContents.size();
+
+    aLines.push_back( line );
+}
+
+
+/// the line endings of the small files, and the lines without a newline
+static int testEndings()
+{
+    static const char* const endings[] = { "\n", "\r\n", "" };
+
+    int errors = 0;
+
+    // an empty file
+    errors += readFile( std::string(), std::vector<LINE>(), "empty file" );
+
+    for( unsigned ii = 0;  ii < sizeof( endings ) / sizeof( endings[0] );  ++ii )
+    {
+        std::string         contents;
+        std::vector<LINE>   lines;
+
+        // a line of the ending only, a '\r' inside a line, and a last line
+        addLine( contents, lines, "", "\n" );
+        addLine( contents, lines, "", "\r\n" );
+        addLine( contents, lines, "(module R3 \r(layer F.Cu))", "\r\n" );
+        addLine( contents, lines, "$EndMODULE  R3", endings[ii] );
+
+        errors += readFile( contents, lines, "small file" );
+    }
+
+    printf( "small files: %s\n", errors ? "LINES DIFFER" : "same lines" );
+
+    return errors;
+}
+
+
+static int runTest( int aCount )
+{
+    std::string         contents;
+    std::vector<LINE>   lines;
+
+    for( int ii = 0;  ii < aCount;  ++ii )
+    {
+        std::string text( 1 + rand() % 80, 'a' + ii % 26 );
+        const char* end = rand() % 2 ? "\r\n" : "\n";
+
+        // the last line, with or without a newline
+        if( ii == aCount - 1 && aCount % 2 )
+            end = "";
+
+        addLine( contents, lines, text, end );
+    }
+
+    clock_t start = clock();
+
+    int errors = readFile( contents, lines, "random file" );
+
+    printf( "%7d lines, LF and CRLF: %.1f ms  %s\n",
+            aCount, elapsedMs( start ), errors ? "LINES DIFFER" : "same lines" );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = runTest( 1 );
+
+    errors += runTest( 1000 );
+    errors += runTest( 100001 );
+    errors += testEndings();
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,243 @@
+/*
+    A test program for SNAPSHOT_PLUGIN: a synthetic board of track segments
+    and vias is saved as a snapshot and loaded back, and the board loaded
+    must be written by PCB_IO as the same text as the board saved.  The times
+    of the snapshot Save() and Load() are compared with the ones of PCB_IO.
+    An empty file, a part of the header, truncated snapshots and a snapshot
+    with a track count so large that its size overflows, with a checksum
+    matching it, must not be loaded, but throw an IO_ERROR.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+
+#include <wx/filename.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+#include <class_track.h>
+#include <kicad_plugin.h>
+#include <snapshot_plugin.h>
+
+
+/// @return std::string - the text of @a aBoard written by PCB_IO
+static std::string boardText( BOARD* aBoard )
+{
+    PCB_IO io;
+
+    io.Format( aBoard, 0 );
+
+    return io.GetStringOutput( true );
+}
+
+
+/// @return int - 1 if the file of the @a aSize first bytes of @a aContents is loaded, else 0
+static int loadDamaged( const std::string& aContents, size_t aSize, const char* aName )
+{
+    wxString    fileName = wxFileName::CreateTempFileName( wxT( "snapshot_test" ) );
+    FILE*       file = wxFopen( fileName, wxT( "wb" ) );
+    int         errors = 0;
+
+    fwrite( aContents.data(), 1, aSize, file );
+    fclose( file );
+
+    try
+    {
+        SNAPSHOT_PLUGIN         plugin;
+        std::auto_ptr<BOARD>    board( plugin.Load( fileName, NULL ) );
+
+        printf( "%s: loaded\n", aName );
+        errors++;
+    }
+    catch( const IO_ERROR& )
+    {
+        // not a board snapshot, or a damaged one
+    }
+
+    wxRemoveFile( fileName );
+
+    return errors;
+}
+
+
+/// @return uint32_t - the Adler-32 checksum of the @a aSize bytes of @a aData
+static uint32_t adler32( const char* aData, size_t aSize )
+{
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    for( size_t ii = 0; ii < aSize; ++ii )
+    {
+        a = ( a + (unsigned char) aData[ii] ) % 65521;
+        b = ( b + a ) % 65521;
+    }
+
+    return ( b << 16 ) | a;
+}
+
+
+/**
+ * Function loadOversized
+ * sets the count of the track section of the snapshot @a aContents so that its size,
+ * 48 bytes by track, overflows to 0, and its checksum to the one of the changed sections.
+ * A snapshot is a header of 32 bytes, with the checksum at the offset 16, then the
+ * sections: a tag, an item size and a 64 bit item count (16 bytes), then their items
+ * padded to 8 bytes.  The first section is the text of the board, one byte by item.
+ * @return int - 1 if the snapshot is loaded, else 0
+ */
+static int loadOversized( const std::string& aContents )
+{
+    std::string contents = aContents;
+    uint64_t    textSize;
+
+    memcpy( &textSize, &contents[32 + 8], sizeof( textSize ) );
+
+    size_t      tracks = 32 + 16 + ( textSize + 7 ) / 8 * 8;
+    uint64_t    count = uint64_t( 1 ) << 60;
+
+    memcpy( &contents[tracks + 8], &count, sizeof( count ) );
+
+    uint32_t    checksum = adler32( contents.data() + 32, contents.size() - 32 );
+
+    memcpy( &contents[16], &checksum, sizeof( checksum ) );
+
+    return loadDamaged( contents, contents.size(), "oversized track count" );
+}
+
+
+/// @return int - the number of damaged snapshots of @a aFileName which are loaded
+static int testDamaged( const wxString& aFileName )
+{
+    std::string contents;
+    FILE*       file = wxFopen( aFileName, wxT( "rb" ) );
+    char        buf[4096];
+    size_t      len;
+
+    while( ( len = fread( buf, 1, sizeof( buf ), file ) ) > 0 )
+        contents.append( buf, len );
+
+    fclose( file );
+
+    int errors = loadDamaged( contents, 0, "empty file" )
+               + loadDamaged( contents, 8, "a part of the header" )
+               + loadDamaged( contents, contents.size() / 2, "truncated snapshot" )
+               + loadDamaged( contents, contents.size() - 1, "last byte missing" )
+               + loadOversized( contents );
+
+    printf( "damaged snapshots: %s\n", errors ? "LOADED" : "not loaded" );
+
+    return errors;
+}
+
+
+static void fillBoard( BOARD* aBoard, int aCount )
+{
+    for( int i = 0;  i < aCount;  ++i )
+    {
+        TRACK* track = new TRACK( aBoard );
+
+        // any nanometer, not only the grid ones
+        wxPoint start( rand() % Millimeter2iu( 300 ), rand() % Millimeter2iu( 200 ) );
+
+        track->SetStart( start );
+        track->SetEnd( start + wxPoint( rand() % Millimeter2iu( 10 ), rand() % 1000 ) );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetLayer( i % 2 ? LAYER_N_FRONT : LAYER_N_BACK );
+        track->SetNet( i % 1000 );
+
+        aBoard->m_Track.PushBack( track );
+    }
+}
+
+
+static int runTest( int aCount )
+{
+    BOARD board;
+
+    fillBoard( &board, aCount );
+
+    // a via every 10 segments
+    for( int ii = 0;  ii < aCount / 10;  ++ii )
+    {
+        SEGVIA*    via = new SEGVIA( &board );
+        wxPoint    pos( rand() % Millimeter2iu( 300 ), rand() % Millimeter2iu( 200 ) );
+
+        via->SetStart( pos );
+        via->SetEnd( pos );
+        via->SetWidth( Millimeter2iu( 0.6 ) );
+        via->SetDrill( ii % 2 ? Millimeter2iu( 0.3 ) : UNDEFINED_DRILL_DIAMETER );
+        via->SetLayerPair( LAYER_N_FRONT, LAYER_N_BACK );
+        via->SetNet( ii % 1000 );
+        via->SetTimeStamp( ii );
+
+        board.m_Track.PushBack( via );
+    }
+
+    wxString    snapshotName = wxFileName::CreateTempFileName( wxT( "snapshot_test" ) );
+    wxString    boardName = wxFileName::CreateTempFileName( wxT( "snapshot_test" ) );
+    int         errors = 0;
+
+    try
+    {
+        SNAPSHOT_PLUGIN snapshot;
+        PCB_IO          io;
+        unsigned        start = GetRunningMicroSecs();
+
+        snapshot.Save( snapshotName, &board );
+        unsigned snapshotSave = GetRunningMicroSecs() - start;
+
+        start = GetRunningMicroSecs();
+        std::auto_ptr<BOARD> loaded( snapshot.Load( snapshotName, NULL ) );
+        unsigned snapshotLoad = GetRunningMicroSecs() - start;
+
+        start = GetRunningMicroSecs();
+        io.Save( boardName, &board );
+        unsigned ioSave = GetRunningMicroSecs() - start;
+
+        start = GetRunningMicroSecs();
+        std::auto_ptr<BOARD> parsed( io.Load( boardName, NULL ) );
+        unsigned ioLoad = GetRunningMicroSecs() - start;
+
+        bool same = loaded->m_Track.GetCount() == board.m_Track.GetCount()
+                    && boardText( loaded.get() ) == boardText( &board );
+
+        if( !same )
+            errors++;
+
+        printf( "%7d segments: snapshot save %u usecs load %u usecs, "
+                "PCB_IO save %u usecs load %u usecs  %s\n",
+                aCount, snapshotSave, snapshotLoad, ioSave, ioLoad,
+                same ? "same board" : "BOARDS DIFFER" );
+
+        errors += testDamaged( snapshotName );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        printf( "%d segments: %s\n", aCount, TO_UTF8( ioe.errorText ) );
+        errors++;
+    }
+
+    wxRemoveFile( snapshotName );
+    wxRemoveFile( boardName );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = runTest( 1000 );
+
+    errors += runTest( 100000 );
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,307 @@
+/*
+    A test program which compares the track clearance test of the DRC as it
+    used to be, each segment tested by DRC_WORKER::TestTrack() against the
+    whole rest of the track list, with the test of the segments found by
+    BOARD_SPATIAL_INDEX, on synthetic boards of 1k, 10k and 100k segments
+    laid out as a dense bus.  The former test is quadratic, so both are run
+    on 1000 segments spread over the board only: the violations found must
+    be the same, and so must the neighbours found by a scan of the track
+    list and by the index.  Then half of the segments and a module are
+    deleted by DeleteStructure(), and some segments are moved in place: the
+    index must find exactly the remaining items where they are now.
+*/
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <board_spatial_index.h>
+#include <drc_stuff.h>
+
+
+static void fillBoard( BOARD* aBoard, int aCount )
+{
+    int pitch  = Millimeter2iu( 0.6 );
+    int length = Millimeter2iu( 2.0 );
+    int perRow = 200;
+
+    for( int i = 0;  i < aCount;  ++i )
+    {
+        TRACK* track = new TRACK( aBoard );
+
+        wxPoint start( ( i % perRow ) * pitch, ( i / perRow ) * ( length + pitch ) );
+
+        track->SetStart( start );
+        track->SetEnd( start + wxPoint( 0, length ) );
+
+        // every 10th segment too close to its neighbours
+        track->SetWidth( Millimeter2iu( i % 10 ? 0.25 : 0.5 ) );
+        track->SetLayer( LAYER_N_FRONT );
+        track->SetNet( i + 1 );
+
+        // BOARD::Add() looks for the insertion point of the net, which is
+        // quadratic by itself.
+        aBoard->m_Track.PushBack( track );
+    }
+}
+
+
+static bool sameViolations( const std::vector<DRC_VIOLATION>& aFormer,
+                            const std::vector<DRC_VIOLATION>& aViolations )
+{
+    if( aFormer.size() != aViolations.size() )
+        return false;
+
+    for( unsigned ii = 0;  ii < aFormer.size();  ++ii )
+    {
+        if( aFormer[ii].m_ErrorCode != aViolations[ii].m_ErrorCode
+            || aFormer[ii].m_ItemA != aViolations[ii].m_ItemA
+            || aFormer[ii].m_ItemB != aViolations[ii].m_ItemB
+            || aFormer[ii].m_Rank != aViolations[ii].m_Rank )
+            return false;
+    }
+
+    return true;
+}
+
+
+static int runTest( int aCount )
+{
+    BOARD board;
+
+    fillBoard( &board, aCount );
+
+    std::vector<TRACK*> segments;
+
+    for( TRACK* segm = board.m_Track;  segm;  segm = segm->Next() )
+        segments.push_back( segm );
+
+    int                 step = std::max( 1, aCount / 1000 );
+    int                 halo = board.GetBiggestClearanceValue();
+    std::vector<D_PAD*> pads = board.GetPads();
+
+    // the former DRC: a segment against the rest of the track list
+    DRC_WORKER          former( &board );
+    std::vector<TRACK*> tracks;
+
+    unsigned    formerStart = GetRunningMicroSecs();
+
+    for( int ii = 0;  ii < aCount;  ii += step )
+    {
+        tracks.clear();
+
+        for( TRACK* track = segments[ii]->Next();  track;  track = track->Next() )
+            tracks.push_back( track );
+
+        former.SetRank( ii );
+        former.TestTrack( segments[ii], pads, tracks );
+    }
+
+    unsigned    formerStop = GetRunningMicroSecs();
+
+    // the DRC with the spatial index, the neighbours tested in the list order
+    const BOARD_SPATIAL_INDEX&  index = board.GetSpatialIndex();
+
+    unsigned    buildStop = GetRunningMicroSecs();
+
+    static const KICAD_T        trackTypes[] = { PCB_TRACE_T, PCB_VIA_T, EOT };
+
+    std::map<const BOARD_ITEM*, int> rank;
+
+    for( int ii = 0;  ii < aCount;  ++ii )
+        rank[ segments[ii] ] = ii;
+
+    DRC_WORKER                  worker( &board );
+    std::vector<BOARD_ITEM*>    found;
+    std::vector<int>            neighbours;
+    long long                   queried = 0;
+
+    for( int ii = 0;  ii < aCount;  ii += step )
+    {
+        EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( segments[ii] );
+        area.Inflate( halo );
+
+        found.clear();
+        index.Query( area, found, trackTypes );
+
+        neighbours.clear();
+
+        for( unsigned jj = 0;  jj < found.size();  ++jj )
+        {
+            int foundRank = rank[ found[jj] ];
+
+            if( foundRank > ii )
+                neighbours.push_back( foundRank );
+        }
+
+        std::sort( neighbours.begin(), neighbours.end() );
+
+        tracks.clear();
+
+        for( unsigned jj = 0;  jj < neighbours.size();  ++jj )
+            tracks.push_back( segments[ neighbours[jj] ] );
+
+        queried += tracks.size();
+
+        worker.SetRank( ii );
+        worker.TestTrack( segments[ii], pads, tracks );
+    }
+
+    unsigned    queryStop = GetRunningMicroSecs();
+
+    // the neighbours found by a scan of the rest of the track list
+    long long   scanned = 0;
+
+    for( int ii = 0;  ii < aCount;  ii += step )
+    {
+        EDA_RECT area = BOARD_SPATIAL_INDEX::ItemBoundingBox( segments[ii] );
+        area.Inflate( halo );
+
+        for( TRACK* track = segments[ii]->Next();  track;  track = track->Next() )
+        {
+            if( area.Intersects( BOARD_SPATIAL_INDEX::ItemBoundingBox( track ) ) )
+                ++scanned;
+        }
+    }
+
+    bool same = queried == scanned
+                && sameViolations( former.GetViolations(), worker.GetViolations() );
+
+    printf( "%7d segments, %d tested: former DRC %u usecs  index build %u usecs "
+            "DRC %u usecs (%lld neighbours, %u violations)  %s\n",
+            aCount, ( aCount + step - 1 ) / step,
+            formerStop - formerStart,
+            buildStop - formerStop,
+            queryStop - buildStop, queried, (unsigned) worker.GetViolations().size(),
+            same ? "same violations" : "VIOLATIONS DIFFER" );
+
+    return same ? 0 : 1;
+}
+
+
+/// @return bool - true if @a aIndex finds @a aItem in @a aArea
+static bool finds( const BOARD_SPATIAL_INDEX& aIndex, const EDA_RECT& aArea, BOARD_ITEM* aItem )
+{
+    std::vector<BOARD_ITEM*> found;
+
+    aIndex.Query( aArea, found );
+
+    return std::find( found.begin(), found.end(), aItem ) != found.end();
+}
+
+
+/**
+ * Function testChanges
+ * deletes half of the segments and a module of pads by DeleteStructure(), then moves
+ * every 4th remaining segment in place and invalidates the index, as
+ * PCB_BASE_FRAME::OnModify() does.
+ * @return int - 1 if the index does not hold exactly the remaining items where they
+ *               are now, else 0
+ */
+static int testChanges( int aCount )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+
+    fillBoard( &board, aCount );
+
+    for( int ii = 0;  ii < 10;  ++ii )
+    {
+        D_PAD* pad = new D_PAD( module );
+
+        pad->SetSize( wxSize( Millimeter2iu( 1.0 ), Millimeter2iu( 1.0 ) ) );
+        pad->SetLayerMask( ALL_CU_LAYERS );
+        pad->SetPosition( wxPoint( Millimeter2iu( 2 ) * ii, 0 ) );
+
+        module->m_Pads.PushBack( pad );
+    }
+
+    board.Add( module );
+
+    // build the index before the changes
+    board.GetSpatialIndex();
+
+    TRACK* next;
+    int    ii = 0;
+
+    for( TRACK* segm = board.m_Track;  segm;  segm = next, ++ii )
+    {
+        next = segm->Next();
+
+        if( ii % 2 )
+            segm->DeleteStructure();
+    }
+
+    module->DeleteStructure();
+
+    std::vector<TRACK*>     moved;
+    std::vector<EDA_RECT>   formerAreas;
+    wxPoint                 offset( Millimeter2iu( 200 ), 0 );
+
+    ii = 0;
+
+    for( TRACK* segm = board.m_Track;  segm;  segm = segm->Next(), ++ii )
+    {
+        if( ii % 4 )
+            continue;
+
+        formerAreas.push_back( BOARD_SPATIAL_INDEX::ItemBoundingBox( segm ) );
+        moved.push_back( segm );
+
+        segm->SetStart( segm->GetStart() + offset );
+        segm->SetEnd( segm->GetEnd() + offset );
+    }
+
+    board.InvalidateSpatialIndex();
+
+    const BOARD_SPATIAL_INDEX& index = board.GetSpatialIndex();
+
+    std::set<BOARD_ITEM*>       remaining;
+    std::vector<BOARD_ITEM*>    found;
+
+    for( TRACK* segm = board.m_Track;  segm;  segm = segm->Next() )
+        remaining.insert( segm );
+
+    index.Query( EDA_RECT( wxPoint( -Millimeter2iu( 1000 ), -Millimeter2iu( 1000 ) ),
+                           wxSize( Millimeter2iu( 2000 ), Millimeter2iu( 2000 ) ) ),
+                 found );
+
+    // each remaining segment once, and nothing else
+    std::set<BOARD_ITEM*> indexed( found.begin(), found.end() );
+
+    bool same = found.size() == indexed.size() && indexed == remaining
+                && index.GetCount() == (int) remaining.size();
+
+    for( TRACK* segm = board.m_Track;  segm && same;  segm = segm->Next() )
+        same = finds( index, BOARD_SPATIAL_INDEX::ItemBoundingBox( segm ), segm );
+
+    for( unsigned jj = 0;  jj < moved.size() && same;  ++jj )
+        same = !finds( index, formerAreas[jj], moved[jj] );
+
+    printf( "%7d segments, half deleted, %u moved: %u items indexed for %u segments  %s\n",
+            aCount, (unsigned) moved.size(), (unsigned) found.size(),
+            (unsigned) remaining.size(), same ? "same items" : "ITEMS DIFFER" );
+
+    return same ? 0 : 1;
+}
+
+
+int main( int argc, char** argv )
+{
+    int errors = runTest( 1000 );
+
+    errors += runTest( 10000 );
+    errors += runTest( 100000 );
+    errors += testChanges( 1000 );
+
+    return errors ? 1 : 0;
+}
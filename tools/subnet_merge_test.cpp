@@ -0,0 +1,429 @@
+/*
+    A test program for the connectivity clusters of CONNECTIONS, on synthetic
+    boards.
+
+    Build_CurrNet_SubNets_Connections(), which calls Propagate_SubNets(), is
+    run on a GND net of up to 20k pads chained by tracks given in a random
+    order, with every 1000th track missing so that the net is left in several
+    clusters.  The subnets of the pads and tracks must make these clusters.
+    The time of Propagate_SubNets() is then compared with the one of the
+    former propagation, which relabelled the items of a cluster at each merge,
+    on the same connections.
+
+    RecalculateAllTracksNetcode() is run on 2 nets shorted by their tracks,
+    then on 2 nets bridged by a track without net: the tracks without net
+    connected to the tracks of a net must take the code of this net, not the
+    one of the other net of the short.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <fctsys.h>
+#include <common.h>
+#include <convert_to_biu.h>
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <connect.h>
+
+
+static TRACK* addTrack( BOARD* aBoard, const wxPoint& aStart, const wxPoint& aEnd, int aNetCode )
+{
+    TRACK* track = new TRACK( aBoard );
+
+    track->SetStart( aStart );
+    track->SetEnd( aEnd );
+    track->SetWidth( Millimeter2iu( 0.25 ) );
+    track->SetLayer( LAYER_N_FRONT );
+    track->SetNet( aNetCode );
+
+    // BOARD::Add() looks for the insertion point of the net, which is
+    // quadratic by itself.
+    aBoard->m_Track.PushBack( track );
+
+    return track;
+}
+
+
+static D_PAD* addPad( MODULE* aModule, const wxPoint& aPosition, const wxString& aNetName )
+{
+    D_PAD* pad = new D_PAD( aModule );
+
+    pad->SetShape( PAD_CIRCLE );
+    pad->SetAttribute( PAD_STANDARD );
+    pad->SetSize( wxSize( Millimeter2iu( 1.0 ), Millimeter2iu( 1.0 ) ) );
+    pad->SetDrillSize( wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.5 ) ) );
+    pad->SetLayerMask( ALL_CU_LAYERS );
+    pad->SetPosition( aPosition );
+    pad->SetNetname( aNetName );
+
+    aModule->m_Pads.PushBack( pad );
+
+    return pad;
+}
+
+
+/// the former CONNECTIONS::Merge_PadsSubNets()
+static void formerMergePadsSubNets( const std::vector<D_PAD*>& aPads,
+                                    int aOldSubNet, int aNewSubNet )
+{
+    if( aOldSubNet == aNewSubNet )
+        return;
+
+    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
+        std::swap( aOldSubNet, aNewSubNet );
+
+    for( unsigned ii = 0; ii < aPads.size(); ii++ )
+    {
+        if( aPads[ii]->GetSubNet() == aOldSubNet )
+            aPads[ii]->SetSubNet( aNewSubNet );
+    }
+}
+
+
+/// the former CONNECTIONS::Merge_SubNets(), which relabelled the tracks of a cluster
+static void formerMergeSubNets( TRACK* aFirstTrack, TRACK* aLastTrack,
+                                int aOldSubNet, int aNewSubNet )
+{
+    if( aOldSubNet == aNewSubNet )
+        return;
+
+    if( (aOldSubNet > 0) && (aOldSubNet < aNewSubNet) )
+        std::swap( aOldSubNet, aNewSubNet );
+
+    for( TRACK* curr_track = aFirstTrack; curr_track != NULL; curr_track = curr_track->Next() )
+    {
+        if( curr_track->GetSubNet() == aOldSubNet )
+        {
+            curr_track->SetSubNet( aNewSubNet );
+
+            for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
+            {
+                D_PAD* pad = curr_track->m_PadsConnected[ii];
+
+                if( pad->GetSubNet() == aOldSubNet )
+                    pad->SetSubNet( curr_track->GetSubNet() );
+            }
+        }
+
+        if( curr_track == aLastTrack )
+            break;
+    }
+}
+
+
+/**
+ * the former CONNECTIONS::Propagate_SubNets(): a new subnet for 2 items not yet in a
+ * cluster, and a scan of all the tracks to merge 2 clusters.
+ */
+static void formerPropagateSubNets( const std::vector<D_PAD*>& aPads,
+                                    TRACK* aFirstTrack, TRACK* aLastTrack )
+{
+    int sub_netcode = 0;
+
+    for( unsigned ii = 0; ii < aPads.size(); ii++ )
+    {
+        D_PAD* curr_pad = aPads[ii];
+
+        for( unsigned jj = 0; jj < curr_pad->m_PadsConnected.size(); jj++ )
+        {
+            D_PAD* pad = curr_pad->m_PadsConnected[jj];
+
+            if( curr_pad->GetSubNet() )
+            {
+                if( pad->GetSubNet() > 0 )
+                    formerMergePadsSubNets( aPads, pad->GetSubNet(), curr_pad->GetSubNet() );
+                else
+                    pad->SetSubNet( curr_pad->GetSubNet() );
+            }
+            else if( pad->GetSubNet() > 0 )
+            {
+                curr_pad->SetSubNet( pad->GetSubNet() );
+            }
+            else
+            {
+                sub_netcode++;
+                curr_pad->SetSubNet( sub_netcode );
+                pad->SetSubNet( sub_netcode );
+            }
+        }
+    }
+
+    sub_netcode++;
+
+    if( aFirstTrack )
+        aFirstTrack->SetSubNet( sub_netcode );
+
+    for( TRACK* curr_track = aFirstTrack; curr_track != NULL; curr_track = curr_track->Next() )
+    {
+        for( unsigned ii = 0; ii < curr_track->m_PadsConnected.size(); ii++ )
+        {
+            D_PAD* pad = curr_track->m_PadsConnected[ii];
+
+            if( curr_track->GetSubNet() )
+            {
+                if( pad->GetSubNet() > 0 )
+                    formerMergeSubNets( aFirstTrack, aLastTrack,
+                                        pad->GetSubNet(), curr_track->GetSubNet() );
+                else
+                    pad->SetSubNet( curr_track->GetSubNet() );
+            }
+            else if( pad->GetSubNet() > 0 )
+            {
+                curr_track->SetSubNet( pad->GetSubNet() );
+            }
+            else
+            {
+                sub_netcode++;
+                curr_track->SetSubNet( sub_netcode );
+                pad->SetSubNet( sub_netcode );
+            }
+        }
+
+        for( unsigned ii = 0; ii < curr_track->m_TracksConnected.size(); ii++ )
+        {
+            TRACK* track = curr_track->m_TracksConnected[ii];
+
+            if( curr_track->GetSubNet() )
+            {
+                if( track->GetSubNet() )
+                    formerMergeSubNets( aFirstTrack, aLastTrack,
+                                        track->GetSubNet(), curr_track->GetSubNet() );
+                else
+                    track->SetSubNet( curr_track->GetSubNet() );
+            }
+            else if( track->GetSubNet() )
+            {
+                curr_track->SetSubNet( track->GetSubNet() );
+            }
+            else
+            {
+                sub_netcode++;
+                curr_track->SetSubNet( sub_netcode );
+                track->SetSubNet( sub_netcode );
+            }
+        }
+
+        if( curr_track == aLastTrack )
+            break;
+    }
+}
+
+
+/// @return int - the number of items of which the subnet is not the one of their cluster
+static int checkPartition( const std::vector<int>& aSubnets,
+                           const std::vector<int>& aClusters )
+{
+    // a subnet is the one of a single cluster, and the other way round
+    std::vector<int> clusterOfSubnet( aSubnets.size() + 1, -1 );
+    std::vector<int> subnetOfCluster( aClusters.size() + 1, -1 );
+    int              errors = 0;
+
+    for( unsigned ii = 0; ii < aSubnets.size(); ii++ )
+    {
+        int& cluster = clusterOfSubnet[ aSubnets[ii] ];
+        int& subnet  = subnetOfCluster[ aClusters[ii] ];
+
+        if( cluster < 0 )
+            cluster = aClusters[ii];
+
+        if( subnet < 0 )
+            subnet = aSubnets[ii];
+
+        if( cluster != aClusters[ii] || subnet != aSubnets[ii] )
+            errors++;
+    }
+
+    return errors;
+}
+
+
+/// @return std::vector<int> - the subnets of the pads and of the tracks which exist
+static std::vector<int> subnets( const std::vector<D_PAD*>& aPads,
+                                 const std::vector<TRACK*>& aTracks )
+{
+    std::vector<int> subnets;
+
+    for( unsigned ii = 0; ii < aPads.size(); ii++ )
+    {
+        subnets.push_back( aPads[ii]->GetSubNet() );
+
+        if( ii < aTracks.size() && aTracks[ii] )
+            subnets.push_back( aTracks[ii]->GetSubNet() );
+    }
+
+    return subnets;
+}
+
+
+static int testSubnets( int aPadCount )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+    int     pitch  = Millimeter2iu( 2.0 );
+
+    std::vector<D_PAD*> pads;
+
+    for( int ii = 0; ii < aPadCount; ii++ )
+        pads.push_back( addPad( module, wxPoint( ii * pitch, 0 ), wxT( "GND" ) ) );
+
+    board.Add( module );
+    board.BuildListOfNets();
+
+    int netcode = pads[0]->GetNet();
+
+    // track ii connects the pads ii and ii+1, in a random order.  Every 1000th
+    // track is missing.
+    std::vector<int> order;
+
+    for( int ii = 0; ii < aPadCount - 1; ii++ )
+    {
+        if( ii % 1000 != 999 )
+            order.push_back( ii );
+    }
+
+    std::random_shuffle( order.begin(), order.end() );
+
+    std::vector<TRACK*> tracks( aPadCount - 1, (TRACK*) NULL );
+
+    for( unsigned ii = 0; ii < order.size(); ii++ )
+    {
+        int jj = order[ii];
+
+        tracks[jj] = addTrack( &board, pads[jj]->GetPosition(), pads[jj + 1]->GetPosition(),
+                               netcode );
+    }
+
+    CONNECTIONS connections( &board );
+
+    connections.Build_CurrNet_SubNets_Connections( board.m_Track, board.m_Track.GetLast(),
+                                                   netcode );
+
+    // the pads ii and the tracks ii of a same thousand are in the same cluster
+    std::vector<int> clusters;
+
+    for( int ii = 0; ii < aPadCount; ii++ )
+    {
+        clusters.push_back( ii / 1000 );
+
+        if( ii < aPadCount - 1 && tracks[ii] )
+            clusters.push_back( ii / 1000 );
+    }
+
+    // the same connections, clustered again by the disjoint sets, then as before
+    unsigned    start = GetRunningMicroSecs();
+
+    connections.Propagate_SubNets();
+
+    unsigned    time = GetRunningMicroSecs() - start;
+    int         errors = checkPartition( subnets( pads, tracks ), clusters );
+
+    for( unsigned ii = 0; ii < pads.size(); ii++ )
+        pads[ii]->SetSubNet( 0 );
+
+    for( TRACK* track = board.m_Track; track; track = track->Next() )
+        track->SetSubNet( 0 );
+
+    start = GetRunningMicroSecs();
+
+    formerPropagateSubNets( pads, board.m_Track, board.m_Track.GetLast() );
+
+    unsigned    formerTime = GetRunningMicroSecs() - start;
+
+    errors += checkPartition( subnets( pads, tracks ), clusters );
+
+    printf( "%6d pads: Propagate_SubNets() %u usecs, former relabelling %u usecs  %s\n",
+            aPadCount, time, formerTime, errors ? "CLUSTERS DIFFER" : "expected clusters" );
+
+    return errors;
+}
+
+
+/**
+ * Function testShortedNets
+ * connects a track of the net N1 to a track of the net N2, directly or through a
+ * track without net when @a aBridged is true, then tracks without net to a second
+ * track of N2 only: they must take the net N2.
+ */
+static int testShortedNets( bool aBridged )
+{
+    BOARD   board;
+    MODULE* module = new MODULE( &board );
+
+    D_PAD*  pad1 = addPad( module, wxPoint( 0, 0 ), wxT( "N1" ) );
+    D_PAD*  pad2 = addPad( module, wxPoint( Millimeter2iu( 20 ), 0 ), wxT( "N2" ) );
+
+    board.Add( module );
+
+    wxPoint short_point( Millimeter2iu( 10 ), Millimeter2iu( 10 ) );
+    wxPoint bridge_end( Millimeter2iu( 10 ), Millimeter2iu( 15 ) );
+    wxPoint free_end( Millimeter2iu( 30 ), 0 );
+
+    // the shorted tracks first in the track list
+    addTrack( &board, pad1->GetPosition(), short_point, 0 );
+
+    TRACK* bridge = NULL;
+
+    if( aBridged )
+    {
+        bridge = addTrack( &board, short_point, bridge_end, 0 );
+        addTrack( &board, pad2->GetPosition(), bridge_end, 0 );
+    }
+    else
+    {
+        addTrack( &board, pad2->GetPosition(), short_point, 0 );
+    }
+
+    addTrack( &board, pad2->GetPosition(), free_end, 0 );
+
+    std::vector<TRACK*> netless;
+
+    for( int ii = 0; ii < 100; ii++ )
+    {
+        wxPoint next = free_end + wxPoint( Millimeter2iu( 1 ), 0 );
+
+        netless.push_back( addTrack( &board, free_end, next, 0 ) );
+        free_end = next;
+    }
+
+    CONNECTIONS connections( &board );
+
+    connections.RecalculateAllTracksNetcode();
+
+    int errors = 0;
+
+    for( unsigned ii = 0; ii < netless.size(); ii++ )
+    {
+        if( netless[ii]->GetNet() != pad2->GetNet() )
+            errors++;
+    }
+
+    // the bridge takes the net of one of the clusters it connects
+    if( bridge && bridge->GetNet() != pad1->GetNet() && bridge->GetNet() != pad2->GetNet() )
+        errors++;
+
+    printf( "%s nets: RecalculateAllTracksNetcode() %s\n", aBridged ? "bridged" : "shorted",
+            errors ? "GAVE THE NET OF THE SHORT" : "gave the net of the connected track" );
+
+    return errors;
+}
+
+
+int main( int argc, char** argv )
+{
+    srand( 1 );
+
+    int errors = testSubnets( 1000 );
+
+    errors += testSubnets( 5000 );
+    errors += testSubnets( 20000 );
+    errors += testShortedNets( false );
+    errors += testShortedNets( true );
+
+    return errors ? 1 : 0;
+}
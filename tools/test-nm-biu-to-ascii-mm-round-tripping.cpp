@@ -6,6 +6,10 @@
     that an int can hold, and converts to ASCII and back and verifies integrity
     of the round tripped value.
 
+    The ASCII is read back by ParseDouble(), which must read every string to
+    the same double as strtod(), in the "C" locale and in a locale with a
+    decimal comma.
+
     Author: Dick Hollenbeck
 */
 
@@ -17,6 +21,9 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <locale.h>
+
+#include <parse_double.h>
 
 
 static inline int KiROUND( double v )
@@ -61,15 +68,71 @@ std::string biuFmt( BIU aValue )
 
 int parseBIU( const char* s )
 {
-    double d = strtod( s, NULL );
+    double d = ParseDouble( s );
     return KiROUND( double( d * BIU_PER_MM ) );
 //    return int( d * BIU_PER_MM );
 }
 
 
+/// @return true if ParseDouble() reads @a s as strtod() in the "C" locale reads it.
+bool sameAsStrtod( const char* s )
+{
+    const char* end;
+    char*       strtodEnd;
+    double      d = ParseDouble( s, &end );
+    double      expected = strtod( s, &strtodEnd );
+
+    // compare the bits, for -0.0 and NaN
+    return !memcmp( &d, &expected, sizeof( d ) ) && end == strtodEnd;
+}
+
+
+/// Checks ParseDouble() with unusual numbers, in the current locale.
+unsigned testUnusualNumbers( const char* aLocale )
+{
+    static const char* numbers[] =
+    {
+        "0", "-0", "+1", "  \t12.5mm", ".5", "5.", ".", "-", "+", "", "e5", "1e", "1e+",
+        "1e-3x", "1.5E10", "-2.25e-7", "0x1A", "-0X1p3", "00x1", "inf", "-Infinity",
+        "nan", "1e400", "-1e400", "1e-400", "4.9e-324", "1.7976931348623157e308",
+        "123456789012345678901234567890", "0.1234567890123456789012345",
+        "9007199254740993", "0.000000000000000000000000001", "3,14", "12.5,3",
+        "1000000000000000000000000e-10", "0.00000000000000000000001e30", NULL
+    };
+
+    unsigned mismatches = 0;
+
+    for( int i = 0;  numbers[i];  ++i )
+    {
+        // strtod() reads the number in the "C" locale
+        setlocale( LC_NUMERIC, "C" );
+
+        const char* end;
+        char*       strtodEnd;
+        double      expected = strtod( numbers[i], &strtodEnd );
+
+        setlocale( LC_NUMERIC, aLocale );
+
+        double      d = ParseDouble( numbers[i], &end );
+
+        if( memcmp( &d, &expected, sizeof( d ) ) || end - numbers[i] != strtodEnd - numbers[i] )
+        {
+            printf( "locale %s: '%s': ParseDouble():%.17g strtod():%.17g\n",
+                    aLocale, numbers[i], d, expected );
+            ++mismatches;
+        }
+    }
+
+    setlocale( LC_NUMERIC, "C" );
+
+    return mismatches;
+}
+
+
 int main( int argc, char** argv )
 {
     unsigned mismatches = 0;
+    unsigned parserMismatches = 0;
 
     if( argc > 1 )
     {
@@ -88,6 +151,12 @@ int main( int argc, char** argv )
 
     // printf( "sizeof(long double): %zd\n", sizeof( long double ) );
 
+    parserMismatches += testUnusualNumbers( "C" );
+
+    // a locale with a decimal comma, if installed
+    if( setlocale( LC_NUMERIC, "de_DE.UTF-8" ) || setlocale( LC_NUMERIC, "fr_FR.UTF-8" ) )
+        parserMismatches += testUnusualNumbers( setlocale( LC_NUMERIC, NULL ) );
+
     // Emperically prove that we can round trip all 4 billion 32 bit integers representative
     // of nanometers out to textual floating point millimeters, and back without error using
     // the above two functions.
@@ -106,6 +175,12 @@ int main( int argc, char** argv )
             ++mismatches;
         }
 
+        if( !sameAsStrtod( s.c_str() ) )
+        {
+            printf( "i:%d  biuFmt:%s  ParseDouble() is not strtod()\n", i, s.c_str() );
+            ++parserMismatches;
+        }
+
         if( !( i & 0xFFFFFF ) )
         {
             printf( " %08x", i );
@@ -113,8 +188,8 @@ int main( int argc, char** argv )
         }
     }
 
-    printf( "mismatches:%u\n", mismatches );
+    printf( "mismatches:%u  parser mismatches:%u\n", mismatches, parserMismatches );
 
-    return 0;
+    return mismatches || parserMismatches ? 1 : 0;
 }
 
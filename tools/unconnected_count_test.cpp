@@ -0,0 +1,94 @@
+/*
+    A test program for BOARD::UpdateUnconnectedNetCount(), which updates the
+    count of the active ratsnest links when TestForActiveLinksInRatsnest()
+    tests a single net: a connection of a net is removed, then removed again
+    by a second test of the same net, which must not change the count.  When
+    the count is less than the links of the net which were active, it was not
+    updated with the links and must be counted again, not wrap around.
+*/
+
+#include <stdio.h>
+
+#include <fctsys.h>
+#include <common.h>
+#include <class_board.h>
+#include <class_netinfo.h>
+
+
+/// sets the active links of the ratsnest of @a aNet from @a aActive, and
+/// @return unsigned - the count of its links which were active before
+static unsigned setActiveLinks( BOARD* aBoard, const NETINFO_ITEM* aNet, const char* aActive )
+{
+    unsigned wasActive = 0;
+
+    for( unsigned ii = aNet->m_RatsnestStartIdx; ii < aNet->m_RatsnestEndIdx; ii++ )
+    {
+        RATSNEST_ITEM& link = aBoard->m_FullRatsnest[ii];
+
+        if( link.IsActive() )
+            wasActive++;
+
+        if( aActive[ ii - aNet->m_RatsnestStartIdx ] == '1' )
+            link.m_Status |= CH_ACTIF;
+        else
+            link.m_Status &= ~CH_ACTIF;
+    }
+
+    return wasActive;
+}
+
+
+/// @return int - 1 if the unconnected count of @a aBoard is not @a aCount, else 0
+static int checkCount( BOARD* aBoard, unsigned aCount, const char* aName )
+{
+    bool same = aBoard->GetUnconnectedNetCount() == aCount;
+
+    printf( "%s: %u unconnected  %s\n", aName, aBoard->GetUnconnectedNetCount(),
+            same ? "expected count" : "COUNT DIFFERS" );
+
+    return same ? 0 : 1;
+}
+
+
+int main( int argc, char** argv )
+{
+    BOARD        board;
+    NETINFO_ITEM net( &board, wxT( "N1" ), 1 );
+
+    // 6 links, all active: 2 of an other net, 3 of N1, 1 of an other net
+    for( int ii = 0; ii < 6; ii++ )
+    {
+        RATSNEST_ITEM link;
+
+        link.m_Status = CH_ACTIF | CH_VISIBLE;
+        board.m_FullRatsnest.push_back( link );
+    }
+
+    net.m_RatsnestStartIdx = 2;
+    net.m_RatsnestEndIdx   = 5;
+
+    board.SetUnconnectedNetCount( 6 );
+
+    // a track connects 2 pads of N1
+    unsigned wasActive = setActiveLinks( &board, &net, "101" );
+
+    board.UpdateUnconnectedNetCount( &net, wasActive );
+
+    int errors = checkCount( &board, 5, "connection removed" );
+
+    // N1 tested again, the same connection is not removed twice
+    wasActive = setActiveLinks( &board, &net, "101" );
+    board.UpdateUnconnectedNetCount( &net, wasActive );
+
+    errors += checkCount( &board, 5, "connection removed twice" );
+
+    // a count not updated with the links
+    board.SetUnconnectedNetCount( 0 );
+
+    wasActive = setActiveLinks( &board, &net, "001" );
+    board.UpdateUnconnectedNetCount( &net, wasActive );
+
+    errors += checkCount( &board, 4, "count out of date" );
+
+    return errors ? 1 : 0;
+}